@@ -0,0 +1,312 @@
+// ----------------------------------------------------------------------
+// File: BufferPool.cc
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "common/BufferPool.hh"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+const size_t BufferPool::sMinClassSize;
+const unsigned int BufferPool::sNumClasses;
+
+//! Classes from this size on can be backed by huge pages
+static const size_t sHugePageSize = 2 * 1024 * 1024;
+
+//------------------------------------------------------------------------------
+// Get the process-wide pool
+//------------------------------------------------------------------------------
+BufferPool&
+BufferPool::GetInstance()
+{
+  // Never destroyed: buffers may be released by other static objects
+  static BufferPool* sPool = 0;
+  static XrdSysMutex sMutex;
+  XrdSysMutexHelper lock(sMutex);
+
+  if (!sPool) {
+    size_t max_mb = 512;
+    bool huge_pages = false;
+
+    if (getenv("EOS_BUFFER_POOL_MAX_MB")) {
+      max_mb = strtoul(getenv("EOS_BUFFER_POOL_MAX_MB"), 0, 10);
+    }
+
+    if (getenv("EOS_BUFFER_POOL_HUGEPAGES")) {
+      huge_pages = !strcmp(getenv("EOS_BUFFER_POOL_HUGEPAGES"), "1");
+    }
+
+    sPool = new BufferPool(max_mb * 1024 * 1024, huge_pages);
+  }
+
+  return *sPool;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+BufferPool::BufferPool(size_t maxIdleBytes, bool hugePages):
+  mMaxIdleBytes(maxIdleBytes), mIdleBytes(0), mOversize(0),
+  mHugePages(hugePages)
+{
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+BufferPool::~BufferPool()
+{
+  Trim();
+}
+
+//------------------------------------------------------------------------------
+// Index of the class of a size
+//------------------------------------------------------------------------------
+int
+BufferPool::GetClass(size_t size)
+{
+  size_t class_size = sMinClassSize;
+
+  for (unsigned int i = 0; i < sNumClasses; i++, class_size <<= 1) {
+    if (size <= class_size) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+// Check if the buffers of a class are mmap-ed
+//------------------------------------------------------------------------------
+bool
+BufferPool::IsMapped(size_t size) const
+{
+  return mHugePages && (size >= sHugePageSize);
+}
+
+//------------------------------------------------------------------------------
+// Get new memory for a buffer
+//------------------------------------------------------------------------------
+char*
+BufferPool::AllocateRaw(size_t size, bool mapped)
+{
+  void* ptr = 0;
+
+  if (mapped) {
+#ifdef MAP_HUGETLB
+    ptr = mmap(0, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (ptr != MAP_FAILED) {
+      return static_cast<char*>(ptr);
+    }
+
+#endif
+    // No reserved huge pages, ask for transparent ones
+    ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+               -1, 0);
+
+    if (ptr == MAP_FAILED) {
+      return 0;
+    }
+
+#ifdef MADV_HUGEPAGE
+    (void) madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    return static_cast<char*>(ptr);
+  }
+
+  if (posix_memalign(&ptr, sMinClassSize, size)) {
+    return 0;
+  }
+
+  return static_cast<char*>(ptr);
+}
+
+//------------------------------------------------------------------------------
+// Give memory back to the system
+//------------------------------------------------------------------------------
+void
+BufferPool::FreeRaw(char* buffer, size_t size, bool mapped)
+{
+  if (mapped) {
+    munmap(buffer, size);
+  } else {
+    free(buffer);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Allocate a buffer
+//------------------------------------------------------------------------------
+char*
+BufferPool::Allocate(size_t size)
+{
+  int cls = GetClass(size);
+
+  if (cls < 0) {
+    mOversize++;
+    return AllocateRaw(size, false);
+  }
+
+  SizeClass& sc = mClasses[cls];
+  size_t class_size = sMinClassSize << cls;
+  {
+    XrdSysMutexHelper lock(sc.mutex);
+    sc.inUse++;
+
+    if (!sc.idle.empty()) {
+      char* buffer = sc.idle.back();
+      sc.idle.pop_back();
+      sc.hits++;
+      mIdleBytes -= class_size;
+      return buffer;
+    }
+
+    sc.misses++;
+  }
+  char* buffer = AllocateRaw(class_size, IsMapped(class_size));
+
+  if (!buffer) {
+    XrdSysMutexHelper lock(sc.mutex);
+    sc.inUse--;
+  }
+
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+// Give back a buffer
+//------------------------------------------------------------------------------
+void
+BufferPool::Release(char* buffer, size_t size)
+{
+  if (!buffer) {
+    return;
+  }
+
+  int cls = GetClass(size);
+
+  if (cls < 0) {
+    FreeRaw(buffer, size, false);
+    return;
+  }
+
+  SizeClass& sc = mClasses[cls];
+  size_t class_size = sMinClassSize << cls;
+  {
+    XrdSysMutexHelper lock(sc.mutex);
+    sc.inUse--;
+    // The releases of the other classes update the idle bytes concurrently,
+    // check and reserve the room in one step
+    size_t idle = mIdleBytes.load();
+
+    while (idle + class_size <= mMaxIdleBytes) {
+      if (mIdleBytes.compare_exchange_weak(idle, idle + class_size)) {
+        sc.idle.push_back(buffer);
+        return;
+      }
+    }
+  }
+  FreeRaw(buffer, class_size, IsMapped(class_size));
+}
+
+//------------------------------------------------------------------------------
+// Release all the idle buffers
+//------------------------------------------------------------------------------
+void
+BufferPool::Trim()
+{
+  for (unsigned int i = 0; i < sNumClasses; i++) {
+    size_t class_size = sMinClassSize << i;
+    std::vector<char*> idle;
+    {
+      XrdSysMutexHelper lock(mClasses[i].mutex);
+      idle.swap(mClasses[i].idle);
+      mIdleBytes -= idle.size() * class_size;
+    }
+
+    for (size_t j = 0; j < idle.size(); j++) {
+      FreeRaw(idle[j], class_size, IsMapped(class_size));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the counters of the size classes in use
+//------------------------------------------------------------------------------
+void
+BufferPool::GetStats(std::vector<Stats>& stats)
+{
+  stats.clear();
+
+  for (unsigned int i = 0; i < sNumClasses; i++) {
+    SizeClass& sc = mClasses[i];
+    XrdSysMutexHelper lock(sc.mutex);
+
+    if (!sc.hits && !sc.misses) {
+      continue;
+    }
+
+    Stats st;
+    st.size = sMinClassSize << i;
+    st.inUse = sc.inUse;
+    st.idle = sc.idle.size();
+    st.hits = sc.hits;
+    st.misses = sc.misses;
+    stats.push_back(st);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Print the counters
+//------------------------------------------------------------------------------
+void
+BufferPool::Print(std::string& out)
+{
+  std::vector<Stats> stats;
+  GetStats(stats);
+  char line[256];
+
+  for (size_t i = 0; i < stats.size(); i++) {
+    snprintf(line, sizeof(line), "bufferpool.size=%lu inuse=%llu idle=%llu "
+             "hits=%llu misses=%llu\n", (unsigned long) stats[i].size,
+             (unsigned long long) stats[i].inUse,
+             (unsigned long long) stats[i].idle,
+             (unsigned long long) stats[i].hits,
+             (unsigned long long) stats[i].misses);
+    out += line;
+  }
+
+  snprintf(line, sizeof(line), "bufferpool.idlebytes=%lu maxidlebytes=%lu "
+           "hugepages=%d oversize=%llu\n", (unsigned long) mIdleBytes.load(),
+           (unsigned long) mMaxIdleBytes, mHugePages ? 1 : 0,
+           (unsigned long long) mOversize.load());
+  out += line;
+}
+
+EOSCOMMONNAMESPACE_END
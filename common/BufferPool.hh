@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------
+// File: BufferPool.hh
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+/**
+ * @file   BufferPool.hh
+ *
+ * @brief  Process-wide pool of page-aligned IO buffers
+ *
+ */
+
+#ifndef __EOSCOMMON_BUFFERPOOL_HH__
+#define __EOSCOMMON_BUFFERPOOL_HH__
+
+#include "common/Namespace.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class BufferPool
+//!
+//! Page-aligned IO buffers grouped in power of two size classes from 4 KB to
+//! 64 MB. Released buffers are kept for reuse, up to a limit on the idle
+//! memory of the process (EOS_BUFFER_POOL_MAX_MB, default 512), so that
+//! frequently opened files do not pay for the allocation and the page faults
+//! of their buffers again. With EOS_BUFFER_POOL_HUGEPAGES=1 the classes of
+//! 2 MB and above are backed by huge pages when available.
+//!
+//! A buffer has to be released with the size it was allocated with.
+//------------------------------------------------------------------------------
+class BufferPool
+{
+public:
+  static const size_t sMinClassSize = 4096; ///< smallest size class
+  static const unsigned int sNumClasses = 15; ///< 4 KB up to 64 MB
+
+  //! Counters of a size class
+  struct Stats {
+    size_t size; ///< buffer size of the class
+    uint64_t inUse; ///< buffers handed out
+    uint64_t idle; ///< buffers kept for reuse
+    uint64_t hits; ///< allocations served from the idle buffers
+    uint64_t misses; ///< allocations which had to get new memory
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get the process-wide pool, it is never destroyed
+  //----------------------------------------------------------------------------
+  static BufferPool& GetInstance();
+
+  //----------------------------------------------------------------------------
+  //! Allocate a buffer of at least size bytes, aligned to a page
+  //!
+  //! @return buffer or 0 if out of memory
+  //----------------------------------------------------------------------------
+  char* Allocate(size_t size);
+
+  //----------------------------------------------------------------------------
+  //! Give back a buffer
+  //!
+  //! @param buffer buffer returned by Allocate, can be 0
+  //! @param size size given to Allocate
+  //----------------------------------------------------------------------------
+  void Release(char* buffer, size_t size);
+
+  //----------------------------------------------------------------------------
+  //! Get the counters of all the size classes, the ones never used excepted
+  //----------------------------------------------------------------------------
+  void GetStats(std::vector<Stats>& stats);
+
+  //----------------------------------------------------------------------------
+  //! Print the counters, one line per size class, followed by the number of
+  //! allocations too large for the pool
+  //----------------------------------------------------------------------------
+  void Print(std::string& out);
+
+  //----------------------------------------------------------------------------
+  //! Release all the idle buffers
+  //----------------------------------------------------------------------------
+  void Trim();
+
+  //----------------------------------------------------------------------------
+  //! Constructor, only used directly by the tests
+  //!
+  //! @param maxIdleBytes limit of the memory kept in idle buffers
+  //! @param hugePages back the large classes by huge pages
+  //----------------------------------------------------------------------------
+  BufferPool(size_t maxIdleBytes, bool hugePages);
+
+  ~BufferPool();
+
+private:
+  struct SizeClass {
+    XrdSysMutex mutex;
+    std::vector<char*> idle;
+    uint64_t inUse;
+    uint64_t hits;
+    uint64_t misses;
+
+    SizeClass(): inUse(0), hits(0), misses(0) {}
+  };
+
+  SizeClass mClasses[sNumClasses];
+  size_t mMaxIdleBytes; ///< limit of the memory kept in idle buffers
+  std::atomic<size_t> mIdleBytes; ///< memory kept in idle buffers
+  std::atomic<uint64_t> mOversize; ///< allocations larger than any class
+  bool mHugePages; ///< large classes are mmap-ed with huge pages
+
+  //----------------------------------------------------------------------------
+  //! Index of the class of a size, -1 if larger than the largest class
+  //----------------------------------------------------------------------------
+  static int GetClass(size_t size);
+
+  //----------------------------------------------------------------------------
+  //! Get new memory for a buffer and give it back to the system
+  //----------------------------------------------------------------------------
+  char* AllocateRaw(size_t size, bool mapped);
+  void FreeRaw(char* buffer, size_t size, bool mapped);
+
+  //----------------------------------------------------------------------------
+  //! Check if the buffers of a class are mmap-ed
+  //----------------------------------------------------------------------------
+  bool IsMapped(size_t size) const;
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator = (const BufferPool&) = delete;
+};
+
+EOSCOMMONNAMESPACE_END
+
+#endif
@@ -32,7 +32,7 @@
 
 EOSCOMMONNAMESPACE_BEGIN
 
-LvDbInterfaceBase::Option LvDbInterfaceBase::gDefaultOption = { 10, 100};
+LvDbInterfaceBase::Option LvDbInterfaceBase::gDefaultOption = { 10, 100, 0};
 unsigned LvDbInterfaceBase::pNInstances = 0;
 bool LvDbInterfaceBase::pDebugMode = false;
 bool LvDbInterfaceBase::pAbortOnLvDbError = true;
@@ -1015,12 +1015,12 @@ bool LvDbDbMapInterface::attachDb(const std::string& dbname, bool repair,
     pOptions.create_if_missing = true;
     pOptions.error_if_exists = false;
     leveldb::Status status = dbOpen(pOptions, dbname, &AttachedDb, opt->CacheSizeMb,
-                                    opt->BloomFilterNbits);
+                                    opt->BloomFilterNbits, opt->WriteBufferMb);
 
     if (repair && !status.ok()) {
       leveldb::RepairDB(dbname.c_str(), leveldb::Options());
       status = dbOpen(pOptions, dbname, &AttachedDb, opt->CacheSizeMb,
-                      opt->BloomFilterNbits);
+                      opt->BloomFilterNbits, opt->WriteBufferMb);
     }
 
     TestLvDbError(status, this);
@@ -67,17 +67,24 @@ protected:
   static std::map<std::string , std::pair< std::pair<leveldb::DB*,leveldb::Options* > , int> > pName2CountedDb;
   static std::map<leveldb::DB* , std::pair<std::string,int> > pDb2CountedName;
 
-  static leveldb::Status dbOpen( const leveldb::Options &options, const std::string &dbname, leveldb::DB** db , const size_t cacheSizeMb=0  , const size_t bloomFilterNbits=0)
+  static leveldb::Status dbOpen( const leveldb::Options &options, const std::string &dbname, leveldb::DB** db , const size_t cacheSizeMb=0  , const size_t bloomFilterNbits=0, const size_t writeBufferMb=0)
   {
     RWMutexWriteLock lock(gDbMgmtMutex);
 
     if(!pName2CountedDb.count(dbname)) // this db is not opened yet, open it
     {
-      leveldb::Status status = leveldb::DB::Open(options, dbname, db);
-      if(!status.ok()) return status;
+      // the cache and the filter have to be set before the open to be used
       leveldb::Options *op = new leveldb::Options(options);
       if(cacheSizeMb) op->block_cache = leveldb::NewLRUCache(cacheSizeMb * 1048576);
       if(bloomFilterNbits) op->filter_policy = leveldb::NewBloomFilterPolicy(bloomFilterNbits);
+      if(writeBufferMb) op->write_buffer_size = writeBufferMb * 1048576;
+      leveldb::Status status = leveldb::DB::Open(*op, dbname, db);
+      if(!status.ok()) {
+        if(op->block_cache) delete op->block_cache;
+        if(op->filter_policy) delete op->filter_policy;
+        delete op;
+        return status;
+      }
       //eos_static_debug("LevelDB OPEN : %s\n",dbname.c_str()); // fflush(stdout);
       pName2CountedDb[dbname] = std::make_pair( std::make_pair(*db, op ) , 1 );
       pDb2CountedName[*db] = std::make_pair( dbname , 1);
@@ -125,6 +132,7 @@ public :
   {
     size_t BloomFilterNbits;
     size_t CacheSizeMb;
+    size_t WriteBufferMb;
   };
 
   LvDbInterfaceBase()
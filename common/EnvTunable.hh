@@ -0,0 +1,85 @@
+// ----------------------------------------------------------------------
+// File: EnvTunable.hh
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+/**
+ * @file   EnvTunable.hh
+ *
+ * @brief  Numeric tunables read from the environment
+ *
+ */
+
+#ifndef __EOSCOMMON_ENVTUNABLE_HH__
+#define __EOSCOMMON_ENVTUNABLE_HH__
+
+#include "common/Namespace.hh"
+#include <cstdlib>
+
+EOSCOMMONNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! @brief Static class reading a numeric tunable from the environment
+//!
+//! The environment doesn't change at run time, callers keep the value in a
+//! local static which is initialized once even with concurrent callers.
+//!
+//! Example
+//! \code
+//!   static const int sThreads =
+//!     eos::common::EnvTunable::Get("EOS_FST_VERIFY_THREADS", 8, 1, 64);
+//! \endcode
+//------------------------------------------------------------------------------
+class EnvTunable
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Get a tunable
+  //!
+  //! @param name environment variable
+  //! @param def value if the variable is not set or not a number
+  //! @param min smallest value returned
+  //! @param max largest value returned
+  //!
+  //! @return value of the variable clamped to [min, max]
+  //----------------------------------------------------------------------------
+  static long long
+  Get(const char* name, long long def, long long min, long long max)
+  {
+    long long value = def;
+    const char* ptr = getenv(name);
+
+    if (ptr && *ptr) {
+      char* end = 0;
+      long long parsed = strtoll(ptr, &end, 10);
+
+      if (!*end) {
+        value = parsed;
+      }
+    }
+
+    return ((value < min) ? min : ((value > max) ? max : value));
+  }
+};
+
+EOSCOMMONNAMESPACE_END
+
+#endif
@@ -96,6 +96,8 @@ protected:
 public:
   off_t        mResponseLength;        //!< length of the response
   bool         mUseFileReaderCallback; //!< read the file using callbacks
+  int          mResponseFd;            //!< send the body from this descriptor,
+                                       //!< -1 to use the callbacks
 
 public:
 
@@ -103,7 +105,8 @@ public:
    * Constructor
    */
   HttpResponse () :
-    mResponseCode(OK), mResponseLength(0), mUseFileReaderCallback(false) {};
+    mResponseCode(OK), mResponseLength(0), mUseFileReaderCallback(false),
+    mResponseFd(-1) {};
 
   /**
    * Destructor
@@ -914,6 +914,9 @@ com_fs_usage:
   fprintf(stdout, "fs config <fsid> scaninterval=<seconds>: \n");
   fprintf(stdout,
           "                                                  configures a scanner thread on each FST to recheck the file & block checksums of all stored files every <seconds> seconds. 0 disables the scanning.\n\n");
+  fprintf(stdout, "fs config <fsid> dbcachemb=<MB>|dbbloombits=<bits>|dbwritebuffermb=<MB> :\n");
+  fprintf(stdout,
+          "                                                  LevelDB block cache, bloom filter bits per key and write buffer of the FST meta data DB of the filesystem, applied when the filesystem boots. 0 uses the FST default.\n\n");
   fprintf(stdout, "fs config <fsid> graceperiod=<seconds> :\n");
   fprintf(stdout,
           "                                                  grace period before a filesystem with an operation error get's automatically drained\n");
@@ -26,12 +26,16 @@
 #include "common/FileId.hh"
 #include "common/Path.hh"
 #include "common/DbMap.hh"
+#include "common/ConcurrentQueue.hh"
+#include "common/EnvTunable.hh"
 #include "fst/FmdDbMap.hh"
 #include "fst/XrdFstOfs.hh"
 #include "fst/checksum/ChecksumPlugins.hh"
 #include <fst/io/FileIoPluginCommon.hh>
 /*----------------------------------------------------------------------------*/
+#include "XrdCl/XrdClFile.hh"
 #include "XrdCl/XrdClFileSystem.hh"
+#include "XrdSys/XrdSysTimer.hh"
 /*----------------------------------------------------------------------------*/
 #include <stdio.h>
 #include <sys/mman.h>
@@ -39,6 +43,8 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 /*----------------------------------------------------------------------------*/
 
 EOSFSTNAMESPACE_BEGIN
@@ -47,6 +53,69 @@ EOSFSTNAMESPACE_BEGIN
 FmdDbMapHandler gFmdDbMapHandler; //< static
 /*----------------------------------------------------------------------------*/
 
+// Files handed over at once from the walk of a disk to the resync threads
+static const size_t sBootDiskBatchSize = 256;
+// Records applied to the DB in one write batch during a resync from the MGM
+static const size_t sResyncMgmBatchSize = 10000;
+// Size of the reads of the MGM meta data dump
+static const uint32_t sResyncMgmReadSize = 4 * 1024 * 1024;
+// Attempts without progress before a resync from the MGM is given up
+static const int sResyncMgmAttempts = 3;
+// Records committed to a DB in one write batch at most
+static const size_t sCommitBatchSize = 1000;
+
+#ifndef EOS_SQLITE_DBMAP
+/*----------------------------------------------------------------------------*/
+/**
+ * LevelDB tuning default of the FST taken from the environment
+ *
+ * @param name environment variable
+ * @param def value if the variable is not set, 0 uses the LevelDB default
+ *
+ * @return value to use
+ */
+
+/*----------------------------------------------------------------------------*/
+static size_t
+LevelDbDefault(const char* name, size_t def)
+{
+  const char* ptr = getenv(name);
+  return (ptr ? strtoul(ptr, 0, 10) : def);
+}
+#endif
+
+/*----------------------------------------------------------------------------*/
+/**
+ * Adds the time spent in its scope to a pair of latency counters
+ */
+
+/*----------------------------------------------------------------------------*/
+class LatencyScope
+{
+public:
+  LatencyScope(std::atomic<unsigned long long>* n,
+               std::atomic<unsigned long long>* usec): mN(n), mUsec(usec)
+  {
+    gettimeofday(&mStart, 0);
+  }
+
+  ~LatencyScope()
+  {
+    if (mN) {
+      struct timeval now;
+      gettimeofday(&now, 0);
+      (*mN)++;
+      (*mUsec) += (now.tv_sec - mStart.tv_sec) * 1000000ll +
+                  (now.tv_usec - mStart.tv_usec);
+    }
+  }
+
+private:
+  std::atomic<unsigned long long>* mN;
+  std::atomic<unsigned long long>* mUsec;
+  struct timeval mStart;
+};
+
 /*----------------------------------------------------------------------------*/
 /**
  * Set a new DB file for a filesystem id.
@@ -79,70 +148,100 @@ FmdDbMapHandler::SetDBFile(const char* dbfileprefix, int fsid,
     }
   }
 
-  eos::common::RWMutexWriteLock lock(Mutex);
-  FmdSqliteWriteLock vlock(fsid);
+  {
+    eos::common::RWMutexWriteLock lock(Mutex);
+    FmdSqliteWriteLock vlock(fsid);
 
-  if (!isattached) {
-    dbmap[fsid] = new eos::common::DbMap();
-  }
-
-  //! -when we successfully attach to a DB we set the mode to S_IRWXU & ~S_IRGRP
-  //! -when we shutdown the daemon clean we set the mode back to S_IRWXU | S_IRGRP
-  //! -when we attach and the mode is S_IRWXU & ~S_IRGRP we know that the DB has not been shutdown properly and we set a 'dirty' flag to force a full resynchronization
-  char fsDBFileName[1024];
-  sprintf(fsDBFileName, "%s.%04d.%s", dbfileprefix, fsid,
-          eos::common::DbMap::getDbType().c_str());
-  eos_info("%s DB is now %s\n", eos::common::DbMap::getDbType().c_str(),
-           fsDBFileName);
-  // store the DB file name
-  DBfilename[fsid] = fsDBFileName;
-  // check the mode of the DB
-  struct stat buf;
-  int src = 0;
-
-  if ((src = stat(fsDBFileName, &buf)) || ((buf.st_mode & S_IRGRP) != S_IRGRP)) {
-    isDirty[fsid] = true;
-    stayDirty[fsid] = true;
-    eos_warning("setting %s file dirty - unclean shutdown detected",
-                eos::common::DbMap::getDbType().c_str());
-
-    if (!src) {
-      if (chmod(fsDBFileName, S_IRWXU | S_IRGRP)) {
-        eos_crit("failed to switch the %s database file mode to S_IRWXU | S_IRGRP errno=%d",
-                 eos::common::DbMap::getDbType().c_str(), errno);
-      }
+    if (!isattached) {
+      dbmap[fsid] = new eos::common::DbMap();
     }
-  } else {
-    isDirty[fsid] = false;
-    stayDirty[fsid] = false;
-  }
 
-  // create / or attach the db (try to repair if needed)
-#ifndef EOS_SQLITE_DBMAP
-  eos::common::LvDbDbMapInterface::Option* dbopt = &lvdboption;
+    //! -when we successfully attach to a DB we set the mode to S_IRWXU & ~S_IRGRP
+    //! -when we shutdown the daemon clean we set the mode back to S_IRWXU | S_IRGRP
+    //! -when we attach and the mode is S_IRWXU & ~S_IRGRP we know that the DB has not been shutdown properly and we set a 'dirty' flag to force a full resynchronization
+    char fsDBFileName[1024];
+    sprintf(fsDBFileName, "%s.%04d.%s", dbfileprefix, fsid,
+            eos::common::DbMap::getDbType().c_str());
+    eos_info("%s DB is now %s\n", eos::common::DbMap::getDbType().c_str(),
+             fsDBFileName);
+    // store the DB file name
+    DBfilename[fsid] = fsDBFileName;
+    // check the mode of the DB
+    struct stat buf;
+    int src = 0;
 
-  // if we have not set the leveldb option, use the default (currently, bloom filter 10 bits and 100MB cache)
-  if (lvdboption.BloomFilterNbits == 0) {
-    dbopt = NULL;
-  }
+    if ((src = stat(fsDBFileName, &buf)) || ((buf.st_mode & S_IRGRP) != S_IRGRP)) {
+      {
+        XrdSysMutexHelper flock(FlagMutex);
+        isDirty[fsid] = true;
+        stayDirty[fsid] = true;
+      }
+      eos_warning("setting %s file dirty - unclean shutdown detected",
+                  eos::common::DbMap::getDbType().c_str());
 
+      if (!src) {
+        if (chmod(fsDBFileName, S_IRWXU | S_IRGRP)) {
+          eos_crit("failed to switch the %s database file mode to S_IRWXU | S_IRGRP errno=%d",
+                   eos::common::DbMap::getDbType().c_str(), errno);
+        }
+      }
+    } else {
+      XrdSysMutexHelper flock(FlagMutex);
+      isDirty[fsid] = false;
+      stayDirty[fsid] = false;
+    }
+
+    if (!mFsState.count(fsid)) {
+      mFsState[fsid] = new FsState();
+    }
+
+    // create / or attach the db (try to repair if needed)
+#ifndef EOS_SQLITE_DBMAP
+    // the tuning of the filesystem overrides the one of the FST, the defaults
+    // are the ones DbMap uses without options: a 100 MB block cache and 10
+    // bloom filter bits per key
+    const eos::common::LvDbDbMapInterface::Option& fsopt =
+      mFsState[fsid]->lvdboption;
+    eos::common::LvDbDbMapInterface::Option lvdbfsoption;
+    lvdbfsoption.CacheSizeMb = (fsopt.CacheSizeMb ? fsopt.CacheSizeMb :
+                                (lvdboption.CacheSizeMb ? lvdboption.CacheSizeMb :
+                                 LevelDbDefault("EOS_FST_LEVELDB_CACHE_MB",
+                                                100)));
+    lvdbfsoption.BloomFilterNbits = (fsopt.BloomFilterNbits ?
+                                     fsopt.BloomFilterNbits :
+                                     (lvdboption.BloomFilterNbits ? lvdboption.BloomFilterNbits :
+                                      LevelDbDefault("EOS_FST_LEVELDB_BLOOM_BITS", 10)));
+    lvdbfsoption.WriteBufferMb = (fsopt.WriteBufferMb ? fsopt.WriteBufferMb :
+                                  (lvdboption.WriteBufferMb ? lvdboption.WriteBufferMb :
+                                   LevelDbDefault("EOS_FST_LEVELDB_WRITE_BUFFER_MB", 0)));
+    eos::common::LvDbDbMapInterface::Option* dbopt = &lvdbfsoption;
+    eos_info("msg=\"leveldb tuning\" fsid=%d cache-mb=%lu bloom-bits=%lu "
+             "write-buffer-mb=%lu", fsid, (unsigned long) lvdbfsoption.CacheSizeMb,
+             (unsigned long) lvdbfsoption.BloomFilterNbits,
+             (unsigned long) lvdbfsoption.WriteBufferMb);
 #endif
 
-  if (!dbmap[fsid]->attachDb(fsDBFileName, true, 0, dbopt)) {
-    eos_err("failed to attach %s database file %s",
-            eos::common::DbMap::getDbType().c_str(), fsDBFileName);
-    return false;
-  } else {
-    dbmap[fsid]->outOfCore(true);
-  }
+    if (!dbmap[fsid]->attachDb(fsDBFileName, true, 0, dbopt)) {
+      eos_err("failed to attach %s database file %s",
+              eos::common::DbMap::getDbType().c_str(), fsDBFileName);
+      return false;
+    } else {
+      dbmap[fsid]->outOfCore(true);
+    }
 
-  // set the mode to S_IRWXU & ~S_IRGRP
-  if (chmod(fsDBFileName, S_IRWXU & ~S_IRGRP)) {
-    eos_crit("failed to switch the %s database file mode to S_IRWXU & ~S_IRGRP errno=%d",
-             eos::common::DbMap::getDbType().c_str(), errno);
-    return false;
+    // set the mode to S_IRWXU & ~S_IRGRP
+    if (chmod(fsDBFileName, S_IRWXU & ~S_IRGRP)) {
+      eos_crit("failed to switch the %s database file mode to S_IRWXU & ~S_IRGRP errno=%d",
+               eos::common::DbMap::getDbType().c_str(), errno);
+      return false;
+    }
   }
 
+  // the records are counted and converted without blocking the other
+  // filesystems
+  eos::common::RWMutexReadLock lock(Mutex);
+  FmdSqliteWriteLock vlock(fsid);
+  Recount(fsid);
   return true;
 }
 
@@ -164,7 +263,13 @@ FmdDbMapHandler::ShutdownDB(eos::common::FileSystem::fsid_t fsid)
            eos::common::DbMap::getDbType().c_str(), (unsigned long) fsid);
 
   if (dbmap.count(fsid)) {
-    if (!stayDirty[fsid]) {
+    bool staydirty;
+    {
+      XrdSysMutexHelper flock(FlagMutex);
+      staydirty = stayDirty[fsid];
+    }
+
+    if (!staydirty) {
       // if there was a complete boot procedure done, we remove the dirty flag
       // set the mode back to S_IRWXU | S_IRGRP
       if (chmod(DBfilename[fsid].c_str(), S_IRWXU | S_IRGRP)) {
@@ -173,6 +278,11 @@ FmdDbMapHandler::ShutdownDB(eos::common::FileSystem::fsid_t fsid)
       }
     }
 
+    {
+      FmdSqliteWriteLock vlock(fsid);
+      FlushBatch(fsid);
+    }
+
     if (dbmap[fsid]->detachDb()) {
       delete dbmap[fsid];
       dbmap.erase(fsid);
@@ -253,6 +363,8 @@ FmdDbMapHandler::GetFmd(eos::common::FileId::fileid_t fid,
   }
 
   eos::common::RWMutexReadLock lock(Mutex);
+  FsState* state = GetFsState(fsid);
+  LatencyScope latency(state ? &state->nget : 0, state ? &state->getusec : 0);
 
   if (dbmap.count(fsid)) {
     Fmd valfmd;
@@ -412,14 +524,21 @@ FmdDbMapHandler::DeleteFmd(eos::common::FileId::fileid_t fid,
   eos_static_info("");
   eos::common::RWMutexReadLock lock(Mutex);
   FmdSqliteWriteLock wlock(fsid);
-  bool entryexist = ExistFmd(fid, fsid);
+  // a removal inside a set sequence would still be visible in the DB
+  FlushBatch(fsid);
+  eos::common::DbMap::Tval val;
+  std::string buffer;
+  FmdRecord stored = (dbmap.count(fsid) ? StoredRecord(fid, fsid, val, buffer) :
+                      FmdRecord());
 
   // erase the hash entry
-  if (entryexist) {
+  if (stored.IsValid()) {
     // delete in the in-memory hash
     if (dbmap[fsid]->remove(eos::common::Slice((const char*)&fid, sizeof(fid)))) {
       eos_err("unable to delete fid=%08llx from fst table\n", fid);
       rc = false;
+    } else {
+      Account(fsid, fid, stored, FmdRecord());
     }
   } else {
     rc = false;
@@ -428,6 +547,66 @@ FmdDbMapHandler::DeleteFmd(eos::common::FileId::fileid_t fid,
   return rc;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+ * Delete the fmd records of many files in one DB write batch
+ *
+ * @param fids file ids
+ * @param fsid filesystem id
+ *
+ * @return number of records deleted
+ */
+
+/*----------------------------------------------------------------------------*/
+size_t
+FmdDbMapHandler::DeleteFmds(const std::vector<eos::common::FileId::fileid_t>&
+                            fids, eos::common::FileSystem::fsid_t fsid)
+{
+  eos::common::RWMutexReadLock lock(Mutex);
+  FmdSqliteWriteLock wlock(fsid);
+
+  if (!dbmap.count(fsid)) {
+    eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
+             (unsigned long) fsid);
+    return 0;
+  }
+
+  // a removal inside a set sequence would still be visible in the DB
+  FlushBatch(fsid);
+  size_t cpt = 0;
+  // a removed record is still found in the DB until the sequence ends
+  std::set<eos::common::FileId::fileid_t> removed;
+  eos::common::DbMap::Tval val;
+  std::string buffer;
+  dbmap[fsid]->beginSetSequence();
+
+  for (auto it = fids.begin(); it != fids.end(); ++it) {
+    eos::common::FileId::fileid_t fid = *it;
+
+    if (removed.count(fid)) {
+      continue;
+    }
+
+    FmdRecord stored = StoredRecord(fid, fsid, val, buffer);
+
+    if (stored.IsValid()) {
+      dbmap[fsid]->remove(eos::common::Slice((const char*)&fid, sizeof(fid)));
+      Account(fsid, fid, stored, FmdRecord());
+      removed.insert(fid);
+      cpt++;
+    }
+  }
+
+  if (dbmap[fsid]->endSetSequence() != cpt) {
+    // the setsequence makes that it's impossible to know which key is faulty
+    eos_err("unable to delete %lu fids from fst table of fsid=%lu",
+            (unsigned long) cpt, (unsigned long) fsid);
+    return 0;
+  }
+
+  return cpt;
+}
+
 
 /*----------------------------------------------------------------------------*/
 /**
@@ -462,28 +641,326 @@ FmdDbMapHandler::Commit(FmdHelper* fmd, bool lockit)
     FmdSqliteLockWrite(fsid);
   }
 
+  bool res = false;
+
   if (dbmap.count(fsid)) {
-    bool res = PutFmd(fid, fsid, fmd->fMd);
+    FsState* state = GetFsState(fsid);
+    LatencyScope latency(state ? &state->ncommit : 0,
+                         state ? &state->commitusec : 0);
+
+    if (state && CommitFlushMs()) {
+      // the record goes to the DB with the next flush of the set sequence,
+      // until then it is returned by the lookups from the sequence
+      if (!state->pending) {
+        dbmap[fsid]->beginSetSequence();
+        state->opened = tv.tv_sec * 1000ull + tv.tv_usec / 1000;
+      }
 
-    // update in-memory
-    if (lockit) {
-      FmdSqliteUnLockWrite(fsid);
-      Mutex.UnLockRead(); // <----
-    }
+      state->pending++;
+      res = PutFmd(fid, fsid, fmd->fMd);
 
-    return res;
+      if (state->pending >= sCommitBatchSize) {
+        FlushBatch(fsid);
+      }
+    } else {
+      res = PutFmd(fid, fsid, fmd->fMd);
+    }
   } else {
     eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
              (unsigned long) fsid);
+  }
+
+  if (lockit) {
+    FmdSqliteUnLockWrite(fsid);
+    Mutex.UnLockRead(); // <----
+  }
 
-    if (lockit) {
-      FmdSqliteUnLockWrite(fsid);
-      Mutex.UnLockRead(); // <----
+  return res;
+}
+
+/*----------------------------------------------------------------------------*/
+void
+FmdDbMapHandler::FlushBatch(eos::common::FileSystem::fsid_t fsid)
+{
+  FsState* state = GetFsState(fsid);
+
+  if (state && state->pending && dbmap.count(fsid)) {
+    dbmap[fsid]->endSetSequence();
+    state->pending = 0;
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+ * Get the file id of a DB key
+ */
+
+/*----------------------------------------------------------------------------*/
+static eos::common::FileId::fileid_t
+KeyFid(const eos::common::DbMapTypes::Tkey& key)
+{
+  eos::common::FileId::fileid_t fid = 0;
+
+  if (key.size() == sizeof(fid)) {
+    memcpy(&fid, key.data(), sizeof(fid));
+  }
+
+  return fid;
+}
+
+/*----------------------------------------------------------------------------*/
+FmdRecord
+FmdDbMapHandler::RetrieveFmd(eos::common::FileId::fileid_t fid,
+                             eos::common::FileSystem::fsid_t fsid, Fmd& fmd,
+                             eos::common::DbMap::Tval& val, std::string& buffer)
+{
+  FmdRecord stored = StoredRecord(fid, fsid, val, buffer);
+
+  if (stored.IsValid()) {
+    FmdRecord::Decode(val.value, fmd);
+  } else {
+    fmd.Clear();
+  }
+
+  return stored;
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+FmdDbMapHandler::PutFmd(eos::common::FileId::fileid_t fid,
+                        eos::common::FileSystem::fsid_t fsid, const Fmd& fmd,
+                        const FmdRecord* stored)
+{
+  eos::common::DbMap::Tval val;
+  std::string buffer;
+  // the commits come with a copy of the record which may be outdated, so the
+  // record is read again for them
+  FmdRecord oldrec = (stored ? *stored : StoredRecord(fid, fsid, val, buffer));
+  std::string sval;
+  FmdRecord::Encode(fmd, sval);
+
+  // inside a set sequence the number of buffered entries is returned
+  if (dbmap[fsid]->set(eos::common::Slice((const char*)&fid, sizeof(fid)),
+                       sval, "") == (unsigned long) - 1) {
+    return false;
+  }
+
+  Account(fsid, fid, oldrec, FmdRecord(sval.data(), sval.size()));
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+void
+FmdDbMapHandler::Account(eos::common::FileSystem::fsid_t fsid,
+                         eos::common::FileId::fileid_t fid,
+                         const FmdRecord& oldrec, const FmdRecord& newrec)
+{
+  FsState* state = GetFsState(fsid);
+
+  if (!state) {
+    return;
+  }
+
+  uint32_t oldscan = (oldrec.IsValid() ? oldrec.GetScanTime() :
+                      FmdRecord::sNoScan);
+  uint32_t newscan = (newrec.IsValid() ? newrec.GetScanTime() :
+                      FmdRecord::sNoScan);
+
+  if (oldscan != newscan) {
+    if (oldscan != FmdRecord::sNoScan) {
+      state->scantimes.erase(std::make_pair(oldscan, fid));
+    }
+
+    if (newscan != FmdRecord::sNoScan) {
+      state->scantimes.insert(std::make_pair(newscan, fid));
     }
   }
 
-  return false;
+  unsigned int oldcls = (oldrec.IsValid() ? oldrec.GetClasses() : 0);
+  unsigned int newcls = (newrec.IsValid() ? newrec.GetClasses() : 0);
+
+  if (oldcls == newcls) {
+    return;
+  }
+
+  for (int cls = 0; cls < FmdRecord::kNumClasses; cls++) {
+    bool was = (oldcls & (1u << cls));
+    bool is = (newcls & (1u << cls));
+
+    if (was == is) {
+      continue;
+    }
+
+    if (is) {
+      state->nrecords[cls]++;
+    } else if (state->nrecords[cls]) {
+      state->nrecords[cls]--;
+    }
+
+    if (FmdRecord::HasFidSet(cls)) {
+      if (is) {
+        state->fids[cls].insert(fid);
+      } else {
+        state->fids[cls].erase(fid);
+      }
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+FmdRecord
+FmdDbMapHandler::StoredRecord(eos::common::FileId::fileid_t fid,
+                              eos::common::FileSystem::fsid_t fsid,
+                              eos::common::DbMap::Tval& val, std::string& buffer)
+{
+  if (!dbmap[fsid]->get(eos::common::Slice((const char*)&fid, sizeof(fid)),
+                        &val)) {
+    return FmdRecord();
+  }
+
+  return FmdRecord::Open(val.value.data(), val.value.size(), buffer);
+}
+
+/*----------------------------------------------------------------------------*/
+void
+FmdDbMapHandler::Recount(eos::common::FileSystem::fsid_t fsid)
+{
+  FsState* state = GetFsState(fsid);
+
+  if (!state || !dbmap.count(fsid)) {
+    return;
+  }
+
+  for (int cls = 0; cls < FmdRecord::kNumClasses; cls++) {
+    state->nrecords[cls] = 0;
+    state->fids[cls].clear();
+  }
+
+  state->scantimes.clear();
+
+  FlushBatch(fsid);
+  const eos::common::DbMapTypes::Tkey* k;
+  const eos::common::DbMapTypes::Tval* v;
+  eos::common::DbMapTypes::Tval val;
+  std::string buffer;
+  unsigned long converted = 0;
+  dbmap[fsid]->beginSetSequence();
+
+  for (dbmap[fsid]->beginIter(); dbmap[fsid]->iterate(&k, &v);) {
+    bool protobuf = (v->value.empty() ||
+                     (v->value[0] != (char) FmdRecord::sMagic));
+    FmdRecord rec = FmdRecord::Open(v->value.data(), v->value.size(), buffer);
+
+    if (protobuf) {
+      // the view holds the record converted to the binary layout
+      val = *v;
+      val.value = buffer;
+      dbmap[fsid]->set(*k, val);
+      converted++;
+    }
+
+    unsigned int classes = rec.GetClasses();
+    eos::common::FileId::fileid_t fid = KeyFid(*k);
+    uint32_t scantime = rec.GetScanTime();
+
+    if (scantime != FmdRecord::sNoScan) {
+      state->scantimes.insert(std::make_pair(scantime, fid));
+    }
+
+    for (int cls = 0; cls < FmdRecord::kNumClasses; cls++) {
+      if (classes & (1u << cls)) {
+        state->nrecords[cls]++;
+
+        if (FmdRecord::HasFidSet(cls)) {
+          state->fids[cls].insert(fid);
+        }
+      }
+    }
+  }
+
+  if (dbmap[fsid]->endSetSequence() != converted) {
+    eos_err("unable to convert %lu records of fsid=%lu to the binary layout",
+            converted, (unsigned long) fsid);
+  } else if (converted) {
+    eos_info("converted %lu records of fsid=%lu to the binary layout",
+             converted, (unsigned long) fsid);
+  }
+
+  eos_info("fsid=%lu records=%lu", (unsigned long) fsid,
+           (unsigned long) state->nrecords[FmdRecord::kMem]);
+}
+
+/*----------------------------------------------------------------------------*/
+void
+FmdDbMapHandler::FlushBatches()
+{
+  unsigned long long interval = CommitFlushMs();
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  unsigned long long now = tv.tv_sec * 1000ull + tv.tv_usec / 1000;
+  eos::common::RWMutexReadLock lock(Mutex);
+
+  for (auto it = dbmap.begin(); it != dbmap.end(); ++it) {
+    FsState* state = GetFsState(it->first);
+
+    if (!state) {
+      continue;
+    }
+
+    FmdSqliteWriteLock wlock(it->first);
+
+    if (state->pending && ((now - state->opened) >= interval)) {
+      FlushBatch(it->first);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+int
+FmdDbMapHandler::CommitFlushMs()
+{
+  static const int sFlushMs =
+    eos::common::EnvTunable::Get("EOS_FST_FMD_FLUSH_MS", 200, 0, 10000);
+  return sFlushMs;
+}
+
+/*----------------------------------------------------------------------------*/
+void
+FmdDbMapHandler::GetLatency(eos::common::FileSystem::fsid_t fsid,
+                            double& get_usec, double& commit_usec)
+{
+  eos::common::RWMutexReadLock lock(Mutex);
+  FsState* state = GetFsState(fsid);
+  get_usec = commit_usec = 0;
+
+  if (state) {
+    unsigned long long n = state->nget.exchange(0);
+    unsigned long long usec = state->getusec.exchange(0);
+    get_usec = (n ? (double) usec / n : 0);
+    n = state->ncommit.exchange(0);
+    usec = state->commitusec.exchange(0);
+    commit_usec = (n ? (double) usec / n : 0);
+  }
+}
+
+#ifndef EOS_SQLITE_DBMAP
+/*----------------------------------------------------------------------------*/
+void
+FmdDbMapHandler::SetLevelDbOptions(eos::common::FileSystem::fsid_t fsid,
+                                   size_t cachemb, size_t bloombits,
+                                   size_t writebuffermb)
+{
+  eos::common::RWMutexWriteLock lock(Mutex);
+
+  if (!mFsState.count(fsid)) {
+    mFsState[fsid] = new FsState();
+  }
+
+  mFsState[fsid]->lvdboption.CacheSizeMb = cachemb;
+  mFsState[fsid]->lvdboption.BloomFilterNbits = bloombits;
+  mFsState[fsid]->lvdboption.WriteBufferMb = writebuffermb;
 }
+#endif
 
 /*----------------------------------------------------------------------------*/
 /**
@@ -519,7 +996,10 @@ FmdDbMapHandler::UpdateFromDisk(eos::common::FileSystem::fsid_t fsid,
   }
 
   if (dbmap.count(fsid)) {
-    Fmd valfmd = RetrieveFmd(fid, fsid);
+    Fmd valfmd;
+    eos::common::DbMap::Tval val;
+    std::string buffer;
+    FmdRecord stored = RetrieveFmd(fid, fsid, valfmd, val, buffer);
     // update in-memory
     valfmd.set_disksize(disksize);
     // fix the reference value from disk
@@ -538,7 +1018,7 @@ FmdDbMapHandler::UpdateFromDisk(eos::common::FileSystem::fsid_t fsid,
       valfmd.set_layouterror(eos::common::LayoutId::kOrphan);
     }
 
-    return PutFmd(fid, fsid, valfmd);
+    return PutFmd(fid, fsid, valfmd, &stored);
   } else {
     eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
              (unsigned long) fsid);
@@ -546,6 +1026,37 @@ FmdDbMapHandler::UpdateFromDisk(eos::common::FileSystem::fsid_t fsid,
   }
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+ * Copy the fields known by the MGM into a local record
+ *
+ * @param mgmfmd record received from the MGM
+ * @param fmd local record to update
+ */
+
+/*----------------------------------------------------------------------------*/
+static void
+CopyMgmFields(const FmdBase& mgmfmd, Fmd& fmd)
+{
+  fmd.set_mgmsize(mgmfmd.mgmsize());
+  fmd.set_size(mgmfmd.mgmsize());
+  fmd.set_cid(mgmfmd.cid());
+  fmd.set_lid(mgmfmd.lid());
+  fmd.set_uid(mgmfmd.uid());
+  fmd.set_gid(mgmfmd.gid());
+  fmd.set_ctime(mgmfmd.ctime());
+  fmd.set_ctime_ns(mgmfmd.ctime_ns());
+  fmd.set_mtime(mgmfmd.mtime());
+  fmd.set_mtime_ns(mgmfmd.mtime_ns());
+  fmd.set_locations(mgmfmd.locations());
+  // truncate the checksum to the right string length
+  size_t cslen = eos::common::LayoutId::GetChecksumLen(mgmfmd.lid()) * 2;
+  std::string checksum = mgmfmd.mgmchecksum();
+  checksum.erase(std::min(checksum.length(), cslen));
+  fmd.set_checksum(checksum);
+  fmd.set_mgmchecksum(checksum);
+}
+
 /*----------------------------------------------------------------------------*/
 /**
  * Update mgm metadata
@@ -580,37 +1091,31 @@ FmdDbMapHandler::UpdateFromMgm(eos::common::FileSystem::fsid_t fsid,
   }
 
   if (dbmap.count(fsid)) {
-    bool entryexist = ExistFmd(fid, fsid);
-    Fmd valfmd = RetrieveFmd(fid, fsid);
+    Fmd valfmd;
+    eos::common::DbMap::Tval val;
+    std::string buffer;
+    FmdRecord stored = RetrieveFmd(fid, fsid, valfmd, val, buffer);
 
-    if (!entryexist) {
+    if (!stored.IsValid()) {
       valfmd.set_disksize(0xfffffffffff1ULL);
     }
 
     // update in-memory
-    valfmd.set_mgmsize(mgmsize);
-    valfmd.set_size(mgmsize);
-    valfmd.set_checksum(mgmchecksum);
-    valfmd.set_mgmchecksum(mgmchecksum);
-    valfmd.set_cid(cid);
-    valfmd.set_lid(lid);
-    valfmd.set_uid(uid);
-    valfmd.set_gid(gid);
-    valfmd.set_ctime(ctime);
-    valfmd.set_ctime_ns(ctime_ns);
-    valfmd.set_mtime(mtime);
-    valfmd.set_mtime_ns(mtime_ns);
+    Fmd mgmfmd;
+    mgmfmd.set_mgmsize(mgmsize);
+    mgmfmd.set_mgmchecksum(mgmchecksum);
+    mgmfmd.set_cid(cid);
+    mgmfmd.set_lid(lid);
+    mgmfmd.set_uid(uid);
+    mgmfmd.set_gid(gid);
+    mgmfmd.set_ctime(ctime);
+    mgmfmd.set_ctime_ns(ctime_ns);
+    mgmfmd.set_mtime(mtime);
+    mgmfmd.set_mtime_ns(mtime_ns);
+    mgmfmd.set_locations(locations);
+    CopyMgmFields(mgmfmd, valfmd);
     valfmd.set_layouterror(layouterror);
-    valfmd.set_locations(locations);
-    // truncate the checksum to the right string length
-    size_t cslen = eos::common::LayoutId::GetChecksumLen(lid) * 2;
-    valfmd.set_mgmchecksum(
-      std::string(valfmd.mgmchecksum()).erase(std::min(valfmd.mgmchecksum().length(),
-          cslen)));
-    valfmd.set_checksum(
-      std::string(valfmd.checksum()).erase(std::min(valfmd.checksum().length(),
-                                           cslen)));
-    return PutFmd(fid, fsid, valfmd);
+    return PutFmd(fid, fsid, valfmd, &stored);
   } else {
     eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
              (unsigned long) fsid);
@@ -635,22 +1140,26 @@ FmdDbMapHandler::ResetDiskInformation(eos::common::FileSystem::fsid_t fsid)
   FmdSqliteWriteLock wlock(fsid);
 
   if (dbmap.count(fsid)) {
+    FlushBatch(fsid);
     const eos::common::DbMapTypes::Tkey* k;
     const eos::common::DbMapTypes::Tval* v;
     eos::common::DbMapTypes::Tval val;
+    std::string buffer;
     dbmap[fsid]->beginSetSequence();
     unsigned long cpt = 0;
 
     for (dbmap[fsid]->beginIter(); dbmap[fsid]->iterate(&k, &v);) {
       Fmd f;
-      f.ParseFromString(v->value);
+      FmdRecord::Decode(v->value, f);
       f.set_disksize(0xfffffffffff1ULL);
       f.set_diskchecksum("");
       f.set_checktime(0);
       f.set_filecxerror(-1);
       f.set_blockcxerror(-1);
       val = *v;
-      f.SerializeToString(&val.value);
+      FmdRecord::Encode(f, val.value);
+      Account(fsid, KeyFid(*k), FmdRecord::Open(v->value.data(), v->value.size(),
+              buffer), FmdRecord(val.value.data(), val.value.size()));
       dbmap[fsid]->set(*k, val);
       cpt++;
     }
@@ -687,20 +1196,24 @@ FmdDbMapHandler::ResetMgmInformation(eos::common::FileSystem::fsid_t fsid)
   FmdSqliteWriteLock vlock(fsid);
 
   if (dbmap.count(fsid)) {
+    FlushBatch(fsid);
     const eos::common::DbMapTypes::Tkey* k;
     const eos::common::DbMapTypes::Tval* v;
     eos::common::DbMapTypes::Tval val;
+    std::string buffer;
     dbmap[fsid]->beginSetSequence();
     unsigned long cpt = 0;
 
     for (dbmap[fsid]->beginIter(); dbmap[fsid]->iterate(&k, &v);) {
       Fmd f;
-      f.ParseFromString(v->value);
+      FmdRecord::Decode(v->value, f);
       f.set_mgmsize(0xfffffffffff1ULL);
       f.set_mgmchecksum("");
       f.set_locations("");
       val = *v;
-      f.SerializeToString(&val.value);
+      FmdRecord::Encode(f, val.value);
+      Account(fsid, KeyFid(*k), FmdRecord::Open(v->value.data(), v->value.size(),
+              buffer), FmdRecord(val.value.data(), val.value.size()));
       dbmap[fsid]->set(*k, val);
       cpt++;
     }
@@ -767,6 +1280,7 @@ FmdDbMapHandler::ResyncDisk(const char* path,
         io->attrGet("user.eos.checksumtype", checksumType);
         io->attrGet("user.eos.filecxerror", filecxError);
         io->attrGet("user.eos.blockcxerror", blockcxError);
+        io->attrGet("user.eos.timestamp", checksumStamp);
         checktime = (strtoull(checksumStamp.c_str(), 0, 10) / 1000000);
 
         if (checksumLen) {
@@ -833,7 +1347,7 @@ FmdDbMapHandler::ResyncAllDisk(const char* path,
   paths[1] = 0;
 
   if (flaglayouterror) {
-    isSyncing[fsid] = true;
+    SetSyncing(fsid, true);
   }
 
   if (!ResetDiskInformation(fsid)) {
@@ -842,47 +1356,106 @@ FmdDbMapHandler::ResyncAllDisk(const char* path,
     return false;
   }
 
+  // The walk only collects the paths, the stat and extended attribute reads
+  // and the DB updates of the files are done by a pool of threads
+  int nthreads = BootDiskThreads();
+  eos::common::ConcurrentQueue<std::vector<std::string>> queue;
+  std::atomic<unsigned long long> cnt(0);
+  std::vector<std::thread> workers;
+
+  for (int i = 0; i < nthreads; i++) {
+    workers.push_back(std::thread([this, &queue, &cnt, fsid, flaglayouterror]() {
+      std::vector<std::string> batch;
+
+      while (true) {
+        queue.wait_pop(batch);
+
+        if (batch.empty()) {
+          break;
+        }
+
+        for (auto it = batch.begin(); it != batch.end(); ++it) {
+          eos_debug("file=%s", it->c_str());
+          ResyncDisk(it->c_str(), fsid, flaglayouterror);
+        }
+
+        unsigned long long done = (cnt += batch.size());
+
+        if ((done % 10000) < batch.size()) {
+          eos_info("msg=\"synced files so far\" nfiles=%llu fsid=%lu", done,
+                   (unsigned long) fsid);
+          SetSyncProgress(fsid, "disk", done);
+        }
+      }
+    }));
+  }
+
   // scan all the files
   FTS* tree = fts_open(paths, FTS_NOCHDIR, 0);
+  bool ok = true;
 
   if (!tree) {
     eos_err("fts_open failed");
-    free(paths);
-    return false;
-  }
+    ok = false;
+  } else {
+    FTSENT* node;
+    std::vector<std::string> batch;
 
-  FTSENT* node;
-  unsigned long long cnt = 0;
+    while ((node = fts_read(tree))) {
+      if (node->fts_level > 0 && node->fts_name[0] == '.') {
+        fts_set(tree, node, FTS_SKIP);
+      } else {
+        if (node->fts_info == FTS_F) {
+          XrdOucString filePath = node->fts_accpath;
 
-  while ((node = fts_read(tree))) {
-    if (node->fts_level > 0 && node->fts_name[0] == '.') {
-      fts_set(tree, node, FTS_SKIP);
-    } else {
-      if (node->fts_info == FTS_F) {
-        XrdOucString filePath = node->fts_accpath;
+          if (!filePath.matches("*.xsmap")) {
+            batch.push_back(filePath.c_str());
 
-        if (!filePath.matches("*.xsmap")) {
-          cnt++;
-          eos_debug("file=%s", filePath.c_str());
-          ResyncDisk(filePath.c_str(), fsid, flaglayouterror);
+            if (batch.size() == sBootDiskBatchSize) {
+              // Don't let the walk run too far ahead of the workers
+              while (!queue.push_size(batch, 4 * nthreads)) {
+                XrdSysTimer::Wait(10);
+              }
 
-          if (!(cnt % 10000)) {
-            eos_info("msg=\"synced files so far\" nfiles=%llu fsid=%lu", cnt,
-                     (unsigned long) fsid);
+              batch.clear();
+            }
           }
         }
       }
     }
+
+    if (batch.size()) {
+      queue.push(batch);
+    }
+
+    if (fts_close(tree)) {
+      eos_err("fts_close failed");
+      ok = false;
+    }
   }
 
-  if (fts_close(tree)) {
-    eos_err("fts_close failed");
-    free(paths);
-    return false;
+  // An empty batch stops a worker
+  for (int i = 0; i < nthreads; i++) {
+    std::vector<std::string> stop;
+    queue.push(stop);
+  }
+
+  for (auto it = workers.begin(); it != workers.end(); ++it) {
+    it->join();
   }
 
+  SetSyncProgress(fsid, "disk", cnt);
   free(paths);
-  return true;
+  return ok;
+}
+
+/*----------------------------------------------------------------------------*/
+int
+FmdDbMapHandler::BootDiskThreads()
+{
+  static const int sThreads =
+    eos::common::EnvTunable::Get("EOS_FST_BOOT_DISK_THREADS", 4, 1, 64);
+  return sThreads;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1016,90 +1589,209 @@ FmdDbMapHandler::ResyncAllMgm(eos::common::FileSystem::fsid_t fsid,
     return false;
   }
 
-  XrdOucString consolestring = "/proc/admin/?&mgm.format=fuse&mgm.cmd=fs&"
-                               "mgm.subcmd=dumpmd&mgm.dumpmd.storetime=1&mgm.dumpmd.option=m&mgm.fsid=";
-  consolestring += (int) fsid;
+  eos::common::FileId::fileid_t lastfid = 0;
+  unsigned long long cnt = 0;
+  eos::common::FileId::fileid_t progressfid = 0;
+  int attempts = 0;
+
+  // An interrupted dump is resumed after the last file id applied, we only
+  // give up if several attempts in a row don't make any progress
+  while (!ResyncMgmStream(fsid, manager, lastfid, cnt)) {
+    if (lastfid != progressfid) {
+      progressfid = lastfid;
+      attempts = 0;
+    }
+
+    if (++attempts >= sResyncMgmAttempts) {
+      eos_err("msg=\"giving up the mgm resync\" fsid=%lu last-fid=%08llx "
+              "nfiles=%llu", (unsigned long) fsid, lastfid, cnt);
+      return false;
+    }
+
+    eos_warning("msg=\"resuming the mgm resync\" fsid=%lu last-fid=%08llx "
+                "nfiles=%llu", (unsigned long) fsid, lastfid, cnt);
+    XrdSysTimer sleeper;
+    sleeper.Snooze(5);
+  }
+
+  eos_info("msg=\"synced files\" nfiles=%llu fsid=%lu", cnt,
+           (unsigned long) fsid);
+  SetSyncing(fsid, false);
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+FmdDbMapHandler::ResyncMgmStream(eos::common::FileSystem::fsid_t fsid,
+                                 const char* manager,
+                                 eos::common::FileId::fileid_t& lastfid,
+                                 unsigned long long& cnt)
+{
   XrdOucString url = "root://";
   url += manager;
-  url += "//";
-  url += consolestring;
-  // We run an external command and parse the output
-  char tmpfile[] = "/tmp/efstd.XXXXXX";
-  int tmp_fd = mkstemp(tmpfile);
-
-  if (tmp_fd == -1) {
-    eos_err("failed to create a temporary file");
+  url += "//proc/admin/?&mgm.format=fuse&mgm.cmd=fs&mgm.subcmd=dumpmd&"
+         "mgm.dumpmd.storetime=1&mgm.dumpmd.option=b&mgm.fsid=";
+  url += (int) fsid;
+  url += "&mgm.dumpmd.startfid=";
+  char sfid[32];
+  snprintf(sfid, sizeof(sfid), "%llu", (unsigned long long) lastfid);
+  url += sfid;
+  XrdCl::File file;
+  XrdCl::XRootDStatus status = file.Open(url.c_str(), XrdCl::OpenFlags::Read);
+
+  if (!status.IsOK()) {
+    eos_err("msg=\"failed to open the mgm dump\" url=\"%s\" status=\"%s\"",
+            url.c_str(), status.ToString().c_str());
     return false;
   }
 
-  (void) close(tmp_fd);
-  XrdOucString cmd = "env XrdSecPROTOCOL=sss xrdcp -f -s \"";
-  cmd += url;
-  cmd += "\" ";
-  cmd += tmpfile;
-  int rc = system(cmd.c_str());
+  std::vector<char> buffer(sResyncMgmReadSize);
+  std::vector<Fmd> records;
+  records.reserve(sResyncMgmBatchSize);
+  std::string pending;
+  uint64_t offset = 0;
+  bool complete = false;
+  bool failed = false;
+
+  while (!complete && !failed) {
+    uint32_t nread = 0;
+    status = file.Read(offset, buffer.size(), buffer.data(), nread);
+
+    if (!status.IsOK()) {
+      eos_err("msg=\"failed to read the mgm dump\" fsid=%lu offset=%llu "
+              "status=\"%s\"", (unsigned long) fsid, (unsigned long long) offset,
+              status.ToString().c_str());
+      failed = true;
+      break;
+    }
 
-  if (WEXITSTATUS(rc)) {
-    eos_err("%s returned %d", cmd.c_str(), WEXITSTATUS(rc));
-    return false;
-  } else {
-    eos_debug("%s executed successfully", cmd.c_str());
-  }
+    if (!nread) {
+      // The dump was cut before the end marker
+      break;
+    }
 
-  // Parse the result and unlink temporary file
-  std::ifstream inFile(tmpfile);
-  std::string dumpentry;
-  unlink(tmpfile);
-  unsigned long long cnt = 0;
+    offset += nread;
+    pending.append(buffer.data(), nread);
+    size_t start = 0;
+    size_t pos;
 
-  while (std::getline(inFile, dumpentry)) {
-    cnt++;
-    eos_debug("line=%s", dumpentry.c_str());
-    XrdOucEnv* env = new XrdOucEnv(dumpentry.c_str());
-
-    if (env) {
-      struct Fmd fMd;
-      FmdHelper::Reset(fMd);
-
-      if (EnvMgmToFmdSqlite(*env, fMd)) {
-        // get/create one
-        FmdHelper* fmd = GetFmd(fMd.fid(), fsid, fMd.uid(), fMd.gid(), fMd.lid(), true,
-                                true);
-        fMd.set_layouterror(FmdHelper::LayoutError(fsid, fMd.lid(), fMd.locations()));
-
-        if (fmd) {
-          // check if it exists on disk
-          if (fmd->fMd.disksize() == 0xfffffffffff1ULL) {
-            fMd.set_layouterror(fMd.layouterror() | eos::common::LayoutId::kMissing);
-            eos_warning("found missing replica for fid=%08llx on fsid=%lu", fMd.fid(),
-                        (unsigned long) fsid);
-          }
+    while ((pos = pending.find('\n', start)) != std::string::npos) {
+      XrdOucString line = pending.substr(start, pos - start).c_str();
+      start = pos + 1;
 
-          if (!UpdateFromMgm(fsid, fMd.fid(), fMd.cid(), fMd.lid(), fMd.mgmsize(),
-                             fMd.mgmchecksum(), fMd.uid(), fMd.gid(), fMd.ctime(), fMd.ctime_ns(),
-                             fMd.mtime(), fMd.mtime_ns(), fMd.layouterror(), fMd.locations())) {
-            eos_err("failed to update fmd %s", dumpentry.c_str());
-          }
+      if (line.beginswith("#eof")) {
+        complete = true;
+        break;
+      }
 
-          delete fmd;
-        } else {
-          eos_err("failed to get/create fmd %s", dumpentry.c_str());
+      char* data = 0;
+      unsigned int len = 0;
+      Fmd record;
+
+      if (!line.length() ||
+          !eos::common::SymKey::Base64Decode(line, data, len) ||
+          !record.ParseFromArray(data, len)) {
+        eos_err("msg=\"failed to decode a record of the mgm dump\" fsid=%lu",
+                (unsigned long) fsid);
+        free(data);
+        failed = true;
+        break;
+      }
+
+      free(data);
+      records.push_back(record);
+
+      if (records.size() >= sResyncMgmBatchSize) {
+        if (!ApplyMgmRecords(fsid, records)) {
+          failed = true;
+          break;
         }
-      } else {
-        eos_err("failed to convert %s", dumpentry.c_str());
+
+        lastfid = records.back().fid();
+        cnt += records.size();
+        records.clear();
+        eos_info("msg=\"synced files so far\" nfiles=%llu fsid=%lu", cnt,
+                 (unsigned long) fsid);
+        SetSyncProgress(fsid, "mgm", cnt);
       }
+    }
+
+    pending.erase(0, start);
+  }
+
+  if (!failed && records.size()) {
+    if (ApplyMgmRecords(fsid, records)) {
+      lastfid = records.back().fid();
+      cnt += records.size();
+    } else {
+      failed = true;
+    }
+  }
+
+  (void) file.Close();
+  return (complete && !failed);
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+FmdDbMapHandler::ApplyMgmRecords(eos::common::FileSystem::fsid_t fsid,
+                                 const std::vector<Fmd>& records)
+{
+  eos::common::RWMutexReadLock lock(Mutex);
+  FmdSqliteWriteLock wlock(fsid);
+
+  if (!dbmap.count(fsid)) {
+    eos_crit("no %s DB open for fsid=%llu", eos::common::DbMap::getDbType().c_str(),
+             (unsigned long) fsid);
+    return false;
+  }
+
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  bool ok = true;
+  eos::common::DbMap::Tval val;
+  std::string buffer;
+  FlushBatch(fsid);
+  // All the records of the batch go to the DB in one write batch
+  dbmap[fsid]->beginSetSequence();
+
+  for (auto it = records.begin(); it != records.end(); ++it) {
+    if (!it->fid()) {
+      eos_info("skipping to insert a file with fid 0");
+      continue;
+    }
+
+    Fmd valfmd;
+    int layouterror = FmdHelper::LayoutError(fsid, it->lid(), it->locations());
+    FmdRecord stored = RetrieveFmd(it->fid(), fsid, valfmd, val, buffer);
 
-      delete env;
+    if (stored.IsValid()) {
+      // check if it exists on disk
+      if (valfmd.disksize() == 0xfffffffffff1ULL) {
+        layouterror |= eos::common::LayoutId::kMissing;
+        eos_warning("found missing replica for fid=%08llx on fsid=%lu", it->fid(),
+                    (unsigned long) fsid);
+      }
+    } else {
+      FmdHelper::Reset(valfmd);
+      valfmd.set_fid(it->fid());
+      valfmd.set_fsid(fsid);
+      valfmd.set_atime(tv.tv_sec);
+      valfmd.set_atime_ns(tv.tv_usec * 1000);
     }
 
-    if (!(cnt % 10000)) {
-      eos_info("msg=\"synced files so far\" nfiles=%llu fsid=%lu", cnt,
-               (unsigned long) fsid);
+    CopyMgmFields(*it, valfmd);
+    valfmd.set_layouterror(layouterror);
+
+    if (!PutFmd(it->fid(), fsid, valfmd, &stored)) {
+      eos_err("failed to update fmd fid=%08llx fsid=%lu", it->fid(),
+              (unsigned long) fsid);
+      ok = false;
     }
   }
 
-  isSyncing[fsid] = false;
-  return true;
+  dbmap[fsid]->endSetSequence();
+  return ok;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -1145,103 +1837,20 @@ FmdDbMapHandler::GetInconsistencyStatistics(eos::common::FileSystem::fsid_t
     return false;
   }
 
-  // query in-memory
-  statistics["mem_n"] = 0; // number of files in DB
-  statistics["d_sync_n"] = 0; // number of synced files from disk
-  statistics["m_sync_n"] = 0; // number of synced files from MGM server
-  // number of files with disk and reference size mismatch
-  statistics["d_mem_sz_diff"] = 0;
-  // number of files with MGM and reference size mismatch
-  statistics["m_mem_sz_diff"] = 0;
-  // number of files with disk and reference checksum mismatch
-  statistics["d_cx_diff"] = 0;
-  // number of files with MGM and reference checksum mismatch
-  statistics["m_cx_diff"] = 0;
-  statistics["orphans_n"] = 0; // number of orphaned replicas
-  statistics["unreg_n"] = 0; // number of unregistered replicas
-  statistics["rep_diff_n"] = 0; // number of files with replica number mismatch
-  statistics["rep_missing_n"] = 0; // number of files which are missing on disk
-  fidset["m_sync_n"].clear(); // file set's for the same items as above
-  fidset["m_mem_sz_diff"].clear();
-  fidset["mem_n"].clear();
-  fidset["d_sync_n"].clear();
-  fidset["d_mem_sz_diff"].clear();
-  fidset["m_cx_diff"].clear();
-  fidset["d_cx_diff"].clear();
-  fidset["orphans_n"].clear();
-  fidset["unreg_n"].clear();
-  fidset["rep_diff_n"].clear();
-  fidset["rep_missing_n"].clear();
-
-  if (!IsSyncing(fsid)) {
-    const eos::common::DbMapTypes::Tkey* k;
-    const eos::common::DbMapTypes::Tval* v;
-    eos::common::DbMapTypes::Tval val;
-    FmdSqliteReadLock vlock(fsid);
-
-    // We report values only when we are not in the sync phase from disk/mgm
-    for (dbmap[fsid]->beginIter(); dbmap[fsid]->iterate(&k, &v);) {
-      Fmd f;
-      f.ParseFromString(v->value);
+  FsState* state = GetFsState(fsid);
+  FmdSqliteReadLock vlock(fsid);
 
-      if (f.layouterror()) {
-        if (f.layouterror() & eos::common::LayoutId::kOrphan) {
-          statistics["orphans_n"]++;
-          fidset["orphans_n"].insert(f.fid());
-        }
+  // The counters are kept up to date with every change of a record, they are
+  // reported only when we are not in the sync phase from disk/mgm
+  for (int cls = 0; cls < FmdRecord::kNumClasses; cls++) {
+    const char* name = FmdRecord::ClassName(cls);
+    bool report = (state && !IsSyncing(fsid));
+    statistics[name] = (report ? state->nrecords[cls] : 0);
 
-        if (f.layouterror() & eos::common::LayoutId::kUnregistered) {
-          statistics["unreg_n"]++;
-          fidset["unreg_n"].insert(f.fid());
-        }
-
-        if (f.layouterror() & eos::common::LayoutId::kReplicaWrong) {
-          statistics["rep_diff_n"]++;
-          fidset["rep_diff_n"].insert(f.fid());
-        }
-
-        if (f.layouterror() & eos::common::LayoutId::kMissing) {
-          statistics["rep_missing_n"]++;
-          fidset["rep_missing_n"].insert(f.fid());
-        }
-      }
-
-      if (f.mgmsize() != 0xfffffffffff1ULL) {
-        statistics["m_sync_n"]++;
-
-        if (f.size() != 0xfffffffffff1ULL) {
-          if (f.size() != f.mgmsize()) {
-            statistics["m_mem_sz_diff"]++;
-            fidset["m_mem_sz_diff"].insert(f.fid());
-          }
-        }
-      }
-
-      if (!f.layouterror()) {
-        if (f.size() && f.diskchecksum().length() &&
-            (f.diskchecksum() != f.checksum())) {
-          statistics["d_cx_diff"]++;
-          fidset["d_cx_diff"].insert(f.fid());
-        }
-
-        if (f.size() && f.mgmchecksum().length() && (f.mgmchecksum() != f.checksum())) {
-          statistics["m_cx_diff"]++;
-          fidset["m_cx_diff"].insert(f.fid());
-        }
-      }
-
-      statistics["mem_n"]++;
-
-      if (f.disksize() != 0xfffffffffff1ULL) {
-        statistics["d_sync_n"]++;
-
-        if (f.size() != 0xfffffffffff1ULL) {
-          if (f.size() != f.disksize()) {
-            statistics["d_mem_sz_diff"]++;
-            fidset["d_mem_sz_diff"].insert(f.fid());
-          }
-        }
-      }
+    if (report && FmdRecord::HasFidSet(cls)) {
+      fidset[name] = state->fids[cls];
+    } else {
+      fidset[name].clear();
     }
   }
 
@@ -1307,6 +1916,104 @@ FmdDbMapHandler::RemoveGhostEntries(const char* path,
   return rc;
 }
 
+/*----------------------------------------------------------------------------*/
+/**
+ * Get the files due for a checksum scan
+ *
+ * @param fsid filesystem id
+ * @param interval scan interval in seconds
+ * @param fids filled with the due file ids, the longest unchecked first
+ *
+ * @return false if the filesystem has no DB attached
+ */
+
+/*----------------------------------------------------------------------------*/
+bool
+FmdDbMapHandler::GetScanDue(eos::common::FileSystem::fsid_t fsid,
+                            time_t interval,
+                            std::vector<eos::common::FileId::fileid_t>& fids)
+{
+  time_t now = time(NULL);
+  // files scanned after this time are not due
+  uint32_t due = ((now > interval) ? (uint32_t)(now - interval) : 0);
+  fids.clear();
+  eos::common::RWMutexReadLock lock(Mutex);
+  FsState* state = GetFsState(fsid);
+
+  if (!state || !dbmap.count(fsid)) {
+    return false;
+  }
+
+  // The due files lead the scan time index, they stay in it until the scan
+  // moves their check time, so a file skipped by a scan stays due
+  FmdSqliteReadLock vlock(fsid);
+  auto end = state->scantimes.upper_bound(std::make_pair(due,
+                                          std::numeric_limits<eos::common::FileId::fileid_t>::max()));
+
+  for (auto it = state->scantimes.begin(); it != end; ++it) {
+    fids.push_back(it->second);
+  }
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+ * Record the time of the last checksum scan of a file
+ *
+ * @param fid file id
+ * @param fsid filesystem id
+ * @param checktime time of the scan
+ *
+ * @return true if the file has a record which was updated
+ */
+
+/*----------------------------------------------------------------------------*/
+bool
+FmdDbMapHandler::SetCheckTime(eos::common::FileId::fileid_t fid,
+                              eos::common::FileSystem::fsid_t fsid,
+                              unsigned long checktime)
+{
+  eos::common::RWMutexReadLock lock(Mutex);
+  FmdSqliteWriteLock vlock(fsid);
+
+  if (!fid || !dbmap.count(fsid)) {
+    return false;
+  }
+
+  Fmd valfmd;
+  eos::common::DbMap::Tval val;
+  std::string buffer;
+  FmdRecord stored = RetrieveFmd(fid, fsid, valfmd, val, buffer);
+
+  if (!stored.IsValid()) {
+    return false;
+  }
+
+  valfmd.set_checktime(checktime);
+  return PutFmd(fid, fsid, valfmd, &stored);
+}
+
+/*----------------------------------------------------------------------------*/
+/**
+ * Check if a file has a record
+ *
+ * @param fid file id
+ * @param fsid filesystem id
+ *
+ * @return true if the record exists
+ */
+
+/*----------------------------------------------------------------------------*/
+bool
+FmdDbMapHandler::HasFmd(eos::common::FileId::fileid_t fid,
+                        eos::common::FileSystem::fsid_t fsid)
+{
+  eos::common::RWMutexReadLock lock(Mutex);
+  FmdSqliteReadLock vlock(fsid);
+  return ExistFmd(fid, fsid);
+}
+
 /*----------------------------------------------------------------------------*/
 /**
  * Reset(clear) the contents of the DB
@@ -1327,6 +2034,7 @@ FmdDbMapHandler::ResetDB(eos::common::FileSystem::fsid_t fsid)
   // erase the hash entry
   if (dbmap.count(fsid)) {
     FmdSqliteWriteLock vlock(fsid);
+    FlushBatch(fsid);
 
     // delete in the in-memory hash
     if (!dbmap[fsid]->clear()) {
@@ -1335,6 +2043,9 @@ FmdDbMapHandler::ResetDB(eos::common::FileSystem::fsid_t fsid)
     } else {
       rc = true;
     }
+
+    // the counters of the records which are left are rebuilt
+    Recount(fsid);
   } else {
     rc = false;
   }
@@ -41,6 +41,7 @@
 #include "common/LayoutId.hh"
 #include "common/DbMap.hh"
 #include "fst/FmdHandler.hh"
+#include "fst/FmdRecord.hh"
 /*----------------------------------------------------------------------------*/
 #include "XrdOuc/XrdOucString.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -58,6 +59,8 @@
 #include <dirent.h>
 #include <zlib.h>
 #include <openssl/sha.h>
+#include <atomic>
+#include <set>
 
 #ifdef __APPLE__
 #define ECOMM 70
@@ -119,6 +122,14 @@ public:
   virtual bool DeleteFmd(eos::common::FileId::fileid_t fid,
                          eos::common::FileSystem::fsid_t fsid);
 
+  // ---------------------------------------------------------------------------
+  //! Delete the fmd records of many files in one DB write batch
+  //!
+  //! @return number of records deleted, missing records are skipped
+  // ---------------------------------------------------------------------------
+  virtual size_t DeleteFmds(const std::vector<eos::common::FileId::fileid_t>&
+                            fids, eos::common::FileSystem::fsid_t fsid);
+
   inline bool ExistFmd(eos::common::FileId::fileid_t fid,
                        eos::common::FileSystem::fsid_t fsid)
   {
@@ -139,20 +150,38 @@ public:
     eos::common::DbMap::Tval val;
     dbmap[fsid]->get(eos::common::Slice((const char*)&fid, sizeof(fid)), &val);
     Fmd retval;
-    retval.ParseFromString(val.value);
-    std::stringstream ss;
+    FmdRecord::Decode(val.value, retval);
     //eos_warning("RetrieveFmd fid=%lu fsid=%u getfid=%lu getfsid=%u",fid,fsid,retval.fid(),retval.fsid());
     return retval;
   }
-  inline bool PutFmd(eos::common::FileId::fileid_t fid,
-                     eos::common::FileSystem::fsid_t fsid, const Fmd& fmd)
-  {
-    std::string sval;
-    fmd.SerializePartialToString(&sval);
-    //eos_warning("RetrieveFmd fid=%lu fsid=%u setfid=%lu setfsid=%u",fid,fsid,fmd.fid(),fmd.fsid());
-    return dbmap[fsid]->set(eos::common::Slice((const char*)&fid, sizeof(fid)),
-                            sval, "") == 0;
-  }
+
+  // ---------------------------------------------------------------------------
+  //! Retrieve the record of a file together with a view of the stored record,
+  //! which is handed to PutFmd to save reading the record again
+  //!
+  //! @param fid file id
+  //! @param fsid filesystem id
+  //! @param fmd filled with the record, empty if there is none
+  //! @param val holds the stored record
+  //! @param buffer holds a stored record converted to the binary layout
+  //!
+  //! @return view of the stored record, invalid if the file has no record
+  // ---------------------------------------------------------------------------
+  FmdRecord RetrieveFmd(eos::common::FileId::fileid_t fid,
+                        eos::common::FileSystem::fsid_t fsid, Fmd& fmd,
+                        eos::common::DbMap::Tval& val, std::string& buffer);
+
+  // ---------------------------------------------------------------------------
+  //! Store a record in the binary layout and account the change of its
+  //! consistency classes, the caller holds Mutex and the write lock of the
+  //! filesystem
+  //!
+  //! @param stored view of the record currently stored, as returned by
+  //!        RetrieveFmd under the same lock, if 0 it is read from the DB
+  // ---------------------------------------------------------------------------
+  bool PutFmd(eos::common::FileId::fileid_t fid,
+              eos::common::FileSystem::fsid_t fsid, const Fmd& fmd,
+              const FmdRecord* stored = 0);
 
   // ---------------------------------------------------------------------------
   //! Commit a modified fmd record
@@ -193,11 +222,18 @@ public:
                              unsigned long long mtime_ns, int layouterror, std::string locations);
 
   // ---------------------------------------------------------------------------
-  //! Resync File meta data found under path
+  //! Resync File meta data found under path, the files found by the walk are
+  //! resynced by BootDiskThreads() threads
   // ---------------------------------------------------------------------------
   virtual bool ResyncAllDisk(const char* path,
                              eos::common::FileSystem::fsid_t fsid, bool flaglayouterror);
 
+  // ---------------------------------------------------------------------------
+  //! Number of threads resyncing the files of one disk at boot, configured
+  //! with EOS_FST_BOOT_DISK_THREADS (default 4)
+  // ---------------------------------------------------------------------------
+  static int BootDiskThreads();
+
   // ---------------------------------------------------------------------------
   //! Resync a single entry from Disk
   // ---------------------------------------------------------------------------
@@ -241,6 +277,39 @@ public:
   bool RemoveGhostEntries(const char* prefix,
                           eos::common::FileSystem::fsid_t fsid);
 
+  //----------------------------------------------------------------------------
+  //! Get the files of a filesystem due for a checksum scan: never checked,
+  //! checked longer than the interval ago or modified after their last check
+  //!
+  //! @param fsid filesystem id
+  //! @param interval scan interval in seconds
+  //! @param fids filled with the due file ids, the longest unchecked first
+  //!
+  //! @return false if the filesystem has no DB attached
+  //----------------------------------------------------------------------------
+  bool GetScanDue(eos::common::FileSystem::fsid_t fsid, time_t interval,
+                  std::vector<eos::common::FileId::fileid_t>& fids);
+
+  //----------------------------------------------------------------------------
+  //! Record the time of the last checksum scan of a file, without changing
+  //! its modification time
+  //!
+  //! @param fid file id
+  //! @param fsid filesystem id
+  //! @param checktime time of the scan
+  //!
+  //! @return true if the file has a record which was updated
+  //----------------------------------------------------------------------------
+  bool SetCheckTime(eos::common::FileId::fileid_t fid,
+                    eos::common::FileSystem::fsid_t fsid,
+                    unsigned long checktime);
+
+  //----------------------------------------------------------------------------
+  //! Check if a file has a record, taking the locks ExistFmd needs
+  //----------------------------------------------------------------------------
+  bool HasFmd(eos::common::FileId::fileid_t fid,
+              eos::common::FileSystem::fsid_t fsid);
+
   //----------------------------------------------------------------------------
   //! Initialize the changelog hash
   //----------------------------------------------------------------------------
@@ -265,90 +334,73 @@ public:
   // that is all we need for meta data handling
 
   // ---------------------------------------------------------------------------
-  //! Hash map protecting each filesystem map in FmdSqliteMap
-  // ---------------------------------------------------------------------------
-
-  google::dense_hash_map<eos::common::FileSystem::fsid_t, eos::common::RWMutex>
-  FmdSqliteMutexMap;
-
-  // ---------------------------------------------------------------------------
-  //! Mutex protecting the previous map
+  //! Locks protecting the DB of each filesystem. A filesystem always uses the
+  //! stripe fsid % sFmdLockStripes, so finding its lock needs no lookup.
   // ---------------------------------------------------------------------------
-  eos::common::RWMutex FmdSqliteMutexMapMutex;
-
-  inline void _FmdSqliteLock(const eos::common::FileSystem::fsid_t& fsid,
-                             bool write)
-  {
-    FmdSqliteMutexMapMutex.LockRead();
-
-    if (FmdSqliteMutexMap.count(fsid)) {
-      if (write) {
-        FmdSqliteMutexMap[fsid].LockWrite();
-      } else {
-        FmdSqliteMutexMap[fsid].LockRead();
-      }
-
-      FmdSqliteMutexMapMutex.UnLockRead();
-    } else {
-      FmdSqliteMutexMapMutex.UnLockRead();
-      FmdSqliteMutexMapMutex.LockWrite();
-
-      if (write) {
-        FmdSqliteMutexMap[fsid].LockWrite();
-      } else {
-        FmdSqliteMutexMap[fsid].LockRead();
-      }
-
-      FmdSqliteMutexMapMutex.UnLockWrite();
-    }
-  }
+  static const size_t sFmdLockStripes = 64;
+  eos::common::RWMutex FmdSqliteMutex[sFmdLockStripes];
 
-  inline void _FmdSqliteUnLock(const eos::common::FileSystem::fsid_t& fsid,
-                               bool write)
+  inline eos::common::RWMutex&
+  FmdSqliteMutexOf(const eos::common::FileSystem::fsid_t& fsid)
   {
-    FmdSqliteMutexMapMutex.LockRead();
-
-    if (FmdSqliteMutexMap.count(fsid)) {
-      if (write) {
-        FmdSqliteMutexMap[fsid].UnLockWrite();
-      } else {
-        FmdSqliteMutexMap[fsid].UnLockRead();
-      }
-
-      FmdSqliteMutexMapMutex.UnLockRead();
-    } else {
-      // This should NEVER happen as the entry should be in the map because
-      // mutex #i should have been locked at some point.
-      FmdSqliteMutexMapMutex.UnLockRead();
-      FmdSqliteMutexMapMutex.LockWrite();
-
-      if (write) {
-        FmdSqliteMutexMap[fsid].UnLockWrite();
-      } else {
-        FmdSqliteMutexMap[fsid].UnLockRead();
-      }
-
-      FmdSqliteMutexMapMutex.UnLockWrite();
-    }
+    return FmdSqliteMutex[fsid % sFmdLockStripes];
   }
 
   inline void FmdSqliteLockRead(const eos::common::FileSystem::fsid_t& fsid)
   {
-    _FmdSqliteLock(fsid, false);
+    FmdSqliteMutexOf(fsid).LockRead();
   }
   inline void FmdSqliteLockWrite(const eos::common::FileSystem::fsid_t& fsid)
   {
-    _FmdSqliteLock(fsid, true);
+    FmdSqliteMutexOf(fsid).LockWrite();
   }
   inline void FmdSqliteUnLockRead(const eos::common::FileSystem::fsid_t& fsid)
   {
-    _FmdSqliteUnLock(fsid, false);
+    FmdSqliteMutexOf(fsid).UnLockRead();
   }
   inline void FmdSqliteUnLockWrite(const eos::common::FileSystem::fsid_t& fsid)
   {
-    _FmdSqliteUnLock(fsid, true);
+    FmdSqliteMutexOf(fsid).UnLockWrite();
   }
 
+  // ---------------------------------------------------------------------------
+  //! Commit the batched record updates of all filesystems which are pending
+  //! for longer than the flush interval
+  // ---------------------------------------------------------------------------
+  void FlushBatches();
+
+  // ---------------------------------------------------------------------------
+  //! Interval in milliseconds after which committed records have to be
+  //! written to the DB, configured with EOS_FST_FMD_FLUSH_MS (default 200).
+  //! 0 writes every commit to the DB immediately.
+  // ---------------------------------------------------------------------------
+  static int CommitFlushMs();
+
+  // ---------------------------------------------------------------------------
+  //! Get the average latency of the record lookups and commits of a
+  //! filesystem since the previous call
+  //!
+  //! @param fsid filesystem id
+  //! @param get_usec average GetFmd latency in micro seconds
+  //! @param commit_usec average Commit latency in micro seconds
+  // ---------------------------------------------------------------------------
+  void GetLatency(eos::common::FileSystem::fsid_t fsid, double& get_usec,
+                  double& commit_usec);
+
+#ifndef EOS_SQLITE_DBMAP
+  // ---------------------------------------------------------------------------
+  //! Define the LevelDB tuning of a filesystem, used when its DB is attached.
+  //! A value of 0 keeps the default of the FST.
+  //!
+  //! @param fsid filesystem id
+  //! @param cachemb block cache size in MB
+  //! @param bloombits bits per key of the bloom filter
+  //! @param writebuffermb write buffer size in MB
+  // ---------------------------------------------------------------------------
+  void SetLevelDbOptions(eos::common::FileSystem::fsid_t fsid, size_t cachemb,
+                         size_t bloombits, size_t writebuffermb);
+#endif
+
   // ---------------------------------------------------------------------------
   //! Hash map pointing from fid to offset in changelog file
   // ---------------------------------------------------------------------------
@@ -366,11 +418,8 @@ public:
 #ifndef EOS_SQLITE_DBMAP
     lvdboption.CacheSizeMb = 0;
     lvdboption.BloomFilterNbits = 0;
+    lvdboption.WriteBufferMb = 0;
 #endif
-    FmdSqliteMutexMap.set_deleted_key(
-      std::numeric_limits<eos::common::FileSystem::fsid_t>::max() - 2);
-    FmdSqliteMutexMap.set_empty_key(
-      std::numeric_limits<eos::common::FileSystem::fsid_t>::max() - 1);
     FmdHelperMap.set_deleted_key(
       std::numeric_limits<eos::common::FileSystem::fsid_t>::max() - 2);
     FmdHelperMap.set_empty_key(
@@ -384,6 +433,10 @@ public:
   virtual ~FmdDbMapHandler()
   {
     Shutdown();
+
+    for (auto it = mFsState.begin(); it != mFsState.end(); ++it) {
+      delete it->second;
+    }
   }
 
   // ---------------------------------------------------------------------------
@@ -434,6 +487,125 @@ private:
   eos::common::LvDbDbMapInterface::Option lvdboption;
 #endif
   std::map<eos::common::FileSystem::fsid_t, std::string> DBfilename;
+
+  // ---------------------------------------------------------------------------
+  //! State kept per filesystem. The objects are created with the DB of the
+  //! filesystem and never removed, they are looked up with Mutex locked.
+  // ---------------------------------------------------------------------------
+  struct FsState {
+    //! records committed in the set sequence open on the DB, protected by the
+    //! write lock of the filesystem
+    size_t pending;
+    //! time of the first commit of the set sequence in ms
+    unsigned long long opened;
+    std::atomic<unsigned long long> nget; ///< GetFmd calls
+    std::atomic<unsigned long long> getusec; ///< time spent in GetFmd
+    std::atomic<unsigned long long> ncommit; ///< Commit calls
+    std::atomic<unsigned long long> commitusec; ///< time spent in Commit
+#ifndef EOS_SQLITE_DBMAP
+    eos::common::LvDbDbMapInterface::Option lvdboption; ///< LevelDB tuning
+#endif
+    //! records per consistency class and the file ids of the inconsistent
+    //! ones, protected by the lock of the filesystem
+    size_t nrecords[FmdRecord::kNumClasses];
+    std::set<eos::common::FileId::fileid_t> fids[FmdRecord::kNumClasses];
+    //! files on disk ordered by the time from which on their scan interval
+    //! counts, protected by the lock of the filesystem
+    std::set<std::pair<uint32_t, eos::common::FileId::fileid_t>> scantimes;
+
+    FsState(): pending(0), opened(0), nget(0), getusec(0), ncommit(0),
+      commitusec(0)
+    {
+      for (int i = 0; i < FmdRecord::kNumClasses; i++) {
+        nrecords[i] = 0;
+      }
+
+#ifndef EOS_SQLITE_DBMAP
+      lvdboption.CacheSizeMb = 0;
+      lvdboption.BloomFilterNbits = 0;
+      lvdboption.WriteBufferMb = 0;
+#endif
+    }
+  };
+
+  //! inserted with Mutex write locked
+  std::map<eos::common::FileSystem::fsid_t, FsState*> mFsState;
+
+  // ---------------------------------------------------------------------------
+  //! Get the state of a filesystem, the caller holds Mutex
+  //!
+  //! @return state or 0 if the filesystem has no DB attached yet
+  // ---------------------------------------------------------------------------
+  inline FsState*
+  GetFsState(eos::common::FileSystem::fsid_t fsid)
+  {
+    auto it = mFsState.find(fsid);
+    return ((it != mFsState.end()) ? it->second : 0);
+  }
+
+  // ---------------------------------------------------------------------------
+  //! Write the records batched for a filesystem to its DB, the caller holds
+  //! Mutex and the write lock of the filesystem
+  // ---------------------------------------------------------------------------
+  void FlushBatch(eos::common::FileSystem::fsid_t fsid);
+
+  // ---------------------------------------------------------------------------
+  //! Account the change of the consistency classes and of the scan time of a
+  //! record, the caller holds Mutex and the write lock of the filesystem
+  //!
+  //! @param fsid filesystem id
+  //! @param fid file id
+  //! @param oldrec previous record, invalid if there was none
+  //! @param newrec new record, invalid if it is deleted
+  // ---------------------------------------------------------------------------
+  void Account(eos::common::FileSystem::fsid_t fsid,
+               eos::common::FileId::fileid_t fid, const FmdRecord& oldrec,
+               const FmdRecord& newrec);
+
+  // ---------------------------------------------------------------------------
+  //! Get a view of the stored record of a file, which refers to val and
+  //! buffer
+  //!
+  //! @return view of the record, invalid if the file has no record
+  // ---------------------------------------------------------------------------
+  FmdRecord StoredRecord(eos::common::FileId::fileid_t fid,
+                         eos::common::FileSystem::fsid_t fsid,
+                         eos::common::DbMap::Tval& val, std::string& buffer);
+
+  // ---------------------------------------------------------------------------
+  //! Count the consistency classes of all records of a filesystem, index
+  //! their scan times and rewrite the records still in the protobuf format in the binary layout.
+  //! The caller holds Mutex read locked and the write lock of the filesystem,
+  //! the pass over the DB must not block the other filesystems.
+  // ---------------------------------------------------------------------------
+  void Recount(eos::common::FileSystem::fsid_t fsid);
+
+  //----------------------------------------------------------------------------
+  //! Read the binary meta data dump of a filesystem from the MGM over one
+  //! connection and apply the records to the DB in batches as they arrive
+  //!
+  //! @param fsid filesystem id
+  //! @param manager host:port of the MGM
+  //! @param lastfid the dump starts after this file id, it is moved to the
+  //!        last file id of each batch applied
+  //! @param cnt number of records applied, updated after each batch
+  //!
+  //! @return true if the complete dump was applied
+  //----------------------------------------------------------------------------
+  bool ResyncMgmStream(eos::common::FileSystem::fsid_t fsid, const char* manager,
+                       eos::common::FileId::fileid_t& lastfid,
+                       unsigned long long& cnt);
+
+  //----------------------------------------------------------------------------
+  //! Apply records received from the MGM in a single DB write sequence
+  //!
+  //! @param fsid filesystem id
+  //! @param records MGM records
+  //!
+  //! @return true if successful
+  //----------------------------------------------------------------------------
+  bool ApplyMgmRecords(eos::common::FileSystem::fsid_t fsid,
+                       const std::vector<Fmd>& records);
 };
 
 // ---------------------------------------------------------------------------
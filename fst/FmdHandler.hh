@@ -56,9 +56,57 @@ public:
   virtual bool
   IsSyncing (eos::common::FileSystem::fsid_t fsid)
   {
+    XrdSysMutexHelper lock(FlagMutex);
     return isSyncing[fsid];
   }
 
+  // ---------------------------------------------------------------------------
+  //! Set the syncing flag
+  // ---------------------------------------------------------------------------
+
+  virtual void
+  SetSyncing (eos::common::FileSystem::fsid_t fsid, bool syncing)
+  {
+    XrdSysMutexHelper lock(FlagMutex);
+    isSyncing[fsid] = syncing;
+  }
+
+  // ---------------------------------------------------------------------------
+  //! Set the resync progress of a filesystem, published while it boots
+  // ---------------------------------------------------------------------------
+
+  virtual void
+  SetSyncProgress (eos::common::FileSystem::fsid_t fsid, const char* phase, unsigned long long nfiles)
+  {
+    char progress[256];
+    snprintf(progress, sizeof(progress), "%s:%llu", phase, nfiles);
+    XrdSysMutexHelper lock(FlagMutex);
+    syncProgress[fsid] = progress;
+  }
+
+  // ---------------------------------------------------------------------------
+  //! Forget the resync progress of a filesystem
+  // ---------------------------------------------------------------------------
+
+  virtual void
+  ClearSyncProgress (eos::common::FileSystem::fsid_t fsid)
+  {
+    XrdSysMutexHelper lock(FlagMutex);
+    syncProgress.erase(fsid);
+  }
+
+  // ---------------------------------------------------------------------------
+  //! Return's the resync progress as <phase>:<files> or an empty string
+  // ---------------------------------------------------------------------------
+
+  virtual std::string
+  GetSyncProgress (eos::common::FileSystem::fsid_t fsid)
+  {
+    XrdSysMutexHelper lock(FlagMutex);
+    auto it = syncProgress.find(fsid);
+    return ((it != syncProgress.end()) ? it->second : "");
+  }
+
   // ---------------------------------------------------------------------------
   //! Return's the dirty flag indicating a non-clean shutdown
   // ---------------------------------------------------------------------------
@@ -66,6 +114,7 @@ public:
   virtual bool
   IsDirty (eos::common::FileSystem::fsid_t fsid)
   {
+    XrdSysMutexHelper lock(FlagMutex);
     return isDirty[fsid];
   }
 
@@ -76,6 +125,7 @@ public:
   virtual void
   StayDirty (eos::common::FileSystem::fsid_t fsid, bool dirty)
   {
+    XrdSysMutexHelper lock(FlagMutex);
     stayDirty[fsid] = dirty;
   }
 
@@ -227,6 +277,10 @@ protected:
   std::map<eos::common::FileSystem::fsid_t, bool> stayDirty;
 
   std::map<eos::common::FileSystem::fsid_t, bool> isSyncing;
+
+  //! the filesystems boot in parallel, the flags above are protected by this
+  XrdSysMutex FlagMutex;
+  std::map<eos::common::FileSystem::fsid_t, std::string> syncProgress;
 };
 
 EOSFSTNAMESPACE_END
@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------
+// File: FmdRecord.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/FmdRecord.hh"
+#include "common/LayoutId.hh"
+#include <cstring>
+#include <endian.h>
+
+EOSFSTNAMESPACE_BEGIN
+
+const unsigned char FmdRecord::sMagic;
+const unsigned char FmdRecord::sVersion;
+const uint64_t FmdRecord::sUndefSize;
+const uint32_t FmdRecord::sNoScan;
+
+//------------------------------------------------------------------------------
+// Get the statistics name of a consistency class
+//------------------------------------------------------------------------------
+const char*
+FmdRecord::ClassName(int cls)
+{
+  static const char* sNames[kNumClasses] = {
+    "mem_n", "d_sync_n", "m_sync_n", "d_mem_sz_diff", "m_mem_sz_diff",
+    "d_cx_diff", "m_cx_diff", "orphans_n", "unreg_n", "rep_diff_n",
+    "rep_missing_n"
+  };
+  return (((cls >= 0) && (cls < kNumClasses)) ? sNames[cls] : "");
+}
+
+//------------------------------------------------------------------------------
+// Encode a record in the current layout
+//------------------------------------------------------------------------------
+void
+FmdRecord::Encode(const FmdBase& fmd, std::string& out)
+{
+  Layout hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = sMagic;
+  hdr.version = sVersion;
+  hdr.fsid = htole32(fmd.fsid());
+  hdr.fid = htole64(fmd.fid());
+  hdr.cid = htole64(fmd.cid());
+  hdr.size = htole64(fmd.size());
+  hdr.disksize = htole64(fmd.disksize());
+  hdr.mgmsize = htole64(fmd.mgmsize());
+  hdr.filecxerror = htole64(fmd.filecxerror());
+  hdr.blockcxerror = htole64(fmd.blockcxerror());
+  hdr.layouterror = htole64(fmd.layouterror());
+  hdr.ctime = htole32(fmd.ctime());
+  hdr.ctime_ns = htole32(fmd.ctime_ns());
+  hdr.mtime = htole32(fmd.mtime());
+  hdr.mtime_ns = htole32(fmd.mtime_ns());
+  hdr.atime = htole32(fmd.atime());
+  hdr.atime_ns = htole32(fmd.atime_ns());
+  hdr.checktime = htole32(fmd.checktime());
+  hdr.lid = htole32(fmd.lid());
+  hdr.uid = htole32(fmd.uid());
+  hdr.gid = htole32(fmd.gid());
+  hdr.checksum_len = htole32(fmd.checksum().length());
+  hdr.diskchecksum_len = htole32(fmd.diskchecksum().length());
+  hdr.mgmchecksum_len = htole32(fmd.mgmchecksum().length());
+  hdr.locations_len = htole32(fmd.locations().length());
+  out.clear();
+  out.reserve(sizeof(hdr) + fmd.checksum().length() +
+              fmd.diskchecksum().length() + fmd.mgmchecksum().length() +
+              fmd.locations().length());
+  out.append((const char*) &hdr, sizeof(hdr));
+  out.append(fmd.checksum());
+  out.append(fmd.diskchecksum());
+  out.append(fmd.mgmchecksum());
+  out.append(fmd.locations());
+}
+
+//------------------------------------------------------------------------------
+// Decode a record of any layout version or in the protobuf format
+//------------------------------------------------------------------------------
+bool
+FmdRecord::Decode(const char* data, size_t len, FmdBase& fmd)
+{
+  fmd.Clear();
+
+  if (!len || (data[0] != (char) sMagic)) {
+    // written before the binary layout existed
+    return fmd.ParseFromArray(data, len);
+  }
+
+  FmdRecord rec(data, len);
+
+  if (!rec.IsValid()) {
+    return false;
+  }
+
+  size_t slen = 0;
+  size_t off = rec.GetString(0, slen);
+  fmd.set_checksum(data + off, slen);
+  off = rec.GetString(1, slen);
+  fmd.set_diskchecksum(data + off, slen);
+  off = rec.GetString(2, slen);
+  fmd.set_mgmchecksum(data + off, slen);
+  off = rec.GetString(3, slen);
+  fmd.set_locations(data + off, slen);
+  fmd.set_fsid(rec.Get32(offsetof(Layout, fsid)));
+  fmd.set_fid(rec.GetFid());
+  fmd.set_cid(rec.Get64(offsetof(Layout, cid)));
+  fmd.set_size(rec.GetSize());
+  fmd.set_disksize(rec.GetDiskSize());
+  fmd.set_mgmsize(rec.GetMgmSize());
+  fmd.set_filecxerror((int64_t) rec.Get64(offsetof(Layout, filecxerror)));
+  fmd.set_blockcxerror((int64_t) rec.Get64(offsetof(Layout, blockcxerror)));
+  fmd.set_layouterror(rec.GetLayoutError());
+  fmd.set_ctime(rec.Get32(offsetof(Layout, ctime)));
+  fmd.set_ctime_ns(rec.Get32(offsetof(Layout, ctime_ns)));
+  fmd.set_mtime(rec.GetMtime());
+  fmd.set_mtime_ns(rec.Get32(offsetof(Layout, mtime_ns)));
+  fmd.set_atime(rec.Get32(offsetof(Layout, atime)));
+  fmd.set_atime_ns(rec.Get32(offsetof(Layout, atime_ns)));
+  fmd.set_checktime(rec.GetCheckTime());
+  fmd.set_lid(rec.Get32(offsetof(Layout, lid)));
+  fmd.set_uid(rec.Get32(offsetof(Layout, uid)));
+  fmd.set_gid(rec.Get32(offsetof(Layout, gid)));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Get a view of a stored record
+//------------------------------------------------------------------------------
+FmdRecord
+FmdRecord::Open(const char* data, size_t len, std::string& buffer)
+{
+  FmdRecord rec(data, len);
+
+  if (rec.IsValid()) {
+    return rec;
+  }
+
+  // a corrupted record is viewed as an empty one
+  FmdBase fmd;
+  Decode(data, len, fmd);
+  Encode(fmd, buffer);
+  return FmdRecord(buffer.data(), buffer.size());
+}
+
+//------------------------------------------------------------------------------
+// Tell if the data is a complete record of the current layout
+//------------------------------------------------------------------------------
+bool
+FmdRecord::IsValid() const
+{
+  if ((mLen < sizeof(Layout)) || (mData[0] != (char) sMagic) ||
+      (mData[1] != (char) sVersion)) {
+    return false;
+  }
+
+  size_t len = 0;
+  size_t off = GetString(3, len);
+  return (off + len <= mLen);
+}
+
+//------------------------------------------------------------------------------
+// Get the time from which on the scan interval of the file counts
+//------------------------------------------------------------------------------
+uint32_t
+FmdRecord::GetScanTime() const
+{
+  uint64_t disksize = GetDiskSize();
+
+  // files which are not on disk can't be scanned
+  if ((disksize == sUndefSize) || (disksize == 0xfffffff1ULL)) {
+    return sNoScan;
+  }
+
+  uint32_t checktime = GetCheckTime();
+  return ((GetMtime() >= checktime) ? 0 : checktime);
+}
+
+//------------------------------------------------------------------------------
+// Get the consistency classes of the record
+//------------------------------------------------------------------------------
+unsigned int
+FmdRecord::GetClasses() const
+{
+  unsigned int cls = (1u << kMem);
+  uint64_t size = GetSize();
+  uint64_t disksize = GetDiskSize();
+  uint64_t mgmsize = GetMgmSize();
+  int64_t layouterror = GetLayoutError();
+
+  if (layouterror & eos::common::LayoutId::kOrphan) {
+    cls |= (1u << kOrphan);
+  }
+
+  if (layouterror & eos::common::LayoutId::kUnregistered) {
+    cls |= (1u << kUnregistered);
+  }
+
+  if (layouterror & eos::common::LayoutId::kReplicaWrong) {
+    cls |= (1u << kReplicaDiff);
+  }
+
+  if (layouterror & eos::common::LayoutId::kMissing) {
+    cls |= (1u << kMissing);
+  }
+
+  if (mgmsize != sUndefSize) {
+    cls |= (1u << kMgmSync);
+
+    if ((size != sUndefSize) && (size != mgmsize)) {
+      cls |= (1u << kMgmSizeDiff);
+    }
+  }
+
+  if (disksize != sUndefSize) {
+    cls |= (1u << kDiskSync);
+
+    if ((size != sUndefSize) && (size != disksize)) {
+      cls |= (1u << kDiskSizeDiff);
+    }
+  }
+
+  if (!layouterror && size) {
+    // the checksums are compared in place
+    size_t cxlen = 0, dcxlen = 0, mcxlen = 0;
+    size_t cxoff = GetString(0, cxlen);
+    size_t dcxoff = GetString(1, dcxlen);
+    size_t mcxoff = GetString(2, mcxlen);
+
+    if (dcxlen && ((dcxlen != cxlen) ||
+                   memcmp(mData + dcxoff, mData + cxoff, cxlen))) {
+      cls |= (1u << kDiskCxDiff);
+    }
+
+    if (mcxlen && ((mcxlen != cxlen) ||
+                   memcmp(mData + mcxoff, mData + cxoff, cxlen))) {
+      cls |= (1u << kMgmCxDiff);
+    }
+  }
+
+  return cls;
+}
+
+//------------------------------------------------------------------------------
+// Read the fields in place, the record data has no alignment
+//------------------------------------------------------------------------------
+uint64_t
+FmdRecord::Get64(size_t offset) const
+{
+  uint64_t val;
+  memcpy(&val, mData + offset, sizeof(val));
+  return le64toh(val);
+}
+
+uint32_t
+FmdRecord::Get32(size_t offset) const
+{
+  uint32_t val;
+  memcpy(&val, mData + offset, sizeof(val));
+  return le32toh(val);
+}
+
+//------------------------------------------------------------------------------
+// Get the offset of a string of the record
+//------------------------------------------------------------------------------
+size_t
+FmdRecord::GetString(int index, size_t& len) const
+{
+  size_t off = sizeof(Layout);
+
+  for (int i = 0; i <= index; i++) {
+    len = Get32(offsetof(Layout, checksum_len) + i * sizeof(uint32_t));
+
+    if (i < index) {
+      off += len;
+    }
+  }
+
+  return off;
+}
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------------
+//! @file FmdRecord.hh
+//! @author agent
+//! @brief Fixed layout binary encoding of the file meta data stored in the DB
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_FMDRECORD_HH__
+#define __EOSFST_FMDRECORD_HH__
+
+#include "fst/Namespace.hh"
+#include "fst/FmdBase.pb.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! View of a file meta data record as stored in the DB. Records start with a
+//! zero byte, which never starts a serialized protobuf, followed by the
+//! version of the layout and a fixed header in little endian byte order. The
+//! variable length strings follow the header. The numeric fields are read in
+//! place without decoding the record. Records written in the former protobuf
+//! format are still decoded and converted on demand.
+//------------------------------------------------------------------------------
+class FmdRecord
+{
+public:
+  static const unsigned char sMagic = 0x00; ///< First byte of a binary record
+  static const unsigned char sVersion = 1; ///< Current layout version
+  //! Size and disk size marker of a file which is not synced
+  static const uint64_t sUndefSize = 0xfffffffffff1ULL;
+  //! Scan time of a file which is not on disk
+  static const uint32_t sNoScan = 0xffffffff;
+
+  //----------------------------------------------------------------------------
+  //! Consistency classes of a record, reported by their statistics name
+  //----------------------------------------------------------------------------
+  enum Class {
+    kMem = 0, ///< records in the DB
+    kDiskSync, ///< records synced from disk
+    kMgmSync, ///< records synced from the MGM
+    kDiskSizeDiff, ///< disk and reference size mismatch
+    kMgmSizeDiff, ///< MGM and reference size mismatch
+    kDiskCxDiff, ///< disk and reference checksum mismatch
+    kMgmCxDiff, ///< MGM and reference checksum mismatch
+    kOrphan, ///< orphaned replicas
+    kUnregistered, ///< unregistered replicas
+    kReplicaDiff, ///< replica number mismatch
+    kMissing, ///< replicas missing on disk
+    kNumClasses
+  };
+
+  //----------------------------------------------------------------------------
+  //! Get the statistics name of a consistency class e.g. "d_mem_sz_diff"
+  //----------------------------------------------------------------------------
+  static const char* ClassName(int cls);
+
+  //----------------------------------------------------------------------------
+  //! Tell if the files of a consistency class are reported by file id, which
+  //! is the case for the inconsistencies only
+  //----------------------------------------------------------------------------
+  static bool HasFidSet(int cls)
+  {
+    return (cls >= kDiskSizeDiff);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Encode a record in the current layout
+  //!
+  //! @param fmd file meta data
+  //! @param out filled with the encoded record
+  //----------------------------------------------------------------------------
+  static void Encode(const FmdBase& fmd, std::string& out);
+
+  //----------------------------------------------------------------------------
+  //! Decode a record of any layout version or in the protobuf format
+  //!
+  //! @param data record as stored in the DB
+  //! @param len length of the record
+  //! @param fmd filled with the file meta data
+  //!
+  //! @return false if the record is corrupted or of an unknown version
+  //----------------------------------------------------------------------------
+  static bool Decode(const char* data, size_t len, FmdBase& fmd);
+
+  static bool Decode(const std::string& data, FmdBase& fmd)
+  {
+    return Decode(data.data(), data.size(), fmd);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get a valid view of a stored record. A record in the protobuf format is
+  //! converted into buffer, which has to outlive the view.
+  //!
+  //! @param data record as stored in the DB
+  //! @param len length of the record
+  //! @param buffer holds a converted record
+  //----------------------------------------------------------------------------
+  static FmdRecord Open(const char* data, size_t len, std::string& buffer);
+
+  //----------------------------------------------------------------------------
+  //! Constructor of a view, the data is not copied
+  //----------------------------------------------------------------------------
+  FmdRecord(const char* data, size_t len): mData(data), mLen(len) {}
+
+  //----------------------------------------------------------------------------
+  //! Constructor of an invalid view, standing for a missing record
+  //----------------------------------------------------------------------------
+  FmdRecord(): mData(0), mLen(0) {}
+
+  //----------------------------------------------------------------------------
+  //! Tell if the data is a complete record of the current layout, the
+  //! accessors must only be used on valid records
+  //----------------------------------------------------------------------------
+  bool IsValid() const;
+
+  uint64_t GetFid() const
+  {
+    return Get64(offsetof(Layout, fid));
+  }
+
+  uint64_t GetSize() const
+  {
+    return Get64(offsetof(Layout, size));
+  }
+
+  uint64_t GetDiskSize() const
+  {
+    return Get64(offsetof(Layout, disksize));
+  }
+
+  uint64_t GetMgmSize() const
+  {
+    return Get64(offsetof(Layout, mgmsize));
+  }
+
+  int64_t GetLayoutError() const
+  {
+    return (int64_t) Get64(offsetof(Layout, layouterror));
+  }
+
+  uint32_t GetMtime() const
+  {
+    return Get32(offsetof(Layout, mtime));
+  }
+
+  uint32_t GetCheckTime() const
+  {
+    return Get32(offsetof(Layout, checktime));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the time from which on the scan interval of the file counts: its
+  //! check time, or 0 if it was never checked or modified after the check
+  //!
+  //! @return time or sNoScan if the file is not on disk
+  //----------------------------------------------------------------------------
+  uint32_t GetScanTime() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the consistency classes of the record
+  //!
+  //! @return bit mask with bit (1 << cls) set for every class of the record
+  //----------------------------------------------------------------------------
+  unsigned int GetClasses() const;
+
+private:
+  //! Fixed header of a record, the strings follow in declaration order
+  struct Layout {
+    uint8_t magic;
+    uint8_t version;
+    uint16_t reserved;
+    uint32_t fsid;
+    uint64_t fid;
+    uint64_t cid;
+    uint64_t size;
+    uint64_t disksize;
+    uint64_t mgmsize;
+    int64_t filecxerror;
+    int64_t blockcxerror;
+    int64_t layouterror;
+    uint32_t ctime;
+    uint32_t ctime_ns;
+    uint32_t mtime;
+    uint32_t mtime_ns;
+    uint32_t atime;
+    uint32_t atime_ns;
+    uint32_t checktime;
+    uint32_t lid;
+    uint32_t uid;
+    uint32_t gid;
+    uint32_t checksum_len;
+    uint32_t diskchecksum_len;
+    uint32_t mgmchecksum_len;
+    uint32_t locations_len;
+  };
+
+  static_assert(sizeof(Layout) == 128, "the record header must not be padded");
+
+  const char* mData; ///< Record data, not owned
+  size_t mLen; ///< Length of the record data
+
+  uint64_t Get64(size_t offset) const;
+  uint32_t Get32(size_t offset) const;
+
+  //----------------------------------------------------------------------------
+  //! Get the offset of a string of the record
+  //!
+  //! @param index of the string: checksum, diskchecksum, mgmchecksum and
+  //!        locations
+  //! @param len filled with the length of the string
+  //----------------------------------------------------------------------------
+  size_t GetString(int index, size_t& len) const;
+};
+
+EOSFSTNAMESPACE_END
+
+#endif // __EOSFST_FMDRECORD_HH__
@@ -23,70 +23,154 @@
 
 #include "Health.hh"
 #include "common/ShellCmd.hh"
+#include "common/StringConversion.hh"
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
 
 EOSFSTNAMESPACE_BEGIN
 
+// Seconds between two samples of the node information and raid state
+static const unsigned int sSystemInterval = 10;
+// Seconds given to the smartctl call of a device
+static const size_t sSmartctlTimeout = 5;
+
 //------------------------------------------------------------------------------
 //                        **** Class DiskHealth ****
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
-// Get health information about a certain device
+// Get the latest health sample of a certain device
 //------------------------------------------------------------------------------
 std::map<std::string, std::string> DiskHealth::getHealth(const char* devpath)
 {
   std::string dev = Load::DevMap(devpath);
 
-  if (dev[0] == 'm') {
-    return parse_mdstat(dev.c_str());
+  // Paths which are not on a block device have no health information and
+  // must not be registered for smartctl
+  if (!Load::IsDevice(dev)) {
+    std::map<std::string, std::string> health;
+    health["summary"] = "N/A";
+    return health;
   }
 
   // Chunck partition digits, we need the actual device name for smartctl...
   // no string::back or pop_back support in gcc 4.4 so it looks a bit funny.
-  while (isdigit(dev.at(dev.length() - 1))) {
-    dev.resize(dev.length() - 1);
+  if (dev[0] != 'm') {
+    while ((dev.length() > 1) && isdigit(dev.at(dev.length() - 1))) {
+      dev.resize(dev.length() - 1);
+    }
   }
 
   std::lock_guard<std::mutex> lock(mMutex);
-  return smartctl_results[dev];
+  return mResults[dev];
 }
 
 //------------------------------------------------------------------------------
-// Update health information for all the registered devices
+// Update the S.M.A.R.T information of all the registered devices
 //------------------------------------------------------------------------------
 void
-DiskHealth::Measure()
+DiskHealth::Measure(size_t timeout)
 {
-  std::map<std::string, std::map<std::string, std::string>> tmp;
+  std::vector<std::string> devices;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
 
-  for (auto it = smartctl_results.begin(); it != smartctl_results.end(); it++) {
-    tmp[it->first]["summary"] = smartctl(it->first.c_str());
+    for (auto it = mResults.begin(); it != mResults.end(); it++) {
+      if (it->first[0] != 'm') {
+        devices.push_back(it->first);
+      }
+    }
+  }
+  // Start all the calls before waiting, so a hanging device only costs its
+  // own timeout and doesn't delay the samples of the others
+  std::vector<std::unique_ptr<eos::common::ShellCmd>> cmds;
+
+  for (auto it = devices.begin(); it != devices.end(); it++) {
+    std::string command("smartctl -q silent -a /dev/");
+    command += *it;
+    cmds.emplace_back(new eos::common::ShellCmd(command));
+  }
+
+  std::map<std::string, std::string> tmp;
+  time_t deadline = time(NULL) + timeout;
+
+  for (size_t i = 0; i < devices.size(); i++) {
+    time_t now = time(NULL);
+    tmp[devices[i]] = smartctl(*cmds[i], (now < deadline) ? deadline - now : 0);
   }
 
   std::lock_guard<std::mutex> lock(mMutex);
-  smartctl_results = tmp;
+
+  for (auto it = tmp.begin(); it != tmp.end(); it++) {
+    mResults[it->first]["summary"] = it->second;
+  }
 }
 
 //------------------------------------------------------------------------------
-// Parse /proc/mdstat to obtain raid health
+// Update the raid health of all the registered md devices
 //------------------------------------------------------------------------------
-std::map<std::string, std::string> DiskHealth::parse_mdstat(const char* device)
+void
+DiskHealth::MeasureRaid()
 {
-  std::map<std::string, std::string> health;
+  std::vector<std::string> devices;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    for (auto it = mResults.begin(); it != mResults.end(); it++) {
+      if (it->first[0] == 'm') {
+        devices.push_back(it->first);
+      }
+    }
+  }
+
+  if (devices.empty()) {
+    return;
+  }
+
   std::ifstream file("/proc/mdstat");
   file.rdbuf()->pubsetbuf(0, 0);
   std::stringstream buffer;
   buffer << file.rdbuf();
+  std::string mdstat = buffer.str();
+  std::map<std::string, std::map<std::string, std::string>> tmp;
+
+  for (auto it = devices.begin(); it != devices.end(); it++) {
+    tmp[*it] = parse_mdstat(it->c_str(), mdstat);
+  }
 
-  if (buffer.str().empty()) {
+  std::lock_guard<std::mutex> lock(mMutex);
+
+  for (auto it = tmp.begin(); it != tmp.end(); it++) {
+    mResults[it->first] = it->second;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Parse /proc/mdstat to obtain raid health
+//------------------------------------------------------------------------------
+std::map<std::string, std::string> DiskHealth::parse_mdstat(const char* device,
+    const std::string& mdstat)
+{
+  std::map<std::string, std::string> health;
+
+  if (mdstat.empty()) {
     health["summary"] = "no mdstat";
     return health;
   }
 
-  std::string output = buffer.str();
+  const std::string& output = mdstat;
   auto pos = output.find(device);
+
+  if ((pos == std::string::npos) ||
+      ((pos = output.find("raid", pos)) == std::string::npos) ||
+      (pos + 4 >= output.length())) {
+    health["summary"] = "unknown raid";
+    return health;
+  }
+
   int redundancy_factor;
-  pos = output.find("raid", pos);
   auto c = output[pos + 4];
 
   switch (c) {
@@ -150,12 +234,14 @@ std::map<std::string, std::string> DiskHealth::parse_mdstat(const char* device)
 // Obtain health of a single locally attached storage device by evaluating
 // S.M.A.R.T values.
 //------------------------------------------------------------------------------
-std::string DiskHealth::smartctl(const char* device)
+std::string DiskHealth::smartctl(eos::common::ShellCmd& cmd, size_t timeout)
 {
-  std::string command("smartctl -q silent -a /dev/");
-  command += device;
-  eos::common::ShellCmd scmd(command.c_str());
-  eos::common::cmd_status rc = scmd.wait(5);
+  eos::common::cmd_status rc = cmd.wait(timeout);
+
+  // The command was killed after the timeout
+  if (rc.signaled) {
+    return "timeout";
+  }
 
   if (rc.exit_code == 0) {
     return "OK";
@@ -246,25 +332,81 @@ Health::Monitor()
 }
 
 //------------------------------------------------------------------------------
-// Loop run by the monitoring thread to keep updated the disk health info.
+// Loop run by the monitoring thread to keep updated the disk health and node
+// information.
 //------------------------------------------------------------------------------
 void
 Health::Measure()
 {
+  time_t next_smartctl = 0;
+
   while (1) {
     XrdSysThread::SetCancelOff();
-    mDiskHealth.Measure();
+    // Node information and raid state are cheap to get, they are sampled
+    // every sSystemInterval seconds, S.M.A.R.T only every mIntervalMin minutes
+    MeasureSystem();
+    mDiskHealth.MeasureRaid();
+
+    if (mSkip || (time(NULL) >= next_smartctl)) {
+      mSkip = false;
+      mDiskHealth.Measure(sSmartctlTimeout);
+      next_smartctl = time(NULL) + 60 * mIntervalMin;
+    }
+
     XrdSysThread::SetCancelOn();
+    sleep(sSystemInterval);
+  }
+}
 
-    for (unsigned int i = 0; i < mIntervalMin; i++) {
-      sleep(60);
+//------------------------------------------------------------------------------
+// Sample the node information
+//------------------------------------------------------------------------------
+void
+Health::MeasureSystem()
+{
+  std::map<std::string, std::string> info;
+  char tmp_name[] = "/tmp/fst.health.XXXXXX";
+  int tmp_fd = mkstemp(tmp_name);
 
-      if (mSkip) {
-        mSkip = false;
-        break;
-      }
+  if (tmp_fd == -1) {
+    eos_static_err("failed to create temporary file for uptime command");
+  } else {
+    (void) close(tmp_fd);
+    std::string uptime = "uptime | tr -d \"\n\" > ";
+    uptime += tmp_name;
+    eos::common::ShellCmd scmd(uptime.c_str());
+    eos::common::cmd_status rc = scmd.wait(5);
+
+    if (rc.exit_code) {
+      eos_static_err("retrieve uptime call failed");
     }
+
+    eos::common::StringConversion::LoadFileIntoString(tmp_name, info["uptime"]);
+    (void) unlink(tmp_name);
+  }
+
+  // Number of lines in /proc/net/tcp like "cat /proc/net/tcp | wc -l"
+  std::ifstream tcp("/proc/net/tcp");
+  std::string line;
+  long long sockets = 0;
+
+  while (std::getline(tcp, line)) {
+    sockets++;
   }
+
+  info["sockets"] = std::to_string(sockets);
+  std::lock_guard<std::mutex> lock(mSysMutex);
+  mSysInfo = info;
+}
+
+//------------------------------------------------------------------------------
+// Get the latest sample of the node information
+//------------------------------------------------------------------------------
+std::map<std::string, std::string>
+Health::getSystemInfo()
+{
+  std::lock_guard<std::mutex> lock(mSysMutex);
+  return mSysInfo;
 }
 
 //------------------------------------------------------------------------------
@@ -278,7 +420,7 @@ Health::getDiskHealth(const char* devpath)
 
   // If we don't have any result, don't wait for interval timeout to measure
   if (result.empty()) {
-    mSkip = true; // this doesn't need a mutex, worst case we wait 1 more min.
+    mSkip = true; // this doesn't need a mutex, worst case we wait 1 more run
   }
 
   return result;
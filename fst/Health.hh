@@ -26,18 +26,21 @@
 
 #include "fst/Namespace.hh"
 #include "fst/storage/FileSystem.hh"
+#include "common/ShellCmd.hh"
 #include <mutex>
 
 EOSFSTNAMESPACE_BEGIN
 
 //------------------------------------------------------------------------------
-//! Class retrieving disk health information
+//! Class retrieving disk health information. The devices are sampled by the
+//! health thread, readers only get the latest cached sample.
 //------------------------------------------------------------------------------
 class DiskHealth
 {
 public:
   //----------------------------------------------------------------------------
-  //! Get health information about a certain device
+  //! Get the latest health sample of a certain device. Unknown devices are
+  //! registered for sampling and return an empty map.
   //!
   //! @param devpath path of the targeted device
   //!
@@ -46,36 +49,48 @@ public:
   std::map<std::string, std::string> getHealth(const char* devpath);
 
   //----------------------------------------------------------------------------
-  //! Update health information for all the registered devices
+  //! Update the S.M.A.R.T information of all the registered devices. The
+  //! smartctl calls run concurrently, each one is killed after the timeout.
+  //!
+  //! @param timeout seconds given to the smartctl call of a device
   //----------------------------------------------------------------------------
-  void Measure();
+  void Measure(size_t timeout);
+
+  //----------------------------------------------------------------------------
+  //! Update the raid health of all the registered md devices from a single
+  //! read of /proc/mdstat
+  //----------------------------------------------------------------------------
+  void MeasureRaid();
 
 private:
   //----------------------------------------------------------------------------
-  //! Parse /proc/mdstat to obtain raid health. Existing indicator shows
-  //! rebuild in progress.
+  //! Parse the contents of /proc/mdstat to obtain raid health. Existing
+  //! indicator shows rebuild in progress.
   //!
   //! @param device targeted device
+  //! @param mdstat contents of /proc/mdstat
   //!
   //! @return map of health parameters and values
   //----------------------------------------------------------------------------
-  std::map<std::string, std::string> parse_mdstat(const char* device);
+  std::map<std::string, std::string> parse_mdstat(const char* device,
+      const std::string& mdstat);
 
   //----------------------------------------------------------------------------
   //! Obtain health of a single locally attached storage device by evaluating
   //! S.M.A.R.T values.
   //!
-  //! @param device targeted device
+  //! @param cmd running smartctl command of the targeted device
+  //! @param timeout seconds to wait for the command
   //!
   //! @return string representin the result of smartctl run on the targeted
   //!         device. Can be one of the following: OK, no smartclt, N/A, Check,
-  //!         invalid, FAILING.
+  //!         invalid, FAILING, timeout.
   //----------------------------------------------------------------------------
-  std::string smartctl(const char* device);
+  std::string smartctl(eos::common::ShellCmd& cmd, size_t timeout);
 
-  //! Map holding the smartclt results
-  std::map<std::string, std::map<std::string, std::string>> smartctl_results;
-  std::mutex mMutex; ///< Protect acces to the smartctl_results map
+  //! Map of device name to its latest health sample
+  std::map<std::string, std::map<std::string, std::string>> mResults;
+  std::mutex mMutex; ///< Protect acces to the mResults map
 };
 
 //------------------------------------------------------------------------------
@@ -109,7 +124,8 @@ public:
   bool Monitor();
 
   //----------------------------------------------------------------------------
-  //! Loop run by the monitoring thread to keep updated the disk health info.
+  //! Loop run by the monitoring thread to keep updated the disk health and
+  //! node information.
   //----------------------------------------------------------------------------
   void Measure();
 
@@ -123,12 +139,26 @@ public:
   //----------------------------------------------------------------------------
   std::map<std::string, std::string> getDiskHealth(const char* devpath);
 
+  //----------------------------------------------------------------------------
+  //! Get the latest sample of the node information
+  //!
+  //! @return map with the "uptime" and "sockets" values
+  //----------------------------------------------------------------------------
+  std::map<std::string, std::string> getSystemInfo();
+
 private:
+  //----------------------------------------------------------------------------
+  //! Sample the node information
+  //----------------------------------------------------------------------------
+  void MeasureSystem();
+
   ///< Trigger update thread without waiting for the whole interval to elapse
   bool mSkip;
   pthread_t mTid; ///< Monitoring thread id
   unsigned int mIntervalMin; ///< Minutes interval when monitoring thread runs
   DiskHealth mDiskHealth; ///< Objecting collecting disk health information
+  std::mutex mSysMutex; ///< Protect access to the node information
+  std::map<std::string, std::string> mSysInfo; ///< Latest node information
 };
 
 EOSFSTNAMESPACE_END
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+// File: IoScheduler.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/IoScheduler.hh"
+#include "common/Logging.hh"
+#include "common/EnvTunable.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+EOSFSTNAMESPACE_BEGIN
+
+// Budget a busy device keeps so that the background IO still progresses
+static const double sMinBudget = 1.0;
+
+//------------------------------------------------------------------------------
+// Maximum background IO budget of a device in MB/s
+//------------------------------------------------------------------------------
+static double
+MaxBudget()
+{
+  static const int sBudget =
+    eos::common::EnvTunable::Get("EOS_FST_BGIO_RATE_MB", 500, 1, 100000);
+  return sBudget;
+}
+
+//------------------------------------------------------------------------------
+// Device utilisation above which the background IO budget shrinks
+//------------------------------------------------------------------------------
+static double
+TargetUtilisation()
+{
+  static const int sPercent =
+    eos::common::EnvTunable::Get("EOS_FST_BGIO_UTIL", 70, 10, 100);
+  return sPercent / 100.0;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+IoScheduler::IoScheduler(Load* load):
+  mLoad(load)
+{
+}
+
+//------------------------------------------------------------------------------
+// Get the state of a device, created on first use
+//------------------------------------------------------------------------------
+IoScheduler::Device*
+IoScheduler::GetDeviceState(const std::string& device)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::unique_ptr<Device>& state = mDevices[device];
+
+  if (!state) {
+    state.reset(new Device());
+    state->mBudget = MaxBudget();
+    state->mNext = state->mAdjusted = Clock::now();
+    state->mBytes = 0;
+  }
+
+  return state.get();
+}
+
+//------------------------------------------------------------------------------
+// Adjust the budget of a device to its utilisation
+//------------------------------------------------------------------------------
+void
+IoScheduler::Adjust(const std::string& device, Device* state,
+                    Clock::time_point now)
+{
+  if (!mLoad) {
+    return;
+  }
+
+  double elapsed = std::chrono::duration<double>(now - state->mAdjusted).count();
+
+  if (elapsed < mLoad->GetInterval()) {
+    return;
+  }
+
+  double util = mLoad->GetDiskRate(device.c_str(), "millisIO") / 1000.0;
+  double rate = state->mBytes / elapsed / (1024.0 * 1024.0);
+  double budget = state->mBudget;
+
+  if (util > TargetUtilisation()) {
+    // Back off from what the background IO really used, the budget may be
+    // much larger than that
+    budget = std::max(sMinBudget, 0.8 * std::min(budget, rate));
+  } else {
+    // Grow once per measurement interval spent without overload
+    budget = std::min(MaxBudget(), budget * std::pow(1.5, std::floor(elapsed /
+                      mLoad->GetInterval())));
+  }
+
+  if (budget != state->mBudget) {
+    eos_static_debug("msg=\"adjusted background IO budget\" device=%s "
+                     "util=%.02f rate=%.02f budget=%.02f", device.c_str(),
+                     util, rate, budget);
+  }
+
+  state->mBudget = budget;
+  state->mAdjusted = now;
+  state->mBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+// Wait until the budget of a device allows to do some background IO
+//------------------------------------------------------------------------------
+void
+IoScheduler::Acquire(const std::string& device, size_t bytes)
+{
+  if (!bytes) {
+    return;
+  }
+
+  Device* state = GetDeviceState(device);
+  Clock::time_point start;
+  {
+    std::lock_guard<std::mutex> lock(state->mMutex);
+    Clock::time_point now = Clock::now();
+    Adjust(device, state, now);
+    // The callers of a device get consecutive time slots, so they share its
+    // budget whatever their number
+    start = std::max(now, state->mNext);
+    double usec = 1e6 * bytes / (state->mBudget * 1024.0 * 1024.0);
+    state->mNext = start + std::chrono::microseconds((long long) usec);
+    state->mBytes += bytes;
+
+    if (start <= now) {
+      return;
+    }
+  }
+  std::this_thread::sleep_until(start);
+}
+
+//------------------------------------------------------------------------------
+// Get the current budget of a device
+//------------------------------------------------------------------------------
+double
+IoScheduler::GetBudget(const std::string& device)
+{
+  Device* state = GetDeviceState(device);
+  std::lock_guard<std::mutex> lock(state->mMutex);
+  return state->mBudget;
+}
+
+EOSFSTNAMESPACE_END
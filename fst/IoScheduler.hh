@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+//! @file IoScheduler.hh
+//! @author agent
+//! @brief Class sharing the disk bandwidth between the background activities
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_IOSCHEDULER_HH__
+#define __EOSFST_IOSCHEDULER_HH__
+
+#include "fst/Namespace.hh"
+#include "fst/Load.hh"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class pacing the background IO (scanner, verification, scrubbing) per
+//! block device. Each device has a bandwidth budget shared by all the
+//! background activities on it. The budget shrinks while the measured
+//! utilisation of the device is above the target and grows back once the
+//! device is less busy, so background IO on idle devices progresses at full
+//! speed while busy devices are left to the clients. Devices don't wait for
+//! each other.
+//------------------------------------------------------------------------------
+class IoScheduler
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param load load monitor providing the device utilisation
+  //----------------------------------------------------------------------------
+  IoScheduler(Load* load);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  virtual ~IoScheduler() {}
+
+  //----------------------------------------------------------------------------
+  //! Get the device holding a path
+  //!
+  //! @param path filesystem path
+  //!
+  //! @return device name as used by the load monitor
+  //----------------------------------------------------------------------------
+  std::string GetDevice(const std::string& path) const
+  {
+    return Load::DevMap(path);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Wait until the budget of a device allows to do some background IO
+  //!
+  //! @param device device name
+  //! @param bytes amount of IO going to be done
+  //----------------------------------------------------------------------------
+  void Acquire(const std::string& device, size_t bytes);
+
+  //----------------------------------------------------------------------------
+  //! Get the current budget of a device
+  //!
+  //! @param device device name
+  //!
+  //! @return background IO budget in MB/s
+  //----------------------------------------------------------------------------
+  double GetBudget(const std::string& device);
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  //! State of a device
+  struct Device {
+    std::mutex mMutex; ///< Mutex protecting the state
+    double mBudget; ///< Current budget in MB/s
+    Clock::time_point mNext; ///< Time at which the next IO may start
+    Clock::time_point mAdjusted; ///< Time of the last budget adjustment
+    size_t mBytes; ///< IO granted since the last budget adjustment
+  };
+
+  Load* mLoad; ///< Load monitor
+  std::mutex mMutex; ///< Mutex protecting the map of devices
+  std::map<std::string, std::unique_ptr<Device>> mDevices; ///< Device states
+
+  //----------------------------------------------------------------------------
+  //! Get the state of a device, created on first use
+  //----------------------------------------------------------------------------
+  Device* GetDeviceState(const std::string& device);
+
+  //----------------------------------------------------------------------------
+  //! Adjust the budget of a device to its utilisation, at most once per
+  //! measurement interval of the load monitor. Has to be called with the
+  //! device mutex locked.
+  //----------------------------------------------------------------------------
+  void Adjust(const std::string& device, Device* state, Clock::time_point now);
+};
+
+EOSFSTNAMESPACE_END
+
+#endif // __EOSFST_IOSCHEDULER_HH__
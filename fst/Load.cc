@@ -25,6 +25,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <errno.h>
+#include <climits>
+#include <ctime>
 #include <sys/stat.h>
 #include "XrdOuc/XrdOucString.hh"
 
@@ -62,76 +64,93 @@ Load::~Load()
 //------------------------------------------------------------------------------
 // Get device name mounted at the given path
 //-----------------------------------------------------------------------------
-const char*
-Load::DevMap(const char* dev_path)
+std::string
+Load::DevMap(const std::string& dev_path)
 {
   static time_t loadtime = 0;
-  static std::map<std::string, std::string> dev_map;
-  static XrdOucString mapdev = dev_path;
-  static XrdOucString mappath = "";
-  static XrdSysMutex mutex_map; // Protect access to the dev_map
-
-  if (mapdev.beginswith("/")) {
-    XrdSysMutexHelper scope_lock(&mutex_map);
-    mapdev = "";
+  static time_t parsetime = 0;
+  static time_t checktime = 0;
+  // Map from mount path to device name
+  static std::map<std::string, std::string> mount_map;
+  // Map from the paths looked up so far to their device name
+  static std::map<std::string, std::string> path_map;
+  static XrdSysMutex mutex_map; // Protect access to the maps
+
+  // Device names are returned as they are
+  if (dev_path.empty() || (dev_path[0] != '/')) {
+    return dev_path;
+  }
+
+  XrdSysMutexHelper scope_lock(&mutex_map);
+  time_t now = time(NULL);
+
+  if (now != checktime) {
+    checktime = now;
     struct stat stbuf;
 
-    if (!(stat("/etc/mtab", &stbuf))) {
-      dev_map.clear();
-
-      if (stbuf.st_mtime != loadtime) {
-	FILE* fd = fopen("/etc/mtab", "r");
-	// Reparse the mtab
-	char line[1025];
-	char val[6][1024];
-	line[0] = 0;
-
-	while (fd && fgets(line, 1024, fd)) {
-	  if ((sscanf(line, "%s %s %s %s %s %s\n", val[0], val[1], val[2],
-		      val[3], val[4], val[5])) == 6) {
-	    XrdOucString sdev = val[0];
-	    XrdOucString spath = val[1];
-
-	    // fprintf(stderr,"%s => %s\n", sdev.c_str(), spath.c_str());
-	    if (sdev.beginswith("/dev/")) {
-	      sdev.erase(0, 5);
-	      dev_map[sdev.c_str()] = spath.c_str();
-	      // fprintf(stderr,"=> %s %s\n", sdev.c_str(),spath.c_str());
-	    }
-	  }
-	}
+    // A /proc/self/mounts symlink keeps its mtime, reparse it once a minute
+    if (!stat("/etc/mtab", &stbuf) && ((stbuf.st_mtime != loadtime) ||
+                                       (now - parsetime >= 60))) {
+      loadtime = stbuf.st_mtime;
+      parsetime = now;
+      mount_map.clear();
+      path_map.clear();
+      FILE* fd = fopen("/etc/mtab", "r");
+      char line[1025];
+      char val[6][1024];
+      char real[PATH_MAX];
+      line[0] = 0;
+
+      while (fd && fgets(line, 1024, fd)) {
+        if ((sscanf(line, "%s %s %s %s %s %s\n", val[0], val[1], val[2],
+                    val[3], val[4], val[5])) == 6) {
+          // Resolve the links like /dev/mapper/<name> to the kernel device
+          // name used in /proc/diskstats, others like tmpfs have no device
+          std::string sdev = (((val[0][0] == '/') && realpath(val[0], real)) ?
+                              real : val[0]);
+          mount_map[val[1]] = ((sdev.compare(0, 5, "/dev/") == 0) ?
+                               sdev.substr(5) : "");
+        }
+      }
 
-	if (fd) {
-	  fclose(fd);
-	}
+      if (fd) {
+        fclose(fd);
       }
     }
+  }
 
-    XrdOucString match, it_str;
+  auto it = path_map.find(dev_path);
 
-    for (auto dev_map_it = dev_map.begin(); dev_map_it != dev_map.end();
-	 dev_map_it++) {
-      match = dev_path;
-      it_str = dev_map_it->second.c_str();
-      match.erase(dev_map_it->second.length());
+  if (it != path_map.end()) {
+    return it->second;
+  }
 
-      // fprintf(stderr,"%s <=> %s\n",match.c_str(),it_str.c_str());
-      if (match == it_str) {
-	if ((int) dev_map_it->second.length() > (int) mappath.length()) {
-	  mapdev = dev_map_it->first.c_str();
-	  mappath = dev_map_it->second.c_str();
-	  // fprintf(stderr,"Setting up mapping %s=>%s\n", mapdev.c_str(), mappath.c_str());
-	}
-      }
+  // The longest mount path containing the given path holds it
+  std::string dev = dev_path;
+  size_t match_len = 0;
+
+  for (auto mount_it = mount_map.begin(); mount_it != mount_map.end();
+       ++mount_it) {
+    const std::string& mount = mount_it->first;
+
+    if ((mount.length() < match_len) ||
+        dev_path.compare(0, mount.length(), mount)) {
+      continue;
+    }
+
+    if ((mount == "/") || (dev_path.length() == mount.length()) ||
+        (dev_path[mount.length()] == '/')) {
+      dev = mount_it->second;
+      match_len = mount.length();
     }
   }
 
-  if (!mapdev.length()) {
-    mapdev = dev_path;
+  if (dev.empty()) {
+    dev = dev_path;
   }
 
-  // printf("===> returning |%s|\n", mapdev.c_str());
-  return mapdev.c_str();
+  path_map[dev_path] = dev;
+  return dev;
 }
 
 //------------------------------------------------------------------------------
@@ -140,9 +159,8 @@ Load::DevMap(const char* dev_path)
 double
 Load::GetDiskRate(const char* dev_path, const char* tag)
 {
-  const char* dev = DevMap(dev_path);
-  //fprintf(stderr,"**** Device is %s\n", dev);
-  double val = fDiskStat.GetRate(dev, tag);
+  std::string dev = DevMap(dev_path);
+  double val = fDiskStat.GetRate(dev.c_str(), tag);
   return val;
 }
 
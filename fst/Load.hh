@@ -130,12 +130,21 @@ public:
   //----------------------------------------------------------------------------
   //! Get device name mounted at the given path
   //!
-  //! @param dev_path device mount path
+  //! @param dev_path path on a mounted filesystem or device name
   //!
-  //! @return name of the devices which is mounted at the given path or empty
-  //!         string if no device found
+  //! @return name of the device holding the given path as found in
+  //!         /proc/diskstats, the given path if no device found
   //----------------------------------------------------------------------------
-  static const char* DevMap(const char* dev_path);
+  static std::string DevMap(const std::string& dev_path);
+
+  //----------------------------------------------------------------------------
+  //! Tell if a name returned by DevMap is a device name, a path which is not
+  //! on a block device is returned as it is
+  //----------------------------------------------------------------------------
+  static bool IsDevice(const std::string& dev)
+  {
+    return (!dev.empty() && (dev[0] != '/'));
+  }
 
   //----------------------------------------------------------------------------
   //! Constructor
@@ -185,6 +194,15 @@ public:
   //----------------------------------------------------------------------------
   static void* StartLoadThread(void* pp);
 
+  //----------------------------------------------------------------------------
+  //! Get the sampling interval of the measurements in seconds
+  //----------------------------------------------------------------------------
+  inline unsigned int
+  GetInterval() const
+  {
+    return mInterval;
+  }
+
 private:
   pthread_t mTid; ///< Monitor thread id
   unsigned int mInterval; ///< Sampling interval for the monitor thread
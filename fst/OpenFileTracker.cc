@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+// File: OpenFileTracker.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/OpenFileTracker.hh"
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Get the open files of a filesystem
+//------------------------------------------------------------------------------
+OpenFileTracker::FsFiles*
+OpenFileTracker::GetFs(unsigned long fsid, bool create)
+{
+  {
+    eos::common::RWMutexReadLock lock(mMutex);
+    auto it = mFs.find(fsid);
+
+    if (it != mFs.end()) {
+      return it->second.get();
+    }
+  }
+
+  if (!create) {
+    return nullptr;
+  }
+
+  eos::common::RWMutexWriteLock lock(mMutex);
+  std::unique_ptr<FsFiles>& fs = mFs[fsid];
+
+  // Filesystems are never removed, the pointer stays valid
+  if (!fs) {
+    fs.reset(new FsFiles());
+    fs->mNumFiles[0] = fs->mNumFiles[1] = 0;
+  }
+
+  return fs.get();
+}
+
+//------------------------------------------------------------------------------
+// Account an open of a file
+//------------------------------------------------------------------------------
+void
+OpenFileTracker::Up(unsigned long fsid, unsigned long long fid, bool isrw)
+{
+  FsFiles* fs = GetFs(fsid, true);
+  std::lock_guard<std::mutex> lock(fs->mMutex);
+  unsigned int& count = fs->mOpens[isrw][fid];
+
+  if (count) {
+    fs->mHot[isrw].erase(HotFile(count, fid));
+  } else {
+    fs->mNumFiles[isrw]++;
+  }
+
+  count++;
+  fs->mHot[isrw].insert(HotFile(count, fid));
+}
+
+//------------------------------------------------------------------------------
+// Account a close of a file
+//------------------------------------------------------------------------------
+unsigned int
+OpenFileTracker::Down(unsigned long fsid, unsigned long long fid, bool isrw)
+{
+  FsFiles* fs = GetFs(fsid, false);
+
+  if (!fs) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(fs->mMutex);
+  auto it = fs->mOpens[isrw].find(fid);
+
+  if (it == fs->mOpens[isrw].end()) {
+    return 0;
+  }
+
+  fs->mHot[isrw].erase(HotFile(it->second, fid));
+
+  if (--it->second) {
+    fs->mHot[isrw].insert(HotFile(it->second, fid));
+    return it->second;
+  }
+
+  fs->mOpens[isrw].erase(it);
+  fs->mNumFiles[isrw]--;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Get the number of opens of a file
+//------------------------------------------------------------------------------
+unsigned int
+OpenFileTracker::GetUseCount(unsigned long fsid, unsigned long long fid,
+                             bool isrw)
+{
+  FsFiles* fs = GetFs(fsid, false);
+
+  if (!fs) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(fs->mMutex);
+  auto it = fs->mOpens[isrw].find(fid);
+  return ((it != fs->mOpens[isrw].end()) ? it->second : 0);
+}
+
+//------------------------------------------------------------------------------
+// Get the number of files open on a filesystem
+//------------------------------------------------------------------------------
+long long
+OpenFileTracker::GetNumOpenFiles(unsigned long fsid, bool isrw)
+{
+  FsFiles* fs = GetFs(fsid, false);
+  return (fs ? fs->mNumFiles[isrw].load() : 0);
+}
+
+//------------------------------------------------------------------------------
+// Tell if any file is open on any filesystem
+//------------------------------------------------------------------------------
+bool
+OpenFileTracker::IsAnyOpen(bool isrw)
+{
+  eos::common::RWMutexReadLock lock(mMutex);
+
+  for (auto it = mFs.begin(); it != mFs.end(); ++it) {
+    if (it->second->mNumFiles[isrw]) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Get the most opened files of a filesystem
+//------------------------------------------------------------------------------
+std::vector<OpenFileTracker::HotFile>
+OpenFileTracker::GetHotFiles(unsigned long fsid, bool isrw, size_t max)
+{
+  std::vector<HotFile> hot;
+  FsFiles* fs = GetFs(fsid, false);
+
+  if (!fs) {
+    return hot;
+  }
+
+  std::lock_guard<std::mutex> lock(fs->mMutex);
+
+  for (auto it = fs->mHot[isrw].begin();
+       (it != fs->mHot[isrw].end()) && (hot.size() < max); ++it) {
+    hot.push_back(*it);
+  }
+
+  return hot;
+}
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//! @file OpenFileTracker.hh
+//! @author agent
+//! @brief Registry of the files open for reading and writing per filesystem
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_OPENFILETRACKER_HH__
+#define __EOSFST_OPENFILETRACKER_HH__
+
+#include "fst/Namespace.hh"
+#include "common/RWMutex.hh"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class counting the opens of every file per filesystem and access mode.
+//! Each filesystem has its own lock, so opens and closes on different
+//! filesystems don't contend. The map of filesystems is only write locked
+//! when a filesystem is seen for the first time. The number of open files of
+//! a filesystem is kept in atomic counters and the files are additionally
+//! indexed by their number of opens, so the hot files are read in O(K)
+//! without scanning all the open files.
+//------------------------------------------------------------------------------
+class OpenFileTracker
+{
+public:
+  //! Number of opens and file id of an open file
+  typedef std::pair<unsigned int, unsigned long long> HotFile;
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //----------------------------------------------------------------------------
+  OpenFileTracker() {}
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  virtual ~OpenFileTracker() {}
+
+  //----------------------------------------------------------------------------
+  //! Account an open of a file
+  //!
+  //! @param fsid filesystem id
+  //! @param fid file id
+  //! @param isrw true for an open for writing
+  //----------------------------------------------------------------------------
+  void Up(unsigned long fsid, unsigned long long fid, bool isrw);
+
+  //----------------------------------------------------------------------------
+  //! Account a close of a file
+  //!
+  //! @param fsid filesystem id
+  //! @param fid file id
+  //! @param isrw true for an open for writing
+  //!
+  //! @return number of opens left in this mode
+  //----------------------------------------------------------------------------
+  unsigned int Down(unsigned long fsid, unsigned long long fid, bool isrw);
+
+  //----------------------------------------------------------------------------
+  //! Get the number of opens of a file
+  //!
+  //! @param fsid filesystem id
+  //! @param fid file id
+  //! @param isrw true for the opens for writing
+  //----------------------------------------------------------------------------
+  unsigned int GetUseCount(unsigned long fsid, unsigned long long fid,
+                           bool isrw);
+
+  //----------------------------------------------------------------------------
+  //! Tell if a file is open
+  //!
+  //! @param fsid filesystem id
+  //! @param fid file id
+  //! @param isrw true to check the opens for writing
+  //----------------------------------------------------------------------------
+  bool IsOpen(unsigned long fsid, unsigned long long fid, bool isrw)
+  {
+    return (GetUseCount(fsid, fid, isrw) > 0);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the number of files open on a filesystem from its atomic counter,
+  //! without locking the open files of the filesystem
+  //!
+  //! @param fsid filesystem id
+  //! @param isrw true for the files open for writing
+  //----------------------------------------------------------------------------
+  long long GetNumOpenFiles(unsigned long fsid, bool isrw);
+
+  //----------------------------------------------------------------------------
+  //! Tell if any file is open on any filesystem
+  //!
+  //! @param isrw true to check the opens for writing
+  //----------------------------------------------------------------------------
+  bool IsAnyOpen(bool isrw);
+
+  //----------------------------------------------------------------------------
+  //! Get the most opened files of a filesystem, most opened first and by file
+  //! id for the same number of opens
+  //!
+  //! @param fsid filesystem id
+  //! @param isrw true for the files open for writing
+  //! @param max maximum number of files returned
+  //----------------------------------------------------------------------------
+  std::vector<HotFile> GetHotFiles(unsigned long fsid, bool isrw, size_t max);
+
+private:
+  //! Order of the hot file index
+  struct HotOrder {
+    bool operator()(const HotFile& a, const HotFile& b) const
+    {
+      return (a.first > b.first) ||
+             ((a.first == b.first) && (a.second < b.second));
+    }
+  };
+
+  //! Open files of a filesystem, index 0 for reading and 1 for writing
+  struct FsFiles {
+    std::mutex mMutex; ///< Mutex protecting the maps and indices
+    //! Map of file id to number of opens
+    std::unordered_map<unsigned long long, unsigned int> mOpens[2];
+    std::set<HotFile, HotOrder> mHot[2]; ///< Open files by number of opens
+    std::atomic<long long> mNumFiles[2]; ///< Number of open files
+  };
+
+  eos::common::RWMutex mMutex; ///< Mutex protecting the map of filesystems
+  //! Map of filesystem id to its open files
+  std::map<unsigned long, std::unique_ptr<FsFiles>> mFs;
+
+  //----------------------------------------------------------------------------
+  //! Get the open files of a filesystem
+  //!
+  //! @param fsid filesystem id
+  //! @param create if true the filesystem is created on first use
+  //!
+  //! @return open files of the filesystem or null
+  //----------------------------------------------------------------------------
+  FsFiles* GetFs(unsigned long fsid, bool create);
+};
+
+EOSFSTNAMESPACE_END
+
+#endif // __EOSFST_OPENFILETRACKER_HH__
@@ -24,6 +24,7 @@
 #include "common/Logging.hh"
 #include "common/FileId.hh"
 #include "common/Path.hh"
+#include "common/EnvTunable.hh"
 #include "fst/ScanDir.hh"
 #include "fst/Config.hh"
 #include "fst/XrdFstOfs.hh"
@@ -108,7 +109,9 @@ ScanDir::~ScanDir()
     closelog();
   }
 
-  if (buffer) {
+  if (pooledBuffer) {
+    eos::common::BufferPool::GetInstance().Release(buffer, bufferSize);
+  } else if (buffer) {
     free(buffer);
   }
 }
@@ -124,9 +127,76 @@ scandir_cleanup_handle(void* arg)
   }
 }
 
+#ifndef _NOOFS
+//------------------------------------------------------------------------------
+// Hours between the walks through all the files of a filesystem looking for
+// files without record, 0 walks through all the files in every scan
+//------------------------------------------------------------------------------
+static int
+ScanWalkHours()
+{
+  static const int sHours =
+    eos::common::EnvTunable::Get("EOS_FST_SCAN_WALK_HOURS", 168, 0, 8760);
+  return sHours;
+}
+#endif
+
 /*----------------------------------------------------------------------------*/
 void
 ScanDir::ScanFiles()
+{
+#ifndef _NOOFS
+
+  // The local DB tells which files are due, the walk only looks for files
+  // without record from time to time
+  if (bgThread && !forcedScan && ScanWalkHours() && ScanDueFiles()) {
+    time_t now = time(NULL);
+
+    if (now - lastWalk >= ScanWalkHours() * 3600) {
+      lastWalk = now;
+      WalkFiles(true);
+    }
+
+    return;
+  }
+
+#endif
+  WalkFiles(false);
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+ScanDir::ScanDueFiles()
+{
+#ifndef _NOOFS
+  std::vector<eos::common::FileId::fileid_t> fids;
+
+  if (!gFmdDbMapHandler.GetScanDue(fsId, testInterval, fids)) {
+    return false;
+  }
+
+  eos_info("msg=\"scanning due files\" fsid=%u nfiles=%lu", fsId,
+           (unsigned long) fids.size());
+
+  for (auto it = fids.begin(); it != fids.end(); ++it) {
+    XrdOucString hexfid;
+    XrdOucString fstPath;
+    eos::common::FileId::Fid2Hex(*it, hexfid);
+    eos::common::FileId::FidPrefix2FullPath(hexfid.c_str(), dirPath.c_str(),
+                                            fstPath);
+    CheckFile(fstPath.c_str(), true);
+    XrdSysThread::CancelPoint();
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+/*----------------------------------------------------------------------------*/
+void
+ScanDir::WalkFiles(bool unknownOnly)
 {
   std::unique_ptr<FileIo> io(FileIoPluginHelper::GetIoObject(dirPath.c_str()));
 
@@ -160,6 +230,24 @@ ScanDir::ScanFiles()
       fprintf(stderr, "[ScanDir] processing file %s\n", filePath.c_str());
     }
 
+#ifndef _NOOFS
+
+    if (unknownOnly) {
+      // Files with a record are scanned when they are due
+      eos::common::Path cPath(filePath.c_str());
+      eos::common::FileId::fileid_t fid =
+        eos::common::FileId::Hex2Fid(cPath.GetName());
+
+      if (fid && gFmdDbMapHandler.HasFmd(fid, fsId)) {
+        if (bgThread) {
+          XrdSysThread::CancelPoint();
+        }
+
+        continue;
+      }
+    }
+
+#endif
     CheckFile(filePath.c_str());
 
     if (bgThread) {
@@ -181,7 +269,7 @@ ScanDir::ScanFiles()
 
 /*----------------------------------------------------------------------------*/
 void
-ScanDir::CheckFile(const char* filepath)
+ScanDir::CheckFile(const char* filepath, bool due)
 {
   float scantime;
   unsigned long layoutid = 0;
@@ -212,9 +300,7 @@ ScanDir::CheckFile(const char* filepath)
     eos::common::Path cPath(filePath.c_str());
     eos::common::FileId::fileid_t fid = strtoul(cPath.GetName(), 0, 16);
     // check if somebody is still writing on that file and skip in that case
-    XrdSysMutexHelper wLock(gOFS.OpenFidMutex);
-
-    if (gOFS.WOpenFid[fsId].count(fid)) {
+    if (gOFS.mOpenFiles.IsOpen(fsId, fid, true)) {
       syslog(LOG_ERR, "skipping scan w-open file: localpath=%s fsid=%d fid=%x\n",
              filePath.c_str(), (int) fid, fsId);
       eos_warning("skipping scan of w-open file: localpath=%s fsid=%d fid=%x",
@@ -232,9 +318,13 @@ ScanDir::CheckFile(const char* filepath)
     checksumLen = 0;
   }
 
-  io->attrGet("user.eos.timestamp", checksumStamp);
   io->attrGet("user.eos.lfn", logicalFileName);
-  bool rescan = RescanFile(checksumStamp);
+  bool rescan = due;
+
+  if (!due) {
+    io->attrGet("user.eos.timestamp", checksumStamp);
+    rescan = RescanFile(checksumStamp);
+  }
 
   if (rescan || forcedScan) {
     // if (checksumType.compare(""))
@@ -258,9 +348,7 @@ ScanDir::CheckFile(const char* filepath)
           eos::common::Path cPath(filePath.c_str());
           eos::common::FileId::fileid_t fid = strtoul(cPath.GetName(), 0, 16);
           // check if somebody is again writing on that file and skip in that case
-          XrdSysMutexHelper wLock(gOFS.OpenFidMutex);
-
-          if (gOFS.WOpenFid[fsId].count(fid)) {
+          if (gOFS.mOpenFiles.IsOpen(fsId, fid, true)) {
             eos_err("file %s has been reopened for update during the scan ... "
                     "ignoring checksum error", filePath.c_str());
             reopened = true;
@@ -311,9 +399,23 @@ ScanDir::CheckFile(const char* filepath)
 
       if (rescan) {
         if (!skiptosettime) {
-          if (io->attrSet("user.eos.timestamp", GetTimestampSmeared())) {
+          std::string timestamp = GetTimestampSmeared();
+
+          if (io->attrSet("user.eos.timestamp", timestamp)) {
             failedtoset |= true;
           }
+
+#ifndef _NOOFS
+
+          if (bgThread) {
+            // Keep the scan index of the local DB up to date
+            eos::common::Path cPath(filePath.c_str());
+            gFmdDbMapHandler.SetCheckTime(eos::common::FileId::Hex2Fid(
+                                            cPath.GetName()), fsId,
+                                          strtoull(timestamp.c_str(), 0, 10) / 1000000);
+          }
+
+#endif
         }
 
         if ((io->attrSet("user.eos.filecxerror", filecxerror ? "1" : "0")) ||
@@ -688,9 +790,7 @@ ScanDir::ScanFileLoadAware(const std::unique_ptr<eos::fst::FileIo>& io,
                            unsigned long long& scansize, float& scantime, const char* checksumVal,
                            unsigned long layoutid, const char* lfn, bool& filecxerror, bool& blockcxerror)
 {
-  double load;
   bool retVal, corruptBlockXS = false;
-  int currentRate = rateBandwidth;
   std::string filePath, fileXSPath;
   struct timezone tz;
   struct timeval opentime;
@@ -724,6 +824,11 @@ ScanDir::ScanFileLoadAware(const std::unique_ptr<eos::fst::FileIo>& io,
   off_t offset = 0;
 
   do {
+    // Share the bandwidth of the device with the other background activities
+    if (ioScheduler) {
+      ioScheduler->Acquire(ioDevice, bufferSize);
+    }
+
     errno = 0;
     nread = io->fileRead(offset, buffer, bufferSize);
 
@@ -753,29 +858,17 @@ ScanDir::ScanFileLoadAware(const std::unique_ptr<eos::fst::FileIo>& io,
 
       offset += nread;
 
-      if (currentRate) {
+      if (rateBandwidth) {
         // regulate the verification rate
         gettimeofday(&currenttime, &tz);
         scantime = (((currenttime.tv_sec - opentime.tv_sec) * 1000.0) + ((
                       currenttime.tv_usec - opentime.tv_usec) / 1000.0));
-        float expecttime = (1.0 * offset / currentRate) / 1000.0;
+        float expecttime = (1.0 * offset / rateBandwidth) / 1000.0;
 
         if (expecttime > scantime) {
           XrdSysTimer sleeper;
           sleeper.Wait(expecttime - scantime);
         }
-
-        //adjust the rate according to the load information
-        load = fstLoad->GetDiskRate("sda", "millisIO") / 1000.0;
-
-        if (load > 0.7) {
-          //adjust currentRate
-          if (currentRate > 5) {
-            currentRate = 0.9 * currentRate;
-          }
-        } else {
-          currentRate = rateBandwidth;
-        }
       }
     }
   } while (nread == bufferSize);
@@ -25,11 +25,12 @@
 #define __EOSFST_SCANDIR_HH__
 
 #include <pthread.h>
-#include "fst/Load.hh"
+#include "fst/IoScheduler.hh"
 #include "fst/Namespace.hh"
 #include "fst/FmdDbMap.hh"
 #include "common/Logging.hh"
 #include "common/FileSystem.hh"
+#include "common/BufferPool.hh"
 #include "XrdOuc/XrdOucString.hh"
 #include "fst/checksum/ChecksumPlugins.hh"
 #include "fst/io/FileIo.hh"
@@ -49,9 +50,10 @@ class ScanDir : eos::common::LogId
   //! blockchecksums if present) in a defined interval with limited bandwidth.
   //----------------------------------------------------------------------------
 private:
-  eos::fst::Load* fstLoad;
+  eos::fst::IoScheduler* ioScheduler;
   eos::common::FileSystem::fsid_t fsId;
   XrdOucString dirPath;
+  std::string ioDevice; // device holding dirPath, resolved once
   long int testInterval; // in seconds
 
   // Statistics
@@ -68,24 +70,32 @@ private:
   int rateBandwidth; // MB/s
   long alignment;
   char* buffer;
+  bool pooledBuffer; // buffer comes from the buffer pool
   pthread_t thread;
   bool bgThread;
   bool forcedScan;
+  time_t lastWalk; // time of the last walk through all the files
 
 public:
 
   ScanDir(const char* dirpath, eos::common::FileSystem::fsid_t fsid,
-          eos::fst::Load* fstload, bool bgthread = true, long int testinterval = 10,
-          int ratebandwidth = 100, bool setchecksum = false) :
-    fstLoad(fstload), fsId(fsid), dirPath(dirpath), testInterval(testinterval),
-    setChecksum(setchecksum), rateBandwidth(ratebandwidth), forcedScan(false)
+          eos::fst::IoScheduler* scheduler, bool bgthread = true,
+          long int testinterval = 10, int ratebandwidth = 100,
+          bool setchecksum = false) :
+    ioScheduler(scheduler), fsId(fsid), dirPath(dirpath),
+    ioDevice(scheduler ? scheduler->GetDevice(dirpath) : ""),
+    testInterval(testinterval), setChecksum(setchecksum),
+    rateBandwidth(ratebandwidth), forcedScan(false)
   {
     thread = 0;
+    // The boot of the filesystem walked through all the files
+    lastWalk = time(NULL);
     noNoChecksumFiles = noScanFiles = 0;
     noCorruptFiles = noTotalFiles = SkippedFiles = 0;
     durationScan = 0;
     totalScanSize = bufferSize = 0;
     buffer = 0;
+    pooledBuffer = false;
     bgThread = bgthread;
     alignment = pathconf((dirpath[0] != '/') ? "/" : dirPath.c_str(),
                          _PC_REC_XFER_ALIGN);
@@ -94,7 +104,14 @@ public:
     if (alignment > 0) {
       bufferSize = 256 * alignment;
 
-      if (posix_memalign((void**) &buffer, palignment, bufferSize)) {
+      // Pool buffers are page aligned, which covers the usual alignments
+      if ((palignment <= eos::common::BufferPool::sMinClassSize) &&
+          !(eos::common::BufferPool::sMinClassSize % palignment)) {
+        buffer = eos::common::BufferPool::GetInstance().Allocate(bufferSize);
+        pooledBuffer = (buffer != 0);
+      }
+
+      if (!buffer && posix_memalign((void**) &buffer, palignment, bufferSize)) {
         buffer = 0;
         fprintf(stderr, "error: error calling posix_memaling on dirpath=%s. \n",
                 dirPath.c_str());
@@ -122,8 +139,10 @@ public:
   };
 
   void ScanFiles();
+  void WalkFiles(bool unknownOnly);
+  bool ScanDueFiles();
 
-  void CheckFile(const char*);
+  void CheckFile(const char*, bool due = false);
   eos::fst::CheckSum* GetBlockXS(const char*, unsigned long long maxfilesize);
   bool ScanFileLoadAware(const std::unique_ptr<eos::fst::FileIo>&,
                          unsigned long long&, float&, const char*, unsigned long, const char* lfn,
@@ -31,6 +31,7 @@
 #include "common/Statfs.hh"
 #include "common/SyncAll.hh"
 #include "common/StackTrace.hh"
+#include "common/BufferPool.hh"
 #include "XrdNet/XrdNetOpts.hh"
 #include "XrdOfs/XrdOfs.hh"
 #include "XrdOfs/XrdOfsTrace.hh"
@@ -1025,12 +1026,8 @@ XrdFstOfs::SendFsck(XrdMqMessage* message)
 
           for (fit = icit->second.begin(); fit != icit->second.end(); fit++) {
             // don't report files which are currently write-open
-            XrdSysMutexHelper wLock(gOFS.OpenFidMutex);
-
-            if (gOFS.WOpenFid[fsid].count(*fit)) {
-              if (gOFS.WOpenFid[fsid][*fit] > 0) {
-                continue;
-              }
+            if (gOFS.mOpenFiles.IsOpen(fsid, *fit, true)) {
+              continue;
             }
 
             // loop over all fids
@@ -1125,7 +1122,7 @@ int
 XrdFstOfs::_rem(const char* path, XrdOucErrInfo& error,
                 const XrdSecEntity* client, XrdOucEnv* capOpaque,
                 const char* fstpath, unsigned long long fid,
-                unsigned long fsid, bool ignoreifnotexist)
+                unsigned long fsid, bool ignoreifnotexist, bool deletefmd)
 {
   EPNAME("rem");
   XrdOucString fstPath = "";
@@ -1204,7 +1201,7 @@ XrdFstOfs::_rem(const char* path, XrdOucErrInfo& error,
     }
   }
 
-  if (!gFmdDbMapHandler.DeleteFmd(fid, fsid)) {
+  if (deletefmd && !gFmdDbMapHandler.DeleteFmd(fid, fsid)) {
     eos_notice("unable to delete fmd for fid %llu on filesystem %lu", fid, fsid);
     return gOFS.Emsg(epname, error, EIO, "delete file meta data ", fstPath.c_str());
   }
@@ -1388,6 +1385,14 @@ XrdFstOfs::FSctl(const int cmd, XrdSfsFSctl& args, XrdOucErrInfo& error,
         return SFS_DATA;
       }
     }
+
+    if (execmd == "bufferpool") {
+      // Occupancy and miss counters of the IO buffer pool
+      std::string out;
+      eos::common::BufferPool::GetInstance().Print(out);
+      error.setErrInfo(out.length() + 1, out.c_str());
+      return SFS_DATA;
+    }
   }
 
   return Emsg(epname, error, EINVAL, "execute FSctl command", path.c_str());
@@ -1466,31 +1471,19 @@ XrdFstOfs::WaitForOngoingIO(std::chrono::seconds timeout)
 
   while (std::chrono::system_clock::now() <= deadline) {
     all_done = true;
-    {
-      XrdSysMutexHelper scope_lock(OpenFidMutex);
-
-      for (auto it = WOpenFid.begin(); it != WOpenFid.end(); ++it) {
-        if (it->second.size() != 0) {
-          all_done = false;
-          eos_info("waiting for write IO operations to finish");
-          break;
-        }
-      }
 
-      if (all_done) {
-        for (auto it = ROpenFid.begin(); it != ROpenFid.end(); ++it) {
-          if (it->second.size() != 0) {
-            all_done = false;
-            eos_info("waiting for read IO operations to finish");
-            break;
-          }
-        }
-      }
+    if (mOpenFiles.IsAnyOpen(true)) {
+      all_done = false;
+      eos_info("waiting for write IO operations to finish");
+    } else if (mOpenFiles.IsAnyOpen(false)) {
+      all_done = false;
+      eos_info("waiting for read IO operations to finish");
+    }
 
-      if (all_done) {
-        break;
-      }
+    if (all_done) {
+      break;
     }
+
     std::this_thread::sleep_for(check_interval);
   }
 
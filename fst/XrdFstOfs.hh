@@ -29,6 +29,7 @@
 #include "fst/storage/Storage.hh"
 #include "fst/Config.hh"
 #include "fst/Messaging.hh"
+#include "fst/OpenFileTracker.hh"
 #include "fst/http/HttpServer.hh"
 #include "authz/XrdCapability.hh"
 #include "common/SymKeys.hh"
@@ -249,6 +250,9 @@ public:
 
   //----------------------------------------------------------------------------
   //! Remove path - low-level function
+  //!
+  //! @param deletefmd if false the caller removes the FMD record, e.g. in a
+  //!        batch together with other removed files
   //----------------------------------------------------------------------------
   int _rem(const char* path,
            XrdOucErrInfo& out_error,
@@ -257,7 +261,8 @@ public:
            const char* fstPath = 0,
            unsigned long long fid = 0,
            unsigned long fsid = 0,
-           bool ignoreifnotexist = false);
+           bool ignoreifnotexist = false,
+           bool deletefmd = true);
 
   //----------------------------------------------------------------------------
   //! Get checksum - we publish checksums at the MGM
@@ -332,14 +337,8 @@ public:
   XrdSysError* Eroute;
   eos::fst::Messaging* Messaging; ///< messaging interface class
   eos::fst::Storage* Storage; ///< Meta data & filesytem store object
-  XrdSysMutex OpenFidMutex;
-
-  google::sparse_hash_map<eos::common::FileSystem::fsid_t,
-         google::sparse_hash_map<unsigned long long,
-         unsigned int> > WOpenFid;
-  google::sparse_hash_map<eos::common::FileSystem::fsid_t,
-         google::sparse_hash_map<unsigned long long,
-         unsigned int> > ROpenFid;
+  eos::fst::OpenFileTracker mOpenFiles; ///< Files open for reading/writing
+  XrdSysMutex OpenFidMutex; ///< Mutex protecting WNoDeleteOnCloseFid
   //! Map to forbid deleteOnClose for creates if 1+X open had a successfull close
   google::sparse_hash_map<eos::common::FileSystem::fsid_t,
          google::sparse_hash_map<unsigned long long,
@@ -26,6 +26,7 @@
 /*----------------------------------------------------------------------------*/
 #include "common/Path.hh"
 #include "common/http/OwnCloud.hh"
+#include "common/EnvTunable.hh"
 #include "fst/XrdFstOfsFile.hh"
 #include "fst/XrdFstOfs.hh"
 #include "fst/layout/LayoutPlugin.hh"
@@ -33,6 +34,7 @@
 /*----------------------------------------------------------------------------*/
 #include "XrdOss/XrdOssApi.hh"
 #include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSfs/XrdSfsDio.hh"
 #include "XrdCl/XrdClXRootDResponses.hh"
 /*----------------------------------------------------------------------------*/
 #include <math.h>
@@ -662,16 +664,7 @@ XrdFstOfsFile::open(const char* path, XrdSfsFileOpenMode open_mode,
   eos_info("Path=%s beginswith=%d", Path.c_str(), Path.beginswith("/replicate:"));
 
   if (Path.beginswith("/replicate:")) {
-    bool isopenforwrite = false;
-    gOFS.OpenFidMutex.Lock();
-
-    if (gOFS.WOpenFid[fsid].count(fileid)) {
-      if (gOFS.WOpenFid[fsid][fileid] > 0) {
-        isopenforwrite = true;
-      }
-    }
-
-    gOFS.OpenFidMutex.UnLock();
+    bool isopenforwrite = gOFS.mOpenFiles.IsOpen(fsid, fileid, true);
 
     if (isopenforwrite) {
       eos_err("forbid to open replica - file %s is opened in RW mode", Path.c_str());
@@ -684,16 +677,7 @@ XrdFstOfsFile::open(const char* path, XrdSfsFileOpenMode open_mode,
 
   // Check if this is an open for HTTP
   if ((!isRW) && ((std::string(client->tident) == "http"))) {
-    bool isopenforwrite = false;
-    gOFS.OpenFidMutex.Lock();
-
-    if (gOFS.WOpenFid[fsid].count(fileid)) {
-      if (gOFS.WOpenFid[fsid][fileid] > 0) {
-        isopenforwrite = true;
-      }
-    }
-
-    gOFS.OpenFidMutex.UnLock();
+    bool isopenforwrite = gOFS.mOpenFiles.IsOpen(fsid, fileid, true);
 
     if (isopenforwrite) {
       eos_err("forbid to open replica for synchronization - file %s is opened "
@@ -1070,15 +1054,15 @@ XrdFstOfsFile::open(const char* path, XrdSfsFileOpenMode open_mode,
 
   if (!rc) {
     opened = true;
-    gOFS.OpenFidMutex.Lock();
 
     if (isRW) {
-      gOFS.WOpenFid[fsid][fileid]++;
+      // The close of a writer checks and drops the write opens of the file
+      // under this mutex, a new writer must not slip in between
+      XrdSysMutexHelper aLock(gOFS.OpenFidMutex);
+      gOFS.mOpenFiles.Up(fsid, fileid, isRW);
     } else {
-      gOFS.ROpenFid[fsid][fileid]++;
+      gOFS.mOpenFiles.Up(fsid, fileid, isRW);
     }
-
-    gOFS.OpenFidMutex.UnLock();
   } else {
     // If we have local errors in open we don't disable a filesystem -
     // this is done by the Scrub thread if necessary!
@@ -1245,21 +1229,17 @@ XrdFstOfsFile::modified()
 
   // Check if the file could have been changed in the meanwhile ...
   if (fileExists && isReplication && (!isRW)) {
-    gOFS.OpenFidMutex.Lock();
-
-    if (gOFS.WOpenFid[fsid].count(fileid)) {
-      if (gOFS.WOpenFid[fsid][fileid] > 0) {
-        eos_err("file is now open for writing - discarding replication "
-                "[wopen=%d]", gOFS.WOpenFid[fsid][fileid]);
-        gOFS.Emsg("closeofs", error, EIO, "guarantee correctness - "
-                  "file has been opened for writing during replication",
-                  Path.c_str());
-        rc = SFS_ERROR;
-      }
+    unsigned int wopen = gOFS.mOpenFiles.GetUseCount(fsid, fileid, true);
+
+    if (wopen > 0) {
+      eos_err("file is now open for writing - discarding replication "
+              "[wopen=%d]", wopen);
+      gOFS.Emsg("closeofs", error, EIO, "guarantee correctness - "
+                "file has been opened for writing during replication",
+                Path.c_str());
+      rc = SFS_ERROR;
     }
 
-    gOFS.OpenFidMutex.UnLock();
-
     if ((statinfo.st_mtime != updateStat.st_mtime)) {
       eos_err("file has been modified during replication");
       rc = SFS_ERROR;
@@ -1302,6 +1282,54 @@ XrdFstOfsFile::FileIoReadCB(eos::fst::CheckSum::ReadCallBack::callback_data_t*
   return ((FileIo*) cbd->caller)->fileRead(cbd->offset, cbd->buffer, cbd->size);
 }
 
+//------------------------------------------------------------------------------
+// Number of ranges read in parallel to complete a checksum
+//------------------------------------------------------------------------------
+static int
+ChecksumScanThreads()
+{
+  static const int sThreads =
+    eos::common::EnvTunable::Get("EOS_FST_XS_SCAN_THREADS", 4, 1, 32);
+  return sThreads;
+}
+
+//------------------------------------------------------------------------------
+// Complete the checksum reading only the missing ranges of the local replica
+//------------------------------------------------------------------------------
+bool
+XrdFstOfsFile::ScanMissingChecksum(unsigned long long& scansize,
+                                   float& scantime)
+{
+  // Only these layouts have the full file in the local replica
+  if ((eos::common::LayoutId::GetLayoutType(lid) !=
+       eos::common::LayoutId::kPlain) &&
+      (eos::common::LayoutId::GetLayoutType(lid) !=
+       eos::common::LayoutId::kReplica)) {
+    return false;
+  }
+
+  std::unique_ptr<eos::fst::FileIo> io(eos::fst::FileIoPluginHelper::GetIoObject(
+                                         fstPath.c_str()));
+  struct stat buf;
+
+  if (!io || io->fileOpen(0, 0)) {
+    return false;
+  }
+
+  bool scanned = false;
+
+  if (!io->fileStat(&buf)) {
+    eos::fst::CheckSum::ReadCallBack::callback_data_t cbd;
+    cbd.caller = (void*) io.get();
+    eos::fst::CheckSum::ReadCallBack cb(FileIoReadCB, cbd);
+    scanned = checkSum->ScanMissing(cb, buf.st_size, scansize, scantime,
+                                    ChecksumScanThreads());
+  }
+
+  io->fileClose();
+  return scanned;
+}
+
 //------------------------------------------------------------------------------
 // Verify checksum method
 //------------------------------------------------------------------------------
@@ -1353,12 +1381,18 @@ XrdFstOfsFile::verifychecksum()
       float scantime = 0; // is ms
 
       if (!XrdOfsFile::fctl(SFS_FCTL_GETFD, 0, error)) {
-        // Rescan the file
-        eos::fst::CheckSum::ReadCallBack::callback_data_t cbd;
-        cbd.caller = (void*) layOut;
-        eos::fst::CheckSum::ReadCallBack cb(LayoutReadCB, cbd);
+        // Files written out of order only need the holes to be read again
+        bool scanned = (isRW && ScanMissingChecksum(scansize, scantime));
+
+        if (!scanned) {
+          // Rescan the file
+          eos::fst::CheckSum::ReadCallBack::callback_data_t cbd;
+          cbd.caller = (void*) layOut;
+          eos::fst::CheckSum::ReadCallBack cb(LayoutReadCB, cbd);
+          scanned = checkSum->ScanFile(cb, scansize, scantime);
+        }
 
-        if (checkSum->ScanFile(cb, scansize, scantime)) {
+        if (scanned) {
           XrdOucString sizestring;
           eos_info("info=\"rescanned checksum\" size=%s time=%.02f ms rate=%.02f MB/s %s",
                    eos::common::StringConversion::GetReadableSizeString(sizestring, scansize, "B"),
@@ -1438,17 +1472,8 @@ XrdFstOfsFile::verifychecksum()
       }
     } else {
       // This is a read with checksum check, compare with fMD
-      bool isopenforwrite = false;
-      gOFS.OpenFidMutex.Lock();
-
       // if the file is currently open to be written we don't check checksums!
-      if (gOFS.WOpenFid[fsid].count(fileid)) {
-        if (gOFS.WOpenFid[fsid][fileid] > 0) {
-          isopenforwrite = true;
-        }
-      }
-
-      gOFS.OpenFidMutex.UnLock();
+      bool isopenforwrite = gOFS.mOpenFiles.IsOpen(fsid, fileid, true);
 
       if (isopenforwrite) {
         eos_info("(read)  disabling checksum check: file is currently written");
@@ -1885,29 +1910,20 @@ XrdFstOfsFile::close()
 
     if (isRW) {
       if ((isInjection || isCreation || IsChunkedUpload()) && (!rc) &&
-          (gOFS.WOpenFid[fMd->fMd.fsid()][fMd->fMd.fid()] > 1)) {
+          (gOFS.mOpenFiles.GetUseCount(fMd->fMd.fsid(), fMd->fMd.fid(), true) > 1)) {
         // indicate that this file was closed properly and disable further delete on close
         gOFS.WNoDeleteOnCloseFid[fMd->fMd.fsid()][fMd->fMd.fid()] = true;
       }
-
-      gOFS.WOpenFid[fMd->fMd.fsid()][fMd->fMd.fid()]--;
-    } else {
-      gOFS.ROpenFid[fMd->fMd.fsid()][fMd->fMd.fid()]--;
     }
 
-    if (gOFS.WOpenFid[fMd->fMd.fsid()][fMd->fMd.fid()] <= 0) {
-      gOFS.WOpenFid[fMd->fMd.fsid()].erase(fMd->fMd.fid());
-      gOFS.WOpenFid[fMd->fMd.fsid()].resize(0);
+    gOFS.mOpenFiles.Down(fMd->fMd.fsid(), fMd->fMd.fid(), isRW);
+
+    if (!gOFS.mOpenFiles.IsOpen(fMd->fMd.fsid(), fMd->fMd.fid(), true)) {
       // If this was a write of the last writer we had the lock and we release it
       gOFS.WNoDeleteOnCloseFid[fMd->fMd.fsid()].erase(fMd->fMd.fid());
       gOFS.WNoDeleteOnCloseFid[fMd->fMd.fsid()].resize(0);
     }
 
-    if (gOFS.ROpenFid[fMd->fMd.fsid()][fMd->fMd.fid()] <= 0) {
-      gOFS.ROpenFid[fMd->fMd.fsid()].erase(fMd->fMd.fid());
-      gOFS.ROpenFid[fMd->fMd.fsid()].resize(0);
-    }
-
     gOFS.OpenFidMutex.UnLock();
     gettimeofday(&closeTime, &tz);
 
@@ -2180,6 +2196,18 @@ XrdFstOfsFile::readofs(XrdSfsFileOffset fileOffset, char* buffer,
                                   capOpaque->Get("mgm.path") : FName()) : FName());
   }
 
+  AddReadStats(fileOffset, rc);
+  gettimeofday(&lrTime, &tz);
+  AddReadTime();
+  return rc;
+}
+
+//------------------------------------------------------------------------------
+// Account the seeks and the size of a read
+//------------------------------------------------------------------------------
+void
+XrdFstOfsFile::AddReadStats(XrdSfsFileOffset fileOffset, int rc)
+{
   // Account seeks for monitoring
   if (rOffset != static_cast<unsigned long long>(fileOffset)) {
     if (rOffset < static_cast<unsigned long long>(fileOffset)) {
@@ -2212,10 +2240,6 @@ XrdFstOfsFile::readofs(XrdSfsFileOffset fileOffset, char* buffer,
 
     rOffset = fileOffset + rc;
   }
-
-  gettimeofday(&lrTime, &tz);
-  AddReadTime();
-  return rc;
 }
 
 //------------------------------------------------------------------------------
@@ -2907,6 +2931,105 @@ XrdFstOfsFile::fctl(const int cmd, int alen, const char* args,
   return SFS_ERROR;
 }
 
+//------------------------------------------------------------------------------
+// Implementation dependant commands (version 1)
+//------------------------------------------------------------------------------
+int
+XrdFstOfsFile::fctl(const int cmd, const char* args, XrdOucErrInfo& eInfo)
+{
+  if (cmd == SFS_FCTL_GETFD) {
+    // Never hand out the descriptor itself, xrootd would bypass the layout
+    eInfo.setErrCode((GetZeroCopyFd() >= 0) ? (int) SFS_SFIO_FDVAL : -1);
+    return SFS_OK;
+  }
+
+  return XrdOfsFile::fctl(cmd, args, eInfo);
+}
+
+//------------------------------------------------------------------------------
+// Check if zero copy reads are enabled
+//------------------------------------------------------------------------------
+static bool
+ZeroCopyReadEnabled()
+{
+  static const bool sEnabled =
+    (eos::common::EnvTunable::Get("EOS_FST_ZEROCOPY_READ", 0, 0, 1) == 1);
+  return sEnabled;
+}
+
+//------------------------------------------------------------------------------
+// Get the descriptor of the local file for zero copy reads
+//------------------------------------------------------------------------------
+int
+XrdFstOfsFile::GetZeroCopyFd()
+{
+  if (!ZeroCopyReadEnabled() || isRW || !layOut || checkSum || hasBlockXs ||
+      (tpcFlag == kTpcSrcRead) || gOFS.Simulate_IO_read_error ||
+      (eos::common::LayoutId::GetLayoutType(lid) !=
+       eos::common::LayoutId::kPlain)) {
+    return -1;
+  }
+
+  XrdOucErrInfo fd_info;
+
+  if (XrdOfsFile::fctl(SFS_FCTL_GETFD, 0, fd_info)) {
+    return -1;
+  }
+
+  return fd_info.getErrInfo();
+}
+
+//------------------------------------------------------------------------------
+// Account a read served from the zero copy descriptor
+//------------------------------------------------------------------------------
+void
+XrdFstOfsFile::AddZeroCopyRead(XrdSfsFileOffset offset,
+                               XrdSfsFileOffset length)
+{
+  static const XrdSfsFileOffset sMaxReadSize = 4 * 1024 * 1024;
+  gettimeofday(&cTime, &tz);
+
+  // Whole files sent over http are split like the reads of the callbacks
+  while (length > 0) {
+    int nbytes = (length > sMaxReadSize ? sMaxReadSize : length);
+    rCalls++;
+    AddReadStats(offset, nbytes);
+    offset += nbytes;
+    length -= nbytes;
+  }
+
+  gettimeofday(&lrTime, &tz);
+  AddReadTime();
+}
+
+//------------------------------------------------------------------------------
+// Send file data to an xrootd client with sendfile
+//------------------------------------------------------------------------------
+int
+XrdFstOfsFile::SendData(XrdSfsDio* sfDio, XrdSfsFileOffset offset,
+                        XrdSfsXferSize size)
+{
+  int fd = GetZeroCopyFd();
+
+  // Reads crossing the end of the file take the normal path, which returns
+  // the short read
+  if ((fd < 0) || (offset + size > (XrdSfsFileOffset) openSize)) {
+    return SFS_OK;
+  }
+
+  int rc = sfDio->SendFile(fd);
+
+  if (rc < 0) {
+    // The connection is dropped by xrootd
+    eos_err("msg=\"sendfile failed\" offset=%lli size=%i rc=%i", offset, size,
+            rc);
+    return SFS_OK;
+  }
+
+  AddZeroCopyRead(offset, size);
+  return SFS_OK;
+}
+
 //------------------------------------------------------------------------------
 // Get local path
 //------------------------------------------------------------------------------
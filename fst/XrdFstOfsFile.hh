@@ -101,6 +101,54 @@ public:
                    const XrdSecEntity* client = 0);
 
 
+  //----------------------------------------------------------------------------
+  //! Execute special operation on the file (version 1)
+  //!
+  //! @param  cmd    - SFS_FCTL_GETFD is answered with SFS_SFIO_FDVAL when the
+  //!                  reads can be served with sendfile through SendData,
+  //!                  otherwise with -1 so that all the reads go through the
+  //!                  layout. Other commands go to XrdOfsFile.
+  //! @param  args   - specific arguments to cmd
+  //! @param  eInfo  - error information, holds the descriptor value
+  //!
+  //! @return SFS_OK if successful, otherwise SFS_ERROR
+  //----------------------------------------------------------------------------
+  virtual int fctl(const int cmd,
+                   const char* args,
+                   XrdOucErrInfo& eInfo);
+
+  //----------------------------------------------------------------------------
+  //! Send file data to an xrootd client with sendfile
+  //!
+  //! @param sfDio sendfile object of the client connection
+  //! @param offset read offset
+  //! @param size read size
+  //!
+  //! @return SFS_OK either if the data was sent or if a normal read has to be
+  //!         done
+  //----------------------------------------------------------------------------
+  virtual int SendData(XrdSfsDio* sfDio,
+                       XrdSfsFileOffset offset,
+                       XrdSfsXferSize size);
+
+  //----------------------------------------------------------------------------
+  //! Get the descriptor of the local file if its data can be sent as it is on
+  //! disk, without a copy through the layout: reading a plain file with
+  //! EOS_FST_ZEROCOPY_READ=1 and no checksum or block checksum verification
+  //!
+  //! @return file descriptor or -1, it stays owned by the file
+  //----------------------------------------------------------------------------
+  int GetZeroCopyFd();
+
+  //----------------------------------------------------------------------------
+  //! Account a read served from the descriptor returned by GetZeroCopyFd
+  //!
+  //! @param offset read offset
+  //! @param length bytes sent, accounted as reads of at most 4 MB
+  //----------------------------------------------------------------------------
+  void AddZeroCopyRead(XrdSfsFileOffset offset, XrdSfsFileOffset length);
+
+
   //--------------------------------------------------------------------------
   //! Return the Etag
   //--------------------------------------------------------------------------
@@ -503,6 +551,27 @@ private:
   void AddReadTime();
 
 
+  //--------------------------------------------------------------------------
+  //! Account the seeks and the size of a read
+  //!
+  //! @param fileOffset read offset
+  //! @param rc bytes read or error
+  //--------------------------------------------------------------------------
+  void AddReadStats(XrdSfsFileOffset fileOffset, int rc);
+
+  //--------------------------------------------------------------------------
+  //! Complete the checksum of a written file by reading in parallel only the
+  //! ranges which were not written, directly from the local replica
+  //!
+  //! @param scansize number of bytes read
+  //! @param scantime time spent in ms
+  //!
+  //! @return true if successful, false if the layout has no full local
+  //!         replica or the scan failed
+  //--------------------------------------------------------------------------
+  bool ScanMissingChecksum(unsigned long long& scansize, float& scantime);
+
+
   //--------------------------------------------------------------------------
   //! Compute total time to serve vector read requests
   //--------------------------------------------------------------------------
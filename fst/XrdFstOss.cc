@@ -33,6 +33,7 @@
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdOuc/XrdOuca2x.hh"
 #include "XrdSys/XrdSysPlatform.hh"
+#include "common/EnvTunable.hh"
 #include "fst/XrdFstOss.hh"
 #include "fst/checksum/ChecksumPlugins.hh"
 
@@ -63,6 +64,14 @@ EOSFSTNAMESPACE_BEGIN
 // pointer to the current OSS implementation to be used by the oss files
 XrdFstOss* XrdFstSS = 0;
 
+//------------------------------------------------------------------------------
+// Number of threads computing the block checksums of large requests
+//------------------------------------------------------------------------------
+static unsigned int
+BlockXsThreads()
+{
+  return eos::common::EnvTunable::Get("EOS_FST_BLOCKXS_THREADS", 4, 0, 64);
+}
 
 //------------------------------------------------------------------------------
 // Constructor
@@ -71,6 +80,7 @@ XrdFstOss::XrdFstOss() :
   eos::common::LogId(),
   mFdFence(-1),
   mFdLimit(-1),
+  mBlockXsPool(BlockXsThreads()),
   mPrBytes(0),
   mPrActive(0),
   mPrDepth(0),
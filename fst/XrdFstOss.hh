@@ -31,6 +31,7 @@
 /*----------------------------------------------------------------------------*/
 #include "fst/Namespace.hh"
 #include "fst/checksum/CheckSum.hh"
+#include "fst/checksum/BlockXsPool.hh"
 #include "fst/XrdFstOssFile.hh"
 #include "common/Logging.hh"
 #include "common/Namespace.hh"
@@ -284,6 +285,8 @@ private:
   XrdSysRWLock mRWMap; ///< rw lock for the file <-> xs map
   //! map between file names and block xs objects
   std::map< std::string, std::pair<XrdSysRWLock*, CheckSum*> > mMapFileXs;
+  //! pool computing the block checksums of large requests
+  BlockXsPool mBlockXsPool;
 
   // Parameters for pre-reading (i.e. for fadvise)
   long long mPrPBits; ///< page lo order bit mask
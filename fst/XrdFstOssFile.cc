@@ -45,6 +45,7 @@ XrdFstOssFile::XrdFstOssFile(const char* tid) :
   XrdOssDF(),
   eos::common::LogId(),
   mIsRW(false),
+  mLid(0),
   mRWLockXs(0),
   mBlockXs(0)
 {
@@ -95,6 +96,8 @@ XrdFstOssFile::Open(const char* path, int flags, mode_t mode, XrdOucEnv& env)
     lid = atol(val);
   }
 
+  mLid = lid;
+
   if ((val = env.Get("mgm.bookingsize"))) {
     booking_size = strtoull(val, 0, 10);
 
@@ -186,6 +189,7 @@ XrdFstOssFile::Read(void* buffer, off_t offset, size_t length)
   char* ptr_piece;
   char* ptr_buff;
   std::vector<XrdOucIOVec> pieces;
+  std::vector<XrdOucIOVec> read_pieces;
   eos_debug("off=%ji len=%ji", offset, length);
 
   if (fd < 0) {
@@ -208,15 +212,9 @@ XrdFstOssFile::Read(void* buffer, off_t offset, size_t length)
       nread = pread(fd, piece->data, piece->size, piece->offset);
     } while ((nread < 0) && (errno == EINTR));
 
-    if (mBlockXs) {
-      XrdSysRWLockHelper wr_lock(mRWLockXs, 0);
-
-      if ((nread > 0) &&
-          (!mBlockXs->CheckBlockSum(piece->offset, piece->data, nread))) {
-        eos_err("error=read block-xs error offset=%zu, length=%zu",
-                piece->offset, piece->size);
-        return -EIO;
-      }
+    if (mBlockXs && (nread > 0)) {
+      XrdOucIOVec read_piece = {piece->offset, (int) nread, 0, piece->data};
+      read_pieces.push_back(read_piece);
     }
 
     if (nread >= 0) {
@@ -249,6 +247,11 @@ XrdFstOssFile::Read(void* buffer, off_t offset, size_t length)
     return -EIO;
   }
 
+  // Verify all the pieces at once so that large reads use the block xs pool
+  if (mBlockXs && !CheckBlockXs(read_pieces)) {
+    return -EIO;
+  }
+
   return (retval >= 0 ? retval : static_cast<ssize_t>(-errno));
 }
 
@@ -304,6 +307,171 @@ XrdFstOssFile::AlignBuffer(void* buffer, off_t offset, size_t length)
   return resp;
 }
 
+//------------------------------------------------------------------------------
+// Verify the block checksums of pieces read from the file
+//------------------------------------------------------------------------------
+bool
+XrdFstOssFile::CheckBlockXs(const std::vector<XrdOucIOVec>& pieces)
+{
+  size_t blk_size = eos::common::LayoutId::OssXsBlockSize;
+  size_t nblocks = 0;
+
+  for (auto piece = pieces.begin(); piece != pieces.end(); ++piece) {
+    nblocks += piece->size / blk_size;
+  }
+
+  if (!XrdFstSS->mBlockXsPool.IsParallel(nblocks)) {
+    XrdSysRWLockHelper wr_lock(mRWLockXs, 0);
+
+    for (auto piece = pieces.begin(); piece != pieces.end(); ++piece) {
+      if (!mBlockXs->CheckBlockSum(piece->offset, piece->data, piece->size)) {
+        eos_err("error=read block-xs error offset=%lli, length=%i",
+                piece->offset, piece->size);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // Compute the checksums outside of the lock, several blocks in parallel
+  size_t xs_len = mBlockXs->GetCheckSumLen();
+  std::vector<char> sums(nblocks * xs_len);
+  std::vector<BlockXsPool::Blocks> work;
+  char* ptr_sums = sums.data();
+
+  for (auto piece = pieces.begin(); piece != pieces.end(); ++piece) {
+    BlockXsPool::Blocks blocks = {piece->data, piece->size / blk_size, ptr_sums};
+    work.push_back(blocks);
+    ptr_sums += blocks.mNumBlocks * xs_len;
+  }
+
+  if (!XrdFstSS->mBlockXsPool.Compute(mLid, blk_size, work)) {
+    eos_err("error=unable to compute block-xs lid=%lu", mLid);
+    return false;
+  }
+
+  XrdSysRWLockHelper wr_lock(mRWLockXs, 0);
+
+  for (size_t i = 0; i < pieces.size(); i++) {
+    if (!mBlockXs->CheckBlockSums(pieces[i].offset, work[i].mSums,
+                                  work[i].mNumBlocks)) {
+      eos_err("error=read block-xs error offset=%lli, length=%i",
+              pieces[i].offset, pieces[i].size);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Update the block checksums for a piece written to the file
+//------------------------------------------------------------------------------
+void
+XrdFstOssFile::AddBlockXs(const char* buffer, off_t offset, size_t length)
+{
+  off_t blk_size = eos::common::LayoutId::OssXsBlockSize;
+  off_t align_start = ((offset + blk_size - 1) / blk_size) * blk_size;
+  off_t align_end = ((offset + (off_t) length) / blk_size) * blk_size;
+  size_t nblocks = ((align_end > align_start) ?
+                    (align_end - align_start) / blk_size : 0);
+
+  if (!XrdFstSS->mBlockXsPool.IsParallel(nblocks)) {
+    XrdSysRWLockHelper wr_lock(mRWLockXs, 0);
+    mBlockXs->AddBlockSum(offset, buffer, length);
+    return;
+  }
+
+  std::vector<char> sums(nblocks * mBlockXs->GetCheckSumLen());
+  std::vector<BlockXsPool::Blocks> work;
+  BlockXsPool::Blocks blocks = {buffer + (align_start - offset), nblocks,
+                                sums.data()
+                               };
+  work.push_back(blocks);
+  bool computed = XrdFstSS->mBlockXsPool.Compute(mLid, blk_size, work);
+  XrdSysRWLockHelper wr_lock(mRWLockXs, 0);
+
+  if (!computed) {
+    mBlockXs->AddBlockSum(offset, buffer, length);
+    return;
+  }
+
+  // The partial blocks at the edges only wipe their checksum
+  if (align_start > offset) {
+    mBlockXs->AddBlockSum(offset, buffer, align_start - offset);
+  }
+
+  mBlockXs->AddBlockSums(align_start, sums.data(), nblocks);
+
+  if (offset + (off_t) length > align_end) {
+    mBlockXs->AddBlockSum(align_end, buffer + (align_end - offset),
+                          offset + length - align_end);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Read an element of a vector read deferring the check of its full blocks
+//------------------------------------------------------------------------------
+ssize_t
+XrdFstOssFile::ReadDeferXs(const XrdOucIOVec& piece,
+                           std::vector<XrdOucIOVec>& aligned)
+{
+  off_t blk_size = eos::common::LayoutId::OssXsBlockSize;
+  off_t chunk_end = piece.offset + piece.size;
+  off_t align_start = ((piece.offset + blk_size - 1) / blk_size) * blk_size;
+  off_t align_end = (chunk_end / blk_size) * blk_size;
+
+  if (align_start >= align_end) {
+    return Read(piece.data, piece.offset, piece.size);
+  }
+
+  ssize_t retval = 0;
+  ssize_t nread;
+
+  if (align_start > piece.offset) {
+    nread = Read(piece.data, piece.offset, align_start - piece.offset);
+
+    if (nread != align_start - piece.offset) {
+      return nread;
+    }
+
+    retval += nread;
+  }
+
+  char* ptr_buff = piece.data + (align_start - piece.offset);
+
+  do {
+    nread = pread(fd, ptr_buff, align_end - align_start, align_start);
+  } while ((nread < 0) && (errno == EINTR));
+
+  if (nread < 0) {
+    eos_err("error=failed read offset=%lli, length=%lli", (long long) align_start,
+            (long long)(align_end - align_start));
+    return -EIO;
+  }
+
+  if (nread) {
+    XrdOucIOVec read_piece = {(long long) align_start, (int) nread, 0, ptr_buff};
+    aligned.push_back(read_piece);
+  }
+
+  retval += nread;
+
+  if ((nread == align_end - align_start) && (align_end < chunk_end)) {
+    nread = Read(piece.data + (align_end - piece.offset), align_end,
+                 chunk_end - align_end);
+
+    if (nread < 0) {
+      return nread;
+    }
+
+    retval += nread;
+  }
+
+  return retval;
+}
+
 //------------------------------------------------------------------------------
 // Read raw
 //------------------------------------------------------------------------------
@@ -323,6 +491,21 @@ XrdFstOssFile::ReadV(XrdOucIOVec* readV, int n)
 {
   ssize_t rdsz;
   ssize_t totBytes = 0;
+  std::vector<XrdOucIOVec> aligned;
+  bool defer_xs = false;
+
+  if (mBlockXs) {
+    // Large vector reads verify their full blocks together at the end
+    long long totSize = 0;
+
+    for (int i = 0; i < n; i++) {
+      totSize += readV[i].size;
+    }
+
+    defer_xs = XrdFstSS->mBlockXsPool.IsParallel(totSize /
+               eos::common::LayoutId::OssXsBlockSize);
+  }
+
 #if defined(__linux__) && defined(HAVE_ATOMICS)
   long long begOff, endOff, begLst = -1, endLst = -1;
   int nPR = n;
@@ -358,7 +541,8 @@ XrdFstOssFile::ReadV(XrdOucIOVec* readV, int n)
     // Use normal block read since it also does the blockxs and we have the
     // guarantee that the previous advice was issued for the full block to
     // be read even with the 4K alignment since fadvice does this on its own
-    rdsz = Read(readV[i].data, readV[i].offset, readV[i].size);
+    rdsz = (defer_xs ? ReadDeferXs(readV[i], aligned) :
+            Read(readV[i].data, readV[i].offset, readV[i].size));
 
     if (rdsz < 0 || rdsz != readV[i].size) {
       totBytes = (rdsz < 0 ? -errno : -ESPIPE);
@@ -387,6 +571,10 @@ XrdFstOssFile::ReadV(XrdOucIOVec* readV, int n)
 #endif
   }
 
+  if (defer_xs && (totBytes >= 0) && !CheckBlockXs(aligned)) {
+    totBytes = -EIO;
+  }
+
 // All done, return bytes read.
 #if defined(__linux__)  && defined(HAVE_ATOMICS)
 
@@ -441,8 +629,7 @@ XrdFstOssFile::Write(const void* buffer, off_t offset, size_t length)
   }
 
   if (mBlockXs) {
-    XrdSysRWLockHelper wr_lock(mRWLockXs, 0);
-    mBlockXs->AddBlockSum(offset, static_cast<const char*>(buffer), length);
+    AddBlockXs(static_cast<const char*>(buffer), offset, length);
   }
 
   do {
@@ -197,6 +197,7 @@ private:
  
   XrdOucString mPath; ///< path of the file
   bool mIsRW; ///< mark if opened for rw operations
+  unsigned long mLid; ///< layout id of the file
   XrdSysRWLock* mRWLockXs; ///< rw lock for the block xs
   CheckSum* mBlockXs; ///< block xs object
   char* mPieceStart; ///< start piece aligned to the blockxs offset
@@ -216,6 +217,46 @@ private:
   //--------------------------------------------------------------------------
   std::vector<XrdOucIOVec> AlignBuffer(void* buffer, off_t offset, size_t length);
 
+
+  //--------------------------------------------------------------------------
+  //! Verify the block checksums of pieces read from the file. The checksums
+  //! of large requests are computed in parallel by the pool of the oss and
+  //! only compared under the lock of the shared block checksum map.
+  //!
+  //! @param pieces block aligned pieces, the size being the bytes read
+  //!
+  //! @return true if all the full blocks match, otherwise false
+  //!
+  //--------------------------------------------------------------------------
+  bool CheckBlockXs(const std::vector<XrdOucIOVec>& pieces);
+
+
+  //--------------------------------------------------------------------------
+  //! Update the block checksums for a piece written to the file, computed
+  //! in parallel for large requests
+  //!
+  //! @param buffer data written
+  //! @param offset file offset
+  //! @param length write length
+  //!
+  //--------------------------------------------------------------------------
+  void AddBlockXs(const char* buffer, off_t offset, size_t length);
+
+
+  //--------------------------------------------------------------------------
+  //! Read an element of a vector read whose full blocks are verified later
+  //! on together with the ones of the other elements. The unaligned edges
+  //! are read and verified right away.
+  //!
+  //! @param piece element of the vector read
+  //! @param aligned collects the pieces to be verified
+  //!
+  //! @return number of bytes read, or -errno
+  //!
+  //--------------------------------------------------------------------------
+  ssize_t ReadDeferXs(const XrdOucIOVec& piece,
+                      std::vector<XrdOucIOVec>& aligned);
+
 };
 
 EOSFSTNAMESPACE_END
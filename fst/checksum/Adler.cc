@@ -23,9 +23,21 @@
 
 /*----------------------------------------------------------------------------*/
 #include "fst/checksum/Adler.hh"
+#include "fst/checksum/ChecksumSimd.hh"
+#include "common/BufferPool.hh"
+#include <sys/time.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 EOSFSTNAMESPACE_BEGIN
 
+/*----------------------------------------------------------------------------*/
+// Size of the ranges read in parallel by ScanMissing
+static const off_t sScanRangeSize = 16 * 1024 * 1024;
+// Size of the reads done by ScanMissing
+static const size_t sScanBufferSize = 1024 * 1024;
+
 /*----------------------------------------------------------------------------*/
 bool
 Adler::Add (const char* buffer, size_t length, off_t offset)
@@ -33,41 +45,221 @@ Adler::Add (const char* buffer, size_t length, off_t offset)
   if (offset != adleroffset)
     needsRecalculation = true;
 
-  adler = adler32(0L, Z_NULL, 0);
-  Chunk currChunk;
-  adler = adler32(adler, (const Bytef*) buffer, length);
   adleroffset = offset + length;
   if (adleroffset > maxoffset)
   {
     maxoffset = adleroffset;
   }
+
+  if (!length)
+    return true;
+
+  Chunk currChunk;
   currChunk.offset = offset;
   currChunk.length = length;
-  currChunk.adler = adler;
-
-  map = AddElementToMap(map, currChunk);
+  currChunk.adler = adler32Update(adler32(0L, Z_NULL, 0), buffer, length);
+  AddChunk(currChunk);
 
+  // value of the chunk the data was merged into
+  IterMap iter = map.upper_bound(offset);
+  --iter;
+  adler = iter->second.adler;
   return true;
 }
 
 /*----------------------------------------------------------------------------*/
-MapChunks&
-Adler::AddElementToMap (MapChunks& map, Chunk& chunk)
+void
+Adler::AddChunk (Chunk chunk)
 {
   off_t offEndChunk = chunk.offset + chunk.length;
-  IterMap iter = map.find(offEndChunk);
+  IterMap iter = map.lower_bound(chunk.offset);
 
-  if (iter != map.end())
+  if (iter != map.begin())
   {
+    IterMap prev = iter;
+    --prev;
+
+    if ((off_t) (prev->second.offset + prev->second.length) > chunk.offset)
+      iter = prev;
+  }
+
+  // drop the overlapped chunks, the missing parts of them are read again
+  while ((iter != map.end()) && (iter->first < offEndChunk))
+  {
+    map.erase(iter++);
+  }
+
+  // merge with the chunk ending where this one starts
+  if (iter != map.begin())
+  {
+    IterMap prev = iter;
+    --prev;
+
+    if ((off_t) (prev->second.offset + prev->second.length) == chunk.offset)
+    {
+      chunk.adler = adler32_combine(prev->second.adler, chunk.adler,
+                                    chunk.length);
+      chunk.offset = prev->second.offset;
+      chunk.length += prev->second.length;
+      map.erase(prev);
+    }
+  }
+
+  // merge with the chunk starting where this one ends
+  if ((iter != map.end()) && (iter->first == offEndChunk))
+  {
+    chunk.adler = adler32_combine(chunk.adler, iter->second.adler,
+                                  iter->second.length);
+    chunk.length += iter->second.length;
     map.erase(iter);
-    map.insert(std::pair<off_t, Chunk > (offEndChunk, chunk));
+  }
+
+  map[chunk.offset] = chunk;
+}
+
+/*----------------------------------------------------------------------------*/
+std::vector<Chunk>
+Adler::GetMissingRanges (off_t size)
+{
+  std::vector<Chunk> ranges;
+  off_t offset = 0;
+
+  for (IterMap iter = map.begin(); (iter != map.end()) && (offset < size); ++iter)
+  {
+    if (iter->first > offset)
+    {
+      Chunk range;
+      range.offset = offset;
+      range.length = std::min(iter->first, size) - offset;
+      range.adler = 0;
+      ranges.push_back(range);
+    }
+
+    offset = iter->second.offset + iter->second.length;
+  }
+
+  if (offset < size)
+  {
+    Chunk range;
+    range.offset = offset;
+    range.length = size - offset;
+    range.adler = 0;
+    ranges.push_back(range);
+  }
+
+  return ranges;
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+Adler::ScanMissing (ReadCallBack rcb, off_t filesize,
+                    unsigned long long& scansize, float& scantime,
+                    int nthreads)
+{
+  struct timeval opentime;
+  struct timeval currenttime;
+  scansize = 0;
+  scantime = 0;
+  gettimeofday(&opentime, 0);
+
+  // chunks past the end belong to a previous, longer version of the file
+  if (maxoffset > filesize)
+    Reset();
+
+  // cut the missing ranges in pieces which can be read in parallel
+  std::vector<Chunk> pieces;
+  std::vector<Chunk> ranges = GetMissingRanges(filesize);
+
+  for (size_t i = 0; i < ranges.size(); ++i)
+  {
+    for (off_t offset = 0; offset < (off_t) ranges[i].length; offset += sScanRangeSize)
+    {
+      Chunk piece;
+      piece.offset = ranges[i].offset + offset;
+      piece.length = std::min((off_t) ranges[i].length - offset, sScanRangeSize);
+      piece.adler = adler32(0L, Z_NULL, 0);
+      pieces.push_back(piece);
+    }
+  }
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  auto scan = [&]() {
+    ReadCallBack cb = rcb;
+    char* buffer = eos::common::BufferPool::GetInstance().Allocate(sScanBufferSize);
+
+    if (!buffer)
+    {
+      failed = true;
+      return;
+    }
+
+    for (size_t i = next++; (i < pieces.size()) && !failed; i = next++)
+    {
+      Chunk& piece = pieces[i];
+
+      for (size_t done = 0; done < piece.length;)
+      {
+        cb.data.offset = piece.offset + done;
+        cb.data.buffer = buffer;
+        cb.data.size = std::min(sScanBufferSize, piece.length - done);
+        int nread = cb.call(&cb.data);
+
+        // a short file is a failure as well, the ranges come from its size
+        if (nread <= 0)
+        {
+          failed = true;
+          break;
+        }
+
+        piece.adler = adler32Update(piece.adler, buffer, nread);
+        done += nread;
+      }
+    }
+
+    eos::common::BufferPool::GetInstance().Release(buffer, sScanBufferSize);
+  };
+
+  size_t nworkers = std::min(pieces.size(), (size_t) std::max(nthreads, 1));
+
+  if (nworkers <= 1)
+  {
+    scan();
   }
   else
   {
-    map.insert(std::pair<off_t, Chunk > (offEndChunk, chunk));
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < nworkers; ++i)
+    {
+      workers.emplace_back(scan);
+    }
+
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+      workers[i].join();
+    }
   }
 
-  return map;
+  gettimeofday(&currenttime, 0);
+  scantime = (((currenttime.tv_sec - opentime.tv_sec) * 1000.0) +
+              ((currenttime.tv_usec - opentime.tv_usec) / 1000.0));
+
+  if (failed)
+    return false;
+
+  for (size_t i = 0; i < pieces.size(); ++i)
+  {
+    AddChunk(pieces[i]);
+    scansize += pieces[i].length;
+  }
+
+  adleroffset = filesize;
+  maxoffset = filesize;
+  needsRecalculation = false;
+  finalized = false;
+  Finalize();
+  return !needsRecalculation;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -91,98 +283,31 @@ Adler::GetBinChecksum (int &len)
 /*----------------------------------------------------------------------------*/
 
 /* compute the adler value of the map if we have the full map
- * (starts from 0 and there are no holes)
+ * (a single chunk starting at 0 and reaching the max offset)
  */
 void
 Adler::ValidateAdlerMap ()
 {
-  unsigned int value;
   adler = adler32(0L, Z_NULL, 0);
 
   if (map.begin() == map.end())
   {
-    adler = adler32(0L, Z_NULL, 0);
+    //we have no chunk
     return;
   }
 
-  IterMap iter1 = map.begin();
-  IterMap iter2 = iter1;
-
-  value = iter1->second.adler;
+  IterMap iter = map.begin();
 
-  IterMap iter3;
-  //  for (iter3= map.begin(); iter3!= map.end(); iter3++) {
-  //    fprintf(stderr,"ADLER VALIDATE %llu %llu %llu %x\n", iter3->first,iter3->second.offset, iter3->second.length, iter3->second.adler);
-  //  } 
-
-  if (iter1->second.offset != 0)
+  if ((map.size() != 1) || (iter->second.offset != 0) ||
+      ((off_t) iter->second.length != maxoffset))
   {
-    // the first chunk is not at the beginning
+    // there are holes or there was probably some overwrite
     needsRecalculation = true;
-    adler = adler32(0L, Z_NULL, 0);
-    return;
-  }
-
-  if (map.begin() == map.end())
-  {
-    //we have no chunk
-    adler = adler32(0L, Z_NULL, 0);
     return;
   }
 
   needsRecalculation = false;
-
-  iter2++;
-
-  if (iter2 == map.end())
-  {
-    if ((iter1->first) != maxoffset)
-    {
-      // there was probably some overwrite
-      needsRecalculation = true;
-    }
-    else
-    {
-      if (iter1->second.offset != 0)
-      {
-        needsRecalculation = true;
-      }
-    }
-    //we have one chunk
-    adler = value;
-    return;
-  }
-
-  off_t appliedoffset = 0;
-
-  for (; iter2 != map.end(); iter1++, iter2++)
-  {
-    appliedoffset = iter2->first;
-    value = adler32_combine(value, iter2->second.adler, iter2->second.length);
-    if (iter1->first != iter2->second.offset)
-    {
-      needsRecalculation = true;
-      break;
-    }
-  }
-
-  if (appliedoffset != maxoffset)
-  {
-    // there was probably some overwrite
-    needsRecalculation = true;
-  }
-
-  if (!needsRecalculation)
-  {
-    adler = value;
-  }
-  else
-  {
-    adler = adler32(0L, Z_NULL, 0);
-  }
-
-  fflush(stdout);
-  return;
+  adler = iter->second.adler;
 }
 
 /*----------------------------------------------------------------------------*/
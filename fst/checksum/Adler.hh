@@ -30,26 +30,30 @@
 #include "XrdOuc/XrdOucString.hh"
 #include <zlib.h>
 #include <map>
+#include <vector>
 
 EOSFSTNAMESPACE_BEGIN
 
-struct ltoff_t {
-
-  bool operator()(off_t s1, off_t s2) const
-  {
-    return (s1 < s2);
-  }
-};
-
+//------------------------------------------------------------------------------
+//! Contiguous range of the file with its adler value
+//------------------------------------------------------------------------------
 typedef struct {
   off_t offset;
   size_t length;
   unsigned int adler;
 } Chunk;
 
-typedef std::map<off_t, Chunk, ltoff_t> MapChunks;
-typedef std::map<off_t, Chunk, ltoff_t>::iterator IterMap;
-
+//! Disjoint chunks indexed by their start offset, adjacent chunks are merged
+typedef std::map<off_t, Chunk> MapChunks;
+typedef std::map<off_t, Chunk>::iterator IterMap;
+
+//------------------------------------------------------------------------------
+//! Adler checksum accepting the data in any order. The chunks are kept as
+//! disjoint intervals and merged with adler32_combine as soon as they touch,
+//! so a file written completely ends up as a single chunk starting at 0.
+//! Only the ranges missing at the end have to be read again and since the
+//! adler values of ranges can be combined, they are read in parallel.
+//------------------------------------------------------------------------------
 class Adler : public CheckSum
 {
 private:
@@ -70,7 +74,21 @@ public:
   }
 
   bool Add(const char* buffer, size_t length, off_t offset);
-  MapChunks& AddElementToMap(MapChunks& map, Chunk& chunk);
+
+  //----------------------------------------------------------------------------
+  //! Add a chunk to the map, merging it with its neighbours. The chunks it
+  //! overlaps are dropped since their values don't match the data anymore.
+  //----------------------------------------------------------------------------
+  void AddChunk(Chunk chunk);
+
+  //----------------------------------------------------------------------------
+  //! Get the ranges of [0, size) which are not covered by a chunk
+  //----------------------------------------------------------------------------
+  std::vector<Chunk> GetMissingRanges(off_t size);
+
+  virtual bool ScanMissing(ReadCallBack rcb, off_t filesize,
+                           unsigned long long& scansize, float& scantime,
+                           int nthreads = 1);
 
   off_t
   GetLastOffset()
@@ -110,7 +128,7 @@ public:
   void
   ResetInit(off_t offsetInit, size_t lengthInit, const char* checksumInitHex)
   {
-    Chunk currChunk;
+    map.clear();
     maxoffset = 0;
     adleroffset = offsetInit + lengthInit;
 
@@ -119,21 +137,18 @@ public:
       return;
     }
 
-    int checksumInitBin = strtol(checksumInitHex, 0, 16);
+    // if a file is truncated we get 0,0,<some checksum> => nothing to preset
+    adler = adler32(0L, Z_NULL, 0);
 
-    // if a file is truncated we get 0,0,<some checksum => reset to 0
     if (lengthInit != 0) {
-      adler = checksumInitBin;
-    } else {
-      adler = adler32(0L, Z_NULL, 0);
+      Chunk currChunk;
+      currChunk.offset = offsetInit;
+      currChunk.length = lengthInit;
+      currChunk.adler = strtoul(checksumInitHex, 0, 16);
+      AddChunk(currChunk);
+      adler = currChunk.adler;
     }
 
-    fprintf(stderr, "adler is %x\n", adler);
-    currChunk.offset = offsetInit;
-    currChunk.length = lengthInit;
-    currChunk.adler = adler;
-    map.clear();
-    map = AddElementToMap(map, currChunk);
     maxoffset = (offsetInit + lengthInit);
     needsRecalculation = false;
   }
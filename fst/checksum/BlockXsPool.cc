@@ -0,0 +1,200 @@
+//------------------------------------------------------------------------------
+// File: BlockXsPool.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/checksum/BlockXsPool.hh"
+#include "fst/checksum/ChecksumPlugins.hh"
+#include <algorithm>
+#include <cstring>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+BlockXsPool::BlockXsPool(unsigned int nthreads):
+  mNumThreads(nthreads),
+  mStop(false)
+{
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+BlockXsPool::~BlockXsPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mCond.notify_all();
+
+  for (auto& thread : mThreads) {
+    thread.join();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Loop of the pool threads
+//------------------------------------------------------------------------------
+void
+BlockXsPool::Worker()
+{
+  while (true) {
+    std::shared_ptr<Batch> batch;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mCond.wait(lock, [this]() {
+        return (mStop || !mQueue.empty());
+      });
+
+      if (mStop) {
+        return;
+      }
+
+      batch = mQueue.front();
+      mQueue.pop_front();
+    }
+    // The batch may be complete already, then there is nothing left to run
+    Run(*batch);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Run the tasks of a batch until none is left
+//------------------------------------------------------------------------------
+void
+BlockXsPool::Run(Batch& batch)
+{
+  std::unique_ptr<CheckSum> xs;
+
+  while (true) {
+    size_t index;
+    {
+      std::lock_guard<std::mutex> lock(batch.mMutex);
+
+      if (batch.mNext >= batch.mTasks.size()) {
+        return;
+      }
+
+      index = batch.mNext++;
+    }
+
+    // Each thread uses its own checksum object, the block checksum object of
+    // the file is shared and holds the map
+    if (!xs) {
+      xs.reset(ChecksumPlugins::GetChecksumObject(batch.mLid, true));
+    }
+
+    const Blocks& task = batch.mTasks[index];
+    bool ok = (xs != nullptr);
+
+    if (ok) {
+      int len = xs->GetCheckSumLen();
+
+      for (size_t i = 0; i < task.mNumBlocks; i++) {
+        int bin_len = 0;
+        xs->Reset();
+        xs->Add(task.mData + i * batch.mBlockSize, batch.mBlockSize, 0);
+        xs->Finalize();
+        memcpy(task.mSums + i * len, xs->GetBinChecksum(bin_len), len);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(batch.mMutex);
+
+    if (!ok) {
+      batch.mFailed = true;
+    }
+
+    if (++batch.mDone == batch.mTasks.size()) {
+      batch.mCond.notify_all();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Compute the checksums of a list of blocks and wait for the result
+//------------------------------------------------------------------------------
+bool
+BlockXsPool::Compute(unsigned long lid, size_t blocksize,
+                     const std::vector<Blocks>& work)
+{
+  std::unique_ptr<CheckSum> probe(ChecksumPlugins::GetChecksumObject(lid,
+                                  true));
+
+  if (!probe) {
+    return false;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->mLid = lid;
+  batch->mBlockSize = blocksize;
+  batch->mNext = batch->mDone = 0;
+  batch->mFailed = false;
+  size_t len = probe->GetCheckSumLen();
+
+  for (const auto& blocks : work) {
+    for (size_t i = 0; i < blocks.mNumBlocks; i += sTaskBlocks) {
+      Blocks task = {blocks.mData + i * blocksize,
+                     std::min(sTaskBlocks, blocks.mNumBlocks - i),
+                     blocks.mSums + i * len
+                    };
+      batch->mTasks.push_back(task);
+    }
+  }
+
+  if (batch->mTasks.empty()) {
+    return true;
+  }
+
+  size_t nhelpers = std::min((size_t) mNumThreads, batch->mTasks.size() - 1);
+
+  if (nhelpers) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mThreads.empty()) {
+      for (unsigned int i = 0; i < mNumThreads; i++) {
+        mThreads.push_back(std::thread(&BlockXsPool::Worker, this));
+      }
+    }
+
+    for (size_t i = 0; i < nhelpers; i++) {
+      mQueue.push_back(batch);
+    }
+  }
+
+  if (nhelpers == 1) {
+    mCond.notify_one();
+  } else if (nhelpers) {
+    mCond.notify_all();
+  }
+
+  Run(*batch);
+  std::unique_lock<std::mutex> lock(batch->mMutex);
+  batch->mCond.wait(lock, [&batch]() {
+    return (batch->mDone == batch->mTasks.size());
+  });
+  return !batch->mFailed;
+}
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//! @file BlockXsPool.hh
+//! @author agent
+//! @brief Pool of threads computing block checksums of large requests
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_BLOCKXSPOOL_HH__
+#define __EOSFST_BLOCKXSPOOL_HH__
+
+#include "fst/Namespace.hh"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class computing the checksums of many full blocks in parallel. The
+//! computation doesn't touch the block checksum map of the file, the caller
+//! stores or verifies the resulting checksums under the lock of the map, so
+//! the map stays shared between all the readers and writers of a file while
+//! the CPU intensive part runs outside of its lock. The calling thread takes
+//! part in the computation, the pool threads are started on first use.
+//------------------------------------------------------------------------------
+class BlockXsPool
+{
+public:
+  //! Consecutive full blocks to be checksummed
+  struct Blocks {
+    const char* mData; ///< Data of the first block
+    size_t mNumBlocks; ///< Number of blocks
+    char* mSums; ///< Output, checksum length bytes per block
+  };
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param nthreads number of pool threads, 0 to compute on the caller only
+  //----------------------------------------------------------------------------
+  BlockXsPool(unsigned int nthreads);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  virtual ~BlockXsPool();
+
+  //----------------------------------------------------------------------------
+  //! Tell if a request is large enough to be computed in parallel
+  //!
+  //! @param nblocks number of full blocks of the request
+  //----------------------------------------------------------------------------
+  bool IsParallel(size_t nblocks) const
+  {
+    return (mNumThreads && (nblocks >= 2 * sTaskBlocks));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Compute the checksums of a list of blocks and wait for the result
+  //!
+  //! @param lid layout id giving the block checksum type
+  //! @param blocksize block size
+  //! @param work blocks to be checksummed
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool Compute(unsigned long lid, size_t blocksize,
+               const std::vector<Blocks>& work);
+
+private:
+  //! Number of blocks checksummed by one task
+  static const size_t sTaskBlocks = 256;
+
+  //! Tasks of one Compute call
+  struct Batch {
+    unsigned long mLid; ///< Layout id
+    size_t mBlockSize; ///< Block size
+    std::vector<Blocks> mTasks; ///< Tasks of at most sTaskBlocks blocks
+    std::mutex mMutex; ///< Mutex protecting the members below
+    std::condition_variable mCond; ///< Signalled when all tasks are done
+    size_t mNext; ///< Index of the next task to run
+    size_t mDone; ///< Number of tasks done
+    bool mFailed; ///< Mark if any task failed
+  };
+
+  unsigned int mNumThreads; ///< Number of pool threads
+  std::mutex mMutex; ///< Mutex protecting the queue and the threads
+  std::condition_variable mCond; ///< Signalled when a batch is queued
+  std::deque<std::shared_ptr<Batch>> mQueue; ///< Batches waiting for help
+  std::vector<std::thread> mThreads; ///< Pool threads
+  bool mStop; ///< Mark if the pool threads have to exit
+
+  //----------------------------------------------------------------------------
+  //! Loop of the pool threads
+  //----------------------------------------------------------------------------
+  void Worker();
+
+  //----------------------------------------------------------------------------
+  //! Run the tasks of a batch until none is left
+  //----------------------------------------------------------------------------
+  static void Run(Batch& batch);
+};
+
+EOSFSTNAMESPACE_END
+
+#endif // __EOSFST_BLOCKXSPOOL_HH__
@@ -27,6 +27,7 @@
 /*----------------------------------------------------------------------------*/
 #include "fst/Namespace.hh"
 #include "fst/checksum/CheckSum.hh"
+#include "fst/checksum/ChecksumSimd.hh"
 /*----------------------------------------------------------------------------*/
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucString.hh"
@@ -64,7 +65,7 @@ public:
       needsRecalculation = true;
       return false;
     }
-    crcsum = crc32(crcsum, (const Bytef*) buffer, length);
+    crcsum = crc32Update(crcsum, buffer, length);
     crc32offset += length;
     return true;
   }
@@ -31,6 +31,7 @@
 #include "common/Path.hh"
 #include "common/Logging.hh"
 #include "common/CloExec.hh"
+#include "common/BufferPool.hh"
 #include "XrdSys/XrdSysTimer.hh"
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -113,7 +114,8 @@ CheckSum::ScanFile(int fd, unsigned long long& scansize, float& scantime,
   Reset();
   int nread = 0;
   off_t offset = 0;
-  char* buffer = (char*) malloc(buffersize);
+  char* buffer = eos::common::BufferPool::GetInstance().Allocate(
+                     buffersize);
 
   if (!buffer) {
     return false;
@@ -124,7 +126,7 @@ CheckSum::ScanFile(int fd, unsigned long long& scansize, float& scantime,
     nread = pread(fd, buffer, buffersize, offset);
 
     if (nread < 0) {
-      free(buffer);
+      eos::common::BufferPool::GetInstance().Release(buffer, buffersize);
       return false;
     }
 
@@ -152,7 +154,7 @@ CheckSum::ScanFile(int fd, unsigned long long& scansize, float& scantime,
                 currenttime.tv_usec - opentime.tv_usec) / 1000.0));
   scansize = (unsigned long long) offset;
   Finalize();
-  free(buffer);
+  eos::common::BufferPool::GetInstance().Release(buffer, buffersize);
   return true;
 }
 
@@ -176,7 +178,8 @@ CheckSum::ScanFile(ReadCallBack rcb, unsigned long long& scansize,
   //move at the right location in the  file
   int nread = 0;
   off_t offset = 0;
-  char* buffer = (char*) malloc(buffersize);
+  char* buffer = eos::common::BufferPool::GetInstance().Allocate(
+                     buffersize);
 
   if (!buffer) {
     return false;
@@ -190,7 +193,7 @@ CheckSum::ScanFile(ReadCallBack rcb, unsigned long long& scansize,
     nread = rcb.call(&rcb.data);
 
     if (nread < 0) {
-      free(buffer);
+      eos::common::BufferPool::GetInstance().Release(buffer, buffersize);
       return false;
     }
 
@@ -217,7 +220,7 @@ CheckSum::ScanFile(ReadCallBack rcb, unsigned long long& scansize,
                 currenttime.tv_usec - opentime.tv_usec) / 1000.0));
   scansize = (unsigned long long) offset;
   Finalize();
-  free(buffer);
+  eos::common::BufferPool::GetInstance().Release(buffer, buffersize);
   return true;
 }
 
@@ -253,7 +256,8 @@ CheckSum::ScanFile(const char* path, off_t offsetInit, size_t lengthInit,
 
   int nread = 0;
   off_t offset = 0;
-  char* buffer = (char*) malloc(buffersize);
+  char* buffer = eos::common::BufferPool::GetInstance().Allocate(
+                     buffersize);
 
   if (!buffer) {
     (void) close(fd);
@@ -266,7 +270,7 @@ CheckSum::ScanFile(const char* path, off_t offsetInit, size_t lengthInit,
 
     if (nread < 0) {
       close(fd);
-      free(buffer);
+      eos::common::BufferPool::GetInstance().Release(buffer, buffersize);
       return false;
     }
 
@@ -292,7 +296,7 @@ CheckSum::ScanFile(const char* path, off_t offsetInit, size_t lengthInit,
   scansize = (unsigned long long) offset;
   Finalize();
   close(fd);
-  free(buffer);
+  eos::common::BufferPool::GetInstance().Release(buffer, buffersize);
   return true;
 }
 
@@ -683,14 +687,21 @@ CheckSum::CheckBlockSum(off_t offset, const char* buffer, size_t len)
 /*----------------------------------------------------------------------------*/
 bool
 CheckSum::SetXSMap(off_t offset)
+{
+  int len = 0;
+  return SetXSMap(offset, GetBinChecksum(len));
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+CheckSum::SetXSMap(off_t offset, const char* cks)
 {
   if (!ChangeMap((offset + BlockSize), false)) {
     return false;
   }
 
   off_t mapoffset = (offset / BlockSize) * GetCheckSumLen();
-  int len = 0;
-  const char* cks = GetBinChecksum(len);
+  int len = GetCheckSumLen();
 
   if (!sigsetjmp(sj_env, 1)) {
     for (int i = 0; i < len; i++) {
@@ -711,6 +722,14 @@ CheckSum::SetXSMap(off_t offset)
 /*----------------------------------------------------------------------------*/
 bool
 CheckSum::VerifyXSMap(off_t offset)
+{
+  int len = 0;
+  return VerifyXSMap(offset, GetBinChecksum(len));
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+CheckSum::VerifyXSMap(off_t offset, const char* cks)
 {
   if (!ChangeMap((offset + BlockSize), false)) {
     fprintf(stderr, "Fatal: [CheckSum::VerifyXSMap] ChangeMap failed\n");
@@ -719,8 +738,7 @@ CheckSum::VerifyXSMap(off_t offset)
 
   off_t mapoffset = (offset / BlockSize) * GetCheckSumLen();
   //  fprintf(stderr,"Verifying %llu %llu %d %llu %llu\n", offset, mapoffset, ChecksumMapFd, ChecksumMap, ChecksumMapSize);
-  int len = 0;
-  const char* cks = GetBinChecksum(len);
+  int len = GetCheckSumLen();
 
   if (!sigsetjmp(sj_env, 1)) {
     for (int i = 0; i < len; i++) {
@@ -743,6 +761,40 @@ CheckSum::VerifyXSMap(off_t offset)
   return true;
 }
 
+/*----------------------------------------------------------------------------*/
+bool
+CheckSum::AddBlockSums(off_t offset, const char* sums, size_t nblocks)
+{
+  int len = GetCheckSumLen();
+
+  for (size_t i = 0; i < nblocks; i++) {
+    if (!SetXSMap(offset + i * BlockSize, sums + i * len)) {
+      return false;
+    }
+
+    nXSBlocksWritten++;
+  }
+
+  return true;
+}
+
+/*----------------------------------------------------------------------------*/
+bool
+CheckSum::CheckBlockSums(off_t offset, const char* sums, size_t nblocks)
+{
+  int len = GetCheckSumLen();
+
+  for (size_t i = 0; i < nblocks; i++) {
+    if (!VerifyXSMap(offset + i * BlockSize, sums + i * len)) {
+      return false;
+    }
+
+    nXSBlocksChecked++;
+  }
+
+  return true;
+}
+
 /*----------------------------------------------------------------------------*/
 bool
 CheckSum::AddBlockSumHoles(int fd)
@@ -197,8 +197,31 @@ public:
   virtual bool ScanFile(const char* path, off_t offsetInit, size_t lengthInit,
                         const char* partialChecksum,
                         unsigned long long& scansize, float& scantime, int rate = 0);
+
+  //----------------------------------------------------------------------------
+  //! Complete the checksum of a file by reading only the ranges which were
+  //! not added so far. Algorithms which can't combine the values of separate
+  //! ranges scan the whole file again.
+  //!
+  //! @param rcb read callback, called concurrently if nthreads > 1
+  //! @param filesize size of the file
+  //! @param scansize number of bytes read
+  //! @param scantime time spent in ms
+  //! @param nthreads maximum number of ranges read in parallel
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  virtual bool
+  ScanMissing(ReadCallBack rcb, off_t filesize, unsigned long long& scansize,
+              float& scantime, int nthreads = 1)
+  {
+    return ScanFile(rcb, scansize, scantime);
+  }
+
   virtual bool SetXSMap(off_t offset);
   virtual bool VerifyXSMap(off_t offset);
+  virtual bool SetXSMap(off_t offset, const char* cks);
+  virtual bool VerifyXSMap(off_t offset, const char* cks);
 
   virtual bool OpenMap(const char* mapfilepath, size_t maxfilesize,
                        size_t blocksize, bool isRW);
@@ -216,6 +239,19 @@ public:
                              size_t buffersizem); // this only verifies the checksum on full blocks, not matching edge is not calculated
   virtual bool AddBlockSumHoles(int fd);
 
+  //----------------------------------------------------------------------------
+  //! Store or verify the checksums of consecutive full blocks which were
+  //! computed outside of this object, e.g. in parallel by a BlockXsPool
+  //!
+  //! @param offset block aligned offset of the first block
+  //! @param sums GetCheckSumLen() bytes of binary checksum per block
+  //! @param nblocks number of blocks
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  virtual bool AddBlockSums(off_t offset, const char* sums, size_t nblocks);
+  virtual bool CheckBlockSums(off_t offset, const char* sums, size_t nblocks);
+
   virtual const char*
   MakeBlockXSPath(const char* filepath)
   {
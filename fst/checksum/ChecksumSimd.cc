@@ -0,0 +1,407 @@
+//------------------------------------------------------------------------------
+// File: ChecksumSimd.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/checksum/ChecksumSimd.hh"
+#include <zlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define EOS_CHECKSUMSIMD_X86 1
+#include <immintrin.h>
+#endif
+
+EOSFSTNAMESPACE_BEGIN
+
+// largest prime smaller than 65536 and largest n such that
+// 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 (see zlib adler32.c)
+static const uint32_t sAdlerBase = 65521;
+static const uint32_t sAdlerNMax = 5552;
+
+// slice size used to interleave the streams of the multi-buffer variants
+static const size_t sMultiSlice = 64 * 1024;
+
+uint32_t
+adler32UpdateScalar(uint32_t adler, const char* buffer, size_t length)
+{
+  // zlib takes a uInt length
+  while (length) {
+    uInt n = (length > (1u << 30)) ? (1u << 30) : (uInt) length;
+    adler = adler32(adler, (const Bytef*) buffer, n);
+    buffer += n;
+    length -= n;
+  }
+
+  return adler;
+}
+
+uint32_t
+crc32UpdateScalar(uint32_t crc, const char* buffer, size_t length)
+{
+  while (length) {
+    uInt n = (length > (1u << 30)) ? (1u << 30) : (uInt) length;
+    crc = crc32(crc, (const Bytef*) buffer, n);
+    buffer += n;
+    length -= n;
+  }
+
+  return crc;
+}
+
+#ifdef EOS_CHECKSUMSIMD_X86
+//------------------------------------------------------------------------------
+// Adler32 with 16 byte vectors: s1 is the byte sum, s2 the sum of the bytes
+// weighted by their distance to the end of each 32 byte block plus 32 times
+// the value of s1 before the block (v_ps)
+//------------------------------------------------------------------------------
+__attribute__((target("ssse3"))) static uint32_t
+adler32Ssse3(uint32_t adler, const char* buffer, size_t length)
+{
+  const unsigned char* buf = (const unsigned char*) buffer;
+  uint32_t s1 = adler & 0xffff;
+  uint32_t s2 = adler >> 16;
+  size_t blocks = length / 32;
+  length -= blocks * 32;
+  const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                     24, 23, 22, 21, 20, 19, 18, 17);
+  const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9,
+                                     8, 7, 6, 5, 4, 3, 2, 1);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+
+  while (blocks) {
+    size_t n = sAdlerNMax / 32;
+
+    if (n > blocks) {
+      n = blocks;
+    }
+
+    blocks -= n;
+    __m128i v_ps = _mm_setr_epi32(0, 0, 0, s1 * n);
+    __m128i v_s2 = _mm_setr_epi32(0, 0, 0, s2);
+    __m128i v_s1 = zero;
+
+    do {
+      const __m128i bytes1 = _mm_loadu_si128((const __m128i*) buf);
+      const __m128i bytes2 = _mm_loadu_si128((const __m128i*)(buf + 16));
+      v_ps = _mm_add_epi32(v_ps, v_s1);
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1),
+                                                ones));
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+      v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2),
+                                                ones));
+      buf += 32;
+    } while (--n);
+
+    v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+    v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+    v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+    s1 += _mm_cvtsi128_si32(v_s1);
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+    s2 = _mm_cvtsi128_si32(v_s2);
+    s1 %= sAdlerBase;
+    s2 %= sAdlerBase;
+  }
+
+  adler = s1 | (s2 << 16);
+  return length ? adler32UpdateScalar(adler, (const char*) buf, length) : adler;
+}
+
+//------------------------------------------------------------------------------
+// Adler32 with 32 byte vectors, same scheme as the SSSE3 kernel
+//------------------------------------------------------------------------------
+__attribute__((target("avx2"))) static uint32_t
+adler32Avx2(uint32_t adler, const char* buffer, size_t length)
+{
+  const unsigned char* buf = (const unsigned char*) buffer;
+  uint32_t s1 = adler & 0xffff;
+  uint32_t s2 = adler >> 16;
+  size_t blocks = length / 32;
+  length -= blocks * 32;
+  const __m256i tap = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                       24, 23, 22, 21, 20, 19, 18, 17,
+                                       16, 15, 14, 13, 12, 11, 10, 9,
+                                       8, 7, 6, 5, 4, 3, 2, 1);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi16(1);
+
+  while (blocks) {
+    size_t n = sAdlerNMax / 32;
+
+    if (n > blocks) {
+      n = blocks;
+    }
+
+    blocks -= n;
+    __m256i v_ps = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, s1 * n);
+    __m256i v_s2 = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, s2);
+    __m256i v_s1 = zero;
+
+    do {
+      const __m256i bytes = _mm256_loadu_si256((const __m256i*) buf);
+      v_ps = _mm256_add_epi32(v_ps, v_s1);
+      v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+      v_s2 = _mm256_add_epi32(v_s2,
+                              _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+      buf += 32;
+    } while (--n);
+
+    v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+    __m128i h1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1),
+                               _mm256_extracti128_si256(v_s1, 1));
+    h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(2, 3, 0, 1)));
+    h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(1, 0, 3, 2)));
+    s1 += _mm_cvtsi128_si32(h1);
+    __m128i h2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2),
+                               _mm256_extracti128_si256(v_s2, 1));
+    h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(2, 3, 0, 1)));
+    h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(1, 0, 3, 2)));
+    s2 = _mm_cvtsi128_si32(h2);
+    s1 %= sAdlerBase;
+    s2 %= sAdlerBase;
+  }
+
+  adler = s1 | (s2 << 16);
+  return length ? adler32UpdateScalar(adler, (const char*) buf, length) : adler;
+}
+
+//------------------------------------------------------------------------------
+// CRC32 by carry-less multiplication folding (Intel, "Fast CRC Computation
+// for Generic Polynomials Using PCLMULQDQ Instruction"): four 128 bit lanes
+// are folded 64 bytes at a time, then reduced to 32 bits with a Barrett
+// reduction. Needs at least 64 bytes, the tail is left to zlib.
+//------------------------------------------------------------------------------
+__attribute__((target("sse4.1,pclmul"))) static uint32_t
+crc32Pclmul(uint32_t crc, const char* buffer, size_t length)
+{
+  if (length < 64) {
+    return crc32UpdateScalar(crc, buffer, length);
+  }
+
+  const unsigned char* buf = (const unsigned char*) buffer;
+  size_t tail = length & 15;
+  length -= tail;
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596ll, 0x0154442bd4ll);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009ell, 0x01751997d0ll);
+  const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124ll);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641ll, 0x01db710641ll);
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+  x1 = _mm_loadu_si128((const __m128i*)(buf + 0x00));
+  x2 = _mm_loadu_si128((const __m128i*)(buf + 0x10));
+  x3 = _mm_loadu_si128((const __m128i*)(buf + 0x20));
+  x4 = _mm_loadu_si128((const __m128i*)(buf + 0x30));
+  // zlib values are kept inverted
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(~crc));
+  x0 = k1k2;
+  buf += 64;
+  length -= 64;
+
+  while (length >= 64) {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                       _mm_loadu_si128((const __m128i*)(buf + 0x00)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                       _mm_loadu_si128((const __m128i*)(buf + 0x10)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                       _mm_loadu_si128((const __m128i*)(buf + 0x20)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                       _mm_loadu_si128((const __m128i*)(buf + 0x30)));
+    buf += 64;
+    length -= 64;
+  }
+
+  // fold the four lanes into one
+  x0 = k3k4;
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  // remaining 16 byte blocks
+  while (length >= 16) {
+    x2 = _mm_loadu_si128((const __m128i*) buf);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    buf += 16;
+    length -= 16;
+  }
+
+  // fold 128 to 64 bits
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x0 = k5k0;
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, mask32);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  // Barrett reduction to 32 bits
+  x0 = poly;
+  x2 = _mm_and_si128(x1, mask32);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, mask32);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  crc = ~(uint32_t) _mm_extract_epi32(x1, 1);
+  return tail ? crc32UpdateScalar(crc, (const char*) buf, tail) : crc;
+}
+#endif
+
+typedef uint32_t (*tChecksumKernel)(uint32_t, const char*, size_t);
+
+struct ChecksumKernel {
+  tChecksumKernel kernel;
+  const char* name;
+};
+
+static ChecksumKernel
+selectAdler32Kernel()
+{
+  ChecksumKernel k = { &adler32UpdateScalar, "zlib" };
+#ifdef EOS_CHECKSUMSIMD_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) {
+    k.kernel = &adler32Avx2;
+    k.name = "avx2";
+  } else if (__builtin_cpu_supports("ssse3")) {
+    k.kernel = &adler32Ssse3;
+    k.name = "ssse3";
+  }
+
+#endif
+  return k;
+}
+
+static ChecksumKernel
+selectCrc32Kernel()
+{
+  ChecksumKernel k = { &crc32UpdateScalar, "zlib" };
+#ifdef EOS_CHECKSUMSIMD_X86
+  __builtin_cpu_init();
+  unsigned int eax, ebx, ecx = 0, edx;
+  // there is no __builtin_cpu_supports for pclmul with older compilers
+  __asm__("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1), "c"(0));
+
+  if ((ecx & (1u << 1)) && __builtin_cpu_supports("sse4.1")) {
+    k.kernel = &crc32Pclmul;
+    k.name = "pclmul";
+  }
+
+#endif
+  return k;
+}
+
+// resolved once, safe even if used during static initialization
+static const ChecksumKernel&
+adler32Kernel()
+{
+  static const ChecksumKernel kernel = selectAdler32Kernel();
+  return kernel;
+}
+
+static const ChecksumKernel&
+crc32Kernel()
+{
+  static const ChecksumKernel kernel = selectCrc32Kernel();
+  return kernel;
+}
+
+uint32_t
+adler32Update(uint32_t adler, const char* buffer, size_t length)
+{
+  return adler32Kernel().kernel(adler, buffer, length);
+}
+
+uint32_t
+crc32Update(uint32_t crc, const char* buffer, size_t length)
+{
+  return crc32Kernel().kernel(crc, buffer, length);
+}
+
+static void
+updateMulti(tChecksumKernel kernel, uint32_t* values,
+            const char* const* buffers, const size_t* lengths, size_t count)
+{
+  for (size_t offset = 0; ; offset += sMultiSlice) {
+    bool more = false;
+
+    for (size_t i = 0; i < count; i++) {
+      if (lengths[i] > offset) {
+        size_t n = lengths[i] - offset;
+
+        if (n > sMultiSlice) {
+          n = sMultiSlice;
+          more = true;
+        }
+
+        values[i] = kernel(values[i], buffers[i] + offset, n);
+      }
+    }
+
+    if (!more) {
+      break;
+    }
+  }
+}
+
+void
+adler32UpdateMulti(uint32_t* values, const char* const* buffers,
+                   const size_t* lengths, size_t count)
+{
+  updateMulti(adler32Kernel().kernel, values, buffers, lengths, count);
+}
+
+void
+crc32UpdateMulti(uint32_t* values, const char* const* buffers,
+                 const size_t* lengths, size_t count)
+{
+  updateMulti(crc32Kernel().kernel, values, buffers, lengths, count);
+}
+
+const char*
+adler32KernelName()
+{
+  return adler32Kernel().name;
+}
+
+const char*
+crc32KernelName()
+{
+  return crc32Kernel().name;
+}
+
+EOSFSTNAMESPACE_END
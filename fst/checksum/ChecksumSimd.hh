@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+// File: ChecksumSimd.hh
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_CHECKSUMSIMD_HH__
+#define __EOSFST_CHECKSUMSIMD_HH__
+
+#include "fst/Namespace.hh"
+#include <cstddef>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+//! Vectorized Adler32 and CRC32 (zlib polynomial) kernels
+//!
+//! Both functions are drop-in replacements of zlib's adler32/crc32: they take
+//! the running value (adler32(0, 0, 0) = 1 and crc32(0, 0, 0) = 0 to start)
+//! and return the updated one. The best kernel supported by the CPU is chosen
+//! once at the first call: AVX2 or SSSE3 for Adler32, PCLMULQDQ/SSE4.1 carry-
+//! less folding for CRC32, zlib otherwise.
+//------------------------------------------------------------------------------
+
+EOSFSTNAMESPACE_BEGIN
+
+uint32_t adler32Update(uint32_t adler, const char* buffer, size_t length);
+uint32_t crc32Update(uint32_t crc, const char* buffer, size_t length);
+
+//------------------------------------------------------------------------------
+//! Portable (zlib) implementations
+//------------------------------------------------------------------------------
+uint32_t adler32UpdateScalar(uint32_t adler, const char* buffer, size_t length);
+uint32_t crc32UpdateScalar(uint32_t crc, const char* buffer, size_t length);
+
+//------------------------------------------------------------------------------
+//! Multi-buffer variants: update the checksums of several independent
+//! streams (e.g. the stripes of a RAIN group) in one call. The streams are
+//! processed in lockstep slices so that the data of all of them stays in the
+//! cache while they are produced together.
+//!
+//! @param values running checksum of each stream, updated in place
+//! @param buffers data of each stream
+//! @param lengths length of each buffer
+//! @param count number of streams
+//------------------------------------------------------------------------------
+void adler32UpdateMulti(uint32_t* values, const char* const* buffers,
+                        const size_t* lengths, size_t count);
+void crc32UpdateMulti(uint32_t* values, const char* const* buffers,
+                      const size_t* lengths, size_t count);
+
+//------------------------------------------------------------------------------
+//! Name of the kernels in use ("avx2", "ssse3", "pclmul" or "zlib")
+//------------------------------------------------------------------------------
+const char* adler32KernelName();
+const char* crc32KernelName();
+
+EOSFSTNAMESPACE_END
+
+#endif
@@ -304,6 +304,11 @@ HttpHandler::Get(eos::common::HttpRequest* request)
     response->AddHeader("Last-Modified", eos::common::Timing::utctime(mtime));
     // We want to use the file callbacks
     response->mUseFileReaderCallback = true;
+
+    // Whole plain files are sent straight from the disk file
+    if (!mRangeRequest) {
+      response->mResponseFd = mFile->GetZeroCopyFd();
+    }
   }
 
   return response;
@@ -29,6 +29,7 @@
 /*----------------------------------------------------------------------------*/
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
+#include <unistd.h>
 /*----------------------------------------------------------------------------*/
 
 /*----------------------------------------------------------------------------*/
@@ -145,18 +146,41 @@ HttpServer::Handler(void* cls,
 
   eos_static_debug("\n\n%s", response->ToString().c_str());
   // Create the MHD response
-  struct MHD_Response* mhdResponse;
-
-  if (response->mUseFileReaderCallback) {
-    eos_static_debug("response length=%d", response->mResponseLength);
-    mhdResponse = MHD_create_response_from_callback(response->mResponseLength,
-                  4 * 1024 * 1024, /* 4M page size */
-                  &HttpServer::FileReaderCallback,
-                  (void*) protocolHandler, 0);
-  } else {
-    mhdResponse = MHD_create_response_from_buffer(response->GetBodySize(),
-                  (void*) response->GetBody().c_str(),
-                  MHD_RESPMEM_PERSISTENT);
+  struct MHD_Response* mhdResponse = 0;
+  eos::fst::HttpHandler* httpHandle = dynamic_cast<eos::fst::HttpHandler*>
+                                      (protocolHandler);
+
+  if (response->mUseFileReaderCallback && (response->mResponseFd >= 0) &&
+      httpHandle && httpHandle->mFile) {
+    // The response closes the descriptor once sent, the file keeps its own
+    int zero_copy_fd = dup(response->mResponseFd);
+
+    if (zero_copy_fd >= 0) {
+      eos_static_debug("response length=%d zero-copy",
+                       response->mResponseLength);
+      mhdResponse = MHD_create_response_from_fd_at_offset(
+                      response->mResponseLength, zero_copy_fd, 0);
+
+      if (mhdResponse) {
+        httpHandle->mFile->AddZeroCopyRead(0, response->mResponseLength);
+      } else {
+        close(zero_copy_fd);
+      }
+    }
+  }
+
+  if (!mhdResponse) {
+    if (response->mUseFileReaderCallback) {
+      eos_static_debug("response length=%d", response->mResponseLength);
+      mhdResponse = MHD_create_response_from_callback(response->mResponseLength,
+                    4 * 1024 * 1024, /* 4M page size */
+                    &HttpServer::FileReaderCallback,
+                    (void*) protocolHandler, 0);
+    } else {
+      mhdResponse = MHD_create_response_from_buffer(response->GetBodySize(),
+                    (void*) response->GetBody().c_str(),
+                    MHD_RESPMEM_PERSISTENT);
+    }
   }
 
   if (mhdResponse) {
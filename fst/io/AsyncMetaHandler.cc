@@ -38,6 +38,7 @@ AsyncMetaHandler::AsyncMetaHandler() :
   mErrorType(XrdCl::errNone),
   mAsyncReq(0),
   mAsyncVReq(0),
+  mWriteWindow(0),
   mHandlerDel(NULL),
   mVHandlerDel(NULL)
 {
@@ -99,6 +100,18 @@ AsyncMetaHandler::Register(uint64_t offset, uint32_t length, char* buffer,
     return NULL;
   }
 
+  // Wait for a free slot in the window of write requests
+  if (isWrite && mWriteWindow) {
+    while (mAsyncReq >= mWriteWindow) {
+      mCond.Wait();
+    }
+
+    if (mErrorType == XrdCl::errOperationExpired) {
+      mCond.UnLock(); // <--
+      return NULL;
+    }
+  }
+
   mAsyncReq++;
 
   if (mQRecycle.size() + mAsyncReq >= msMaxNumAsyncObj) {
@@ -179,7 +192,8 @@ AsyncMetaHandler::HandleResponse(XrdCl::XRootDStatus* pStatus,
     }
   }
 
-  if (--mAsyncReq == 0) {
+  // Wake up the wait for all the responses or for a slot in the window
+  if ((--mAsyncReq == 0) || (mAsyncReq + 1 == mWriteWindow)) {
     mCond.Broadcast();
   }
 
@@ -271,6 +285,26 @@ AsyncMetaHandler::WaitOK()
   return ret;
 }
 
+//------------------------------------------------------------------------------
+// Get the error of the requests answered so far
+//------------------------------------------------------------------------------
+uint16_t
+AsyncMetaHandler::GetErrorType()
+{
+  XrdSysCondVarHelper scope_lock(&mCond);
+  return mErrorType;
+}
+
+//------------------------------------------------------------------------------
+// Limit the number of write requests in flight
+//------------------------------------------------------------------------------
+void
+AsyncMetaHandler::SetWriteWindow(uint32_t window)
+{
+  XrdSysCondVarHelper scope_lock(&mCond);
+  mWriteWindow = window;
+}
+
 //------------------------------------------------------------------------------
 // Reset
 //------------------------------------------------------------------------------
@@ -43,6 +43,10 @@ class VectChunkHandler;
 class AsyncMetaHandler: public eos::common::LogId
 {
 public:
+  //! Maxium number of async requests in flight and also the maximum number
+  //! of ChunkHandler object that can be saved in cache
+  static const unsigned int msMaxNumAsyncObj;
+
   //----------------------------------------------------------------------------
   //! Constructor
   //----------------------------------------------------------------------------
@@ -105,6 +109,23 @@ public:
   //----------------------------------------------------------------------------
   uint16_t WaitOK();
 
+  //----------------------------------------------------------------------------
+  //! Get the error of the requests answered so far, without waiting for the
+  //! ones in flight
+  //!
+  //! @return error type, if no error occured return XrdCl::errNone
+  //----------------------------------------------------------------------------
+  uint16_t GetErrorType();
+
+  //----------------------------------------------------------------------------
+  //! Limit the number of write requests in flight, the registration of a new
+  //! one blocks until a response arrives once the limit is reached
+  //!
+  //! @param window maximum number of requests in flight, 0 for no limit
+  //!        other than the number of cached handlers
+  //----------------------------------------------------------------------------
+  void SetWriteWindow(uint32_t window);
+
   //----------------------------------------------------------------------------
   //! Get map of errors
   //!
@@ -123,6 +144,7 @@ private:
   uint32_t mAsyncReq;
   //! number of async VECTOR req. in flight (for which no response was received)
   uint32_t mAsyncVReq;
+  uint32_t mWriteWindow; ///< max write requests in flight, 0 if not limited
   //! condition variable to signal the receival of all responses
   XrdSysCondVar mCond;
   ChunkHandler* mHandlerDel; ///< pointer to handler to be deleted
@@ -132,9 +154,6 @@ private:
   //! recyclable vector handlers
   eos::common::ConcurrentQueue<VectChunkHandler*> mQVRecycle;
   XrdCl::ChunkList mErrors; ///< chunks for which the request failed
-  //! Maxium number of async requests in flight and also the maximum number
-  //! of ChunkHandler object that can be saved in cache
-  static const unsigned int msMaxNumAsyncObj;
 };
 
 EOSFSTNAMESPACE_END
@@ -27,6 +27,7 @@
 
 #include "fst/io/FileIo.hh"
 #include "fst/io/local/FsIo.hh"
+#include "fst/io/local/UringIo.hh"
 #include "fst/io/xrd/XrdIo.hh"
 #include "fst/io/kinetic/KineticIo.hh"
 #ifdef RADOS_FOUND
@@ -77,6 +78,10 @@ public:
     auto ioType = eos::common::LayoutId::GetIoType(path.c_str());
 
     if (ioType == LayoutId::kLocal) {
+      if (IoUring::GetInstance()) {
+        return static_cast<FileIo*>(new UringIo(path));
+      }
+
       return static_cast<FileIo*>(new FsIo(path));
     } else if (ioType == LayoutId::kXrdCl) {
       return static_cast<FileIo*>(new XrdIo(path));
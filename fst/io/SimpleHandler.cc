@@ -122,4 +122,14 @@ SimpleHandler::HasRequest()
   return ret;
 }
 
+//------------------------------------------------------------------------------
+// Check without blocking if the response of the request arrived
+//------------------------------------------------------------------------------
+bool
+SimpleHandler::IsDone()
+{
+  XrdSysCondVarHelper scope_lock(&mCond);
+  return mReqDone;
+}
+
 EOSFSTNAMESPACE_END
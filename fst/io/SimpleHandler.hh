@@ -76,6 +76,13 @@ public:
   //----------------------------------------------------------------------------
   bool HasRequest();
 
+  //----------------------------------------------------------------------------
+  //! Check without blocking if the response of the request arrived
+  //!
+  //! @return true if the request is done, false otherwise
+  //----------------------------------------------------------------------------
+  bool IsDone();
+
   //----------------------------------------------------------------------------
   //! Get request chunk offset
   //----------------------------------------------------------------------------
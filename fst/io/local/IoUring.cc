@@ -0,0 +1,573 @@
+//------------------------------------------------------------------------------
+// File: IoUring.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/io/local/IoUring.hh"
+#include "common/BufferPool.hh"
+#include "common/EnvTunable.hh"
+#include "common/Logging.hh"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define EOS_HAVE_IO_URING 1
+#endif
+#endif
+
+EOSFSTNAMESPACE_BEGIN
+
+const size_t IoUring::sSlotSize;
+
+//! User data of the request stopping the reaper thread
+static const uint64_t sStopRequest = UINT64_MAX;
+
+//------------------------------------------------------------------------------
+// Get the process-wide ring
+//------------------------------------------------------------------------------
+IoUring*
+IoUring::GetInstance()
+{
+  // Never destroyed: the reaper thread runs until the process exits
+  static IoUring* sRing = 0;
+  static bool sProbed = false;
+  static XrdSysMutex sMutex;
+  XrdSysMutexHelper lock(sMutex);
+
+  if (sProbed) {
+    return sRing;
+  }
+
+  sProbed = true;
+
+  if (!getenv("EOS_FST_IO_URING") || strcmp(getenv("EOS_FST_IO_URING"), "1")) {
+    return 0;
+  }
+
+  uint32_t depth =
+    eos::common::EnvTunable::Get("EOS_FST_IO_URING_DEPTH", 32, 1, 1024);
+
+  sRing = new IoUring(depth);
+
+  if (!sRing->IsOk()) {
+    eos_static_warning("msg=\"io_uring not available, using synchronous "
+                       "local IO\"");
+    delete sRing;
+    sRing = 0;
+  } else {
+    eos_static_info("msg=\"local IO submitted through io_uring\" depth=%u",
+                    depth);
+  }
+
+  return sRing;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+IoUring::IoUring(uint32_t depth):
+  mRingFd(-1), mDepth(depth), mSqRing(MAP_FAILED), mSqRingSize(0),
+  mCqRing(MAP_FAILED), mCqRingSize(0), mSqes(MAP_FAILED), mSqesSize(0),
+  mSqHead(0), mSqTail(0), mSqMask(0), mSqArray(0), mCqHead(0), mCqTail(0),
+  mCqMask(0), mCqes(0), mFixed(false)
+{
+  if (!Setup()) {
+    TearDown();
+    return;
+  }
+
+  mReaper = std::thread(&IoUring::Reap, this);
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+IoUring::~IoUring()
+{
+  if (mRingFd >= 0) {
+    // Take all the slots so that nothing is in flight any more
+    for (uint32_t i = 0; i < mDepth; i++) {
+      (void) GetSlot();
+    }
+
+    int retc;
+
+    do {
+      retc = Submit(IORING_OP_NOP, -1, 0, 0, 0, 0, sStopRequest);
+    } while (retc == EAGAIN);
+
+    if (retc) {
+      eos_static_crit("msg=\"failed to stop the io_uring reaper\" errno=%d",
+                      retc);
+      std::abort();
+    }
+
+    mReaper.join();
+  }
+
+  TearDown();
+}
+
+//------------------------------------------------------------------------------
+// Create the ring and map its queues
+//------------------------------------------------------------------------------
+bool
+IoUring::Setup()
+{
+#if defined(EOS_HAVE_IO_URING) && defined(__NR_io_uring_setup)
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  mRingFd = syscall(__NR_io_uring_setup, mDepth, &params);
+
+  if (mRingFd < 0) {
+    mRingFd = -1;
+    return false;
+  }
+
+  mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  mCqRingSize = params.cq_off.cqes + params.cq_entries *
+                sizeof(struct io_uring_cqe);
+  mSqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+  mSqRing = mmap(0, mSqRingSize, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQ_RING);
+  mCqRing = mmap(0, mCqRingSize, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_CQ_RING);
+  mSqes = mmap(0, mSqesSize, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQES);
+
+  if ((mSqRing == MAP_FAILED) || (mCqRing == MAP_FAILED) ||
+      (mSqes == MAP_FAILED)) {
+    return false;
+  }
+
+  char* sq = static_cast<char*>(mSqRing);
+  char* cq = static_cast<char*>(mCqRing);
+  mSqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  mSqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  mSqMask = reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  mSqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  mCqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  mCqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  mCqMask = reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  mCqes = cq + params.cq_off.cqes;
+  // The kernel may round up the number of entries, never go beyond ours
+  mOps.resize(mDepth);
+  std::vector<struct iovec> iovs(mDepth);
+
+  for (uint32_t i = 0; i < mDepth; i++) {
+    char* buffer = eos::common::BufferPool::GetInstance().Allocate(sSlotSize);
+
+    if (!buffer) {
+      return false;
+    }
+
+    mBuffers.push_back(buffer);
+    mFreeSlots.push_back(mDepth - 1 - i);
+    mOps[i].fd = -1;
+    iovs[i].iov_base = buffer;
+    iovs[i].iov_len = sSlotSize;
+  }
+
+  // Registration can fail on a low locked memory limit, the staging buffers
+  // are then passed to the kernel with every write
+  mFixed = (syscall(__NR_io_uring_register, mRingFd, IORING_REGISTER_BUFFERS,
+                    iovs.data(), mDepth) == 0);
+
+  if (!mFixed) {
+    eos_static_warning("msg=\"io_uring buffer registration failed, using "
+                       "unregistered buffers\" errno=%d", errno);
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Unmap the queues and close the ring
+//------------------------------------------------------------------------------
+void
+IoUring::TearDown()
+{
+  if (mSqes != MAP_FAILED) {
+    munmap(mSqes, mSqesSize);
+    mSqes = MAP_FAILED;
+  }
+
+  if (mCqRing != MAP_FAILED) {
+    munmap(mCqRing, mCqRingSize);
+    mCqRing = MAP_FAILED;
+  }
+
+  if (mSqRing != MAP_FAILED) {
+    munmap(mSqRing, mSqRingSize);
+    mSqRing = MAP_FAILED;
+  }
+
+  if (mRingFd >= 0) {
+    // Closing the ring also unregisters the buffers
+    close(mRingFd);
+    mRingFd = -1;
+  }
+
+  for (size_t i = 0; i < mBuffers.size(); i++) {
+    eos::common::BufferPool::GetInstance().Release(mBuffers[i], sSlotSize);
+  }
+
+  mBuffers.clear();
+  mFreeSlots.clear();
+}
+
+//------------------------------------------------------------------------------
+// Take a free slot
+//------------------------------------------------------------------------------
+uint32_t
+IoUring::GetSlot(int fd, uint64_t offset, uint32_t length)
+{
+  XrdSysCondVarHelper lock(mSlotCond);
+
+  while (mFreeSlots.empty() ||
+         ((fd >= 0) && IsWriteInFlight(fd, offset, length))) {
+    mSlotCond.Wait();
+  }
+
+  uint32_t slot = mFreeSlots.back();
+  mFreeSlots.pop_back();
+  // Registered while locked, the following writes see the range in flight
+  mOps[slot].fd = fd;
+  mOps[slot].offset = offset;
+  mOps[slot].length = length;
+  return slot;
+}
+
+//------------------------------------------------------------------------------
+// Check if a write in flight overlaps a range of a file
+//------------------------------------------------------------------------------
+bool
+IoUring::IsWriteInFlight(int fd, uint64_t offset, uint32_t length) const
+{
+  for (uint32_t i = 0; i < mDepth; i++) {
+    const Op& op = mOps[i];
+
+    if ((op.fd == fd) && (op.offset < offset + length) &&
+        (offset < op.offset + op.length)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Give back a slot
+//------------------------------------------------------------------------------
+void
+IoUring::PutSlot(uint32_t slot)
+{
+  XrdSysCondVarHelper lock(mSlotCond);
+  mOps[slot].fd = -1;
+  mFreeSlots.push_back(slot);
+  // Wakes the writers waiting for an overlapping write as well
+  mSlotCond.Broadcast();
+}
+
+//------------------------------------------------------------------------------
+// Put an entry in the submission queue and enter the kernel
+//------------------------------------------------------------------------------
+int
+IoUring::Submit(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+                uint64_t offset, uint16_t bufIndex, uint64_t userData)
+{
+#ifdef EOS_HAVE_IO_URING
+  XrdSysMutexHelper lock(mSubmitMutex);
+  uint32_t tail = *mSqTail;
+  uint32_t index = tail & *mSqMask;
+  struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(mSqes) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->addr = addr;
+  sqe->len = len;
+  sqe->off = offset;
+  sqe->buf_index = bufIndex;
+  sqe->user_data = userData;
+  mSqArray[index] = index;
+  __atomic_store_n(mSqTail, tail + 1, __ATOMIC_RELEASE);
+  int retc;
+
+  do {
+    retc = syscall(__NR_io_uring_enter, mRingFd, 1, 0, 0, 0, 0);
+  } while ((retc < 0) && (errno == EINTR));
+
+  if (retc == 1) {
+    return 0;
+  }
+
+  // The entry was not consumed, take it back
+  int error = ((retc < 0) ? errno : EAGAIN);
+  __atomic_store_n(mSqTail, tail, __ATOMIC_RELEASE);
+  return error;
+#else
+  return EOPNOTSUPP;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Submit a write
+//------------------------------------------------------------------------------
+int
+IoUring::Write(int fd, const char* buffer, size_t length, off_t offset,
+               Tracker& tracker)
+{
+#ifdef EOS_HAVE_IO_URING
+
+  // Writes larger than a staging buffer are split over several slots
+  while (length) {
+    uint32_t chunk = (length > sSlotSize ? sSlotSize : length);
+    uint32_t slot = GetSlot(fd, offset, chunk);
+    Op& op = mOps[slot];
+    memcpy(mBuffers[slot], buffer, chunk);
+    op.tracker = &tracker;
+    op.callback = 0;
+    op.iov.iov_base = mBuffers[slot];
+    op.iov.iov_len = chunk;
+    tracker.Add();
+    int error = (mFixed ?
+                 Submit(IORING_OP_WRITE_FIXED, fd, (uint64_t) mBuffers[slot], chunk,
+                        offset, slot, slot) :
+                 Submit(IORING_OP_WRITEV, fd, (uint64_t) &op.iov, 1, offset, 0,
+                        slot));
+
+    if (error) {
+      PutSlot(slot);
+      tracker.Done(-error, 0);
+      errno = error;
+      return -1;
+    }
+
+    buffer += chunk;
+    offset += chunk;
+    length -= chunk;
+  }
+
+  return 0;
+#else
+  errno = EOPNOTSUPP;
+  return -1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Submit a read
+//------------------------------------------------------------------------------
+int
+IoUring::Read(int fd, char* buffer, size_t length, off_t offset,
+              Tracker& tracker, Callback callback, void* arg)
+{
+#ifdef EOS_HAVE_IO_URING
+  uint32_t slot = GetSlot();
+  Op& op = mOps[slot];
+  op.tracker = &tracker;
+  op.callback = callback;
+  op.arg = arg;
+  // Short reads are fine, the end of the file may have been reached
+  op.length = 0;
+  op.iov.iov_base = buffer;
+  op.iov.iov_len = length;
+  tracker.Add();
+  int error = Submit(IORING_OP_READV, fd, (uint64_t) &op.iov, 1, offset, 0,
+                     slot);
+
+  if (error) {
+    PutSlot(slot);
+    tracker.Done(-error, 0);
+    errno = error;
+    return -1;
+  }
+
+  return 0;
+#else
+  errno = EOPNOTSUPP;
+  return -1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Submit a fsync
+//------------------------------------------------------------------------------
+int
+IoUring::Fsync(int fd, Tracker& tracker)
+{
+#ifdef EOS_HAVE_IO_URING
+  uint32_t slot = GetSlot();
+  Op& op = mOps[slot];
+  op.tracker = &tracker;
+  op.callback = 0;
+  op.length = 0;
+  tracker.Add();
+  int error = Submit(IORING_OP_FSYNC, fd, 0, 0, 0, 0, slot);
+
+  if (error) {
+    PutSlot(slot);
+    tracker.Done(-error, 0);
+    errno = error;
+    return -1;
+  }
+
+  return 0;
+#else
+  errno = EOPNOTSUPP;
+  return -1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Loop of the reaper thread
+//------------------------------------------------------------------------------
+void
+IoUring::Reap()
+{
+#ifdef EOS_HAVE_IO_URING
+  bool stop = false;
+
+  while (!stop) {
+    if ((syscall(__NR_io_uring_enter, mRingFd, 0, 1, IORING_ENTER_GETEVENTS,
+                 0, 0) < 0) && (errno != EINTR)) {
+      eos_static_err("msg=\"failed waiting for io_uring completions\" "
+                     "errno=%d", errno);
+    }
+
+    // Only this thread moves the head of the completion queue
+    uint32_t head = *mCqHead;
+    uint32_t tail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+
+    while (head != tail) {
+      struct io_uring_cqe* cqe = static_cast<struct io_uring_cqe*>(mCqes) +
+                                 (head & *mCqMask);
+      uint64_t user_data = cqe->user_data;
+      int result = cqe->res;
+      head++;
+
+      if (user_data == sStopRequest) {
+        stop = true;
+        continue;
+      }
+
+      // The tracker can go away as soon as it is done, take what is needed
+      // from the slot before giving it back
+      Tracker* tracker = mOps[user_data].tracker;
+      Callback callback = mOps[user_data].callback;
+      void* arg = mOps[user_data].arg;
+      uint32_t expected = mOps[user_data].length;
+      PutSlot(user_data);
+
+      if (callback) {
+        callback(arg, result);
+      }
+
+      tracker->Done(result, expected);
+    }
+
+    __atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+  }
+
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Tracker: count a submitted request
+//------------------------------------------------------------------------------
+void
+IoUring::Tracker::Add()
+{
+  XrdSysCondVarHelper lock(mCond);
+  mPending++;
+}
+
+//------------------------------------------------------------------------------
+// Tracker: account a completed request
+//------------------------------------------------------------------------------
+void
+IoUring::Tracker::Done(int result, uint32_t expected)
+{
+  XrdSysCondVarHelper lock(mCond);
+
+  if (result < 0) {
+    if (!mError) {
+      mError = -result;
+    }
+  } else {
+    mBytes += result;
+
+    if (((uint32_t) result < expected) && !mError) {
+      // A short write to a local disk means it is full
+      mError = ENOSPC;
+    }
+  }
+
+  if (--mPending == 0) {
+    mCond.Broadcast();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Tracker: wait for all the requests submitted so far
+//------------------------------------------------------------------------------
+int
+IoUring::Tracker::Wait()
+{
+  XrdSysCondVarHelper lock(mCond);
+
+  while (mPending) {
+    mCond.Wait();
+  }
+
+  return mError;
+}
+
+//------------------------------------------------------------------------------
+// Tracker: get the errno of the first failed request
+//------------------------------------------------------------------------------
+int
+IoUring::Tracker::GetError()
+{
+  XrdSysCondVarHelper lock(mCond);
+  return mError;
+}
+
+//------------------------------------------------------------------------------
+// Tracker: get the number of bytes transferred
+//------------------------------------------------------------------------------
+uint64_t
+IoUring::Tracker::GetBytes()
+{
+  XrdSysCondVarHelper lock(mCond);
+  return mBytes;
+}
+
+EOSFSTNAMESPACE_END
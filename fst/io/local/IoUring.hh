@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------------
+//! @file IoUring.hh
+//! @author agent
+//! @brief Submission of local disk IO through an io_uring instance
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_IOURING_HH__
+#define __EOSFST_IOURING_HH__
+
+#include "fst/Namespace.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <thread>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class IoUring
+//!
+//! Process-wide io_uring instance used by the local IO objects. The ring is
+//! driven with the raw system calls, a thread reaps the completions. Every
+//! request in flight owns one of the depth slots of the ring, each slot has a
+//! staging buffer registered with the kernel: a write is copied to the
+//! buffers of its slots and submitted as a fixed buffer write, so that the
+//! caller can reuse its buffer as soon as the submission returns. Submitters
+//! block while all the slots are busy. The kernel doesn't order the requests
+//! in flight, so a write also waits for the writes in flight overlapping it.
+//!
+//! The ring is only used with EOS_FST_IO_URING=1 and when the kernel supports
+//! it, EOS_FST_IO_URING_DEPTH sets the number of slots (default 32).
+//------------------------------------------------------------------------------
+class IoUring
+{
+public:
+  static const size_t sSlotSize = 1024 * 1024; ///< staging buffer of a slot
+
+  //----------------------------------------------------------------------------
+  //! Requests of one file, waited for as a group
+  //----------------------------------------------------------------------------
+  class Tracker
+  {
+  public:
+    Tracker(): mPending(0), mError(0), mBytes(0) {}
+
+    //--------------------------------------------------------------------------
+    //! Wait for all the requests submitted so far
+    //!
+    //! @return 0 if all of them succeeded, otherwise the errno of the first
+    //!         failed one
+    //--------------------------------------------------------------------------
+    int Wait();
+
+    //--------------------------------------------------------------------------
+    //! Get the errno of the first failed request, without waiting
+    //--------------------------------------------------------------------------
+    int GetError();
+
+    //--------------------------------------------------------------------------
+    //! Get the number of bytes transferred by the completed requests
+    //--------------------------------------------------------------------------
+    uint64_t GetBytes();
+
+  private:
+    friend class IoUring;
+    XrdSysCondVar mCond;
+    uint32_t mPending; ///< requests in flight
+    int mError; ///< errno of the first failed request
+    uint64_t mBytes; ///< bytes transferred
+
+    void Add();
+    void Done(int result, uint32_t expected);
+  };
+
+  //----------------------------------------------------------------------------
+  //! Completion callback of a read, called by the reaper thread with the bytes
+  //! read or -errno before the tracker of the read is done
+  //----------------------------------------------------------------------------
+  typedef void (*Callback)(void* arg, int result);
+
+  //----------------------------------------------------------------------------
+  //! Get the process-wide ring
+  //!
+  //! @return ring or 0 if disabled or not supported by the kernel, in which
+  //!         case the callers use the synchronous system calls
+  //----------------------------------------------------------------------------
+  static IoUring* GetInstance();
+
+  //----------------------------------------------------------------------------
+  //! Constructor, only used directly by the tests
+  //!
+  //! @param depth number of requests in flight
+  //----------------------------------------------------------------------------
+  IoUring(uint32_t depth);
+
+  //----------------------------------------------------------------------------
+  //! Destructor, waits for the requests in flight
+  //----------------------------------------------------------------------------
+  ~IoUring();
+
+  //----------------------------------------------------------------------------
+  //! Check if the ring was set up
+  //----------------------------------------------------------------------------
+  bool IsOk() const
+  {
+    return (mRingFd >= 0);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Submit a write, the buffer is copied before returning
+  //!
+  //! @return 0 if submitted, otherwise -1 and errno is set
+  //----------------------------------------------------------------------------
+  int Write(int fd, const char* buffer, size_t length, off_t offset,
+            Tracker& tracker);
+
+  //----------------------------------------------------------------------------
+  //! Submit a read, the buffer has to be kept until the tracker is waited for
+  //!
+  //! @param callback called on completion, optional
+  //! @param arg passed to the callback
+  //!
+  //! @return 0 if submitted, otherwise -1 and errno is set
+  //----------------------------------------------------------------------------
+  int Read(int fd, char* buffer, size_t length, off_t offset,
+           Tracker& tracker, Callback callback = 0, void* arg = 0);
+
+  //----------------------------------------------------------------------------
+  //! Submit a fsync, to be ordered after writes the tracker has to be waited
+  //! for first
+  //!
+  //! @return 0 if submitted, otherwise -1 and errno is set
+  //----------------------------------------------------------------------------
+  int Fsync(int fd, Tracker& tracker);
+
+private:
+  //! Request in flight
+  struct Op {
+    Tracker* tracker;
+    Callback callback; ///< completion callback of a read
+    void* arg; ///< argument of the callback
+    uint32_t length; ///< bytes expected
+    struct iovec iov; ///< buffer of a read
+    int fd; ///< file of a write, -1 for other requests
+    uint64_t offset; ///< offset of a write
+  };
+
+  int mRingFd; ///< ring file descriptor, -1 if not set up
+  uint32_t mDepth; ///< number of slots
+  void* mSqRing; ///< mapped submission queue
+  size_t mSqRingSize;
+  void* mCqRing; ///< mapped completion queue
+  size_t mCqRingSize;
+  void* mSqes; ///< mapped submission queue entries
+  size_t mSqesSize;
+  uint32_t* mSqHead;
+  uint32_t* mSqTail;
+  uint32_t* mSqMask;
+  uint32_t* mSqArray;
+  uint32_t* mCqHead;
+  uint32_t* mCqTail;
+  uint32_t* mCqMask;
+  void* mCqes;
+  std::vector<char*> mBuffers; ///< staging buffers of the slots
+  bool mFixed; ///< staging buffers are registered with the kernel
+  std::vector<Op> mOps; ///< requests indexed by slot
+  std::vector<uint32_t> mFreeSlots;
+  XrdSysCondVar mSlotCond; ///< protects and signals the free slots
+  XrdSysMutex mSubmitMutex; ///< serialises the use of the submission queue
+  std::thread mReaper; ///< thread reaping the completions
+
+  //----------------------------------------------------------------------------
+  //! Create the ring and map its queues
+  //----------------------------------------------------------------------------
+  bool Setup();
+
+  //----------------------------------------------------------------------------
+  //! Unmap the queues and close the ring
+  //----------------------------------------------------------------------------
+  void TearDown();
+
+  //----------------------------------------------------------------------------
+  //! Take a free slot, waiting for one if all are busy. For a write it also
+  //! waits until no write in flight to the same file overlaps its range.
+  //!
+  //! @param fd file of a write, -1 for other requests
+  //! @param offset offset of the write
+  //! @param length length of the write
+  //----------------------------------------------------------------------------
+  uint32_t GetSlot(int fd = -1, uint64_t offset = 0, uint32_t length = 0);
+
+  //----------------------------------------------------------------------------
+  //! Check if a write in flight overlaps a range of a file, the slot condition
+  //! variable has to be locked
+  //----------------------------------------------------------------------------
+  bool IsWriteInFlight(int fd, uint64_t offset, uint32_t length) const;
+
+  //----------------------------------------------------------------------------
+  //! Give back a slot
+  //----------------------------------------------------------------------------
+  void PutSlot(uint32_t slot);
+
+  //----------------------------------------------------------------------------
+  //! Put an entry in the submission queue and enter the kernel
+  //!
+  //! @return 0 if submitted, otherwise the errno
+  //----------------------------------------------------------------------------
+  int Submit(uint8_t opcode, int fd, uint64_t addr, uint32_t len,
+             uint64_t offset, uint16_t bufIndex, uint64_t userData);
+
+  //----------------------------------------------------------------------------
+  //! Loop of the reaper thread
+  //----------------------------------------------------------------------------
+  void Reap();
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator = (const IoUring&) = delete;
+};
+
+EOSFSTNAMESPACE_END
+
+#endif // __EOSFST_IOURING_HH__
@@ -0,0 +1,352 @@
+//------------------------------------------------------------------------------
+// File: UringIo.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/io/local/UringIo.hh"
+#include <cstring>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+UringIo::UringIo(std::string path, IoUring* ring) :
+  FsIo(path, "UringIo"), mRing(ring), mRaOffset(-1), mRaLength(0),
+  mRaResult(-1)
+{
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+UringIo::~UringIo()
+{
+  // The fd is closed by FsIo, nothing may still use it
+  DropReadAhead();
+  (void) mWrites.Wait();
+}
+
+//------------------------------------------------------------------------------
+// Wait for the async writes
+//------------------------------------------------------------------------------
+int
+UringIo::WaitWrites()
+{
+  int error = mWrites.Wait();
+
+  if (error) {
+    eos_err("msg=\"async write failed\" path=%s errno=%d", mFilePath.c_str(),
+            error);
+    errno = error;
+    return -1;
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Completion callback of the read ahead
+//------------------------------------------------------------------------------
+void
+UringIo::ReadAheadDone(void* arg, int result)
+{
+  // Only looked at after waiting for the tracker of the read ahead
+  static_cast<UringIo*>(arg)->mRaResult = result;
+}
+
+//------------------------------------------------------------------------------
+// Drop the block read ahead
+//------------------------------------------------------------------------------
+void
+UringIo::DropReadAhead()
+{
+  XrdSysMutexHelper lock(mRaMutex);
+
+  if (mRaOffset >= 0) {
+    (void) mRaTracker.Wait();
+    mRaOffset = -1;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Read from file - sync
+//------------------------------------------------------------------------------
+int64_t
+UringIo::fileRead(XrdSfsFileOffset offset, char* buffer, XrdSfsXferSize length,
+                  uint16_t timeout)
+{
+  if (WaitWrites()) {
+    return SFS_ERROR;
+  }
+
+  if (!mRing) {
+    return FsIo::fileRead(offset, buffer, length, timeout);
+  }
+
+  IoUring::Tracker read;
+
+  if (mRing->Read(mFd, buffer, length, offset, read)) {
+    return SFS_ERROR;
+  }
+
+  int error = read.Wait();
+
+  if (error) {
+    errno = error;
+    return SFS_ERROR;
+  }
+
+  return read.GetBytes();
+}
+
+//------------------------------------------------------------------------------
+// Read from file - async
+//------------------------------------------------------------------------------
+int64_t
+UringIo::fileReadAsync(XrdSfsFileOffset offset, char* buffer,
+                       XrdSfsXferSize length, bool readahead, uint16_t timeout)
+{
+  if (!mRing) {
+    return FsIo::fileReadAsync(offset, buffer, length, readahead, timeout);
+  }
+
+  // The read ahead below must not race with the async writes
+  if (WaitWrites()) {
+    return SFS_ERROR;
+  }
+
+  XrdSysMutexHelper lock(mRaMutex);
+  int64_t nread = SFS_ERROR;
+
+  if (mRaOffset >= 0) {
+    (void) mRaTracker.Wait();
+
+    if ((mRaOffset == offset) && (mRaLength == length) && (mRaResult >= 0)) {
+      memcpy(buffer, mRaBuffer.data(), mRaResult);
+      nread = mRaResult;
+    }
+
+    mRaOffset = -1;
+  }
+
+  if (nread == SFS_ERROR) {
+    nread = fileRead(offset, buffer, length, timeout);
+  }
+
+  // Read the next block while the caller uses this one, unless the end of
+  // the file was reached. A failed read ahead is simply read again.
+  if (readahead && (nread == length)) {
+    if (mRaBuffer.size() < (size_t) length) {
+      mRaBuffer.resize(length);
+    }
+
+    mRaOffset = offset + length;
+    mRaLength = length;
+    mRaResult = -1;
+
+    if (mRing->Read(mFd, mRaBuffer.data(), length, mRaOffset, mRaTracker,
+                    &UringIo::ReadAheadDone, this)) {
+      mRaOffset = -1;
+    }
+  }
+
+  return nread;
+}
+
+//------------------------------------------------------------------------------
+// Write to file - sync
+//------------------------------------------------------------------------------
+int64_t
+UringIo::fileWrite(XrdSfsFileOffset offset, const char* buffer,
+                   XrdSfsXferSize length, uint16_t timeout)
+{
+  DropReadAhead();
+
+  // Overlapping async writes have to land first
+  if (WaitWrites()) {
+    return SFS_ERROR;
+  }
+
+  return FsIo::fileWrite(offset, buffer, length, timeout);
+}
+
+//------------------------------------------------------------------------------
+// Vector read - sync
+//------------------------------------------------------------------------------
+int64_t
+UringIo::fileReadV(XrdCl::ChunkList& chunkList, uint16_t timeout)
+{
+  if (WaitWrites()) {
+    return SFS_ERROR;
+  }
+
+  if (!mRing) {
+    int64_t nread = 0;
+
+    for (auto it = chunkList.begin(); it != chunkList.end(); ++it) {
+      int64_t nbytes = FsIo::fileRead(it->offset, (char*) it->buffer,
+                                      it->length, timeout);
+
+      if (nbytes == -1) {
+        return SFS_ERROR;
+      }
+
+      nread += nbytes;
+    }
+
+    return nread;
+  }
+
+  IoUring::Tracker reads;
+  int retc = SFS_OK;
+
+  for (auto it = chunkList.begin(); it != chunkList.end(); ++it) {
+    if (mRing->Read(mFd, (char*) it->buffer, it->length, it->offset, reads)) {
+      retc = SFS_ERROR;
+      break;
+    }
+  }
+
+  // Even after a failed submission the chunks in flight use the buffers
+  int error = reads.Wait();
+
+  if (retc || error) {
+    errno = (error ? error : errno);
+    return SFS_ERROR;
+  }
+
+  return reads.GetBytes();
+}
+
+//------------------------------------------------------------------------------
+// Write to file - async
+//------------------------------------------------------------------------------
+int64_t
+UringIo::fileWriteAsync(XrdSfsFileOffset offset, const char* buffer,
+                        XrdSfsXferSize length, uint16_t timeout)
+{
+  if (!mRing) {
+    return FsIo::fileWriteAsync(offset, buffer, length, timeout);
+  }
+
+  DropReadAhead();
+  // Stop at the first failed write instead of queueing more data
+  int error = mWrites.GetError();
+
+  if (error) {
+    errno = error;
+    return SFS_ERROR;
+  }
+
+  if (mRing->Write(mFd, buffer, length, offset, mWrites)) {
+    return SFS_ERROR;
+  }
+
+  return length;
+}
+
+//------------------------------------------------------------------------------
+// Wait for the async writes
+//------------------------------------------------------------------------------
+int
+UringIo::fileWaitAsyncIO()
+{
+  return WaitWrites();
+}
+
+//------------------------------------------------------------------------------
+// Truncate
+//------------------------------------------------------------------------------
+int
+UringIo::fileTruncate(XrdSfsFileOffset offset, uint16_t timeout)
+{
+  DropReadAhead();
+  // Errors of the writes are reported by the next sync or close
+  (void) mWrites.Wait();
+  return FsIo::fileTruncate(offset, timeout);
+}
+
+//------------------------------------------------------------------------------
+// Sync file to disk
+//------------------------------------------------------------------------------
+int
+UringIo::fileSync(uint16_t timeout)
+{
+  // The fsync only covers the writes completed before its submission
+  if (WaitWrites()) {
+    return SFS_ERROR;
+  }
+
+  if (!mRing) {
+    return FsIo::fileSync(timeout);
+  }
+
+  IoUring::Tracker sync;
+
+  if (mRing->Fsync(mFd, sync)) {
+    return SFS_ERROR;
+  }
+
+  int error = sync.Wait();
+
+  if (error) {
+    errno = error;
+    return SFS_ERROR;
+  }
+
+  return SFS_OK;
+}
+
+//------------------------------------------------------------------------------
+// Close file
+//------------------------------------------------------------------------------
+int
+UringIo::fileClose(uint16_t timeout)
+{
+  DropReadAhead();
+  int retc = WaitWrites();
+  int error = errno;
+
+  if (FsIo::fileClose(timeout)) {
+    return SFS_ERROR;
+  }
+
+  if (retc) {
+    errno = error;
+    return SFS_ERROR;
+  }
+
+  return SFS_OK;
+}
+
+//------------------------------------------------------------------------------
+// Get stats about the file
+//------------------------------------------------------------------------------
+int
+UringIo::fileStat(struct stat* buf, uint16_t timeout)
+{
+  // The size has to account for the async writes
+  (void) mWrites.Wait();
+  return FsIo::fileStat(buf, timeout);
+}
+
+EOSFSTNAMESPACE_END
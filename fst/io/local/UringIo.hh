@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+//! @file UringIo.hh
+//! @author agent
+//! @brief Class used for doing local IO operations through io_uring
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_URINGFILEIO__HH__
+#define __EOSFST_URINGFILEIO__HH__
+
+#include "fst/io/local/FsIo.hh"
+#include "fst/io/local/IoUring.hh"
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class used for doing local IO operations through the process-wide io_uring
+//! instance. Async writes return once the data is copied to the ring, the
+//! errors are reported by the following sync reads and writes, sync and
+//! close. Vector reads submit all the chunks at once. Async reads with read
+//! ahead submit the next block, which the following read takes if it asks
+//! for it. Without a ring all the calls go to FsIo.
+//------------------------------------------------------------------------------
+class UringIo : public FsIo
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param path file path
+  //! @param ring ring to use, the process-wide one by default
+  //----------------------------------------------------------------------------
+  UringIo(std::string path, IoUring* ring = IoUring::GetInstance());
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  virtual ~UringIo();
+
+  //----------------------------------------------------------------------------
+  //! Read from file - sync
+  //!
+  //! @param offset offset in file
+  //! @param buffer where the data is read
+  //! @param length read length
+  //! @param timeout timeout value
+  //!
+  //! @return number of bytes read or -1 if error
+  //----------------------------------------------------------------------------
+  virtual int64_t fileRead(XrdSfsFileOffset offset,
+                           char* buffer,
+                           XrdSfsXferSize length,
+                           uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Read from file - async
+  //!
+  //! @param offset offset in file
+  //! @param buffer where the data is read
+  //! @param length read length
+  //! @param readahead set if the next block is to be read ahead
+  //! @param timeout timeout value
+  //!
+  //! @return number of bytes read or -1 if error
+  //----------------------------------------------------------------------------
+  virtual int64_t fileReadAsync(XrdSfsFileOffset offset,
+                                char* buffer,
+                                XrdSfsXferSize length,
+                                bool readahead = false,
+                                uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Write to file - sync
+  //!
+  //! @param offset offset
+  //! @param buffer data to be written
+  //! @param length length
+  //! @param timeout timeout value
+  //!
+  //! @return number of bytes written or -1 if error
+  //----------------------------------------------------------------------------
+  virtual int64_t fileWrite(XrdSfsFileOffset offset,
+                            const char* buffer,
+                            XrdSfsXferSize length,
+                            uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Vector read - sync
+  //!
+  //! @param chunkList list of chunks for the vector read
+  //! @param timeout timeout value
+  //!
+  //! @return number of bytes read of -1 if error
+  //----------------------------------------------------------------------------
+  virtual int64_t fileReadV(XrdCl::ChunkList& chunkList,
+                            uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Vector read - async
+  //!
+  //! @param chunkList list of chunks for the vector read
+  //! @param timeout timeout value
+  //!
+  //! @return number of bytes read of -1 if error; this actually calls the
+  //!         ReadV sync method
+  //----------------------------------------------------------------------------
+  virtual int64_t fileReadVAsync(XrdCl::ChunkList& chunkList,
+                                 uint16_t timeout = 0)
+  {
+    return fileReadV(chunkList, timeout);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Write to file - async
+  //!
+  //! @param offset offset
+  //! @param buffer data to be written, can be reused once the call returns
+  //! @param length length
+  //! @param timeout timeout value
+  //!
+  //! @return number of bytes written or -1 if error
+  //----------------------------------------------------------------------------
+  virtual int64_t fileWriteAsync(XrdSfsFileOffset offset,
+                                 const char* buffer,
+                                 XrdSfsXferSize length,
+                                 uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Wait for the async writes
+  //!
+  //! @return 0 if all of them succeeded, -1 otherwise and errno is set
+  //----------------------------------------------------------------------------
+  virtual int fileWaitAsyncIO();
+
+  //----------------------------------------------------------------------------
+  //! Truncate
+  //!
+  //! @param offset truncate file to this value
+  //! @param timeout timeout value
+  //!
+  //! @return 0 if successful, -1 otherwise and error code is set
+  //----------------------------------------------------------------------------
+  virtual int fileTruncate(XrdSfsFileOffset offset, uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Sync file to disk
+  //!
+  //! @param timeout timeout value
+  //!
+  //! @return 0 on success, -1 otherwise and error code is set
+  //----------------------------------------------------------------------------
+  virtual int fileSync(uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Close file
+  //!
+  //! @param timeout timeout value
+  //!
+  //! @return 0 on success, -1 otherwise and error code is set
+  //----------------------------------------------------------------------------
+  virtual int fileClose(uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Get stats about the file
+  //!
+  //! @param buf stat buffer
+  //! @param timeout timeout value
+  //!
+  //! @return 0 on success, -1 otherwise and error code is set
+  //----------------------------------------------------------------------------
+  virtual int fileStat(struct stat* buf, uint16_t timeout = 0);
+
+private:
+  IoUring* mRing; ///< ring used, 0 if not available
+  IoUring::Tracker mWrites; ///< async writes of the file
+  XrdSysMutex mRaMutex; ///< protects the read ahead
+  std::vector<char> mRaBuffer; ///< block read ahead
+  XrdSfsFileOffset mRaOffset; ///< offset of the block, -1 if none
+  XrdSfsXferSize mRaLength; ///< length of the block
+  int64_t mRaResult; ///< bytes read or -errno, set on completion
+  IoUring::Tracker mRaTracker; ///< read ahead in flight
+
+  //----------------------------------------------------------------------------
+  //! Completion callback of the read ahead
+  //----------------------------------------------------------------------------
+  static void ReadAheadDone(void* arg, int result);
+
+  //----------------------------------------------------------------------------
+  //! Wait for the read ahead in flight and drop the block, before writing
+  //! or closing
+  //----------------------------------------------------------------------------
+  void DropReadAhead();
+
+  //----------------------------------------------------------------------------
+  //! Wait for the async writes before an operation depending on them
+  //!
+  //! @return 0 if all of them succeeded, -1 otherwise and errno is set
+  //----------------------------------------------------------------------------
+  int WaitWrites();
+
+  //----------------------------------------------------------------------------
+  //! Disable copy constructor
+  //----------------------------------------------------------------------------
+  UringIo(const UringIo&) = delete;
+
+  //----------------------------------------------------------------------------
+  //! Disable assign operator
+  //----------------------------------------------------------------------------
+  UringIo& operator = (const UringIo&) = delete;
+};
+
+EOSFSTNAMESPACE_END
+
+#endif  // __EOSFST_URINGFILEIO_HH__
@@ -0,0 +1,217 @@
+//------------------------------------------------------------------------------
+// File: ReadaheadStreams.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/io/xrd/ReadaheadStreams.hh"
+#include <cstdio>
+
+EOSFSTNAMESPACE_BEGIN
+
+const unsigned int ReadaheadStreams::sMaxStreams;
+
+//! Prefetched blocks seen before the waste of the file is taken into account
+static const uint64_t sMinSamples = 8;
+//! Reads confirming a stream once the readahead of the file proved wasteful
+static const uint32_t sConfirmReads = 2;
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+ReadaheadStreams::ReadaheadStreams(uint64_t blocksize, uint32_t initWindow,
+                                   uint32_t maxWindow)
+{
+  Reset(blocksize, initWindow, maxWindow);
+}
+
+//------------------------------------------------------------------------------
+// Forget all the streams and counters
+//------------------------------------------------------------------------------
+void
+ReadaheadStreams::Reset(uint64_t blocksize, uint32_t initWindow,
+                        uint32_t maxWindow)
+{
+  mBlocksize = blocksize;
+  mMaxWindow = (maxWindow ? maxWindow : 1);
+  mInitWindow = (initWindow ? initWindow : 1);
+
+  if (mInitWindow > mMaxWindow) {
+    mInitWindow = mMaxWindow;
+  }
+
+  for (unsigned int i = 0; i < sMaxStreams; i++) {
+    mStreams[i].active = false;
+    mStreams[i].next = mStreams[i].prefetch = 0;
+    mStreams[i].window = mInitWindow;
+    mStreams[i].sequential = 0;
+    mStreams[i].lastUse = 0;
+  }
+
+  mClock = mPrefetched = mHits = mWasted = mStalls = mNewStreams = 0;
+  mMaxWindowSeen = 0;
+}
+
+//------------------------------------------------------------------------------
+// Match a read to a stream
+//------------------------------------------------------------------------------
+unsigned int
+ReadaheadStreams::Access(uint64_t offset, uint32_t length, bool& isNew)
+{
+  unsigned int lru = 0;
+  mClock++;
+  isNew = false;
+
+  for (unsigned int i = 0; i < sMaxStreams; i++) {
+    Stream& st = mStreams[i];
+
+    if (!st.active) {
+      if (mStreams[lru].active) {
+        lru = i;
+      }
+
+      continue;
+    }
+
+    if ((offset + mBlocksize >= st.next) && (offset <= st.next + mBlocksize)) {
+      if (offset >= st.next) {
+        st.sequential++;
+      }
+
+      if (offset + length > st.next) {
+        st.next = offset + length;
+      }
+
+      st.lastUse = mClock;
+      return i;
+    }
+
+    if (mStreams[lru].active && (st.lastUse < mStreams[lru].lastUse)) {
+      lru = i;
+    }
+  }
+
+  Stream& st = mStreams[lru];
+  st.active = true;
+  st.next = offset + length;
+  st.prefetch = offset;
+  st.window = mInitWindow;
+  st.sequential = 0;
+  st.lastUse = mClock;
+  mNewStreams++;
+  isNew = true;
+  return lru;
+}
+
+//------------------------------------------------------------------------------
+// Check if prefetching is worth it for a stream
+//------------------------------------------------------------------------------
+bool
+ReadaheadStreams::Wanted(unsigned int stream) const
+{
+  if ((mPrefetched >= sMinSamples) && (2 * mWasted > mPrefetched)) {
+    return (mStreams[stream].sequential >= sConfirmReads);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Continue the prefetching of a stream after a block it did not prefetch
+//------------------------------------------------------------------------------
+void
+ReadaheadStreams::Restart(unsigned int stream, uint64_t offset)
+{
+  Stream& st = mStreams[stream];
+
+  if (st.sequential && (offset == st.prefetch)) {
+    Grow(st);
+  }
+
+  st.prefetch = offset + mBlocksize;
+}
+
+//------------------------------------------------------------------------------
+// The block at the next offset to prefetch was requested
+//------------------------------------------------------------------------------
+void
+ReadaheadStreams::Prefetched(unsigned int stream)
+{
+  mStreams[stream].prefetch += mBlocksize;
+  mPrefetched++;
+}
+
+//------------------------------------------------------------------------------
+// A prefetched block was read for the first time
+//------------------------------------------------------------------------------
+void
+ReadaheadStreams::Hit(unsigned int stream, bool waited)
+{
+  Stream& st = mStreams[stream];
+  mHits++;
+
+  if (waited) {
+    Grow(st);
+  }
+}
+
+//------------------------------------------------------------------------------
+// The window of a stream does not cover the latency of the requests
+//------------------------------------------------------------------------------
+void
+ReadaheadStreams::Grow(Stream& st)
+{
+  mStalls++;
+  st.window = ((2 * st.window > mMaxWindow) ? mMaxWindow : 2 * st.window);
+
+  if (st.window > mMaxWindowSeen) {
+    mMaxWindowSeen = st.window;
+  }
+}
+
+//------------------------------------------------------------------------------
+// A prefetched block was dropped without being read
+//------------------------------------------------------------------------------
+void
+ReadaheadStreams::Wasted(unsigned int stream)
+{
+  Stream& st = mStreams[stream];
+  mWasted++;
+  st.window = ((st.window > 1) ? st.window / 2 : 1);
+}
+
+//------------------------------------------------------------------------------
+// Print the efficiency of the readahead
+//------------------------------------------------------------------------------
+std::string
+ReadaheadStreams::Summary() const
+{
+  char line[256];
+  snprintf(line, sizeof(line), "prefetched=%llu hits=%llu wasted=%llu "
+           "stalls=%llu streams=%llu maxwindow=%u efficiency=%.02f",
+           (unsigned long long) mPrefetched, (unsigned long long) mHits,
+           (unsigned long long) mWasted, (unsigned long long) mStalls,
+           (unsigned long long) mNewStreams,
+           (mMaxWindowSeen > mInitWindow ? mMaxWindowSeen : mInitWindow),
+           mPrefetched ? (100.0 * mHits / mPrefetched) : 0.0);
+  return std::string(line);
+}
+
+EOSFSTNAMESPACE_END
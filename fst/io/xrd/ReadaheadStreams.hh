@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+//! @file ReadaheadStreams.hh
+//! @author agent
+//! @brief Detection of the sequential streams of a file and sizing of their
+//!        readahead window
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_READAHEADSTREAMS_HH__
+#define __EOSFST_READAHEADSTREAMS_HH__
+
+#include "fst/Namespace.hh"
+#include <stdint.h>
+#include <string>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class ReadaheadStreams
+//!
+//! Each read is matched against the streams already seen for the file: a read
+//! starting within one block of where a stream stopped continues it, any other
+//! read starts a new stream, replacing the least recently used one. Every
+//! stream has its own window, the number of blocks prefetched ahead of its
+//! reader. The window doubles when the reader has to wait for a prefetched
+//! block and halves when a prefetched block is dropped without being read.
+//! Once most of the prefetched blocks of the file are wasted, a stream has to
+//! be confirmed by consecutive reads before anything is prefetched for it.
+//!
+//! Not thread-safe, the caller serialises the access.
+//------------------------------------------------------------------------------
+class ReadaheadStreams
+{
+public:
+  static const unsigned int sMaxStreams = 4; ///< streams tracked per file
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param blocksize size of a readahead block
+  //! @param initWindow window of a new stream, in blocks
+  //! @param maxWindow largest window of a stream, in blocks
+  //----------------------------------------------------------------------------
+  ReadaheadStreams(uint64_t blocksize = 1024 * 1024, uint32_t initWindow = 1,
+                   uint32_t maxWindow = 8);
+
+  //----------------------------------------------------------------------------
+  //! Forget all the streams and counters and change the configuration
+  //----------------------------------------------------------------------------
+  void Reset(uint64_t blocksize, uint32_t initWindow, uint32_t maxWindow);
+
+  //----------------------------------------------------------------------------
+  //! Match a read to a stream
+  //!
+  //! @param offset read offset
+  //! @param length read length
+  //! @param isNew set to true if a new stream was started in the returned
+  //!        slot, the blocks prefetched for the previous user of the slot
+  //!        have to be dropped
+  //!
+  //! @return stream index
+  //----------------------------------------------------------------------------
+  unsigned int Access(uint64_t offset, uint32_t length, bool& isNew);
+
+  //----------------------------------------------------------------------------
+  //! Check if prefetching is worth it for a stream
+  //----------------------------------------------------------------------------
+  bool Wanted(unsigned int stream) const;
+
+  //----------------------------------------------------------------------------
+  //! The block at an offset is read without having been prefetched by the
+  //! stream, the prefetching continues after it. If the reader caught up with
+  //! the prefetching, the window did not cover the latency and grows.
+  //!
+  //! @param stream stream index
+  //! @param offset begin offset of the block
+  //----------------------------------------------------------------------------
+  void Restart(unsigned int stream, uint64_t offset);
+
+  //----------------------------------------------------------------------------
+  //! Get the next offset to prefetch for a stream
+  //----------------------------------------------------------------------------
+  uint64_t GetPrefetch(unsigned int stream) const
+  {
+    return mStreams[stream].prefetch;
+  }
+
+  //----------------------------------------------------------------------------
+  //! The block at the next offset to prefetch was requested
+  //----------------------------------------------------------------------------
+  void Prefetched(unsigned int stream);
+
+  //----------------------------------------------------------------------------
+  //! Move the prefetching of a stream past the next block without requesting
+  //! it, e.g. when it is already available
+  //----------------------------------------------------------------------------
+  void Skip(unsigned int stream)
+  {
+    mStreams[stream].prefetch += mBlocksize;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the window of a stream
+  //----------------------------------------------------------------------------
+  uint32_t GetWindow(unsigned int stream) const
+  {
+    return mStreams[stream].window;
+  }
+
+  //----------------------------------------------------------------------------
+  //! A prefetched block was read for the first time
+  //!
+  //! @param stream stream which prefetched the block
+  //! @param waited the reader had to wait for the block to arrive
+  //----------------------------------------------------------------------------
+  void Hit(unsigned int stream, bool waited);
+
+  //----------------------------------------------------------------------------
+  //! A prefetched block was dropped without being read
+  //----------------------------------------------------------------------------
+  void Wasted(unsigned int stream);
+
+  //----------------------------------------------------------------------------
+  //! Check if any block was prefetched
+  //----------------------------------------------------------------------------
+  bool Used() const
+  {
+    return (mPrefetched != 0);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Print the efficiency of the readahead as key=value pairs
+  //----------------------------------------------------------------------------
+  std::string Summary() const;
+
+private:
+  struct Stream {
+    bool active; ///< slot holds a stream
+    uint64_t next; ///< offset following the furthest read of the stream
+    uint64_t prefetch; ///< next offset to prefetch
+    uint32_t window; ///< blocks prefetched ahead of the reader
+    uint32_t sequential; ///< consecutive reads continuing the stream
+    uint64_t lastUse; ///< access clock value of the last read
+  };
+
+  Stream mStreams[sMaxStreams];
+  uint64_t mBlocksize; ///< size of a readahead block
+  uint32_t mInitWindow; ///< window of a new stream
+  uint32_t mMaxWindow; ///< largest window of a stream
+  uint64_t mClock; ///< number of reads seen
+  uint64_t mPrefetched; ///< blocks prefetched
+  uint64_t mHits; ///< prefetched blocks which were read
+  uint64_t mWasted; ///< prefetched blocks dropped unread
+  uint64_t mStalls; ///< hits which had to wait for the block
+  uint64_t mNewStreams; ///< streams started
+  uint32_t mMaxWindowSeen; ///< largest window reached by a stream
+
+  //----------------------------------------------------------------------------
+  //! Double the window of a stream whose reader had to wait
+  //----------------------------------------------------------------------------
+  void Grow(Stream& st);
+};
+
+EOSFSTNAMESPACE_END
+
+#endif // __EOSFST_READAHEADSTREAMS_HH__
@@ -28,6 +28,7 @@
 #include "fst/io/VectChunkHandler.hh"
 #include "common/FileMap.hh"
 #include "common/Logging.hh"
+#include "common/EnvTunable.hh"
 #include "XrdCl/XrdClDefaultEnv.hh"
 #include "XrdCl/XrdClBuffer.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
@@ -47,6 +48,18 @@ uint32_t XrdIo::sConnectionPoolMaxSize = 64;
 XrdSysMutex XrdIo::sConnectionPoolMutex;
 std::map<std::string, std::map<int, size_t> > XrdIo::sConnectionPool;
 
+//------------------------------------------------------------------------------
+// Largest readahead window of a stream, in blocks
+//------------------------------------------------------------------------------
+static uint32_t
+RdAheadMaxWindow()
+{
+  static const uint32_t max_window =
+    eos::common::EnvTunable::Get("EOS_FST_READAHEAD_MAX_WINDOW", 8,
+                                 XrdIo::sNumRdAheadBlocks, 64);
+  return max_window;
+}
+
 namespace
 {
 std::string getAttrUrl(std::string path)
@@ -100,6 +113,9 @@ XrdIo::XrdIo(std::string path) :
   mBlocksize(ReadaheadBlock::sDefaultBlocksize),
   mXrdFile(NULL),
   mMetaHandler(new AsyncMetaHandler()),
+  mNumBlocks(0),
+  mMaxBlocks(0),
+  mReadEnd(UINT64_MAX),
   mConnectionId(0)
 {
   // Set the TimeoutResolution to 1
@@ -132,17 +148,20 @@ XrdIo::~XrdIo()
 
   DropConnection();
 
-  if (mDoReadahead) {
-    while (!mQueueBlocks.empty()) {
-      ReadaheadBlock* ptr_readblock = mQueueBlocks.front();
-      mQueueBlocks.pop();
-      delete ptr_readblock;
-    }
+  while (!mQueueBlocks.empty()) {
+    ReadaheadBlock* ptr_readblock = mQueueBlocks.front();
+    mQueueBlocks.pop();
+    delete ptr_readblock;
+  }
 
-    while (!mMapBlocks.empty()) {
-      delete mMapBlocks.begin()->second;
-      mMapBlocks.erase(mMapBlocks.begin());
-    }
+  while (!mMapBlocks.empty()) {
+    delete mMapBlocks.begin()->second;
+    mMapBlocks.erase(mMapBlocks.begin());
+  }
+
+  while (!mDiscardedBlocks.empty()) {
+    delete mDiscardedBlocks.front();
+    mDiscardedBlocks.pop_front();
   }
 
   delete mMetaHandler;
@@ -173,26 +192,11 @@ XrdIo::fileOpen(XrdSfsFileOpenMode flags,
                 const std::string& opaque,
                 uint16_t timeout)
 {
-  const char* val = 0;
   std::string request;
   std::string lOpaque;
   XrdOucEnv open_opaque(mOpaque.c_str());
 
-  // Decide if readahead is used and the block size
-  if ((val = open_opaque.Get("fst.readahead")) &&
-      (strncmp(val, "true", 4) == 0)) {
-    eos_debug("Enabling the readahead.");
-    mDoReadahead = true;
-    val = 0;
-
-    if ((val = open_opaque.Get("fst.blocksize"))) {
-      mBlocksize = static_cast<uint64_t>(atoll(val));
-    }
-
-    for (unsigned int i = 0; i < sNumRdAheadBlocks; i++) {
-      mQueueBlocks.push(new ReadaheadBlock(mBlocksize));
-    }
-  }
+  InitReadahead(open_opaque);
 
   request = mFilePath;
 
@@ -253,7 +257,6 @@ XrdIo::fileOpenAsync(void* io_handler,
                      XrdSfsFileOpenMode flags, mode_t mode,
                      const std::string& opaque, uint16_t timeout)
 {
-  const char* val = 0;
   std::string request;
   std::string lOpaque;
   size_t qpos = 0;
@@ -268,21 +271,7 @@ XrdIo::fileOpenAsync(void* io_handler,
 
   XrdOucEnv open_opaque(lOpaque.c_str());
 
-  // Decide if readahead is used and the block size
-  if ((val = open_opaque.Get("fst.readahead")) &&
-      (strncmp(val, "true", 4) == 0)) {
-    eos_debug("Enabling the readahead.");
-    mDoReadahead = true;
-    val = 0;
-
-    if ((val = open_opaque.Get("fst.blocksize"))) {
-      mBlocksize = static_cast<uint64_t>(atoll(val));
-    }
-
-    for (unsigned int i = 0; i < sNumRdAheadBlocks; i++) {
-      mQueueBlocks.push(new ReadaheadBlock(mBlocksize));
-    }
-  }
+  InitReadahead(open_opaque);
 
   request = mFilePath;
   request += "?";
@@ -417,95 +406,87 @@ XrdIo::fileReadAsync(XrdSfsFileOffset offset, char* buffer,
     uint64_t read_length = 0;
     uint32_t aligned_length;
     uint32_t shift;
-    std::map<uint64_t, ReadaheadBlock*>::iterator iter;
+    bool new_stream = false;
+    PrefetchMap::iterator iter;
     mPrefetchMutex.Lock(); // -->
+    ReclaimBlocks();
+    unsigned int stream = mStreams.Access(offset, length, new_stream);
+
+    if (new_stream) {
+      // Cancel the readahead of the stream which used this slot before
+      DropStreamBlocks(stream);
+    }
 
     while (length) {
       iter = FindBlock(offset);
 
-      if (iter != mMapBlocks.end()) {
-        // Block found in prefetched blocks
-        SimpleHandler* sh = iter->second->handler;
-        shift = offset - iter->first;
-
-        // We can prefetch another block if we still have available blocks in
-        // the queue or if first read was from second prefetched block
-        if (!mQueueBlocks.empty() || (iter != mMapBlocks.begin())) {
-          if (iter != mMapBlocks.begin()) {
-            eos_debug("recycle the oldest block");
-            mQueueBlocks.push(mMapBlocks.begin()->second);
-            mMapBlocks.erase(mMapBlocks.begin());
-          }
-
-          eos_debug("prefetch new block(2)");
-
-          if (!PrefetchBlock(offset + mBlocksize, false, timeout)) {
-            eos_warning("failed to send prefetch request(2)");
-            break;
-          }
+      if (iter == mMapBlocks.end()) {
+        if (!mStreams.Wanted(stream) || ((uint64_t) offset >= mReadEnd)) {
+          break;
         }
 
-        if (sh->WaitOK()) {
-          eos_debug("block in cache, blk_off=%lld, req_off= %lld", iter->first, offset);
-
-          if (sh->GetRespLength() == 0) {
-            // The request got a response but it read 0 bytes
-            eos_warning("response contains 0 bytes");
-            break;
-          }
-
-          aligned_length = sh->GetRespLength() - shift;
-          read_length = ((uint32_t) length < aligned_length) ? length : aligned_length;
-
-          // If prefetch block smaller than mBlocksize and current offset at end
-          // of the prefetch block then we reached the end of file
-          if ((sh->GetRespLength() != mBlocksize) &&
-              ((uint64_t) offset >= iter->first + sh->GetRespLength())) {
-            done_read = true;
-            break;
-          }
-
-          pBuff = static_cast<char*>(memcpy(pBuff, iter->second->buffer + shift,
-                                            read_length));
-          pBuff += read_length;
-          offset += read_length;
-          length -= read_length;
-          nread += read_length;
-        } else {
-          // Error while prefetching, remove block from map
-          mQueueBlocks.push(iter->second);
-          mMapBlocks.erase(iter);
-          eos_err("error=prefetching failed, disable it and remove block from map");
-          mDoReadahead = false;
+        // The stream moved away from its blocks, restart its readahead here
+        eos_debug("prefetch new block(1)");
+        DropStreamBlocks(stream);
+
+        if (!PrefetchBlock(offset, stream, true, timeout)) {
+          eos_warning("failed to send prefetch request(1)");
           break;
         }
-      } else {
-        // Remove all elements from map so that we can align with the new
-        // requests and prefetch a new block. But first we need to collect any
-        // responses which are in-flight as otherwise these response might
-        // arrive later on, when we are expecting replies for other blocks since
-        // we are recycling the SimpleHandler objects.
-        while (!mMapBlocks.empty()) {
-          SimpleHandler* sh = mMapBlocks.begin()->second->handler;
-
-          if (sh->HasRequest()) {
-            // Not interested in the result - discard it
-            sh->WaitOK();
-          }
-
-          mQueueBlocks.push(mMapBlocks.begin()->second);
-          mMapBlocks.erase(mMapBlocks.begin());
-        }
 
-        if (!mQueueBlocks.empty()) {
-          eos_debug("prefetch new block(1)");
+        mStreams.Restart(stream, offset);
+        continue;
+      }
 
-          if (!PrefetchBlock(offset, false, timeout)) {
-            eos_err("error=failed to send prefetch request(1)");
-            mDoReadahead = false;
-            break;
-          }
-        }
+      // Block found in prefetched blocks
+      ReadaheadBlock* block = iter->second;
+      SimpleHandler* sh = block->handler;
+      shift = offset - iter->first;
+      bool waited = !sh->IsDone();
+
+      if (!sh->WaitOK()) {
+        // Error while prefetching, remove block from map
+        block->used = true;
+        RecycleBlock(iter);
+        eos_err("error=prefetching failed, disable it and remove block from map");
+        mDoReadahead = false;
+        break;
+      }
+
+      if (!block->used) {
+        block->used = true;
+        mStreams.Hit(block->stream, waited);
+      }
+
+      eos_debug("block in cache, blk_off=%lld, req_off= %lld", iter->first, offset);
+
+      // A short block marks the end of file, nothing to prefetch after it
+      if ((sh->GetRespLength() < block->size) &&
+          (iter->first + sh->GetRespLength() < mReadEnd)) {
+        mReadEnd = iter->first + sh->GetRespLength();
+      }
+
+      if ((uint64_t) offset >= iter->first + sh->GetRespLength()) {
+        done_read = true;
+        break;
+      }
+
+      aligned_length = sh->GetRespLength() - shift;
+      read_length = ((uint32_t) length < aligned_length) ? length : aligned_length;
+      pBuff = static_cast<char*>(memcpy(pBuff, block->buffer + shift,
+                                        read_length));
+      pBuff += read_length;
+      offset += read_length;
+      length -= read_length;
+      nread += read_length;
+    }
+
+    if (mDoReadahead) {
+      // Recycle what the stream read and keep its window full
+      DropStreamBlocks(stream, offset);
+
+      if (mStreams.Wanted(stream)) {
+        PrefetchStream(stream, offset, timeout);
       }
     }
 
@@ -537,7 +518,8 @@ XrdIo::fileReadAsync(XrdSfsFileOffset offset, char* buffer,
         mMetaHandler->HandleResponse(&status, handler);
       }
 
-      nread = length;
+      // offset and length already skip what was served from the blocks
+      nread += length;
     }
   }
 
@@ -567,7 +549,8 @@ XrdIo::FindBlock(uint64_t offset)
       // Check if the previous block, we know the map is not empty
       iter--;
 
-      if ((iter->first <= offset) && (offset < (iter->first + mBlocksize))) {
+      if ((iter->first <= offset) &&
+          (offset < (iter->first + iter->second->size))) {
         return iter;
       } else {
         return mMapBlocks.end();
@@ -724,7 +707,7 @@ XrdIo::fileWaitAsyncIO()
 {
   bool async_ok = true;
 
-  if (mDoReadahead) {
+  {
     XrdSysMutexHelper scope_lock(mPrefetchMutex);
 
     // Wait for any requests on the fly and then close
@@ -737,6 +720,15 @@ XrdIo::fileWaitAsyncIO()
 
       delete mMapBlocks.begin()->second;
       mMapBlocks.erase(mMapBlocks.begin());
+      mNumBlocks--;
+    }
+
+    // Nobody is interested in the result of the discarded blocks
+    while (!mDiscardedBlocks.empty()) {
+      (void) mDiscardedBlocks.front()->handler->WaitOK();
+      delete mDiscardedBlocks.front();
+      mDiscardedBlocks.pop_front();
+      mNumBlocks--;
     }
   }
 
@@ -881,6 +873,11 @@ XrdIo::fileClose(uint16_t timeout)
     async_ok = false;
   }
 
+  if (mStreams.Used()) {
+    eos_info("msg=\"readahead efficiency\" path=%s %s", mFilePath.c_str(),
+             mStreams.Summary().c_str());
+  }
+
   XrdCl::XRootDStatus status = mXrdFile->Close(timeout);
 
   if (!status.IsOK()) {
@@ -996,12 +993,36 @@ XrdIo::CleanReadCache()
 {
   if (mDoReadahead) {
     fileWaitAsyncIO();
+    // The file might have grown since
+    XrdSysMutexHelper scope_lock(mPrefetchMutex);
+    mReadEnd = UINT64_MAX;
+  }
+}
 
-    if (mQueueBlocks.empty()) {
-      for (unsigned int i = 0; i < sNumRdAheadBlocks; i++) {
-        mQueueBlocks.push(new ReadaheadBlock(mBlocksize));
-      }
+//------------------------------------------------------------------------------
+// Enable the readahead if requested at open
+//------------------------------------------------------------------------------
+void
+XrdIo::InitReadahead(XrdOucEnv& openOpaque)
+{
+  const char* val = 0;
+
+  // Decide if readahead is used and the block size
+  if ((val = openOpaque.Get("fst.readahead")) &&
+      (strncmp(val, "true", 4) == 0)) {
+    eos_debug("Enabling the readahead.");
+    mDoReadahead = true;
+    val = 0;
+
+    if ((val = openOpaque.Get("fst.blocksize"))) {
+      mBlocksize = static_cast<uint64_t>(atoll(val));
     }
+
+    // Blocks are allocated on demand, up to two full windows
+    XrdSysMutexHelper scope_lock(mPrefetchMutex);
+    mStreams.Reset(mBlocksize, sNumRdAheadBlocks - 1, RdAheadMaxWindow());
+    mMaxBlocks = 2 * RdAheadMaxWindow();
+    mReadEnd = UINT64_MAX;
   }
 }
 
@@ -1009,23 +1030,34 @@ XrdIo::CleanReadCache()
 // Prefetch block using the readahead mechanism
 //------------------------------------------------------------------------------
 bool
-XrdIo::PrefetchBlock(int64_t offset, bool isWrite, uint16_t timeout)
+XrdIo::PrefetchBlock(int64_t offset, unsigned int stream, bool demand,
+                     uint16_t timeout)
 {
-  bool done = true;
   XrdCl::XRootDStatus status;
   ReadaheadBlock* block = NULL;
   eos_debug("try to prefetch with offset: %lli, length: %4u",
             offset, mBlocksize);
 
+  // Drop the free blocks of a previous block size
+  while (!mQueueBlocks.empty() && (mQueueBlocks.front()->size != mBlocksize)) {
+    delete mQueueBlocks.front();
+    mQueueBlocks.pop();
+    mNumBlocks--;
+  }
+
   if (!mQueueBlocks.empty()) {
     block = mQueueBlocks.front();
     mQueueBlocks.pop();
+  } else if (mNumBlocks < mMaxBlocks) {
+    block = new ReadaheadBlock(mBlocksize);
+    mNumBlocks++;
   } else {
-    done = false;
-    return done;
+    return false;
   }
 
-  block->handler->Update(offset, mBlocksize, isWrite);
+  block->used = demand;
+  block->stream = stream;
+  block->Update(offset, mBlocksize, false);
   status = mXrdFile->Read(offset, mBlocksize, block->buffer, block->handler,
                           timeout);
 
@@ -1033,13 +1065,124 @@ XrdIo::PrefetchBlock(int64_t offset, bool isWrite, uint16_t timeout)
     // Create tmp status which is deleted in the HandleResponse method
     XrdCl::XRootDStatus* tmp_status = new XrdCl::XRootDStatus(status);
     block->handler->HandleResponse(tmp_status, NULL);
+    (void) block->handler->WaitOK();
     mQueueBlocks.push(block);
-    done = false;
-  } else {
-    mMapBlocks.insert(std::make_pair(offset, block));
+    return false;
+  }
+
+  mMapBlocks.insert(std::make_pair(offset, block));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Fill the window of a stream with prefetch requests
+//------------------------------------------------------------------------------
+void
+XrdIo::PrefetchStream(unsigned int stream, uint64_t offset, uint16_t timeout)
+{
+  uint32_t ahead = 0;
+
+  for (PrefetchMap::iterator iter = mMapBlocks.upper_bound(offset);
+       iter != mMapBlocks.end(); ++iter) {
+    if (iter->second->stream == stream) {
+      ahead++;
+    }
+  }
+
+  while ((ahead < mStreams.GetWindow(stream)) &&
+         (mStreams.GetPrefetch(stream) < mReadEnd)) {
+    uint64_t next = mStreams.GetPrefetch(stream);
+
+    if (next + mBlocksize <= offset) {
+      // The reader went past the prefetching, resume it where the reader is
+      mStreams.Restart(stream, next);
+
+      while (mStreams.GetPrefetch(stream) + mBlocksize <= offset) {
+        mStreams.Skip(stream);
+      }
+
+      continue;
+    }
+
+    if (FindBlock(next) != mMapBlocks.end()) {
+      // Already requested for another stream reading the same data
+      mStreams.Skip(stream);
+      ahead += (next > offset);
+      continue;
+    }
+
+    eos_debug("prefetch new block(2)");
+
+    if (!PrefetchBlock(next, stream, false, timeout)) {
+      break;
+    }
+
+    mStreams.Prefetched(stream);
+    ahead += (next > offset);
   }
+}
+
+//------------------------------------------------------------------------------
+// Remove a block from the map and make it available again
+//------------------------------------------------------------------------------
+void
+XrdIo::RecycleBlock(PrefetchMap::iterator iter)
+{
+  ReadaheadBlock* block = iter->second;
+  mMapBlocks.erase(iter);
+
+  if (!block->used) {
+    mStreams.Wasted(block->stream);
+  }
+
+  if (block->handler->HasRequest()) {
+    if (!block->handler->IsDone()) {
+      // The response still has to land in the buffer, reuse it later
+      mDiscardedBlocks.push_back(block);
+      return;
+    }
+
+    (void) block->handler->WaitOK();
+  }
+
+  mQueueBlocks.push(block);
+}
 
-  return done;
+//------------------------------------------------------------------------------
+// Recycle the blocks of a stream which end before an offset
+//------------------------------------------------------------------------------
+void
+XrdIo::DropStreamBlocks(unsigned int stream, uint64_t end)
+{
+  PrefetchMap::iterator iter = mMapBlocks.begin();
+
+  while ((iter != mMapBlocks.end()) && (iter->first < end)) {
+    if ((iter->second->stream == stream) &&
+        ((end == UINT64_MAX) || (iter->first + iter->second->size <= end))) {
+      RecycleBlock(iter++);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Make the discarded blocks whose response arrived available again
+//------------------------------------------------------------------------------
+void
+XrdIo::ReclaimBlocks()
+{
+  std::list<ReadaheadBlock*>::iterator iter = mDiscardedBlocks.begin();
+
+  while (iter != mDiscardedBlocks.end()) {
+    if ((*iter)->handler->IsDone()) {
+      (void)(*iter)->handler->WaitOK();
+      mQueueBlocks.push(*iter);
+      iter = mDiscardedBlocks.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
 }
 
 //------------------------------------------------------------------------------
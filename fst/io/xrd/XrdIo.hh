@@ -27,8 +27,12 @@
 
 #include "fst/io/FileIo.hh"
 #include "fst/io/SimpleHandler.hh"
+#include "fst/io/xrd/ReadaheadStreams.hh"
 #include "common/FileMap.hh"
+#include "common/BufferPool.hh"
 #include "XrdCl/XrdClFile.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include <list>
 #include <queue>
 
 EOSFSTNAMESPACE_BEGIN
@@ -88,9 +92,10 @@ struct ReadaheadBlock {
   //!
   //! @param blocksize the size of the readahead
   //----------------------------------------------------------------------------
-  ReadaheadBlock(uint64_t blocksize = sDefaultBlocksize)
+  ReadaheadBlock(uint64_t blocksize = sDefaultBlocksize):
+    size(blocksize), used(false), stream(0)
   {
-    buffer = new char[blocksize];
+    buffer = eos::common::BufferPool::GetInstance().Allocate(blocksize);
     handler = new SimpleHandler();
   }
 
@@ -111,10 +116,13 @@ struct ReadaheadBlock {
   //----------------------------------------------------------------------------
   virtual ~ReadaheadBlock()
   {
-    delete[] buffer;
+    eos::common::BufferPool::GetInstance().Release(buffer, size);
     delete handler;
   }
 
+  uint64_t size; ///< size of the buffer
+  bool used; ///< block was read since it was requested
+  unsigned int stream; ///< readahead stream which requested the block
   char* buffer; ///< pointer to where the data is read
   SimpleHandler* handler; ///< async handler for the requests
 };
@@ -127,7 +135,8 @@ class XrdIo : public FileIo
 {
   friend class AsyncIoOpenHandler;
 public:
-  static const uint32_t sNumRdAheadBlocks; ///< no. of blocks used for readahead
+  //! Blocks of a new readahead stream, the one being read included
+  static const uint32_t sNumRdAheadBlocks;
 
   //----------------------------------------------------------------------------
   //! Constructor
@@ -515,6 +524,12 @@ private:
   AsyncMetaHandler* mMetaHandler; ///< async requests meta handler
   PrefetchMap mMapBlocks; ///< map of block read/prefetched
   std::queue<ReadaheadBlock*> mQueueBlocks; ///< queue containing available blocks
+  //! Blocks dropped while their request was in flight
+  std::list<ReadaheadBlock*> mDiscardedBlocks;
+  uint32_t mNumBlocks; ///< readahead blocks allocated
+  uint32_t mMaxBlocks; ///< limit of the readahead blocks
+  uint64_t mReadEnd; ///< end of file seen by the readahead
+  ReadaheadStreams mStreams; ///< sequential streams of the reads
   XrdSysMutex mPrefetchMutex; ///< mutex to serialise the prefetch step
   eos::common::FileMap mFileMap; ///< extended attribute file map
   std::string mAttrUrl; ///< extended attribute url
@@ -541,15 +556,55 @@ private:
   void DumpConnectionPool();
 
   //----------------------------------------------------------------------------
-  //! Method used to prefetch the next block using the readahead mechanism
+  //! Enable the readahead if requested in the opaque info of the open
   //!
-  //! @param offset begin offset of the current block we are reading
-  //! @param isWrite true if block is for write, false otherwise
+  //! @param openOpaque opaque info of the open
+  //----------------------------------------------------------------------------
+  void InitReadahead(XrdOucEnv& openOpaque);
+
+  //----------------------------------------------------------------------------
+  //! Method used to prefetch a block using the readahead mechanism
+  //!
+  //! @param offset begin offset of the block
+  //! @param stream readahead stream requesting the block
+  //! @param demand block is needed by the current read, not speculative
   //! @param timeout timeout value
   //!
   //! @return true if prefetch request was sent, otherwise false
   //----------------------------------------------------------------------------
-  bool PrefetchBlock(int64_t offset, bool isWrite, uint16_t timeout = 0);
+  bool PrefetchBlock(int64_t offset, unsigned int stream, bool demand,
+                     uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Fill the window of a stream with prefetch requests
+  //!
+  //! @param stream readahead stream
+  //! @param offset current offset of the reader of the stream
+  //! @param timeout timeout value
+  //----------------------------------------------------------------------------
+  void PrefetchStream(unsigned int stream, uint64_t offset,
+                      uint16_t timeout = 0);
+
+  //----------------------------------------------------------------------------
+  //! Remove a block from the map and make it available again. A block still
+  //! waiting for its response is only reused once the response arrived.
+  //!
+  //! @param iter block in the map
+  //----------------------------------------------------------------------------
+  void RecycleBlock(PrefetchMap::iterator iter);
+
+  //----------------------------------------------------------------------------
+  //! Recycle the blocks of a stream which end before an offset
+  //!
+  //! @param stream readahead stream
+  //! @param end offset, by default all the blocks of the stream
+  //----------------------------------------------------------------------------
+  void DropStreamBlocks(unsigned int stream, uint64_t end = UINT64_MAX);
+
+  //----------------------------------------------------------------------------
+  //! Make the discarded blocks whose response arrived available again
+  //----------------------------------------------------------------------------
+  void ReclaimBlocks();
 
   //----------------------------------------------------------------------------
   //! Try to find a block in cache with contains the provided offset
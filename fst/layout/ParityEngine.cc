@@ -0,0 +1,451 @@
+//------------------------------------------------------------------------------
+// File: ParityEngine.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/layout/ParityEngine.hh"
+#include "fst/layout/jerasure/include/jerasure.h"
+#include "fst/layout/jerasure/include/cauchy.h"
+#include "XrdSys/XrdSysPthread.hh"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define EOS_PARITYENGINE_X86 1
+#include <immintrin.h>
+#endif
+
+EOSFSTNAMESPACE_BEGIN
+
+const size_t RaidDpParityPlan::sSliceSize;
+
+//------------------------------------------------------------------------------
+// XOR kernels
+//------------------------------------------------------------------------------
+void
+xorRegionsScalar(char* dst, const char* const* srcs, unsigned int nsrcs,
+                 size_t length)
+{
+  if (!nsrcs) {
+    memset(dst, 0, length);
+    return;
+  }
+
+  size_t i = 0;
+
+  for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+    uint64_t acc;
+    memcpy(&acc, srcs[0] + i, sizeof(acc));
+
+    for (unsigned int s = 1; s < nsrcs; s++) {
+      uint64_t val;
+      memcpy(&val, srcs[s] + i, sizeof(val));
+      acc ^= val;
+    }
+
+    memcpy(dst + i, &acc, sizeof(acc));
+  }
+
+  for (; i < length; i++) {
+    char acc = srcs[0][i];
+
+    for (unsigned int s = 1; s < nsrcs; s++) {
+      acc ^= srcs[s][i];
+    }
+
+    dst[i] = acc;
+  }
+}
+
+#ifdef EOS_PARITYENGINE_X86
+__attribute__((target("sse2"))) static void
+xorRegionsSse2(char* dst, const char* const* srcs, unsigned int nsrcs,
+               size_t length)
+{
+  if (!nsrcs) {
+    memset(dst, 0, length);
+    return;
+  }
+
+  size_t i = 0;
+
+  for (; i + 64 <= length; i += 64) {
+    const char* s0 = srcs[0] + i;
+    __m128i a0 = _mm_loadu_si128((const __m128i*)(s0));
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(s0 + 16));
+    __m128i a2 = _mm_loadu_si128((const __m128i*)(s0 + 32));
+    __m128i a3 = _mm_loadu_si128((const __m128i*)(s0 + 48));
+
+    for (unsigned int s = 1; s < nsrcs; s++) {
+      const char* p = srcs[s] + i;
+      a0 = _mm_xor_si128(a0, _mm_loadu_si128((const __m128i*)(p)));
+      a1 = _mm_xor_si128(a1, _mm_loadu_si128((const __m128i*)(p + 16)));
+      a2 = _mm_xor_si128(a2, _mm_loadu_si128((const __m128i*)(p + 32)));
+      a3 = _mm_xor_si128(a3, _mm_loadu_si128((const __m128i*)(p + 48)));
+    }
+
+    _mm_storeu_si128((__m128i*)(dst + i), a0);
+    _mm_storeu_si128((__m128i*)(dst + i + 16), a1);
+    _mm_storeu_si128((__m128i*)(dst + i + 32), a2);
+    _mm_storeu_si128((__m128i*)(dst + i + 48), a3);
+  }
+
+  if (i < length) {
+    const char* tails[nsrcs];
+
+    for (unsigned int s = 0; s < nsrcs; s++) {
+      tails[s] = srcs[s] + i;
+    }
+
+    xorRegionsScalar(dst + i, tails, nsrcs, length - i);
+  }
+}
+
+__attribute__((target("avx2"))) static void
+xorRegionsAvx2(char* dst, const char* const* srcs, unsigned int nsrcs,
+               size_t length)
+{
+  if (!nsrcs) {
+    memset(dst, 0, length);
+    return;
+  }
+
+  size_t i = 0;
+
+  for (; i + 128 <= length; i += 128) {
+    const char* s0 = srcs[0] + i;
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)(s0));
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(s0 + 32));
+    __m256i a2 = _mm256_loadu_si256((const __m256i*)(s0 + 64));
+    __m256i a3 = _mm256_loadu_si256((const __m256i*)(s0 + 96));
+
+    for (unsigned int s = 1; s < nsrcs; s++) {
+      const char* p = srcs[s] + i;
+      a0 = _mm256_xor_si256(a0, _mm256_loadu_si256((const __m256i*)(p)));
+      a1 = _mm256_xor_si256(a1, _mm256_loadu_si256((const __m256i*)(p + 32)));
+      a2 = _mm256_xor_si256(a2, _mm256_loadu_si256((const __m256i*)(p + 64)));
+      a3 = _mm256_xor_si256(a3, _mm256_loadu_si256((const __m256i*)(p + 96)));
+    }
+
+    _mm256_storeu_si256((__m256i*)(dst + i), a0);
+    _mm256_storeu_si256((__m256i*)(dst + i + 32), a1);
+    _mm256_storeu_si256((__m256i*)(dst + i + 64), a2);
+    _mm256_storeu_si256((__m256i*)(dst + i + 96), a3);
+  }
+
+  if (i < length) {
+    const char* tails[nsrcs];
+
+    for (unsigned int s = 0; s < nsrcs; s++) {
+      tails[s] = srcs[s] + i;
+    }
+
+    xorRegionsSse2(dst + i, tails, nsrcs, length - i);
+  }
+}
+#endif
+
+typedef void (*tXorKernel)(char*, const char* const*, unsigned int, size_t);
+
+struct XorKernel {
+  tXorKernel kernel;
+  const char* name;
+};
+
+static XorKernel
+selectXorKernel()
+{
+  XorKernel k = { &xorRegionsScalar, "scalar" };
+#ifdef EOS_PARITYENGINE_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) {
+    k.kernel = &xorRegionsAvx2;
+    k.name = "avx2";
+  } else if (__builtin_cpu_supports("sse2")) {
+    k.kernel = &xorRegionsSse2;
+    k.name = "sse2";
+  }
+
+#endif
+  return k;
+}
+
+// resolved once, safe even if used during static initialization
+static const XorKernel&
+xorKernel()
+{
+  static const XorKernel kernel = selectXorKernel();
+  return kernel;
+}
+
+void
+xorRegions(char* dst, const char* const* srcs, unsigned int nsrcs,
+           size_t length)
+{
+  xorKernel().kernel(dst, srcs, nsrcs, length);
+}
+
+const char*
+xorKernelName()
+{
+  return xorKernel().name;
+}
+
+//------------------------------------------------------------------------------
+// RAID-DP plan, the blocks are selected exactly like the original pairwise
+// computation in RaidDpLayout did
+//------------------------------------------------------------------------------
+RaidDpParityPlan::RaidDpParityPlan(unsigned int nbDataFiles)
+{
+  unsigned int nb_total_files = nbDataFiles + 2;
+  unsigned int nb_total_blocks = nbDataFiles * nbDataFiles + 2 * nbDataFiles;
+
+  // Simple parity: the data blocks of the line
+  for (unsigned int i = 0; i < nbDataFiles; i++) {
+    unsigned int index_pblock = (i + 1) * nbDataFiles + 2 * i;
+    std::vector<unsigned int> srcs;
+
+    for (unsigned int b = i * (nbDataFiles + 2); b < index_pblock; b++) {
+      srcs.push_back(b);
+    }
+
+    mTargets.push_back(index_pblock);
+    mSources.push_back(srcs);
+  }
+
+  // Double parity: the blocks of the diagonal, including simple parity
+  unsigned int jump_blocks = nb_total_files + 1;
+  std::vector<unsigned int> used_blocks;
+
+  for (unsigned int i = 0; i < nbDataFiles; i++) {
+    used_blocks.push_back((i + 1) * (nbDataFiles + 1) + i);
+  }
+
+  for (unsigned int i = 0; i < nbDataFiles; i++) {
+    unsigned int index_dpblock = (i + 1) * (nbDataFiles + 1) + i;
+    unsigned int next_block = i + jump_blocks;
+    std::vector<unsigned int> srcs;
+    srcs.push_back(i);
+    srcs.push_back(next_block);
+    used_blocks.push_back(i);
+    used_blocks.push_back(next_block);
+
+    for (unsigned int j = 0; j + 2 < nbDataFiles; j++) {
+      unsigned int aux_block = next_block + jump_blocks;
+
+      if ((aux_block < nb_total_blocks) &&
+          (find(used_blocks.begin(), used_blocks.end(),
+                aux_block) == used_blocks.end())) {
+        next_block = aux_block;
+      } else {
+        next_block++;
+
+        while (find(used_blocks.begin(), used_blocks.end(),
+                    next_block) != used_blocks.end()) {
+          next_block++;
+        }
+      }
+
+      srcs.push_back(next_block);
+      used_blocks.push_back(next_block);
+    }
+
+    mTargets.push_back(index_dpblock);
+    mSources.push_back(srcs);
+  }
+}
+
+const RaidDpParityPlan&
+RaidDpParityPlan::Get(unsigned int nbDataFiles)
+{
+  static XrdSysMutex sMutex;
+  static std::map<unsigned int, RaidDpParityPlan*> sPlans;
+  XrdSysMutexHelper lock(sMutex);
+  RaidDpParityPlan*& plan = sPlans[nbDataFiles];
+
+  if (!plan) {
+    plan = new RaidDpParityPlan(nbDataFiles);
+  }
+
+  return *plan;
+}
+
+void
+RaidDpParityPlan::Compute(char** blocks, size_t width) const
+{
+  size_t max_srcs = 0;
+
+  for (size_t t = 0; t < mSources.size(); t++) {
+    max_srcs = std::max(max_srcs, mSources[t].size());
+  }
+
+  const char* srcs[max_srcs + 1];
+
+  for (size_t off = 0; off < width; off += sSliceSize) {
+    size_t len = std::min(sSliceSize, width - off);
+
+    for (size_t t = 0; t < mTargets.size(); t++) {
+      const std::vector<unsigned int>& ids = mSources[t];
+
+      for (size_t s = 0; s < ids.size(); s++) {
+        srcs[s] = blocks[ids[s]] + off;
+      }
+
+      xorRegions(blocks[mTargets[t]] + off, srcs, ids.size(), len);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Reed-Solomon codec
+//------------------------------------------------------------------------------
+ReedSCodec::ReedSCodec(int k, int m, int w):
+  mK(k), mM(m), mW(w), mMatrix(0), mBitmatrix(0), mSchedule(0),
+  mDecodeCache(0), mMaxSrcs(0)
+{
+}
+
+bool
+ReedSCodec::Init()
+{
+  mMatrix = cauchy_good_general_coding_matrix(mK, mM, mW);
+
+  if (!mMatrix) {
+    return false;
+  }
+
+  mBitmatrix = jerasure_matrix_to_bitmatrix(mK, mM, mW, mMatrix);
+
+  if (!mBitmatrix) {
+    return false;
+  }
+
+  mSchedule = jerasure_smart_bitmatrix_to_schedule(mK, mM, mW, mBitmatrix);
+
+  if (!mSchedule) {
+    return false;
+  }
+
+  if (mM == 2) {
+    mDecodeCache = jerasure_generate_schedule_cache(mK, mM, mW, mBitmatrix, 1);
+  }
+
+  // Fuse the runs of operations writing the same packet: a copy followed by
+  // XORs becomes one multi-source XOR
+  for (int op = 0; mSchedule[op][0] >= 0; op++) {
+    int src = mSchedule[op][0] * mW + mSchedule[op][1];
+    int dst = mSchedule[op][2] * mW + mSchedule[op][3];
+    bool is_xor = mSchedule[op][4];
+
+    if (mOps.empty() || (mOps.back().dst != dst) || !is_xor) {
+      FusedOp fop;
+      fop.dst = dst;
+
+      if (is_xor) {
+        fop.srcs.push_back(dst);
+      }
+
+      mOps.push_back(fop);
+    }
+
+    mOps.back().srcs.push_back(src);
+    mMaxSrcs = std::max(mMaxSrcs, (unsigned int) mOps.back().srcs.size());
+  }
+
+  return true;
+}
+
+const ReedSCodec*
+ReedSCodec::Get(int k, int m, int w)
+{
+  static XrdSysMutex sMutex;
+  static std::map<std::vector<int>, ReedSCodec*> sCodecs;
+  std::vector<int> key;
+  key.push_back(k);
+  key.push_back(m);
+  key.push_back(w);
+  XrdSysMutexHelper lock(sMutex);
+  std::map<std::vector<int>, ReedSCodec*>::iterator it = sCodecs.find(key);
+
+  if (it != sCodecs.end()) {
+    return it->second;
+  }
+
+  ReedSCodec* codec = new ReedSCodec(k, m, w);
+
+  if (!codec->Init()) {
+    // jerasure structures of a failed initialisation are not reclaimed
+    delete codec;
+    codec = 0;
+  }
+
+  sCodecs[key] = codec;
+  return codec;
+}
+
+void
+ReedSCodec::Encode(char** data, char** coding, size_t size,
+                   int packetSize) const
+{
+  char* ptrs[mK + mM];
+  const char* srcs[mMaxSrcs + 1];
+  size_t chunk = (size_t) packetSize * mW;
+
+  for (int i = 0; i < mK; i++) {
+    ptrs[i] = data[i];
+  }
+
+  for (int i = 0; i < mM; i++) {
+    ptrs[mK + i] = coding[i];
+  }
+
+  for (size_t done = 0; done < size; done += chunk) {
+    for (size_t op = 0; op < mOps.size(); op++) {
+      const FusedOp& fop = mOps[op];
+
+      for (size_t s = 0; s < fop.srcs.size(); s++) {
+        srcs[s] = ptrs[fop.srcs[s] / mW] + (fop.srcs[s] % mW) * packetSize + done;
+      }
+
+      xorRegions(ptrs[fop.dst / mW] + (fop.dst % mW) * packetSize + done, srcs,
+                 fop.srcs.size(), packetSize);
+    }
+  }
+}
+
+int
+ReedSCodec::Decode(int* erasures, char** data, char** coding, size_t size,
+                   int packetSize) const
+{
+  if (mDecodeCache && (erasures[0] >= 0) &&
+      ((erasures[1] == -1) || (erasures[2] == -1))) {
+    return jerasure_schedule_decode_cache(mK, mM, mW, mDecodeCache, erasures,
+                                          data, coding, size, packetSize);
+  }
+
+  return jerasure_schedule_decode_lazy(mK, mM, mW, mBitmatrix, erasures, data,
+                                       coding, size, packetSize, 1);
+}
+
+EOSFSTNAMESPACE_END
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+// File: ParityEngine.hh
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_PARITYENGINE_HH__
+#define __EOSFST_PARITYENGINE_HH__
+
+#include "fst/Namespace.hh"
+#include <cstddef>
+#include <vector>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! XOR a set of regions into a destination in a single pass, using AVX2 or
+//! SSE2 when available. The destination may also be one of the sources, with
+//! no sources the destination is zeroed.
+//!
+//! @param dst destination region
+//! @param srcs source regions
+//! @param nsrcs number of sources
+//! @param length length of all regions
+//------------------------------------------------------------------------------
+void xorRegions(char* dst, const char* const* srcs, unsigned int nsrcs,
+                size_t length);
+
+//------------------------------------------------------------------------------
+//! Portable implementation of xorRegions
+//------------------------------------------------------------------------------
+void xorRegionsScalar(char* dst, const char* const* srcs, unsigned int nsrcs,
+                      size_t length);
+
+//------------------------------------------------------------------------------
+//! Name of the XOR kernel in use ("avx2", "sse2" or "scalar")
+//------------------------------------------------------------------------------
+const char* xorKernelName();
+
+//------------------------------------------------------------------------------
+//! Class RaidDpParityPlan - simple and double parity of a RAID-DP group
+//!
+//! The list of blocks contributing to each parity block only depends on the
+//! number of data files, it is computed once per configuration and shared by
+//! all the files. The parity is then computed in one pass over the group,
+//! slice by slice, so that the data blocks of a slice are still in the cache
+//! when the double parity (which covers the simple parity) is computed.
+//------------------------------------------------------------------------------
+class RaidDpParityPlan
+{
+public:
+  static const size_t sSliceSize = 8 * 1024; ///< bytes per block and slice
+
+  //----------------------------------------------------------------------------
+  //! Get the (cached) plan for a number of data files
+  //----------------------------------------------------------------------------
+  static const RaidDpParityPlan& Get(unsigned int nbDataFiles);
+
+  //----------------------------------------------------------------------------
+  //! Compute all the parity blocks of a group
+  //!
+  //! @param blocks the nbDataFiles * (nbDataFiles + 2) blocks of the group
+  //! @param width size of a block
+  //----------------------------------------------------------------------------
+  void Compute(char** blocks, size_t width) const;
+
+  //----------------------------------------------------------------------------
+  //! Index of each parity block and the blocks it is computed from, simple
+  //! parity blocks first
+  //----------------------------------------------------------------------------
+  const std::vector<unsigned int>& GetTargets() const
+  {
+    return mTargets;
+  }
+
+  const std::vector< std::vector<unsigned int> >& GetSources() const
+  {
+    return mSources;
+  }
+
+private:
+  std::vector<unsigned int> mTargets;
+  std::vector< std::vector<unsigned int> > mSources;
+
+  explicit RaidDpParityPlan(unsigned int nbDataFiles);
+};
+
+//------------------------------------------------------------------------------
+//! Class ReedSCodec - Cauchy Reed-Solomon coding structures of a (k, m, w)
+//! configuration
+//!
+//! The coding matrix, its bitmatrix and the encoding schedule are built once
+//! per configuration and shared by all the files. The jerasure schedule is
+//! turned into fused operations where all the XORs into the same packet are
+//! done in a single pass. For m = 2 the decoding schedules of all the erasure
+//! patterns are cached as well.
+//------------------------------------------------------------------------------
+class ReedSCodec
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Get the (cached) codec of a configuration, 0 if it cannot be built
+  //----------------------------------------------------------------------------
+  static const ReedSCodec* Get(int k, int m, int w);
+
+  //----------------------------------------------------------------------------
+  //! Encode, same result as jerasure_schedule_encode
+  //!
+  //! @param data k data blocks
+  //! @param coding m parity blocks
+  //! @param size size of the blocks (multiple of w * packetSize)
+  //! @param packetSize jerasure packet size
+  //----------------------------------------------------------------------------
+  void Encode(char** data, char** coding, size_t size, int packetSize) const;
+
+  //----------------------------------------------------------------------------
+  //! Decode the erased blocks in place
+  //!
+  //! @param erasures ids of the erased blocks terminated by -1
+  //!
+  //! @return 0 if successful, -1 otherwise
+  //----------------------------------------------------------------------------
+  int Decode(int* erasures, char** data, char** coding, size_t size,
+             int packetSize) const;
+
+  int* GetBitmatrix() const
+  {
+    return mBitmatrix;
+  }
+
+  int** GetSchedule() const
+  {
+    return mSchedule;
+  }
+
+private:
+  //! One destination packet and the packets XOR-ed into it, a packet being
+  //! identified by device * w + packet index
+  struct FusedOp {
+    int dst;
+    std::vector<int> srcs;
+  };
+
+  int mK, mM, mW;
+  int* mMatrix;
+  int* mBitmatrix;
+  int** mSchedule;
+  int*** mDecodeCache; ///< decoding schedules for m = 2
+  std::vector<FusedOp> mOps;
+  unsigned int mMaxSrcs;
+
+  ReedSCodec(int k, int m, int w);
+  bool Init();
+};
+
+EOSFSTNAMESPACE_END
+
+#endif
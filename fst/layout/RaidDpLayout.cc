@@ -28,14 +28,13 @@
 #include <sys/stat.h>
 /*----------------------------------------------------------------------------*/
 #include "fst/layout/RaidDpLayout.hh"
+#include "fst/layout/ParityEngine.hh"
 #include "fst/io/AsyncMetaHandler.hh"
 #include "common/Timing.hh"
 /*----------------------------------------------------------------------------*/
 
 EOSFSTNAMESPACE_BEGIN
 
-typedef long v2do __attribute__((vector_size(VECTOR_SIZE)));
-
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
@@ -63,7 +62,8 @@ RaidDpLayout::RaidDpLayout(XrdFstOfsFile* file,
 //------------------------------------------------------------------------------
 RaidDpLayout::~RaidDpLayout()
 {
-  // empty
+  // The parity thread calls our ComputeParity and WriteParityToFiles
+  StopParity();
 }
 
 
@@ -71,117 +71,30 @@ RaidDpLayout::~RaidDpLayout()
 // Compute simple and double parity blocks
 //------------------------------------------------------------------------------
 bool
-RaidDpLayout::ComputeParity()
+RaidDpLayout::ComputeParity(std::vector<char*>& blocks)
 {
-  int index_pblock;
-  int current_block;
-
-  // Compute simple parity
-  for (unsigned int i = 0; i < mNbDataFiles; i++) {
-    index_pblock = (i + 1) * mNbDataFiles + 2 * i;
-    current_block = i * (mNbDataFiles + 2); //beginning of current line
-    OperationXOR(mDataBlocks[current_block],
-                 mDataBlocks[current_block + 1],
-                 mDataBlocks[index_pblock],
-                 mStripeWidth);
-    current_block += 2;
-
-    while (current_block < index_pblock) {
-      OperationXOR(mDataBlocks[index_pblock],
-                   mDataBlocks[current_block],
-                   mDataBlocks[index_pblock],
-                   mStripeWidth);
-      current_block++;
-    }
-  }
-
-  // Compute double parity
-  unsigned int aux_block;
-  unsigned int next_block;
-  unsigned int index_dpblock;
-  unsigned int jump_blocks = mNbTotalFiles + 1;
-  vector<int> used_blocks;
-
-  for (unsigned int i = 0; i < mNbDataFiles; i++) {
-    index_dpblock = (i + 1) * (mNbDataFiles + 1) + i;
-    used_blocks.push_back(index_dpblock);
-  }
-
-  for (unsigned int i = 0; i < mNbDataFiles; i++) {
-    index_dpblock = (i + 1) * (mNbDataFiles + 1) + i;
-    next_block = i + jump_blocks;
-    OperationXOR(mDataBlocks[i],
-                 mDataBlocks[next_block],
-                 mDataBlocks[index_dpblock],
-                 mStripeWidth);
-    used_blocks.push_back(i);
-    used_blocks.push_back(next_block);
-
-    for (unsigned int j = 0; j < mNbDataFiles - 2; j++) {
-      aux_block = next_block + jump_blocks;
-
-      if ((aux_block < mNbTotalBlocks) &&
-          (find(used_blocks.begin(), used_blocks.end(),
-                aux_block) == used_blocks.end())) {
-        next_block = aux_block;
-      } else {
-        next_block++;
-
-        while (find(used_blocks.begin(), used_blocks.end(),
-                    next_block) != used_blocks.end()) {
-          next_block++;
-        }
-      }
-
-      OperationXOR(mDataBlocks[index_dpblock],
-                   mDataBlocks[next_block],
-                   mDataBlocks[index_dpblock],
-                   mStripeWidth);
-      used_blocks.push_back(next_block);
-    }
-  }
-
+  RaidDpParityPlan::Get(mNbDataFiles).Compute(&blocks[0], mStripeWidth);
   return true;
 }
 
 
 //------------------------------------------------------------------------------
-// XOR the two blocks using 128 bits and return the result
+// Rebuild a block as the XOR of the other blocks of its stripe
 //------------------------------------------------------------------------------
 void
-RaidDpLayout::OperationXOR(char* pBlock1,
-                           char* pBlock2,
-                           char* pResult,
-                           size_t totalBytes)
+RaidDpLayout::XorStripe(const std::vector<unsigned int>& stripe,
+                        unsigned int idCorrupted)
 {
-  v2do* xor_res;
-  v2do* idx1;
-  v2do* idx2;
-  char* byte_res;
-  char* byte_idx1;
-  char* byte_idx2;
-  long int noPices = -1;
-  idx1 = (v2do*) pBlock1;
-  idx2 = (v2do*) pBlock2;
-  xor_res = (v2do*) pResult;
-  noPices = totalBytes / sizeof(v2do);
-
-  for (unsigned int i = 0; i < noPices; idx1++, idx2++, xor_res++, i++) {
-    *xor_res = *idx1 ^ *idx2;
-  }
-
-  // If the block does not devide perfectly to 128 ...
-  if (totalBytes % sizeof(v2do) != 0) {
-    byte_res = (char*) xor_res;
-    byte_idx1 = (char*) idx1;
-    byte_idx2 = (char*) idx2;
+  std::vector<const char*> srcs;
 
-    for (unsigned int i = noPices * sizeof(v2do);
-         i < totalBytes;
-         byte_res++, byte_idx1++, byte_idx2++, i++) {
-      *byte_res = *byte_idx1 ^ *byte_idx2;
+  for (unsigned int ind = 0; ind < stripe.size(); ind++) {
+    if (stripe[ind] != idCorrupted) {
+      srcs.push_back(mDataBlocks[stripe[ind]]);
     }
   }
+
+  xorRegions(mDataBlocks[idCorrupted], srcs.empty() ? 0 : &srcs[0],
+             srcs.size(), mStripeWidth);
 }
 
 
@@ -302,16 +215,7 @@ RaidDpLayout::RecoverPiecesInGroup(XrdCl::ChunkList& grp_errs)
 
     if (ValidHorizStripe(horizontal_stripe, status_blocks, id_corrupted)) {
       // Try to recover using simple parity
-      memset(mDataBlocks[id_corrupted], 0, mStripeWidth);
-
-      for (unsigned int ind = 0; ind < horizontal_stripe.size(); ind++) {
-        if (horizontal_stripe[ind] != id_corrupted) {
-          OperationXOR(mDataBlocks[id_corrupted],
-                       mDataBlocks[horizontal_stripe[ind]],
-                       mDataBlocks[id_corrupted],
-                       mStripeWidth);
-        }
-      }
+      XorStripe(horizontal_stripe, id_corrupted);
 
       // Return recovered block and also write it to the file
       stripe_id = id_corrupted % mNbTotalFiles;
@@ -361,16 +265,7 @@ RaidDpLayout::RecoverPiecesInGroup(XrdCl::ChunkList& grp_errs)
     } else {
       // Try to recover using double parity
       if (ValidDiagStripe(diagonal_stripe, status_blocks, id_corrupted)) {
-        memset(mDataBlocks[id_corrupted], 0, mStripeWidth);
-
-        for (unsigned int ind = 0; ind < diagonal_stripe.size(); ind++) {
-          if (diagonal_stripe[ind] != id_corrupted) {
-            OperationXOR(mDataBlocks[id_corrupted],
-                         mDataBlocks[diagonal_stripe[ind]],
-                         mDataBlocks[id_corrupted],
-                         mStripeWidth);
-          }
-        }
+        XorStripe(diagonal_stripe, id_corrupted);
 
         // Return recovered block and also write them to the files
         stripe_id = id_corrupted % mNbTotalFiles;
@@ -501,7 +396,7 @@ RaidDpLayout::AddDataBlock(uint64_t offset,
       // We completed a group, we can compute parity
       mOffGroupParity = ((offset - 1) / mSizeGroup) * mSizeGroup;
       mFullDataBlocks = true;
-      DoBlockParity(mOffGroupParity);
+      SubmitBlockParity(mOffGroupParity);
       mOffGroupParity += mSizeGroup;
 
       for (unsigned int i = 0; i < mNbTotalBlocks; i++) {
@@ -516,7 +411,7 @@ RaidDpLayout::AddDataBlock(uint64_t offset,
 // Write the parity blocks from mDataBlocks to the corresponding file stripes
 //------------------------------------------------------------------------------
 int
-RaidDpLayout::WriteParityToFiles(uint64_t offGroup)
+RaidDpLayout::WriteParityToFiles(uint64_t offGroup, std::vector<char*>& blocks)
 {
   eos_debug("offGroup = %zu", offGroup);
   int ret = SFS_OK;
@@ -536,7 +431,7 @@ RaidDpLayout::WriteParityToFiles(uint64_t offGroup)
     // Writing simple parity
     if (mStripe[physical_pindex]) {
       nwrite = mStripe[physical_pindex]->fileWriteAsync(off_parity_local,
-               mDataBlocks[index_pblock],
+               blocks[index_pblock],
                mStripeWidth,
                mTimeout);
 
@@ -554,7 +449,7 @@ RaidDpLayout::WriteParityToFiles(uint64_t offGroup)
     // Writing double parity
     if (mStripe[physical_dpindex]) {
       nwrite = mStripe[physical_dpindex]->fileWriteAsync(off_parity_local,
-               mDataBlocks[index_dpblock],
+               blocks[index_dpblock],
                mStripeWidth,
                mTimeout);
 
@@ -827,6 +722,8 @@ RaidDpLayout::Truncate(XrdSfsFileOffset offset)
   eos_debug("offset = %lli", offset);
   int rc = SFS_OK;
   uint64_t truncate_offset = 0;
+  // Parity still in flight must not land beyond the new end of the stripes
+  WaitParity();
   truncate_offset = ceil((offset * 1.0) / mSizeGroup) * mSizeLine;
   truncate_offset += mSizeHeader;
 
@@ -31,10 +31,6 @@
 
 EOSFSTNAMESPACE_BEGIN
 
-//! Used for computing XOR or 128 bits = 8 * 16
-#define VECTOR_SIZE 16
-
-
 //------------------------------------------------------------------------------
 //! Implementation of the RAID-double parity layout
 //------------------------------------------------------------------------------
@@ -124,36 +120,36 @@ private:
   //----------------------------------------------------------------------------
   //! Compute parity information
   //!
+  //! @param blocks data and parity blocks of the group
+  //!
   //! @return true if parity info computed successfully, otherwise false
   //!
   //------------------------------------------------------------------------------
-  virtual bool ComputeParity();
+  virtual bool ComputeParity(std::vector<char*>& blocks);
 
 
   //----------------------------------------------------------------------------
   //! Write parity information corresponding to a group to files
   //!
   //! @param offsetGroup offset of the group of blocks
+  //! @param blocks data and parity blocks of the group
   //!
   //! @return 0 if successful, otherwise error
   //!
   //----------------------------------------------------------------------------
-  virtual int WriteParityToFiles(uint64_t offsetGroup);
+  virtual int WriteParityToFiles(uint64_t offsetGroup,
+                                 std::vector<char*>& blocks);
 
 
   //----------------------------------------------------------------------------
-  //! Compute XOR operation for two blocks of any size
+  //! Rebuild a block as the XOR of all the other blocks of its stripe
   //!
-  //! @param pBlock1 first input block
-  //! @param pBlock2 second input block
-  //! @param pResult result of XOR operation
-  //! @param totalBytes size of input blocks
+  //! @param stripe horizontal or diagonal stripe containing the block
+  //! @param idCorrupted id of the block to rebuild
   //!
   //----------------------------------------------------------------------------
-  void OperationXOR(char* pBlock1,
-                    char* pBlock2,
-                    char* pResult,
-                    size_t totalBytes);
+  void XorStripe(const std::vector<unsigned int>& stripe,
+                 unsigned int idCorrupted);
 
 
   //----------------------------------------------------------------------------
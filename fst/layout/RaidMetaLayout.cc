@@ -22,12 +22,15 @@
  ************************************************************************/
 
 #include <cmath>
+#include <cstdlib>
 #include <string>
 #include <utility>
 #include <stdint.h>
 #include "common/Timing.hh"
 #include "fst/layout/RaidMetaLayout.hh"
 #include "fst/io/AsyncMetaHandler.hh"
+#include "common/BufferPool.hh"
+#include "common/EnvTunable.hh"
 
 // Linux compat for Apple
 #ifdef __APPLE__
@@ -69,7 +72,13 @@ RaidMetaLayout::RaidMetaLayout(XrdFstOfsFile* file,
   mTargetSize(targetSize),
   mSizeLine(0),
   mSizeGroup(0),
-  mBookingOpaque(bookingOpaque)
+  mBookingOpaque(bookingOpaque),
+  mPipelineDepth(2),
+  mNbSpareGroups(0),
+  mParityCond(0),
+  mParityThreadRunning(false),
+  mParityStop(false),
+  mParityError(false)
 {
   mStripeWidth = eos::common::LayoutId::GetBlocksize(lid);
   mNbTotalFiles = eos::common::LayoutId::GetStripeNumber(lid) + 1;
@@ -79,6 +88,11 @@ RaidMetaLayout::RaidMetaLayout(XrdFstOfsFile* file,
   mOffGroupParity = -1;
   mPhysicalStripeIndex = -1;
   mIsEntryServer = false;
+
+  // Number of groups kept in memory by a writer: one being filled and the
+  // others waiting for their parity to be computed and written
+  mPipelineDepth =
+    eos::common::EnvTunable::Get("EOS_FST_RAIN_PIPELINE_DEPTH", 2, 1, 8);
 }
 
 //------------------------------------------------------------------------------
@@ -86,6 +100,9 @@ RaidMetaLayout::RaidMetaLayout(XrdFstOfsFile* file,
 //------------------------------------------------------------------------------
 RaidMetaLayout::~RaidMetaLayout()
 {
+  // Already stopped by the derived destructors
+  StopParity();
+
   while (!mHdrInfo.empty()) {
     HeaderCRC* hd = mHdrInfo.back();
     mHdrInfo.pop_back();
@@ -106,7 +123,22 @@ RaidMetaLayout::~RaidMetaLayout()
   while (!mDataBlocks.empty()) {
     char* ptr_char = mDataBlocks.back();
     mDataBlocks.pop_back();
-    delete[] ptr_char;
+    eos::common::BufferPool::GetInstance().Release(ptr_char, mStripeWidth);
+  }
+
+  while (!mParityJobs.empty()) {
+    mFreeGroups.push_back(mParityJobs.front().second);
+    mParityJobs.pop_front();
+  }
+
+  while (!mFreeGroups.empty()) {
+    std::vector<char*>& blocks = mFreeGroups.front();
+
+    for (unsigned int i = 0; i < blocks.size(); i++) {
+      eos::common::BufferPool::GetInstance().Release(blocks[i], mStripeWidth);
+    }
+
+    mFreeGroups.pop_front();
   }
 }
 
@@ -233,7 +265,8 @@ RaidMetaLayout::Open(XrdSfsFileOpenMode flags, mode_t mode, const char* opaque)
 
     // Allocate memory for blocks - used only by the entry server
     for (unsigned int i = 0; i < mNbTotalBlocks; i++) {
-      mDataBlocks.push_back(new char[mStripeWidth]);
+      mDataBlocks.push_back(
+        eos::common::BufferPool::GetInstance().Allocate(mStripeWidth));
     }
 
     // Assign stripe urls and check minimal requirements
@@ -392,7 +425,8 @@ RaidMetaLayout::OpenPio(std::vector<std::string> stripeUrls,
 
   // Allocate memory for blocks - done only once
   for (unsigned int i = 0; i < mNbTotalBlocks; i++) {
-    mDataBlocks.push_back(new char[mStripeWidth]);
+    mDataBlocks.push_back(
+      eos::common::BufferPool::GetInstance().Allocate(mStripeWidth));
   }
 
   //!!!!
@@ -594,6 +628,8 @@ RaidMetaLayout::Read(XrdSfsFileOffset offset, char* buffer,
     }
   } else {
     // Only entry server does this
+    WaitParity();
+
     if ((uint64_t)offset > mFileSize) {
       eos_warning("offset:%lld larger then file size:%lld", offset, mFileSize);
       return 0;
@@ -614,7 +650,8 @@ RaidMetaLayout::Read(XrdSfsFileOffset offset, char* buffer,
         len = mSizeGroup;
       }
 
-      char* recover_block = new char[mStripeWidth];
+      char* recover_block =
+        eos::common::BufferPool::GetInstance().Allocate(mStripeWidth);
 
       while ((uint32_t)len >= mStripeWidth) {
         all_errs.push_back(XrdCl::ChunkInfo((uint64_t)offset,
@@ -624,7 +661,8 @@ RaidMetaLayout::Read(XrdSfsFileOffset offset, char* buffer,
         if (offset % mSizeGroup == 0) {
           if (!RecoverPieces(all_errs)) {
             eos_err("failed recovery of stripe");
-            delete[] recover_block;
+            eos::common::BufferPool::GetInstance().Release(recover_block,
+                mStripeWidth);
             return SFS_ERROR;
           } else {
             all_errs.clear();
@@ -635,7 +673,8 @@ RaidMetaLayout::Read(XrdSfsFileOffset offset, char* buffer,
         offset += mSizeGroup;
       }
 
-      delete[] recover_block;
+      eos::common::BufferPool::GetInstance().Release(recover_block,
+          mStripeWidth);
     } else {
       // Reset all the async handlers
       for (unsigned int i = 0; i < mStripe.size(); i++) {
@@ -759,7 +798,9 @@ RaidMetaLayout::ReadV(XrdCl::ChunkList& chunkList, uint32_t len)
       }
     }
   } else {
-    // Reset all the async handlers
+    // Reset all the async handlers, once no parity writes are in flight
+    WaitParity();
+
     for (unsigned int i = 0; i < mStripe.size(); i++) {
       if (mStripe[i]) {
         phandler = static_cast<AsyncMetaHandler*>(mStripe[i]->fileGetAsyncHandler());
@@ -960,11 +1001,11 @@ RaidMetaLayout::DoBlockParity(uint64_t offGroup)
   COMMONTIMING("Compute-In", &up);
 
   // Compute parity blocks
-  if ((done = ComputeParity())) {
+  if ((done = ComputeParity(mDataBlocks))) {
     COMMONTIMING("Compute-Out", &up);
 
     // Write parity blocks to files
-    if (WriteParityToFiles(offGroup) == SFS_ERROR) {
+    if (WriteParityToFiles(offGroup, mDataBlocks) == SFS_ERROR) {
       done = false;
     }
 
@@ -976,6 +1017,143 @@ RaidMetaLayout::DoBlockParity(uint64_t offGroup)
   return done;
 }
 
+//------------------------------------------------------------------------------
+// Hand over the current group to the parity thread
+//------------------------------------------------------------------------------
+bool
+RaidMetaLayout::SubmitBlockParity(uint64_t offGroup)
+{
+  if (mPipelineDepth < 2) {
+    return DoBlockParity(offGroup);
+  }
+
+  XrdSysCondVarHelper scope_lock(mParityCond);
+
+  if (!mParityThreadRunning) {
+    if (XrdSysThread::Run(&mParityThread, RaidMetaLayout::StartParityThread,
+                          static_cast<void*>(this), XRDSYSTHREAD_HOLD,
+                          "RAIN Parity Thread")) {
+      eos_warning("msg=\"failed to start parity thread, computing in place\"");
+      mPipelineDepth = 1;
+      scope_lock.UnLock();
+      return DoBlockParity(offGroup);
+    }
+
+    mParityThreadRunning = true;
+  }
+
+  // Wait for a free set of blocks unless we can still allocate one
+  while (mFreeGroups.empty() && (mNbSpareGroups + 1 >= mPipelineDepth)) {
+    mParityCond.Wait();
+  }
+
+  std::vector<char*> blocks;
+
+  if (mFreeGroups.empty()) {
+    for (unsigned int i = 0; i < mNbTotalBlocks; i++) {
+      blocks.push_back(
+        eos::common::BufferPool::GetInstance().Allocate(mStripeWidth));
+    }
+
+    mNbSpareGroups++;
+  } else {
+    blocks.swap(mFreeGroups.front());
+    mFreeGroups.pop_front();
+  }
+
+  mParityJobs.push_back(std::make_pair(offGroup, mDataBlocks));
+  mDataBlocks.swap(blocks);
+  mFullDataBlocks = false;
+  mParityCond.Broadcast();
+  return !mParityError;
+}
+
+//------------------------------------------------------------------------------
+// Wait for all the submitted groups
+//------------------------------------------------------------------------------
+bool
+RaidMetaLayout::WaitParity()
+{
+  XrdSysCondVarHelper scope_lock(mParityCond);
+
+  while (!mParityJobs.empty()) {
+    mParityCond.Wait();
+  }
+
+  return !mParityError;
+}
+
+//------------------------------------------------------------------------------
+// Stop the parity thread
+//------------------------------------------------------------------------------
+void
+RaidMetaLayout::StopParity()
+{
+  if (mParityThreadRunning) {
+    // Groups not started yet are dropped, Close waits for all of them
+    mParityCond.Lock();
+    mParityStop = true;
+    mParityCond.Broadcast();
+    mParityCond.UnLock();
+    XrdSysThread::Join(mParityThread, 0);
+    mParityThreadRunning = false;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Parity thread startup function
+//------------------------------------------------------------------------------
+void*
+RaidMetaLayout::StartParityThread(void* arg)
+{
+  reinterpret_cast<RaidMetaLayout*>(arg)->ParityLoop();
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Compute and write the parity of the submitted groups. A group stays in the
+// queue until its parity is written so that WaitParity covers it.
+//------------------------------------------------------------------------------
+void
+RaidMetaLayout::ParityLoop()
+{
+  mParityCond.Lock();
+
+  while (true) {
+    while (mParityJobs.empty() && !mParityStop) {
+      mParityCond.Wait();
+    }
+
+    if (mParityStop) {
+      break;
+    }
+
+    uint64_t off_group = mParityJobs.front().first;
+    std::vector<char*> blocks = mParityJobs.front().second;
+    mParityCond.UnLock();
+    bool done = ComputeParity(blocks);
+
+    if (!done) {
+      eos_err("msg=\"failed to compute parity\" offset=%llu", off_group);
+    } else if (WriteParityToFiles(off_group, blocks) == SFS_ERROR) {
+      eos_err("msg=\"failed to write parity\" offset=%llu", off_group);
+      done = false;
+    }
+
+    mParityCond.Lock();
+
+    if (!done) {
+      mParityError = true;
+    }
+
+    mFreeGroups.push_back(blocks);
+    mParityJobs.pop_front();
+    mParityCond.Broadcast();
+  }
+
+  mParityCond.UnLock();
+}
+
 //------------------------------------------------------------------------------
 // Recover pieces from the whole file. The map contains the original position of
 // the corrupted pieces in the initial file.
@@ -1069,10 +1247,15 @@ RaidMetaLayout::ReadGroup(uint64_t offGroup)
   int64_t nread = 0;
   AsyncMetaHandler* phandler = 0;
 
-// Collect all the write the responses and reset all the handlers
-  for (unsigned int i = 0; i < mStripe.size(); i++) {
-    if (mStripe[i]) {
-      phandler = static_cast<AsyncMetaHandler*>(mStripe[i]->fileGetAsyncHandler());
+// Collect the write responses and reset the handlers of the data stripes,
+// the parity stripes may still be written by the parity thread and are
+// collected in Close
+  for (unsigned int i = 0; i < mNbDataFiles; i++) {
+    physical_id = mapLP[i];
+
+    if (mStripe[physical_id]) {
+      phandler = static_cast<AsyncMetaHandler*>
+                 (mStripe[physical_id]->fileGetAsyncHandler());
 
       if (phandler) {
         if (phandler->WaitOK() != XrdCl::errNone) {
@@ -1213,9 +1396,10 @@ RaidMetaLayout::SparseParityComputation(bool force)
   MergePieces();
   GetOffsetGroups(off_grps, force);
 
+  // The next group is read while the parity of the previous one is done
   for (auto off = off_grps.begin(); off != off_grps.end(); off++) {
     if (ReadGroup(*off)) {
-      done = DoBlockParity(*off);
+      done = SubmitBlockParity(*off);
 
       if (!done) {
         break;
@@ -1238,6 +1422,11 @@ RaidMetaLayout::Sync()
   int ret = SFS_OK;
 
   if (mIsOpen) {
+    if (!WaitParity()) {
+      eos_err("parity computation failed");
+      ret = SFS_ERROR;
+    }
+
     // Sync local file
     if (mStripe[0]) {
       if (mStripe[0]->fileSync(mTimeout)) {
@@ -1277,6 +1466,7 @@ RaidMetaLayout::Remove()
 {
   eos_debug("Calling RaidMetaLayout::Remove");
   int ret = SFS_OK;
+  WaitParity();
 
   if (mIsEntryServer) {
     // Unlink remote stripes
@@ -1366,6 +1556,8 @@ RaidMetaLayout::Close()
 
   if (mIsOpen) {
     if (mIsEntryServer) {
+      bool parity_ok = WaitParity();
+
       if (mStoreRecovery) {
         if (mDoneRecovery || mDoTruncate) {
           eos_debug("truncating after done a recovery or at end of write");
@@ -1391,6 +1583,8 @@ RaidMetaLayout::Close()
           SparseParityComputation(true);
         }
 
+        parity_ok = WaitParity();
+
         // Collect all the write responses and reset all the handlers
         for (unsigned int i = 0; i < mStripe.size(); i++) {
           if (mStripe[i]) {
@@ -1450,6 +1644,11 @@ RaidMetaLayout::Close()
         }
       }
 
+      if (!parity_ok) {
+        eos_err("failed to compute or write the parity of some groups");
+        rc = SFS_ERROR;
+      }
+
       // Close remote files
       for (unsigned int i = 1; i < mStripe.size(); i++) {
         if (mStripe[i]) {
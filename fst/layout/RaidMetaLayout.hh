@@ -305,6 +305,19 @@ protected:
   ///< parity computation has not been done yet
   std::string mLastErrMsg; ///< last error messages ssen
 
+  //! Parity pipeline: while the parity of a group is computed and written by
+  //! the parity thread, the next group is filled in a spare set of blocks
+  unsigned int mPipelineDepth; ///< max number of groups held in memory
+  unsigned int mNbSpareGroups; ///< number of spare sets of blocks allocated
+  std::list< std::vector<char*> > mFreeGroups; ///< unused sets of blocks
+  std::list< std::pair<uint64_t, std::vector<char*> > > mParityJobs; ///< groups
+  ///< waiting for their parity to be computed and written, oldest first
+  XrdSysCondVar mParityCond; ///< protects the parity pipeline
+  pthread_t mParityThread; ///< thread computing the parity
+  bool mParityThreadRunning; ///< mark if the parity thread was started
+  bool mParityStop; ///< mark the parity thread to exit
+  bool mParityError; ///< mark if any pipelined parity computation failed
+
   //----------------------------------------------------------------------------
   //! Test and recover any corrupted headers in the stripe files
   //----------------------------------------------------------------------------
@@ -334,6 +347,36 @@ protected:
   virtual bool DoBlockParity(uint64_t offGroup);
 
 
+  //----------------------------------------------------------------------------
+  //! Hand over the group held in mDataBlocks to the parity thread and
+  //! continue with a spare set of blocks. Blocks while mPipelineDepth groups
+  //! are already in memory. With a depth of 1 the parity is done in place.
+  //!
+  //! @param offGroup offset of group of blocks
+  //!
+  //! @return false if a parity computation failed so far, otherwise true
+  //!
+  //----------------------------------------------------------------------------
+  bool SubmitBlockParity(uint64_t offGroup);
+
+
+  //----------------------------------------------------------------------------
+  //! Wait until the parity of all the submitted groups has been written
+  //!
+  //! @return false if any of them failed, otherwise true
+  //!
+  //----------------------------------------------------------------------------
+  bool WaitParity();
+
+
+  //----------------------------------------------------------------------------
+  //! Stop the parity thread once its current group is done, the groups not
+  //! started yet are dropped. The parity is computed by the derived classes,
+  //! so their destructors have to call it before their members go away.
+  //----------------------------------------------------------------------------
+  void StopParity();
+
+
   //----------------------------------------------------------------------------
   //! Recover corrupted chunks from the current group
   //!
@@ -362,21 +405,25 @@ protected:
   //------------------------------------------------------------------------------
   //! Compute error correction blocks
   //!
+  //! @param blocks data and parity blocks of the group
+  //!
   //! @return true if parity info computed successfully, otherwise false
   //!
   //------------------------------------------------------------------------------
-  virtual bool ComputeParity() = 0;
+  virtual bool ComputeParity(std::vector<char*>& blocks) = 0;
 
 
   //----------------------------------------------------------------------------
   //! Write parity information corresponding to a group to files
   //!
   //! @param offsetGroup offset of the group of blocks
+  //! @param blocks data and parity blocks of the group
   //!
   //! @return 0 if successful, otherwise error
   //!
   //----------------------------------------------------------------------------
-  virtual int WriteParityToFiles(uint64_t offsetGroup) = 0;
+  virtual int WriteParityToFiles(uint64_t offsetGroup,
+                                 std::vector<char*>& blocks) = 0;
 
 
   //----------------------------------------------------------------------------
@@ -497,6 +544,19 @@ private:
   XrdCl::ChunkList SplitRead(uint64_t off, uint32_t len, char* buff);
 
 
+  //----------------------------------------------------------------------------
+  //! Parity thread startup function
+  //----------------------------------------------------------------------------
+  static void* StartParityThread(void* arg);
+
+
+  //----------------------------------------------------------------------------
+  //! Loop run by the parity thread, it computes and writes the parity of the
+  //! submitted groups in order
+  //----------------------------------------------------------------------------
+  void ParityLoop();
+
+
   //----------------------------------------------------------------------------
   //! Disable copy constructor
   //----------------------------------------------------------------------------
@@ -51,7 +51,7 @@ ReedSLayout::ReedSLayout(XrdFstOfsFile* file,
   RaidMetaLayout(file, lid, client, outError, path, timeout,
                  storeRecovery, targetSize, bookingOpaque),
   mDoneInitialisation(false),
-  mPacketSize(0), matrix(0), bitmatrix(0), schedule(0)
+  mPacketSize(0), mCodec(0)
 {
   mNbDataBlocks = mNbDataFiles;
   mNbTotalBlocks = mNbDataFiles + mNbParityFiles;
@@ -67,7 +67,8 @@ ReedSLayout::ReedSLayout(XrdFstOfsFile* file,
 //------------------------------------------------------------------------------
 ReedSLayout::~ReedSLayout()
 {
-  // empty
+  // The parity thread calls our ComputeParity and WriteParityToFiles
+  StopParity();
 }
 
 
@@ -87,12 +88,14 @@ ReedSLayout::InitialiseJerasure()
     return false;
   }
 
-  // Initialise Jerasure data structures
-  matrix = cauchy_good_general_coding_matrix(mNbDataBlocks, mNbParityFiles, w);
-  bitmatrix = jerasure_matrix_to_bitmatrix(mNbDataBlocks, mNbParityFiles, w,
-              matrix);
-  schedule = jerasure_smart_bitmatrix_to_schedule(mNbDataBlocks, mNbParityFiles,
-             w, bitmatrix);
+  // Jerasure data structures are built once per configuration
+  mCodec = ReedSCodec::Get(mNbDataBlocks, mNbParityFiles, w);
+
+  if (!mCodec) {
+    eos_err("failed to build the coding structures");
+    return false;
+  }
+
   return true;
 }
 
@@ -101,7 +104,7 @@ ReedSLayout::InitialiseJerasure()
 // Compute the error correction blocks
 //------------------------------------------------------------------------------
 bool
-ReedSLayout::ComputeParity()
+ReedSLayout::ComputeParity(std::vector<char*>& blocks)
 {
   // Initialise Jerasure structures if not done already
   if (!mDoneInitialisation) {
@@ -118,16 +121,15 @@ ReedSLayout::ComputeParity()
   char* coding[mNbParityFiles];
 
   for (unsigned int i = 0; i < mNbDataFiles; ++i) {
-    data[i] = (char*) mDataBlocks[i];
+    data[i] = blocks[i];
   }
 
   for (unsigned int i = 0; i < mNbParityFiles; ++i) {
-    coding[i] = (char*) mDataBlocks[mNbDataFiles + i];
+    coding[i] = blocks[mNbDataFiles + i];
   }
 
   // Encode the blocks
-  jerasure_schedule_encode(mNbDataBlocks, mNbParityFiles, w, schedule, data,
-                           coding, mStripeWidth, mPacketSize);
+  mCodec->Encode(data, coding, mStripeWidth, mPacketSize);
   return true;
 }
 
@@ -245,9 +247,8 @@ ReedSLayout::RecoverPiecesInGroup(XrdCl::ChunkList& grp_errs)
 
   erasures[invalid_ids.size()] = -1;
   // ******* DECODE ******
-  int decode = jerasure_schedule_decode_lazy(mNbDataBlocks, mNbParityFiles, w,
-               bitmatrix, erasures, data, coding,
-               mStripeWidth, mPacketSize, 1);
+  int decode = mCodec->Decode(erasures, data, coding, mStripeWidth,
+                              mPacketSize);
   // Free memory
   delete[] erasures;
 
@@ -376,7 +377,7 @@ ReedSLayout::AddDataBlock(uint64_t offset, const char* pBuffer, uint32_t length)
       // We completed a group, we can compute parity
       mOffGroupParity = ((offset - 1) / mSizeGroup) * mSizeGroup;
       mFullDataBlocks = true;
-      DoBlockParity(mOffGroupParity);
+      SubmitBlockParity(mOffGroupParity);
       mOffGroupParity = (offset / mSizeGroup) * mSizeGroup;
 
       for (unsigned int i = 0; i < mNbDataFiles; i++) {
@@ -391,7 +392,8 @@ ReedSLayout::AddDataBlock(uint64_t offset, const char* pBuffer, uint32_t length)
 // Write the parity blocks from mDataBlocks to the corresponding file stripes
 //------------------------------------------------------------------------------
 int
-ReedSLayout::WriteParityToFiles(uint64_t offsetGroup)
+ReedSLayout::WriteParityToFiles(uint64_t offsetGroup,
+                                std::vector<char*>& blocks)
 {
   int ret = SFS_OK;
   int64_t nwrite = 0;
@@ -404,7 +406,7 @@ ReedSLayout::WriteParityToFiles(uint64_t offsetGroup)
 
     // Write parity block
     if (mStripe[physical_id]) {
-      nwrite = mStripe[physical_id]->fileWriteAsync(offset_local, mDataBlocks[i],
+      nwrite = mStripe[physical_id]->fileWriteAsync(offset_local, blocks[i],
                mStripeWidth, mTimeout);
 
       if (nwrite != (int64_t)mStripeWidth) {
@@ -429,6 +431,8 @@ int
 ReedSLayout::Truncate(XrdSfsFileOffset offset)
 {
   int rc = SFS_OK;
+  // Parity still in flight must not land beyond the new end of the stripes
+  WaitParity();
   uint64_t truncate_offset = 0;
   truncate_offset = ceil((offset * 1.0) / mSizeGroup) * mStripeWidth;
   truncate_offset += mSizeHeader;
@@ -27,6 +27,7 @@
 
 /*----------------------------------------------------------------------------*/
 #include "fst/layout/RaidMetaLayout.hh"
+#include "fst/layout/ParityEngine.hh"
 /*----------------------------------------------------------------------------*/
 
 EOSFSTNAMESPACE_BEGIN
@@ -109,9 +110,7 @@ private:
   bool mDoneInitialisation; ///< Jerasure codes initialisation status
   unsigned int w;           ///< word size for Jerasure
   unsigned int mPacketSize; ///< packet size for Jerasure
-  int* matrix;
-  int* bitmatrix;
-  int** schedule;
+  const ReedSCodec* mCodec;  ///< coding structures shared per configuration
 
 
   //----------------------------------------------------------------------------
@@ -137,21 +136,25 @@ private:
   //----------------------------------------------------------------------------
   //! Compute error correction blocks
   //!
+  //! @param blocks data and parity blocks of the group
+  //!
   //! @return true if parity info computed successfully, otherwise false
   //!
   //----------------------------------------------------------------------------
-  virtual bool ComputeParity();
+  virtual bool ComputeParity(std::vector<char*>& blocks);
 
 
   //----------------------------------------------------------------------------
   //! Write parity information corresponding to a group to files
   //!
   //! @param offsetGroup offset of the group of blocks
+  //! @param blocks data and parity blocks of the group
   //!
   //! @return 0 if successful, otherwise error
   //!
   //--------------------------------------------------------------------------
-  virtual int WriteParityToFiles(uint64_t offsetGroup);
+  virtual int WriteParityToFiles(uint64_t offsetGroup,
+                                 std::vector<char*>& blocks);
 
 
   //--------------------------------------------------------------------------
@@ -25,9 +25,23 @@
 #include "fst/io/FileIoPlugin.hh"
 #include "fst/io/AsyncMetaHandler.hh"
 #include "fst/XrdFstOfs.hh"
+#include "common/EnvTunable.hh"
 
 EOSFSTNAMESPACE_BEGIN
 
+//------------------------------------------------------------------------------
+// Number of chunks in flight to a remote replica
+//------------------------------------------------------------------------------
+static uint32_t
+ReplicaWriteWindow()
+{
+  // Never more than the handlers cached per file
+  static const uint32_t sWindow =
+    eos::common::EnvTunable::Get("EOS_FST_REPLICA_WRITE_WINDOW", 16, 1,
+                                 AsyncMetaHandler::msMaxNumAsyncObj);
+  return sWindow;
+}
+
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
@@ -220,6 +234,13 @@ ReplicaParLayout::Open(XrdSfsFileOpenMode flags, mode_t mode,
           mLastTriedUrl = file->GetLastTriedUrl();
           mLastUrl = file->GetLastUrl();
           mReplicaFile.push_back(file);
+          AsyncMetaHandler* handler =
+            static_cast<AsyncMetaHandler*>(file->fileGetAsyncHandler());
+
+          if (handler) {
+            handler->SetWriteWindow(ReplicaWriteWindow());
+          }
+
           eos_debug("Opened remote file for IO: %s.", maskUrl.c_str());
         } else {
           // Read case just uses one replica
@@ -324,38 +345,76 @@ ReplicaParLayout::Write(XrdSfsFileOffset offset,
                         const char* buffer,
                         XrdSfsXferSize length)
 {
-  int64_t rc;
+  // The chunk is handed to the remote replicas first so that their transfer
+  // overlaps with the write of the local replica. The remote writes are
+  // acknowledged asynchronously, within the window of chunks in flight to
+  // each replica, and a failure is reported with the next write.
+  unsigned int first_remote = (ioLocal ? 1 : 0);
+
+  for (unsigned int i = first_remote; i < mReplicaFile.size(); i++) {
+    if (!WriteReplica(i, offset, buffer, length)) {
+      return WriteError(i, offset);
+    }
+  }
 
-  for (unsigned int i = 0; i < mReplicaFile.size(); i++) {
-    rc = mReplicaFile[i]->fileWriteAsync(offset, buffer, length, mTimeout);
+  if (ioLocal && !mReplicaFile.empty()) {
+    if (!WriteReplica(0, offset, buffer, length)) {
+      return WriteError(0, offset);
+    }
+  }
 
-    if (rc != length) {
-      XrdOucString maskUrl = mReplicaUrl[i].c_str() ? mReplicaUrl[i].c_str() : "";
-      // mask some opaque parameters to shorten the logging
-      eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
-      eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
-      eos::common::StringConversion::MaskTag(maskUrl, "authz");
+  return length;
+}
 
-      if (i != 0) {
-        errno = EREMOTEIO;
-      }
+//------------------------------------------------------------------------------
+// Write a chunk to one replica
+//------------------------------------------------------------------------------
+bool
+ReplicaParLayout::WriteReplica(unsigned int i, XrdSfsFileOffset offset,
+                               const char* buffer, XrdSfsXferSize length)
+{
+  AsyncMetaHandler* handler =
+    static_cast<AsyncMetaHandler*>(mReplicaFile[i]->fileGetAsyncHandler());
+
+  // Acknowledgements of the previous chunks
+  if (handler && (handler->GetErrorType() != XrdCl::errNone)) {
+    eos_err("msg=\"previous write to replica %i failed\"", i);
+    errno = EREMOTEIO;
+    return false;
+  }
 
-      // show only the first write error as an error to broadcast upstream
-      if (hasWriteError) {
-        eos_err("[NB] Failed to write replica %i - write failed -%llu %s",
-                i, offset, maskUrl.c_str());
-      } else {
-        eos_err("Failed to write replica %i - write failed - %llu %s",
-                i, offset, maskUrl.c_str());
-      }
+  return (mReplicaFile[i]->fileWriteAsync(offset, buffer, length,
+                                          mTimeout) == length);
+}
 
-      hasWriteError = true;
-      return gOFS.Emsg("ReplicaWrite", *mError, errno, "write replica failed",
-                       maskUrl.c_str());
-    }
+//------------------------------------------------------------------------------
+// Report a failed write to a replica
+//------------------------------------------------------------------------------
+int
+ReplicaParLayout::WriteError(unsigned int i, XrdSfsFileOffset offset)
+{
+  XrdOucString maskUrl = mReplicaUrl[i].c_str() ? mReplicaUrl[i].c_str() : "";
+  // mask some opaque parameters to shorten the logging
+  eos::common::StringConversion::MaskTag(maskUrl, "cap.sym");
+  eos::common::StringConversion::MaskTag(maskUrl, "cap.msg");
+  eos::common::StringConversion::MaskTag(maskUrl, "authz");
+
+  if (i != 0) {
+    errno = EREMOTEIO;
   }
 
-  return length;
+  // show only the first write error as an error to broadcast upstream
+  if (hasWriteError) {
+    eos_err("[NB] Failed to write replica %i - write failed -%llu %s",
+            i, offset, maskUrl.c_str());
+  } else {
+    eos_err("Failed to write replica %i - write failed - %llu %s",
+            i, offset, maskUrl.c_str());
+  }
+
+  hasWriteError = true;
+  return gOFS.Emsg("ReplicaWrite", *mError, errno, "write replica failed",
+                   maskUrl.c_str());
 }
 
 //------------------------------------------------------------------------------
@@ -216,6 +216,30 @@ private:
   std::vector<FileIo*> mReplicaFile;
   std::vector<std::string> mReplicaUrl; ///< URLs of the replica files
   bool hasWriteError;
+
+  //----------------------------------------------------------------------------
+  //! Write a chunk to one replica, failing if a previous chunk sent to it
+  //! asynchronously failed
+  //!
+  //! @param i index of the replica
+  //! @param offset offset
+  //! @param buffer data to be written
+  //! @param length length
+  //!
+  //! @return true if successful, otherwise false
+  //----------------------------------------------------------------------------
+  bool WriteReplica(unsigned int i, XrdSfsFileOffset offset,
+                    const char* buffer, XrdSfsXferSize length);
+
+  //----------------------------------------------------------------------------
+  //! Report a failed write to a replica
+  //!
+  //! @param i index of the replica
+  //! @param offset offset of the write
+  //!
+  //! @return SFS_ERROR
+  //----------------------------------------------------------------------------
+  int WriteError(unsigned int i, XrdSfsFileOffset offset);
 };
 
 EOSFSTNAMESPACE_END
@@ -466,7 +466,7 @@ Storage::Communicator()
                                         mQueue2FsMap[queue.c_str()]->GetLongLong("scaninterval");
 
                       if (interval > 0) {
-                        mQueue2FsMap[queue.c_str()]->RunScanner(&mFstLoad, interval);
+                        mQueue2FsMap[queue.c_str()]->RunScanner(&mIoScheduler, interval);
                       }
                     }
                   } else {
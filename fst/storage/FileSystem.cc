@@ -195,16 +195,7 @@ FileSystem::CleanTransactions()
                                                 fstPath);
         unsigned long long fileid = eos::common::FileId::Hex2Fid(hexfid.c_str());
         // we allow to keep files open for 1 week
-        bool isOpen = false;
-        {
-          XrdSysMutexHelper wLock(gOFS.OpenFidMutex);
-
-          if (gOFS.WOpenFid[GetId()].count(fileid)) {
-            if (gOFS.WOpenFid[GetId()][fileid] > 0) {
-              isOpen = true;
-            }
-          }
-        }
+        bool isOpen = gOFS.mOpenFiles.IsOpen(GetId(), fileid, true);
 
         if ((buf.st_mtime < (time(NULL) - (7 * 86400))) && (!isOpen)) {
           FmdHelper* fMd = 0;
@@ -309,7 +300,7 @@ FileSystem::SyncTransactions(const char* manager)
 
 /*----------------------------------------------------------------------------*/
 void
-FileSystem::RunScanner(Load* fstLoad, time_t interval)
+FileSystem::RunScanner(IoScheduler* scheduler, time_t interval)
 {
   // don't scan filesystems which are 'remote'
   if (GetPath()[0] != '/') {
@@ -321,7 +312,7 @@ FileSystem::RunScanner(Load* fstLoad, time_t interval)
   }
 
   // create the object running the scanner thread
-  scanDir = new ScanDir(GetPath().c_str(), GetId(), fstLoad, true, interval);
+  scanDir = new ScanDir(GetPath().c_str(), GetId(), scheduler, true, interval);
   eos_info("Started 'ScanDir' thread with interval time of %u seconds",
            (unsigned long) interval);
 }
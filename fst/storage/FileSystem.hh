@@ -90,7 +90,7 @@ public:
   void CleanTransactions();
   bool SyncTransactions(const char* manager);
 
-  void RunScanner(Load* fstLoad, time_t interval);
+  void RunScanner(IoScheduler* scheduler, time_t interval);
 
   std::string
   GetPath()
@@ -0,0 +1,52 @@
+// ----------------------------------------------------------------------
+// File: FmdFlusher.cc
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+/*----------------------------------------------------------------------------*/
+#include "fst/storage/Storage.hh"
+#include "fst/XrdFstOfs.hh"
+/*----------------------------------------------------------------------------*/
+#include <algorithm>
+
+/*----------------------------------------------------------------------------*/
+
+EOSFSTNAMESPACE_BEGIN
+
+/*----------------------------------------------------------------------------*/
+void
+Storage::FmdFlusher()
+{
+  // this thread writes the batched fmd commits to the DBs
+  int interval = FmdDbMapHandler::CommitFlushMs();
+
+  if (!interval) {
+    eos_info("msg=\"fmd commits are not batched\"");
+    return;
+  }
+
+  while (1) {
+    XrdSysTimer::Wait(std::max(interval / 2, 1));
+    gFmdDbMapHandler.FlushBatches();
+  }
+}
+
+EOSFSTNAMESPACE_END
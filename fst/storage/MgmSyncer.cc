@@ -94,18 +94,8 @@ Storage::MgmSyncer ()
         continue;
       }
 
-      bool isopenforwrite = false;
-
       // check if someone is still writing on that file
-      gOFS.OpenFidMutex.Lock();
-      if (gOFS.WOpenFid[fmd.fsid()].count(fmd.fid()))
-      {
-        if (gOFS.WOpenFid[fmd.fsid()][fmd.fid()] > 0)
-        {
-          isopenforwrite = true;
-        }
-      }
-      gOFS.OpenFidMutex.UnLock();
+      bool isopenforwrite = gOFS.mOpenFiles.IsOpen(fmd.fsid(), fmd.fid(), true);
 
       if (!isopenforwrite)
       {
@@ -22,12 +22,128 @@
  ************************************************************************/
 
 #include "fst/storage/Storage.hh"
+#include "fst/storage/PublishFilter.hh"
 #include "fst/XrdFstOfs.hh"
 #include "common/LinuxStat.hh"
 #include "common/ShellCmd.hh"
+#include <algorithm>
 
 EOSFSTNAMESPACE_BEGIN
 
+//------------------------------------------------------------------------------
+// Store a filesystem statistic if it changed enough since the last publication
+//------------------------------------------------------------------------------
+static bool
+SetDoubleIfChanged(PublishFilter& filter, eos::common::FileSystem* fs,
+                   const char* key, double value)
+{
+  if (filter.Changed(filter.FullPublish() ? "" : fs->GetString(key), value)) {
+    return fs->SetDouble(key, value);
+  }
+
+  return true;
+}
+
+static bool
+SetLongLongIfChanged(PublishFilter& filter, eos::common::FileSystem* fs,
+                     const char* key, long long value)
+{
+  if (filter.Changed(filter.FullPublish() ? "" : fs->GetString(key), value)) {
+    return fs->SetLongLong(key, value);
+  }
+
+  return true;
+}
+
+static bool
+SetStringIfChanged(PublishFilter& filter, eos::common::FileSystem* fs,
+                   const char* key, const std::string& value)
+{
+  if (filter.Changed(filter.FullPublish() ? "" : fs->GetString(key), value)) {
+    return fs->SetString(key, value.c_str());
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Store the statfs values which changed, see common::FileSystem::SetStatfs
+//------------------------------------------------------------------------------
+static bool
+SetStatfsIfChanged(PublishFilter& filter, eos::common::FileSystem* fs,
+                   struct statfs* statfs)
+{
+  if (!statfs) {
+    return false;
+  }
+
+  bool success = true;
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.type",
+                                  statfs->f_type);
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.bsize",
+                                  statfs->f_bsize);
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.blocks",
+                                  statfs->f_blocks);
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.bfree",
+                                  statfs->f_bfree);
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.bavail",
+                                  statfs->f_bavail);
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.files",
+                                  statfs->f_files);
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.ffree",
+                                  statfs->f_ffree);
+#ifdef __APPLE__
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.namelen", MNAMELEN);
+#else
+  success &= SetLongLongIfChanged(filter, fs, "stat.statfs.namelen",
+                                  statfs->f_namelen);
+#endif
+  return success;
+}
+
+//------------------------------------------------------------------------------
+// Store a node statistic if it changed since the last publication, integer
+// values given as approximate are filtered like rates
+//------------------------------------------------------------------------------
+template <typename T>
+static void
+SetNodeIfChanged(PublishFilter& filter, XrdMqSharedHash* hash, const char* key,
+                 T value)
+{
+  if (filter.Changed(filter.FullPublish() ? "" : hash->Get(key), value)) {
+    hash->Set(key, value);
+  }
+}
+
+static void
+SetNodeApproxIfChanged(PublishFilter& filter, XrdMqSharedHash* hash,
+                       const char* key, long long value)
+{
+  if (filter.Changed(filter.FullPublish() ? "" : hash->Get(key),
+                     (double) value)) {
+    hash->Set(key, value);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Build the hot file list "<count>:<hexfid> ..." of the most opened files
+//------------------------------------------------------------------------------
+static void
+HotFiles(const std::vector<OpenFileTracker::HotFile>& hot,
+         XrdOucString& hotfiles)
+{
+  hotfiles = "";
+  XrdOucString hexfid;
+
+  for (size_t i = 0; i < hot.size(); ++i) {
+    eos::common::FileId::Fid2Hex(hot[i].second, hexfid);
+    hotfiles += (int) hot[i].first;
+    hotfiles += ":";
+    hotfiles += hexfid.c_str();
+    hotfiles += " ";
+  }
+}
+
 //------------------------------------------------------------------------------
 // Publish
 //------------------------------------------------------------------------------
@@ -81,8 +197,31 @@ Storage::Publish()
     fclose(fnetspeed);
   }
 
+  (void) unlink(tmp_name);
   eos_static_info("publishing:networkspeed=%.02f GB/s",
                   1.0 * netspeed / 1000000000.0);
+  // Rates and loads are only republished if they changed by more than
+  // EOS_FST_PUBLISH_THRESHOLD percent, all values are republished every
+  // EOS_FST_PUBLISH_REFRESH seconds
+  PublishFilter filter;
+  double threshold_percent = 5.0;
+  time_t full_publish_interval = 300;
+
+  if (getenv("EOS_FST_PUBLISH_THRESHOLD")) {
+    threshold_percent = strtod(getenv("EOS_FST_PUBLISH_THRESHOLD"), 0);
+  }
+
+  if (getenv("EOS_FST_PUBLISH_REFRESH")) {
+    full_publish_interval = strtol(getenv("EOS_FST_PUBLISH_REFRESH"), 0, 10);
+
+    if (full_publish_interval < 10) {
+      full_publish_interval = 10;
+    }
+  }
+
+  filter.SetThresholds(threshold_percent / 100.0, 0.01);
+  eos_static_info("publishing:threshold=%.02f%% refresh=%lds",
+                  threshold_percent, (long) full_publish_interval);
   // Wait before publishing
   XrdSysTimer sleeper;
   sleeper.Snooze(3);
@@ -97,31 +236,12 @@ Storage::Publish()
   eos::common::FileSystem::fsid_t fsid = 0;
   std::string publish_uptime = "";
   std::string publish_sockets = "";
+  time_t next_full_publish = 0;
+  // current publication period, shrinks while filesystems change and grows
+  // back to the configured interval once they are idle
+  unsigned int lCycleMilliSeconds = 0;
 
   while (1) {
-    {
-      // Retrieve uptime information
-      XrdOucString uptime = "uptime | tr -d \"\n\" > ";
-      uptime += tmp_name;
-      eos::common::ShellCmd scmd2(uptime.c_str());
-      rc = scmd2.wait(5);
-
-      if (rc.exit_code) {
-        eos_static_err("retrieve uptime call failed");
-      }
-
-      eos::common::StringConversion::LoadFileIntoString(tmp_name, publish_uptime);
-      XrdOucString sockets = "cat /proc/net/tcp | wc -l | tr -d \"\n\" >";
-      sockets += tmp_name;
-      eos::common::ShellCmd scmd3(sockets.c_str());
-      rc = scmd3.wait(5);
-
-      if (rc.exit_code) {
-        eos_static_err("retrieve #socket call failed");
-      }
-
-      eos::common::StringConversion::LoadFileIntoString(tmp_name, publish_sockets);
-    }
     time_t now = time(NULL);
     gettimeofday(&tv1, &tz);
     // TODO: derive this from a global variable
@@ -136,14 +256,39 @@ Storage::Publish()
       PublishInterval = 10;
     }
 
-    unsigned int lReportIntervalMilliSeconds = (PublishInterval * 500) +
-        (unsigned int)((PublishInterval * 1000.0) * rand() / RAND_MAX);
+    unsigned int lMaxCycleMilliSeconds = PublishInterval * 1000;
+    unsigned int lMinCycleMilliSeconds = std::max(1000, PublishInterval * 200);
+
+    if ((lCycleMilliSeconds < lMinCycleMilliSeconds) ||
+        (lCycleMilliSeconds > lMaxCycleMilliSeconds)) {
+      lCycleMilliSeconds = lMaxCycleMilliSeconds;
+    }
+
+    unsigned int lReportIntervalMilliSeconds = (lCycleMilliSeconds / 2) +
+        (unsigned int)((lCycleMilliSeconds * 1.0) * rand() / RAND_MAX);
+
+    {
+      // The node information is sampled by the health thread, so slow
+      // commands never delay the heartbeat
+      std::map<std::string, std::string> sys_info = mFstHealth.getSystemInfo();
+      publish_uptime = sys_info["uptime"];
+      publish_sockets = sys_info["sockets"];
+    }
+
     eos::common::LinuxStat::linux_stat_t osstat;
 
     if (!eos::common::LinuxStat::GetStat(osstat)) {
       eos_err("failed to get the memory usage information");
     }
 
+    filter.SetFullPublish(next_full_publish <= now);
+
+    if (filter.FullPublish()) {
+      next_full_publish = now + full_publish_interval;
+    }
+
+    filter.ResetCounters();
+    bool busy = false;
     {
       // run through our defined filesystems and publish with a MuxTransaction all changes
       eos::common::RWMutexReadLock lock(mFsMutex);
@@ -165,65 +310,18 @@ Storage::Publish()
             continue;
           }
 
+          unsigned long long published = filter.GetPublished();
           XrdOucString r_open_hotfiles;
           XrdOucString w_open_hotfiles;
+          long long r_open = 0;
+          long long w_open = 0;
           {
-            std::map<unsigned int, std::set<unsigned long long>> Rhotfiles;
-            std::map<unsigned int, std::set<unsigned long long>> Whotfiles;
-            {
-              XrdSysMutexHelper fLock(gOFS.OpenFidMutex);
-
-              if (gOFS.ROpenFid.count(fsid)) {
-                for (auto it = gOFS.ROpenFid[fsid].begin(); it != gOFS.ROpenFid[fsid].end();
-                     ++it) {
-                  Rhotfiles[it->second].insert(it->first);
-                }
-              }
-
-              if (gOFS.WOpenFid.count(fsid)) {
-                for (auto it = gOFS.WOpenFid[fsid].begin(); it != gOFS.WOpenFid[fsid].end();
-                     ++it) {
-                  Whotfiles[it->second].insert(it->first);
-                }
-              }
-            }
-            size_t cnt = 0;
-
-            for (auto it = Rhotfiles.rbegin(); it != Rhotfiles.rend(); ++it) {
-              XrdOucString hexfid;
-
-              for (auto fit = it->second.begin(); fit != it->second.end(); ++fit) {
-                eos::common::FileId::Fid2Hex(*fit, hexfid);
-                r_open_hotfiles += (int) it->first;
-                r_open_hotfiles += ":";
-                r_open_hotfiles += hexfid.c_str();
-                r_open_hotfiles += " ";
-                ++cnt;
-
-                if (cnt == 10) {
-                  break;
-                }
-              }
-            }
-
-            cnt = 0;
-
-            for (auto it = Whotfiles.rbegin(); it != Whotfiles.rend(); ++it) {
-              XrdOucString hexfid;
-
-              for (auto fit = it->second.begin(); fit != it->second.end(); ++fit) {
-                eos::common::FileId::Fid2Hex(*fit, hexfid);
-                w_open_hotfiles += (int) it->first;
-                w_open_hotfiles += ":";
-                w_open_hotfiles += hexfid.c_str();
-                w_open_hotfiles += " ";
-                ++cnt;
-
-                if (cnt == 10) {
-                  break;
-                }
-              }
-            }
+            // Counters and hot files are maintained on open and close, no
+            // need to look at all the open files here
+            r_open = gOFS.mOpenFiles.GetNumOpenFiles(fsid, false);
+            w_open = gOFS.mOpenFiles.GetNumOpenFiles(fsid, true);
+            HotFiles(gOFS.mOpenFiles.GetHotFiles(fsid, false, 10), r_open_hotfiles);
+            HotFiles(gOFS.mOpenFiles.GetHotFiles(fsid, true, 10), w_open_hotfiles);
           }
           // Retrieve Statistics from the SQLITE DB
           std::map<std::string, size_t>::const_iterator isit;
@@ -243,29 +341,29 @@ Storage::Publish()
                 //eos_static_debug("%-24s => %lu", isit->first.c_str(), isit->second);
                 std::string sname = "stat.fsck.";
                 sname += isit->first;
-                success &= mFsVect[i]->SetLongLong(sname.c_str(), isit->second);
+                success &= SetLongLongIfChanged(filter, mFsVect[i], sname.c_str(),
+                                                isit->second);
               }
             }
           }
 
           eos::common::Statfs* statfs = 0;
 
-          // call the update function which stores into the filesystem shared hash
+          // store the statfs values which changed into the filesystem shared hash
           if ((statfs = mFsVect[i]->GetStatfs())) {
-            // call the update function which stores into the filesystem shared hash
-            if (!mFsVect[i]->SetStatfs(statfs->GetStatfs())) {
+            if (!SetStatfsIfChanged(filter, mFsVect[i], statfs->GetStatfs())) {
               eos_static_err("cannot SetStatfs on filesystem %s",
                              mFsVect[i]->GetPath().c_str());
             }
           }
 
           // Copy out net info
-          success &= mFsVect[i]->SetDouble("stat.net.ethratemib",
-                                           netspeed / (8 * 1024 * 1024));
-          success &= mFsVect[i]->SetDouble("stat.net.inratemib",
-                                           mFstLoad.GetNetRate(lEthernetDev.c_str(), "rxbytes") / 1024.0 / 1024.0);
-          success &= mFsVect[i]->SetDouble("stat.net.outratemib",
-                                           mFstLoad.GetNetRate(lEthernetDev.c_str(), "txbytes") / 1024.0 / 1024.0);
+          success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.net.ethratemib",
+                                        netspeed / (8 * 1024 * 1024));
+          success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.net.inratemib",
+                                        mFstLoad.GetNetRate(lEthernetDev.c_str(), "rxbytes") / 1024.0 / 1024.0);
+          success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.net.outratemib",
+                                        mFstLoad.GetNetRate(lEthernetDev.c_str(), "txbytes") / 1024.0 / 1024.0);
           // Set current load stats, io-target specific implementation may override
           // fst load implementation
           {
@@ -287,10 +385,16 @@ Storage::Publish()
                                               "millisIO") / 1000.0;
             }
 
-            success &= mFsVect[i]->SetDouble("stat.disk.readratemb", readratemb);
-            success &= mFsVect[i]->SetDouble("stat.disk.writeratemb",
-                                             writeratemb);
-            success &= mFsVect[i]->SetDouble("stat.disk.load", diskload);
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.disk.readratemb",
+                                          readratemb);
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.disk.writeratemb",
+                                          writeratemb);
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.disk.load",
+                                          diskload);
+            // Bandwidth left to the scanner, verifications and scrubbing
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.disk.iobudget",
+                                          mIoScheduler.GetBudget(
+                                            mIoScheduler.GetDevice(mFsVect[i]->GetPath())));
           }
           // copy out net info
           {
@@ -301,66 +405,91 @@ Storage::Publish()
               health = mFstHealth.getDiskHealth(mFsVect[i]->GetPath().c_str());
             }
 
-            success &= mFsVect[i]->SetString("stat.health",
-                                             (health.count("summary") ? health["summary"].c_str() : "N/A"));
-            success &= mFsVect[i]->SetLongLong("stat.health.indicator",
-                                               strtoll(health["indicator"].c_str(), 0, 10));
-            success &= mFsVect[i]->SetLongLong("stat.health.drives_total",
-                                               strtoll(health["drives_total"].c_str(), 0, 10));
-            success &= mFsVect[i]->SetLongLong("stat.health.drives_failed",
-                                               strtoll(health["drives_failed"].c_str(), 0, 10));
-            success &= mFsVect[i]->SetLongLong("stat.health.redundancy_factor",
-                                               strtoll(health["redundancy_factor"].c_str(), 0, 10));
+            success &= SetStringIfChanged(filter, mFsVect[i], "stat.health",
+                                          (health.count("summary") ? health["summary"].c_str() : "N/A"));
+            success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.health.indicator",
+                                            strtoll(health["indicator"].c_str(), 0, 10));
+            success &= SetLongLongIfChanged(filter, mFsVect[i],
+                                            "stat.health.drives_total",
+                                            strtoll(health["drives_total"].c_str(), 0, 10));
+            success &= SetLongLongIfChanged(filter, mFsVect[i],
+                                            "stat.health.drives_failed",
+                                            strtoll(health["drives_failed"].c_str(), 0, 10));
+            success &= SetLongLongIfChanged(filter, mFsVect[i],
+                                            "stat.health.redundancy_factor",
+                                            strtoll(health["redundancy_factor"].c_str(), 0, 10));
           }
-          long long r_open = 0;
-          long long w_open = 0;
           {
-            XrdSysMutexHelper fLock(gOFS.OpenFidMutex);
-            r_open = (long long) gOFS.ROpenFid[fsid].size();
-            w_open = (long long) gOFS.WOpenFid[fsid].size();
+            // Files waiting for deletion and deletions per second
+            unsigned long long backlog = 0;
+            double rate = 0;
+            GetDeletionStats(fsid, backlog, rate);
+            success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.deletion.backlog",
+                                            backlog);
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.deletion.rate", rate);
+          }
+          success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.ropen", r_open);
+          success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.wopen", w_open);
+          {
+            long long blocks = mFsVect[i]->GetLongLong("stat.statfs.blocks");
+            long long bfree = mFsVect[i]->GetLongLong("stat.statfs.bfree");
+            long long bsize = mFsVect[i]->GetLongLong("stat.statfs.bsize");
+            long long files = mFsVect[i]->GetLongLong("stat.statfs.files");
+            long long ffree = mFsVect[i]->GetLongLong("stat.statfs.ffree");
+            success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.statfs.freebytes",
+                                            bfree * bsize);
+            success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.statfs.usedbytes",
+                                            (blocks - bfree) * bsize);
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.statfs.filled",
+                                          100.0 * (blocks - bfree) / (1 + blocks));
+            success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.statfs.capacity",
+                                            blocks * bsize);
+            success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.statfs.fused",
+                                            (files - ffree) * bsize);
+          }
+          {
+            long long used_files = 0;
+            {
+              eos::common::RWMutexReadLock lock(gFmdDbMapHandler.Mutex);
+              FmdSqliteWriteLock vlock(fsid);
+              used_files = (long long)(gFmdDbMapHandler.dbmap.count(fsid) ?
+                                       gFmdDbMapHandler.dbmap[fsid]->size() : 0);
+            }
+            success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.usedfiles",
+                                            used_files);
           }
-          success &= mFsVect[i]->SetLongLong("stat.ropen", r_open);
-          success &= mFsVect[i]->SetLongLong("stat.wopen", w_open);
-          success &= mFsVect[i]->SetLongLong("stat.statfs.freebytes",
-                                             mFsVect[i]->GetLongLong("stat.statfs.bfree") *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
-          success &= mFsVect[i]->SetLongLong("stat.statfs.usedbytes",
-                                             (mFsVect[i]->GetLongLong("stat.statfs.blocks") -
-                                              mFsVect[i]->GetLongLong("stat.statfs.bfree")) *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
-          success &= mFsVect[i]->SetDouble("stat.statfs.filled",
-                                           100.0 * ((mFsVect[i]->GetLongLong("stat.statfs.blocks") -
-                                               mFsVect[i]->GetLongLong("stat.statfs.bfree"))) /
-                                           (1 + mFsVect[i]->GetLongLong("stat.statfs.blocks")));
-          success &= mFsVect[i]->SetLongLong("stat.statfs.capacity",
-                                             mFsVect[i]->GetLongLong("stat.statfs.blocks") *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
-          success &= mFsVect[i]->SetLongLong("stat.statfs.fused",
-                                             (mFsVect[i]->GetLongLong("stat.statfs.files") -
-                                              mFsVect[i]->GetLongLong("stat.statfs.ffree")) *
-                                             mFsVect[i]->GetLongLong("stat.statfs.bsize"));
           {
-            eos::common::RWMutexReadLock lock(gFmdDbMapHandler.Mutex);
-            FmdSqliteWriteLock vlock(fsid);
-            success &= mFsVect[i]->SetLongLong("stat.usedfiles",
-                                               (long long)(gFmdDbMapHandler.dbmap.count(fsid) ?
-                                                   gFmdDbMapHandler.dbmap[fsid]->size() : 0));
+            double get_usec;
+            double commit_usec;
+            gFmdDbMapHandler.GetLatency(fsid, get_usec, commit_usec);
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.fmd.getusec",
+                                          get_usec);
+            success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.fmd.commitusec",
+                                          commit_usec);
           }
-          success &= mFsVect[i]->SetString("stat.boot",
-                                           mFsVect[i]->GetStatusAsString(mFsVect[i]->GetStatus()));
-          success &= mFsVect[i]->SetString("stat.geotag", lNodeGeoTag.c_str());
-          struct timeval tvfs;
-          gettimeofday(&tvfs, &tz);
-          size_t nowms = tvfs.tv_sec * 1000 + tvfs.tv_usec / 1000;
-          success &= mFsVect[i]->SetLongLong("stat.publishtimestamp", nowms);
-          success &= mFsVect[i]->SetLongLong("stat.drainer.running",
-                                             mFsVect[i]->GetDrainQueue()->GetRunningAndQueued());
-          success &= mFsVect[i]->SetLongLong("stat.balancer.running",
-                                             mFsVect[i]->GetBalanceQueue()->GetRunningAndQueued());
-          success &= mFsVect[i]->SetLongLong("stat.disk.iops",
-                                             mFsVect[i]->getIOPS());
-          success &= mFsVect[i]->SetDouble("stat.disk.bw",
-                                           mFsVect[i]->getSeqBandwidth()); // in MB
+          success &= SetStringIfChanged(filter, mFsVect[i], "stat.boot",
+                                        mFsVect[i]->GetStatusAsString(mFsVect[i]->GetStatus()));
+          {
+            // resync progress of a booting filesystem, e.g. disk:120000
+            std::string progress = gFmdDbMapHandler.GetSyncProgress(fsid);
+
+            if (progress.empty()) {
+              progress = " ";
+            }
+
+            success &= SetStringIfChanged(filter, mFsVect[i], "stat.bootprogress",
+                                          progress.c_str());
+          }
+          success &= SetStringIfChanged(filter, mFsVect[i], "stat.geotag",
+                                        lNodeGeoTag.c_str());
+          success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.drainer.running",
+                                          mFsVect[i]->GetDrainQueue()->GetRunningAndQueued());
+          success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.balancer.running",
+                                          mFsVect[i]->GetBalanceQueue()->GetRunningAndQueued());
+          success &= SetLongLongIfChanged(filter, mFsVect[i], "stat.disk.iops",
+                                          mFsVect[i]->getIOPS());
+          success &= SetDoubleIfChanged(filter, mFsVect[i], "stat.disk.bw",
+                                        mFsVect[i]->getSeqBandwidth()); // in MB
           {
             // we have to set something which is not empty to update the value
             if (!r_open_hotfiles.length()) {
@@ -372,11 +501,25 @@ Storage::Publish()
             }
 
             // Copy out hot file list
-            success &= mFsVect[i]->SetString("stat.ropen.hotfiles",
-                                             r_open_hotfiles.c_str());
-            success &= mFsVect[i]->SetString("stat.wopen.hotfiles",
-                                             w_open_hotfiles.c_str());
+            success &= SetStringIfChanged(filter, mFsVect[i], "stat.ropen.hotfiles",
+                                          r_open_hotfiles.c_str());
+            success &= SetStringIfChanged(filter, mFsVect[i], "stat.wopen.hotfiles",
+                                          w_open_hotfiles.c_str());
+          }
+
+          if (filter.GetPublished() != published) {
+            busy |= !filter.FullPublish();
           }
+
+          {
+            // the MGM takes filesystems without a recent timestamp out of
+            // placement, so it goes out every cycle even if nothing changed
+            struct timeval tvfs;
+            gettimeofday(&tvfs, &tz);
+            size_t nowms = tvfs.tv_sec * 1000 + tvfs.tv_usec / 1000;
+            success &= mFsVect[i]->SetLongLong("stat.publishtimestamp", nowms);
+          }
+
           {
             long long fbytes = mFsVect[i]->GetLongLong("stat.statfs.freebytes");
             XrdSysMutexHelper(mFsFullMapMutex);
@@ -415,31 +558,39 @@ Storage::Publish()
                                     Config::gConfig.FstNodeConfigQueue.c_str(), "hash");
 
           if (hash) {
-            hash->Set("stat.sys.kernel", eos::fst::Config::gConfig.KernelVersion.c_str());
-            hash->Set("stat.sys.vsize", osstat.vsize);
-            hash->Set("stat.sys.rss", osstat.rss);
-            hash->Set("stat.sys.threads", osstat.threads);
+            SetNodeIfChanged(filter, hash, "stat.sys.kernel",
+                             eos::fst::Config::gConfig.KernelVersion.c_str());
+            SetNodeApproxIfChanged(filter, hash, "stat.sys.vsize", osstat.vsize);
+            SetNodeApproxIfChanged(filter, hash, "stat.sys.rss", osstat.rss);
+            SetNodeIfChanged(filter, hash, "stat.sys.threads",
+                             (long long) osstat.threads);
             {
               XrdOucString v = VERSION;
               v += "-";
               v += RELEASE;
-              hash->Set("stat.sys.eos.version", v.c_str());
+              SetNodeIfChanged(filter, hash, "stat.sys.eos.version", v.c_str());
             }
-            hash->Set("stat.sys.keytab", eos::fst::Config::gConfig.KeyTabAdler.c_str());
-            hash->Set("stat.sys.uptime", publish_uptime.c_str());
-            hash->Set("stat.sys.sockets", publish_sockets.c_str());
-            hash->Set("stat.sys.eos.start", eos::fst::Config::gConfig.StartDate.c_str());
-            hash->Set("stat.geotag", lNodeGeoTag.c_str());
-            hash->Set("debug.state",
-                      eos::common::StringConversion::ToLower
-                      (g_logging.GetPriorityString
-                       (g_logging.gPriorityLevel)).c_str());
+            SetNodeIfChanged(filter, hash, "stat.sys.keytab",
+                             eos::fst::Config::gConfig.KeyTabAdler.c_str());
+            SetNodeIfChanged(filter, hash, "stat.sys.uptime", publish_uptime.c_str());
+            SetNodeIfChanged(filter, hash, "stat.sys.sockets", publish_sockets.c_str());
+            SetNodeIfChanged(filter, hash, "stat.sys.eos.start",
+                             eos::fst::Config::gConfig.StartDate.c_str());
+            SetNodeIfChanged(filter, hash, "stat.geotag", lNodeGeoTag.c_str());
+            SetNodeIfChanged(filter, hash, "debug.state",
+                             eos::common::StringConversion::ToLower
+                             (g_logging.GetPriorityString
+                              (g_logging.gPriorityLevel)).c_str());
             // copy out net info
-            hash->Set("stat.net.ethratemib", netspeed / (8 * 1024 * 1024));
-            hash->Set("stat.net.inratemib", mFstLoad.GetNetRate(lEthernetDev.c_str(),
-                      "rxbytes") / 1024.0 / 1024.0);
-            hash->Set("stat.net.outratemib", mFstLoad.GetNetRate(lEthernetDev.c_str(),
-                      "txbytes") / 1024.0 / 1024.0);
+            SetNodeIfChanged(filter, hash, "stat.net.ethratemib",
+                             (long long)(netspeed / (8 * 1024 * 1024)));
+            SetNodeIfChanged(filter, hash, "stat.net.inratemib",
+                             mFstLoad.GetNetRate(lEthernetDev.c_str(),
+                                                 "rxbytes") / 1024.0 / 1024.0);
+            SetNodeIfChanged(filter, hash, "stat.net.outratemib",
+                             mFstLoad.GetNetRate(lEthernetDev.c_str(),
+                                                 "txbytes") / 1024.0 / 1024.0);
+            // the node timestamp is the heartbeat of the publisher
             struct timeval tvfs;
             gettimeofday(&tvfs, &tz);
             size_t nowms = tvfs.tv_sec * 1000 + tvfs.tv_usec / 1000;
@@ -455,23 +606,30 @@ Storage::Publish()
       }
     }
 
+    // publish faster while the filesystems change, slow down when idle
+    if (busy) {
+      lCycleMilliSeconds = std::max(lMinCycleMilliSeconds, lCycleMilliSeconds / 2);
+    } else {
+      lCycleMilliSeconds = std::min(lMaxCycleMilliSeconds, lCycleMilliSeconds * 2);
+    }
+
     gettimeofday(&tv2, &tz);
     int lCycleDuration = (int)((tv2.tv_sec * 1000.0) - (tv1.tv_sec * 1000.0) +
                                (tv2.tv_usec / 1000.0) - (tv1.tv_usec / 1000.0));
     int lSleepTime = lReportIntervalMilliSeconds - lCycleDuration;
-    eos_static_debug("msg=\"publish interval\" %d %d", lReportIntervalMilliSeconds,
-                     lCycleDuration);
+    eos_static_debug("msg=\"publish interval\" %d %d published=%llu suppressed=%llu "
+                     "full=%d", lReportIntervalMilliSeconds, lCycleDuration,
+                     filter.GetPublished(), filter.GetSuppressed(),
+                     filter.FullPublish());
 
     if (lSleepTime < 0) {
       eos_static_warning("Publisher cycle exceeded %d millisecons - took %d milliseconds",
                          lReportIntervalMilliSeconds, lCycleDuration);
     } else {
       XrdSysTimer sleeper;
-      sleeper.Snooze(lSleepTime / 1000);
+      sleeper.Wait(lSleepTime);
     }
   }
-
-  (void) unlink(tmp_name);
 }
 
 EOSFSTNAMESPACE_END
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+// File: PublishFilter.hh
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_PUBLISHFILTER_HH__
+#define __EOSFST_PUBLISHFILTER_HH__
+
+#include "fst/Namespace.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class PublishFilter - decides which statistics the publisher has to send
+//!
+//! The previously published value is the one stored in the shared hash. Rates
+//! and loads (doubles) are only republished if they moved by more than a
+//! relative threshold and an absolute floor, or if they dropped to zero.
+//! Counters, sizes and strings are republished on any change. During a full
+//! publication cycle every value is sent, whatever its previous value.
+//------------------------------------------------------------------------------
+class PublishFilter
+{
+public:
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param relative relative change threshold for approximate values
+  //! @param absolute absolute change floor for approximate values
+  //----------------------------------------------------------------------------
+  PublishFilter(double relative = 0.05, double absolute = 0.01):
+    mRelative(relative), mAbsolute(absolute), mFullPublish(true),
+    mPublished(0), mSuppressed(0)
+  {
+  }
+
+  void
+  SetThresholds(double relative, double absolute)
+  {
+    mRelative = (relative < 0) ? 0 : relative;
+    mAbsolute = (absolute < 0) ? 0 : absolute;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Enable/disable the publication of all values in the current cycle
+  //----------------------------------------------------------------------------
+  void
+  SetFullPublish(bool full)
+  {
+    mFullPublish = full;
+  }
+
+  bool
+  FullPublish() const
+  {
+    return mFullPublish;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if an approximate value has to be published
+  //!
+  //! @param prev previously published value as stored in the hash ("" if none)
+  //! @param cur current value
+  //----------------------------------------------------------------------------
+  bool
+  Changed(const std::string& prev, double cur)
+  {
+    bool changed = mFullPublish || prev.empty();
+
+    if (!changed) {
+      double old = strtod(prev.c_str(), 0);
+      double delta = std::fabs(cur - old);
+
+      if ((cur == 0) || (old == 0)) {
+        changed = (delta > mAbsolute) || ((cur == 0) && (old != 0));
+      } else {
+        changed = (delta > mAbsolute) &&
+                  (delta > mRelative * std::max(std::fabs(old), std::fabs(cur)));
+      }
+    }
+
+    return Count(changed);
+  }
+
+  //----------------------------------------------------------------------------
+  //! Check if an exact value has to be published
+  //----------------------------------------------------------------------------
+  bool
+  Changed(const std::string& prev, long long cur)
+  {
+    return Count(mFullPublish || prev.empty() ||
+                 (strtoll(prev.c_str(), 0, 10) != cur));
+  }
+
+  bool
+  Changed(const std::string& prev, const std::string& cur)
+  {
+    return Count(mFullPublish || (prev != cur));
+  }
+
+  //----------------------------------------------------------------------------
+  //! Number of values published/suppressed since the last ResetCounters
+  //----------------------------------------------------------------------------
+  unsigned long long
+  GetPublished() const
+  {
+    return mPublished;
+  }
+
+  unsigned long long
+  GetSuppressed() const
+  {
+    return mSuppressed;
+  }
+
+  void
+  ResetCounters()
+  {
+    mPublished = mSuppressed = 0;
+  }
+
+private:
+  double mRelative; ///< Relative change threshold for approximate values
+  double mAbsolute; ///< Absolute change floor for approximate values
+  bool mFullPublish; ///< If true every value is published
+  unsigned long long mPublished; ///< Number of published values
+  unsigned long long mSuppressed; ///< Number of suppressed values
+
+  bool
+  Count(bool changed)
+  {
+    if (changed) {
+      ++mPublished;
+    } else {
+      ++mSuppressed;
+    }
+
+    return changed;
+  }
+};
+
+EOSFSTNAMESPACE_END
+
+#endif
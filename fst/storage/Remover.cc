@@ -23,9 +23,100 @@
 
 #include "fst/storage/Storage.hh"
 #include "fst/XrdFstOfs.hh"
+#include "fst/FmdDbMap.hh"
 
 EOSFSTNAMESPACE_BEGIN
 
+// Bytes of background IO accounted for unlinking one file
+static const size_t sDeletionCost = 64 * 1024;
+
+/*----------------------------------------------------------------------------*/
+void
+Storage::Deleter()
+{
+  // Thread that unlinks stored files, at most one batch per device at a time
+  while (1) {
+    std::string device;
+    std::unique_ptr<Deletion> to_del = GetDeletion(device);
+
+    if (!to_del) {
+      XrdSysTimer msSleep;
+      msSleep.Wait(100);
+      continue;
+    }
+
+    eos_static_debug("%u files to delete", GetNumDeletions());
+    RunDeletion(*to_del, device);
+    DoneDeletion(to_del->fsId, device, to_del->fIdVector);
+  }
+}
+
+/*----------------------------------------------------------------------------*/
+void
+Storage::RunDeletion(Deletion& del, const std::string& device)
+{
+  std::vector<eos::common::FileId::fileid_t> removed;
+  removed.reserve(del.fIdVector.size());
+
+  for (unsigned int j = 0; j < del.fIdVector.size(); ++j) {
+    eos_static_debug("Deleting file_id=%llu on fs_id=%u", del.fIdVector[j],
+                     del.fsId);
+    // Unlinks share the background IO budget of the device, so they slow
+    // down while the device is busy with client IO
+    mIoScheduler.Acquire(device, sDeletionCost);
+    XrdOucString hexstring = "";
+    eos::common::FileId::Fid2Hex(del.fIdVector[j], hexstring);
+    XrdOucErrInfo error;
+    XrdOucString OpaqueString = "";
+    OpaqueString += "&mgm.fsid=";
+    OpaqueString += (int) del.fsId;
+    OpaqueString += "&mgm.fid=";
+    OpaqueString += hexstring;
+    OpaqueString += "&mgm.localprefix=";
+    OpaqueString += del.localPrefix;
+    XrdOucEnv Opaque(OpaqueString.c_str());
+
+    // The fmd records are removed below in one write batch
+    if ((gOFS._rem("/DELETION", error, (const XrdSecEntity*) 0, &Opaque,
+                   0, 0, 0, true, false) != SFS_OK)) {
+      eos_static_warning("unable to remove fid %s fsid %lu localprefix=%s",
+                         hexstring.c_str(), del.fsId, del.localPrefix.c_str());
+    } else {
+      removed.push_back(del.fIdVector[j]);
+    }
+  }
+
+  if (removed.size()) {
+    size_t ndeleted = gFmdDbMapHandler.DeleteFmds(removed, del.fsId);
+
+    if (ndeleted != removed.size()) {
+      eos_static_notice("unable to delete fmd for %lu of %lu files on "
+                        "filesystem %lu", (unsigned long)(removed.size() - ndeleted),
+                        (unsigned long) removed.size(), del.fsId);
+    }
+  }
+
+  // Update the manager, the drop protocol takes a single file id
+  for (unsigned int j = 0; j < del.fIdVector.size(); ++j) {
+    XrdOucString hexstring = "";
+    eos::common::FileId::Fid2Hex(del.fIdVector[j], hexstring);
+    XrdOucErrInfo error;
+    XrdOucString capOpaqueString = "/?mgm.pcmd=drop";
+    capOpaqueString += "&mgm.fsid=";
+    capOpaqueString += (int) del.fsId;
+    capOpaqueString += "&mgm.fid=";
+    capOpaqueString += hexstring;
+    capOpaqueString += "&mgm.localprefix=";
+    capOpaqueString += del.localPrefix;
+    int rc = gOFS.CallManager(&error, 0, 0 , capOpaqueString);
+
+    if (rc) {
+      eos_static_err("unable to drop file id %s fsid %u at manager %s",
+                     hexstring.c_str(), del.fsId, del.managerId.c_str());
+    }
+  }
+}
+
 /*----------------------------------------------------------------------------*/
 void
 Storage::Remover()
@@ -42,52 +133,16 @@ Storage::Remover()
   }
 
   nodeconfigqueue = eos::fst::Config::gConfig.FstNodeConfigQueue.c_str();
-  std::unique_ptr<Deletion> to_del {};
 
-  // Thread that unlinks stored files
+  // Thread that asks the manager for deletions, the deleter threads run them
   while (1) {
-    while ((to_del = GetDeletion())) {
-      eos_static_debug("%u files to delete", GetNumDeletions());
-
-      for (unsigned int j = 0; j < to_del->fIdVector.size(); ++j) {
-        eos_static_debug("Deleting file_id=%llu on fs_id=%u", to_del->fIdVector[j],
-                         to_del->fsId);
-        XrdOucString hexstring = "";
-        eos::common::FileId::Fid2Hex(to_del->fIdVector[j], hexstring);
-        XrdOucErrInfo error;
-        XrdOucString capOpaqueString = "/?mgm.pcmd=drop";
-        XrdOucString OpaqueString = "";
-        OpaqueString += "&mgm.fsid=";
-        OpaqueString += (int) to_del->fsId;
-        OpaqueString += "&mgm.fid=";
-        OpaqueString += hexstring;
-        OpaqueString += "&mgm.localprefix=";
-        OpaqueString += to_del->localPrefix;
-        XrdOucEnv Opaque(OpaqueString.c_str());
-        capOpaqueString += OpaqueString;
-
-        if ((gOFS._rem("/DELETION", error, (const XrdSecEntity*) 0, &Opaque,
-                       0, 0, 0, true) != SFS_OK)) {
-          eos_static_warning("unable to remove fid %s fsid %lu localprefix=%s",
-                             hexstring.c_str(), to_del->fsId, to_del->localPrefix.c_str());
-        }
-
-        // Update the manager
-        int rc = gOFS.CallManager(&error, 0, 0 , capOpaqueString);
-
-        if (rc) {
-          eos_static_err("unable to drop file id %s fsid %u at manager %s",
-                         hexstring.c_str(), to_del->fsId, to_del->managerId.c_str());
-        }
-      }
-    }
-
     XrdSysTimer msSleep;
     msSleep.Wait(100);
     time_t now = time(NULL);
 
-    // Ask to schedule deletions every 5 minutes
-    if ((now - lastAskedForDeletions) > 300) {
+    // Ask to schedule deletions every 5 minutes while a filesystem has drained
+    // its backlog, a slow device doesn't hold back the others
+    if (((now - lastAskedForDeletions) > 300) && IsDeletionQueryDue()) {
       // get some global variables
       gOFS.ObjectManager.HashMutex.LockRead();
       XrdMqSharedHash* confighash = gOFS.ObjectManager.GetHash(
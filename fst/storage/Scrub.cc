@@ -149,6 +149,7 @@ Storage::ScrubFs(const char* path, unsigned long long free,
   eos_static_debug("Running Scrubber on filesystem path=%s id=%u free=%llu blocks=%llu index=%d",
                    path, id, free, blocks, index);
   int fserrors = 0;
+  std::string device = mIoScheduler.GetDevice(path);
 
   for (int fs = 1; fs <= index; fs++) {
     // check if test file exists, if not, write it
@@ -192,6 +193,7 @@ Storage::ScrubFs(const char* path, unsigned long long free,
         eos_static_debug("rshift is %d", rshift);
 
         for (int i = 0; i < MB; i++) {
+          mIoScheduler.Acquire(device, 1024 * 1024);
           int nwrite = write(ff, mScrubPattern[rshift], 1024 * 1024);
 
           if (nwrite != (1024 * 1024)) {
@@ -221,6 +223,7 @@ Storage::ScrubFs(const char* path, unsigned long long free,
       int eberrors = 0;
 
       for (int i = 0; i < MB; i++) {
+        mIoScheduler.Acquire(device, 1024 * 1024);
         int nread = read(ff, mScrubPatternVerify, 1024 * 1024);
 
         if (nread != (1024 * 1024)) {
@@ -31,10 +31,12 @@
 #include "common/StringConversion.hh"
 #include "common/LinuxStat.hh"
 #include "common/ShellCmd.hh"
+#include "common/EnvTunable.hh"
 #include "mq/XrdMqMessaging.hh"
 #include "MonitorVarPartition.hh"
 #include <google/dense_hash_map>
 #include <math.h>
+#include <algorithm>
 #include "fst/XrdFstOss.hh"
 #include "XrdSys/XrdSysTimer.hh"
 
@@ -58,10 +60,40 @@ Storage::Create(const char* meta_dir)
   return storage;
 }
 
+//------------------------------------------------------------------------------
+// Number of threads running verifications, at most one per device
+//------------------------------------------------------------------------------
+static int
+VerifyThreads()
+{
+  static const int sThreads =
+    eos::common::EnvTunable::Get("EOS_FST_VERIFY_THREADS", 8, 1, 64);
+  return sThreads;
+}
+
+//------------------------------------------------------------------------------
+// Number of threads running deletions, at most one per device
+//------------------------------------------------------------------------------
+static int
+DeletionThreads()
+{
+  static const int sThreads =
+    eos::common::EnvTunable::Get("EOS_FST_DELETION_THREADS", 8, 1, 64);
+  return sThreads;
+}
+
+// Maximum number of files unlinked by a deletion thread in one batch
+static const size_t sDeletionBatchSize = 1000;
+// Number of queued deletions looked at to find one on an idle device
+static const size_t sDeletionLookAhead = 10000;
+// Seconds over which the deletion rate is computed
+static const time_t sDeletionRateWindow = 30;
+
 //------------------------------------------------------------------------------
 // Constructor
 //------------------------------------------------------------------------------
-Storage::Storage(const char* meta_dir)
+Storage::Storage(const char* meta_dir):
+  mIoScheduler(&mFstLoad)
 {
   SetLogId("FstOfsStorage");
   XrdOucString mkmetalogdir = "mkdir -p ";
@@ -127,6 +159,16 @@ Storage::Storage(const char* meta_dir)
     mZombie = true;
   }
 
+  mThreadSet.insert(tid);
+  eos_info("starting fmd flusher thread");
+
+  if ((rc = XrdSysThread::Run(&tid, Storage::StartFmdFlusher,
+                              static_cast<void*>(this),
+                              0, "Meta Store Flusher"))) {
+    eos_crit("cannot start fmd flusher thread");
+    mZombie = true;
+  }
+
   mThreadSet.insert(tid);
   eos_info("starting deletion thread");
 
@@ -138,6 +180,19 @@ Storage::Storage(const char* meta_dir)
   }
 
   mThreadSet.insert(tid);
+  eos_info("starting %d deletion threads", DeletionThreads());
+
+  for (int i = 0; i < DeletionThreads(); i++) {
+    if ((rc = XrdSysThread::Run(&tid, Storage::StartFsDeleter,
+                                static_cast<void*>(this),
+                                0, "Data Store Deleter"))) {
+      eos_crit("cannot start deleter thread");
+      mZombie = true;
+    }
+
+    mThreadSet.insert(tid);
+  }
+
   eos_info("starting report thread");
 
   if ((rc = XrdSysThread::Run(&tid, Storage::StartFsReport,
@@ -158,16 +213,19 @@ Storage::Storage(const char* meta_dir)
   }
 
   mThreadSet.insert(tid);
-  eos_info("starting verification thread");
+  eos_info("starting %d verification threads", VerifyThreads());
+
+  for (int i = 0; i < VerifyThreads(); i++) {
+    if ((rc = XrdSysThread::Run(&tid, Storage::StartFsVerify,
+                                static_cast<void*>(this),
+                                0, "Verify Thread"))) {
+      eos_crit("cannot start verify thread");
+      mZombie = true;
+    }
 
-  if ((rc = XrdSysThread::Run(&tid, Storage::StartFsVerify,
-                              static_cast<void*>(this),
-                              0, "Verify Thread"))) {
-    eos_crit("cannot start verify thread");
-    mZombie = true;
+    mThreadSet.insert(tid);
   }
 
-  mThreadSet.insert(tid);
   eos_info("starting filesystem communication thread");
 
   if ((rc = XrdSysThread::Run(&tid, Storage::StartFsCommunicator,
@@ -305,7 +363,7 @@ Storage::PushVerification(eos::fst::Verify* entry)
   XrdSysMutexHelper scope_lock(mVerifyMutex);
 
   if (mVerifications.size() < 1000000) {
-    mVerifications.push(entry);
+    mVerifications.push_back(entry);
     entry->Show();
   } else {
     eos_err("verify list has already 1 Mio. entries - discarding verify message");
@@ -321,6 +379,7 @@ Storage::Boot(FileSystem* fs)
   }
 
   fs->SetStatus(eos::common::FileSystem::kBooting);
+  gFmdDbMapHandler.ClearSyncProgress(fs->GetId());
   // we have to wait that we know who is our manager
   std::string manager = "";
   size_t cnt = 0;
@@ -408,16 +467,14 @@ Storage::Boot(FileSystem* fs)
     }
   }
 
-  gOFS.OpenFidMutex.Lock();
-  gOFS.ROpenFid.clear_deleted_key();
-  gOFS.ROpenFid[fsid].clear_deleted_key();
-  gOFS.WOpenFid[fsid].clear_deleted_key();
-  gOFS.ROpenFid.set_deleted_key(0);
-  gOFS.ROpenFid[fsid].set_deleted_key(0);
-  gOFS.WOpenFid[fsid].set_deleted_key(0);
-  gOFS.OpenFidMutex.UnLock();
   XrdOucString dbfilename;
   gFmdDbMapHandler.CreateDBFileName(mMetaDir.c_str(), dbfilename);
+#ifndef EOS_SQLITE_DBMAP
+  // LevelDB tuning configured for this filesystem with 'fs config'
+  gFmdDbMapHandler.SetLevelDbOptions(fsid, fs->GetLongLong("dbcachemb"),
+                                     fs->GetLongLong("dbbloombits"),
+                                     fs->GetLongLong("dbwritebuffermb"));
+#endif
 
   // attach to the SQLITE DB
   if (!gFmdDbMapHandler.SetDBFile(dbfilename.c_str(), fsid)) {
@@ -485,6 +542,7 @@ Storage::Boot(FileSystem* fs)
 
   // indicate the flag to unset the DB dirty flag at shutdown
   gFmdDbMapHandler.StayDirty(fsid, false);
+  gFmdDbMapHandler.ClearSyncProgress(fsid);
 
   // allows fast boot the next time
   if (fast_boot) {
@@ -590,6 +648,17 @@ Storage::StartFsTrim(void* pp)
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// Start fmd DB flusher thread
+//------------------------------------------------------------------------------
+void*
+Storage::StartFmdFlusher(void* pp)
+{
+  Storage* storage = (Storage*) pp;
+  storage->FmdFlusher();
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 // Start remover thread
 //------------------------------------------------------------------------------
@@ -601,6 +670,17 @@ Storage::StartFsRemover(void* pp)
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// Start deleter thread
+//------------------------------------------------------------------------------
+void*
+Storage::StartFsDeleter(void* pp)
+{
+  Storage* storage = (Storage*) pp;
+  storage->Deleter();
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 // Start reporter thread
 //------------------------------------------------------------------------------
@@ -824,26 +904,143 @@ void
 Storage::AddDeletion(std::unique_ptr<Deletion> del)
 {
   XrdSysMutexHelper scope_lock(mDeletionsMutex);
+  DeletionStats& stats = mDeletionStats[del->fsId];
+  std::vector<unsigned long long> fids;
+
+  for (auto it = del->fIdVector.begin(); it != del->fIdVector.end(); ++it) {
+    if (stats.mQueued.insert(*it).second) {
+      fids.push_back(*it);
+    }
+  }
+
+  size_t nskipped = del->fIdVector.size() - fids.size();
+
+  if (nskipped) {
+    stats.mSkipped += nskipped;
+    eos_static_info("msg=\"skip deletions already queued\" fsid=%lu "
+                    "nfiles=%lu skipped=%lu total_skipped=%llu", del->fsId,
+                    (unsigned long) del->fIdVector.size(),
+                    (unsigned long) nskipped, stats.mSkipped);
+  }
+
+  if (fids.empty()) {
+    return;
+  }
+
+  del->fIdVector.swap(fids);
   mListDeletions.push_front(std::move(del));
 }
 
 //------------------------------------------------------------------------------
-// Get deletion object removing it from the list
+// Check if the manager is to be queried for deletions
+//------------------------------------------------------------------------------
+bool
+Storage::IsDeletionQueryDue()
+{
+  std::vector<eos::common::FileSystem::fsid_t> fsids;
+  {
+    eos::common::RWMutexReadLock lock(mFsMutex);
+
+    for (auto it = mFsVect.begin(); it != mFsVect.end(); ++it) {
+      fsids.push_back((*it)->GetId());
+    }
+  }
+  XrdSysMutexHelper scope_lock(mDeletionsMutex);
+
+  for (auto it = fsids.begin(); it != fsids.end(); ++it) {
+    if (mDeletionStats[*it].mQueued.empty()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+// Get the oldest deletion of an idle device removing at most a batch of files
 //------------------------------------------------------------------------------
 std::unique_ptr<Deletion>
-Storage::GetDeletion()
+Storage::GetDeletion(std::string& device)
 {
   std::unique_ptr<Deletion> del;
   XrdSysMutexHelper scope_lock(mDeletionsMutex);
+  size_t lookahead = 0;
+
+  // The oldest deletions are at the back of the list
+  for (auto it = mListDeletions.rbegin(); (it != mListDeletions.rend()) &&
+       (lookahead < sDeletionLookAhead); ++it, ++lookahead) {
+    std::string dev = mIoScheduler.GetDevice((*it)->localPrefix.c_str());
+
+    if (mDeletionDevices.count(dev)) {
+      continue;
+    }
 
-  if (mListDeletions.size()) {
-    del.swap(mListDeletions.back());
-    mListDeletions.pop_back();
+    std::vector<unsigned long long>& fids = (*it)->fIdVector;
+
+    if (fids.size() > sDeletionBatchSize) {
+      // Split large deletions, the remaining files stay queued
+      std::vector<unsigned long long> batch(fids.begin(),
+                                            fids.begin() + sDeletionBatchSize);
+      fids.erase(fids.begin(), fids.begin() + sDeletionBatchSize);
+      del.reset(new Deletion(batch, (*it)->fsId, (*it)->localPrefix.c_str(),
+                             (*it)->managerId.c_str(), (*it)->opaque.c_str()));
+    } else {
+      del.swap(*it);
+      mListDeletions.erase(std::next(it).base());
+    }
+
+    mDeletionDevices.insert(dev);
+    device = dev;
+    break;
   }
 
   return del;
 }
 
+//------------------------------------------------------------------------------
+// Mark a deletion batch done and account it in the deletion statistics
+//------------------------------------------------------------------------------
+void
+Storage::DoneDeletion(eos::common::FileSystem::fsid_t fsid,
+                      const std::string& device,
+                      const std::vector<unsigned long long>& fids)
+{
+  XrdSysMutexHelper scope_lock(mDeletionsMutex);
+  mDeletionDevices.erase(device);
+  DeletionStats& stats = mDeletionStats[fsid];
+
+  for (auto it = fids.begin(); it != fids.end(); ++it) {
+    stats.mQueued.erase(*it);
+  }
+
+  stats.mDeleted += fids.size();
+}
+
+//------------------------------------------------------------------------------
+// Get the deletion statistics of a filesystem
+//------------------------------------------------------------------------------
+void
+Storage::GetDeletionStats(eos::common::FileSystem::fsid_t fsid,
+                          unsigned long long& backlog, double& rate)
+{
+  XrdSysMutexHelper scope_lock(mDeletionsMutex);
+  DeletionStats& stats = mDeletionStats[fsid];
+  time_t now = time(NULL);
+
+  if (!stats.mWindowStart) {
+    stats.mWindowStart = now;
+    stats.mWindowDeleted = stats.mDeleted;
+  } else if ((now - stats.mWindowStart) >= sDeletionRateWindow) {
+    stats.mRate = 1.0 * (stats.mDeleted - stats.mWindowDeleted) /
+                  (now - stats.mWindowStart);
+    stats.mWindowStart = now;
+    stats.mWindowDeleted = stats.mDeleted;
+  }
+
+  backlog = stats.mQueued.size();
+  rate = stats.mRate;
+}
+
 //------------------------------------------------------------------------------
 // Get number of pending deletions
 //------------------------------------------------------------------------------
@@ -35,13 +35,16 @@
 #include "fst/Deletion.hh"
 #include "fst/Verify.hh"
 #include "fst/Load.hh"
+#include "fst/IoScheduler.hh"
 #include "fst/Health.hh"
 #include "mq/XrdMqSharedObject.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include <vector>
 #include <list>
 #include <queue>
+#include <deque>
 #include <map>
+#include <set>
 
 EOSFSTNAMESPACE_BEGIN
 
@@ -78,18 +81,52 @@ public:
   void ShutdownThreads();
 
   //----------------------------------------------------------------------------
-  //! Add deletion object to the list of pending ones
+  //! Add deletion object to the list of pending ones. The manager sends all
+  //! the deletions of a filesystem with every query, the files which are
+  //! already queued or being deleted are skipped.
   //!
   //! @param del deletion object
   //----------------------------------------------------------------------------
   void AddDeletion(std::unique_ptr<Deletion> del);
 
   //----------------------------------------------------------------------------
-  //! Get deletion object removing it from the list
+  //! Check if the manager is to be queried for deletions
   //!
-  //! @return get deletion object
+  //! @return true if a filesystem has no backlog and takes new deletions
   //----------------------------------------------------------------------------
-  std::unique_ptr<Deletion> GetDeletion();
+  bool IsDeletionQueryDue();
+
+  //----------------------------------------------------------------------------
+  //! Get the oldest deletion object of a device without running deletions,
+  //! removing at most a batch of files from the list. The device is marked
+  //! busy until DoneDeletion is called.
+  //!
+  //! @param device set to the device holding the files of the deletion
+  //!
+  //! @return get deletion object or null if there is nothing to delete
+  //----------------------------------------------------------------------------
+  std::unique_ptr<Deletion> GetDeletion(std::string& device);
+
+  //----------------------------------------------------------------------------
+  //! Mark a deletion batch done and account it in the deletion statistics
+  //!
+  //! @param fsid filesystem id of the deletion
+  //! @param device device returned by GetDeletion
+  //! @param fids files handled
+  //----------------------------------------------------------------------------
+  void DoneDeletion(eos::common::FileSystem::fsid_t fsid,
+                    const std::string& device,
+                    const std::vector<unsigned long long>& fids);
+
+  //----------------------------------------------------------------------------
+  //! Get the deletion statistics of a filesystem
+  //!
+  //! @param fsid filesystem id
+  //! @param backlog number of files waiting to be deleted
+  //! @param rate files deleted per second over the last window
+  //----------------------------------------------------------------------------
+  void GetDeletionStats(eos::common::FileSystem::fsid_t fsid,
+                        unsigned long long& backlog, double& rate);
 
   //----------------------------------------------------------------------------
   //! Get number of pending deletions
@@ -157,7 +194,6 @@ private:
   XrdSysMutex mBootingMutex; // Mutex protecting the boot set
   //! Set containing the filesystems currently booting
   std::set<eos::common::FileSystem::fsid_t> mBootingSet;
-  eos::fst::Verify* mRunningVerify; ///< Currently running verification job
   XrdSysMutex mThreadsMutex; ///< Mutex protecting access to the set of threads
   std::set<pthread_t> mThreadSet; ///< Set of running helper threads
   XrdSysMutex mFsFullMapMutex; ///< Mutex protecting access to the fs full map
@@ -168,11 +204,32 @@ private:
   std::map<eos::common::FileSystem::fsid_t, bool> mFsFullWarnMap;
   XrdSysMutex mVerifyMutex; ///< Mutex protecting access to the verifications
   //! Queue of verification jobs pending
-  std::queue <eos::fst::Verify*> mVerifications;
+  std::deque <eos::fst::Verify*> mVerifications;
+  //! Devices with a running verification job
+  std::set<std::string> mVerifyDevices;
+  //! Map of file id to time until which no warning is logged about skipping
+  //! its verification because it is open for writing
+  std::map<uint64_t, time_t> mVerifyOpenWarn;
   XrdSysMutex mDeletionsMutex; ///< Mutex protecting the list of deletions
   std::list< std::unique_ptr<Deletion> > mListDeletions; ///< List of deletions
+  //! Devices with a running deletion batch
+  std::set<std::string> mDeletionDevices;
+
+  //! Deletion statistics of a filesystem
+  struct DeletionStats {
+    std::set<unsigned long long> mQueued; ///< Files queued or being deleted
+    unsigned long long mSkipped; ///< Deletions skipped as already queued
+    unsigned long long mDeleted; ///< Files deleted since startup
+    unsigned long long mWindowDeleted; ///< Files deleted at window start
+    time_t mWindowStart; ///< Start of the rate window
+    double mRate; ///< Files deleted per second in the last window
+  };
+
+  //! Map of filesystem id to deletion statistics
+  std::map<eos::common::FileSystem::fsid_t, DeletionStats> mDeletionStats;
   Load mFstLoad; ///< Net/IO load monitor
-  Health mFstHealth; ///< Local disk S.M.A.R.T monitor
+  IoScheduler mIoScheduler; ///< Per device budgets of the background IO
+  Health mFstHealth; ///< Local disk S.M.A.R.T and node information monitor
 
   //! Struct BootThreadInfo
   struct BootThreadInfo {
@@ -188,7 +245,9 @@ private:
   static void* StartFsCommunicator(void* pp);
   static void* StartFsScrub(void* pp);
   static void* StartFsTrim(void* pp);
+  static void* StartFmdFlusher(void* pp);
   static void* StartFsRemover(void* pp);
+  static void* StartFsDeleter(void* pp);
   static void* StartFsReport(void* pp);
   static void* StartFsErrorReport(void* pp);
   static void* StartFsVerify(void* pp);
@@ -206,7 +265,9 @@ private:
   void Communicator();
   void Scrub();
   void Trim();
+  void FmdFlusher();
   void Remover();
+  void Deleter();
   void Report();
   void ErrorReport();
   void Verify();
@@ -217,6 +278,22 @@ private:
   void MgmSyncer();
   void Boot(FileSystem* fs);
 
+  //----------------------------------------------------------------------------
+  //! Verify a file and commit the result locally and to the MGM
+  //!
+  //! @param verifyfile verification job
+  //----------------------------------------------------------------------------
+  void VerifyFile(eos::fst::Verify* verifyfile);
+
+  //----------------------------------------------------------------------------
+  //! Unlink the files of a deletion batch, remove their FMD records in one
+  //! write batch and drop them at the MGM
+  //!
+  //! @param del deletion batch
+  //! @param device device holding the files
+  //----------------------------------------------------------------------------
+  void RunDeletion(Deletion& del, const std::string& device);
+
   //----------------------------------------------------------------------------
   //! Scrub filesystem
   //----------------------------------------------------------------------------
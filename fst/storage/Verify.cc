@@ -36,298 +36,330 @@ extern eos::fst::XrdFstOss* XrdOfsOss;
 
 EOSFSTNAMESPACE_BEGIN
 
-/*----------------------------------------------------------------------------*/
+// Number of queued jobs looked at to find one on a device without a running one
+static const size_t sVerifyLookAhead = 10000;
+
+//------------------------------------------------------------------------------
+// Caller data of the reads done to verify a file
+//------------------------------------------------------------------------------
+struct VerifyReadInfo {
+  FileIo* io;
+  IoScheduler* scheduler;
+  std::string device;
+};
+
+//------------------------------------------------------------------------------
+// Read callback of the verification within the budget of the device
+//------------------------------------------------------------------------------
+static int
+VerifyReadCB(eos::fst::CheckSum::ReadCallBack::callback_data_t* cbd)
+{
+  VerifyReadInfo* info = (VerifyReadInfo*) cbd->caller;
+  info->scheduler->Acquire(info->device, cbd->size);
+  return info->io->fileRead(cbd->offset, cbd->buffer, cbd->size);
+}
+
+//------------------------------------------------------------------------------
+// Verification thread, runs the jobs of devices which have none running so
+// that the threads work on different devices
+//------------------------------------------------------------------------------
 void
 Storage::Verify()
 {
-  std::map<uint64_t, time_t> open_w_out;
-
-  // This thread unlinks stored files
   while (1) {
+    eos::fst::Verify* verifyfile = 0;
+    std::string device;
+    size_t lookahead = 0;
     mVerifyMutex.Lock();
 
-    if (!mVerifications.size()) {
-      mVerifyMutex.UnLock();
-      sleep(1);
-      continue;
-    }
+    for (auto it = mVerifications.begin(); (it != mVerifications.end()) &&
+         (lookahead < sVerifyLookAhead); ++it, ++lookahead) {
+      device = mIoScheduler.GetDevice((*it)->localPrefix.c_str());
 
-    eos::fst::Verify* verifyfile = mVerifications.front();
-
-    if (verifyfile) {
-      eos_static_debug("got %llu\n", (unsigned long long) verifyfile);
-      mVerifications.pop();
-      mRunningVerify = verifyfile;
-      {
-        XrdSysMutexHelper wLock(gOFS.OpenFidMutex);
-
-        if (gOFS.WOpenFid[verifyfile->fsId].count(verifyfile->fId)) {
-          if (gOFS.WOpenFid[verifyfile->fsId][verifyfile->fId] > 0) {
-            time_t now = time(NULL);
-
-            if (open_w_out[verifyfile->fId] < now) {
-              eos_static_warning("file is currently opened for writing id=%x on "
-                                 "fs=%u - skipping verification", verifyfile->fId,
-                                 verifyfile->fsId);
-              // Spit this message out only once pre minute
-              open_w_out[verifyfile->fId] = now + 60;
-            }
-
-            mVerifications.push(verifyfile);
-            mVerifyMutex.UnLock();
-            continue;
-          }
+      if (mVerifyDevices.count(device)) {
+        continue;
+      }
+
+      if (gOFS.mOpenFiles.IsOpen((*it)->fsId, (*it)->fId, true)) {
+        time_t now = time(NULL);
+
+        if (mVerifyOpenWarn[(*it)->fId] < now) {
+          eos_static_warning("file is currently opened for writing id=%x on "
+                             "fs=%u - skipping verification", (*it)->fId,
+                             (*it)->fsId);
+          // Spit this message out only once pre minute
+          mVerifyOpenWarn[(*it)->fId] = now + 60;
         }
+
+        continue;
       }
-    } else {
-      eos_static_debug("got nothing");
-      mVerifyMutex.UnLock();
-      mRunningVerify = 0;
-      continue;
+
+      verifyfile = *it;
+      mVerifications.erase(it);
+      mVerifyDevices.insert(device);
+      mVerifyOpenWarn.erase(verifyfile->fId);
+      break;
     }
 
     mVerifyMutex.UnLock();
-    eos_static_debug("verifying File Id=%x on Fs=%u", verifyfile->fId,
-                     verifyfile->fsId);
-    // verify the file
-    XrdOucString hexfid = "";
-    eos::common::FileId::Fid2Hex(verifyfile->fId, hexfid);
-    XrdOucErrInfo error;
-    XrdOucString fstPath = "";
-    eos::common::FileId::FidPrefix2FullPath(hexfid.c_str(),
-                                            verifyfile->localPrefix.c_str(), fstPath);
-    {
-      FmdHelper* fMd = 0;
-      fMd = gFmdDbMapHandler.GetFmd(verifyfile->fId, verifyfile->fsId, 0, 0, 0, 0,
-                                    true);
-
-      if (fMd) {
-        // force a resync of meta data from the MGM
-        // e.g. store in the WrittenFilesQueue to have it done asynchronous
-        gOFS.WrittenFilesQueueMutex.Lock();
-        gOFS.WrittenFilesQueue.push(fMd->fMd);
-        gOFS.WrittenFilesQueueMutex.UnLock();
-        delete fMd;
-      }
-    }
-    FileIo* io = eos::fst::FileIoPluginHelper::GetIoObject(fstPath.c_str());
-    // get current size on disk
-    struct stat statinfo;
-    int open_rc = -1;
-
-    if (!io || (open_rc = io->fileOpen(0, 0)) || io->fileStat(&statinfo)) {
-      eos_static_err("unable to verify file id=%x on fs=%u path=%s - stat on "
-                     "local disk failed", verifyfile->fId, verifyfile->fsId,
-                     fstPath.c_str());
-      // If there is no file, we should not commit anything to the MGM
-      verifyfile->commitSize = 0;
-      verifyfile->commitChecksum = 0;
-      statinfo.st_size = 0; // indicates the missing file - not perfect though
+
+    if (!verifyfile) {
+      sleep(1);
+      continue;
     }
 
-    // even if the stat failed, we run this code to tag the file as is ...
-    // attach meta data
+    eos_static_debug("got %llu\n", (unsigned long long) verifyfile);
+    VerifyFile(verifyfile);
+    delete verifyfile;
+    XrdSysMutexHelper scope_lock(mVerifyMutex);
+    mVerifyDevices.erase(device);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Verify a file and commit the result locally and to the MGM
+//------------------------------------------------------------------------------
+void
+Storage::VerifyFile(eos::fst::Verify* verifyfile)
+{
+  eos_static_debug("verifying File Id=%x on Fs=%u", verifyfile->fId,
+                   verifyfile->fsId);
+  // verify the file
+  XrdOucString hexfid = "";
+  eos::common::FileId::Fid2Hex(verifyfile->fId, hexfid);
+  XrdOucErrInfo error;
+  XrdOucString fstPath = "";
+  eos::common::FileId::FidPrefix2FullPath(hexfid.c_str(),
+                                          verifyfile->localPrefix.c_str(), fstPath);
+  {
     FmdHelper* fMd = 0;
-    fMd = gFmdDbMapHandler.GetFmd(verifyfile->fId, verifyfile->fsId, 0, 0, 0,
-                                  verifyfile->commitFmd, true);
-    bool localUpdate = false;
+    fMd = gFmdDbMapHandler.GetFmd(verifyfile->fId, verifyfile->fsId, 0, 0, 0, 0,
+                                  true);
+
+    if (fMd) {
+      // force a resync of meta data from the MGM
+      // e.g. store in the WrittenFilesQueue to have it done asynchronous
+      gOFS.WrittenFilesQueueMutex.Lock();
+      gOFS.WrittenFilesQueue.push(fMd->fMd);
+      gOFS.WrittenFilesQueueMutex.UnLock();
+      delete fMd;
+    }
+  }
+  FileIo* io = eos::fst::FileIoPluginHelper::GetIoObject(fstPath.c_str());
+  // get current size on disk
+  struct stat statinfo;
+  int open_rc = -1;
+
+  if (!io || (open_rc = io->fileOpen(0, 0)) || io->fileStat(&statinfo)) {
+    eos_static_err("unable to verify file id=%x on fs=%u path=%s - stat on "
+                   "local disk failed", verifyfile->fId, verifyfile->fsId,
+                   fstPath.c_str());
+    // If there is no file, we should not commit anything to the MGM
+    verifyfile->commitSize = 0;
+    verifyfile->commitChecksum = 0;
+    statinfo.st_size = 0; // indicates the missing file - not perfect though
+  }
 
-    if (!fMd) {
-      eos_static_err("unable to verify id=%x on fs=%u path=%s - no local MD stored",
-                     verifyfile->fId, verifyfile->fsId, fstPath.c_str());
-    } else {
-      if ((fMd->fMd.size() != (unsigned long long) statinfo.st_size)  ||
-          (fMd->fMd.disksize() != (unsigned long long) statinfo.st_size)) {
-        eos_static_err("updating file size: path=%s fid=%s fs value %llu - changelog value %llu",
-                       verifyfile->path.c_str(), hexfid.c_str(), statinfo.st_size, fMd->fMd.size());
-        fMd->fMd.set_disksize(statinfo.st_size);
-        localUpdate = true;
-      }
+  // even if the stat failed, we run this code to tag the file as is ...
+  // attach meta data
+  FmdHelper* fMd = 0;
+  fMd = gFmdDbMapHandler.GetFmd(verifyfile->fId, verifyfile->fsId, 0, 0, 0,
+                                verifyfile->commitFmd, true);
+  bool localUpdate = false;
+
+  if (!fMd) {
+    eos_static_err("unable to verify id=%x on fs=%u path=%s - no local MD stored",
+                   verifyfile->fId, verifyfile->fsId, fstPath.c_str());
+  } else {
+    if ((fMd->fMd.size() != (unsigned long long) statinfo.st_size)  ||
+        (fMd->fMd.disksize() != (unsigned long long) statinfo.st_size)) {
+      eos_static_err("updating file size: path=%s fid=%s fs value %llu - changelog value %llu",
+                     verifyfile->path.c_str(), hexfid.c_str(), statinfo.st_size, fMd->fMd.size());
+      fMd->fMd.set_disksize(statinfo.st_size);
+      localUpdate = true;
+    }
 
-      if (fMd->fMd.lid() != verifyfile->lId) {
-        eos_static_err("updating layout id: path=%s fid=%s central value %u - changelog value %u",
-                       verifyfile->path.c_str(), hexfid.c_str(), verifyfile->lId, fMd->fMd.lid());
-        localUpdate = true;
-      }
+    if (fMd->fMd.lid() != verifyfile->lId) {
+      eos_static_err("updating layout id: path=%s fid=%s central value %u - changelog value %u",
+                     verifyfile->path.c_str(), hexfid.c_str(), verifyfile->lId, fMd->fMd.lid());
+      localUpdate = true;
+    }
+
+    if (fMd->fMd.cid() != verifyfile->cId) {
+      eos_static_err("updating container: path=%s fid=%s central value %llu - changelog value %llu",
+                     verifyfile->path.c_str(), hexfid.c_str(), verifyfile->cId, fMd->fMd.cid());
+      localUpdate = true;
+    }
 
-      if (fMd->fMd.cid() != verifyfile->cId) {
-        eos_static_err("updating container: path=%s fid=%s central value %llu - changelog value %llu",
-                       verifyfile->path.c_str(), hexfid.c_str(), verifyfile->cId, fMd->fMd.cid());
-        localUpdate = true;
+    // update size
+    fMd->fMd.set_size(statinfo.st_size);
+    fMd->fMd.set_lid(verifyfile->lId);
+    fMd->fMd.set_cid(verifyfile->cId);
+    CheckSum* checksummer = ChecksumPlugins::GetChecksumObject(fMd->fMd.lid());
+    unsigned long long scansize = 0;
+    float scantime = 0; // is ms
+    VerifyReadInfo info;
+    info.io = io;
+    info.scheduler = &mIoScheduler;
+    info.device = mIoScheduler.GetDevice(verifyfile->localPrefix.c_str());
+    eos::fst::CheckSum::ReadCallBack::callback_data_t cbd;
+    cbd.caller = (void*) &info;
+    eos::fst::CheckSum::ReadCallBack cb(VerifyReadCB, cbd);
+
+    if ((checksummer) && verifyfile->computeChecksum &&
+        (!checksummer->ScanFile(cb, scansize, scantime, verifyfile->verifyRate))) {
+      eos_static_crit("cannot scan file to recalculate the checksum id=%llu on fs=%u path=%s",
+                      verifyfile->fId, verifyfile->fsId, fstPath.c_str());
+    } else {
+      XrdOucString sizestring;
+
+      if (checksummer && verifyfile->computeChecksum) {
+        eos_static_info("rescanned checksum - size=%s time=%.02fms rate=%.02f "
+                        "MB/s limit=%d MB/s", eos::common::StringConversion::GetReadableSizeString(
+                          sizestring, scansize, "B"),
+                        scantime, 1.0 * scansize / 1000 / (scantime ? scantime : 99999999999999LL),
+                        verifyfile->verifyRate);
       }
 
-      // update size
-      fMd->fMd.set_size(statinfo.st_size);
-      fMd->fMd.set_lid(verifyfile->lId);
-      fMd->fMd.set_cid(verifyfile->cId);
-      CheckSum* checksummer = ChecksumPlugins::GetChecksumObject(fMd->fMd.lid());
-      unsigned long long scansize = 0;
-      float scantime = 0; // is ms
-      eos::fst::CheckSum::ReadCallBack::callback_data_t cbd;
-      cbd.caller = (void*) io;
-      eos::fst::CheckSum::ReadCallBack cb(eos::fst::XrdFstOfsFile::FileIoReadCB, cbd);
-
-      if ((checksummer) && verifyfile->computeChecksum &&
-          (!checksummer->ScanFile(cb, scansize, scantime, verifyfile->verifyRate))) {
-        eos_static_crit("cannot scan file to recalculate the checksum id=%llu on fs=%u path=%s",
-                        verifyfile->fId, verifyfile->fsId, fstPath.c_str());
-      } else {
-        XrdOucString sizestring;
+      if (checksummer && verifyfile->computeChecksum) {
+        int checksumlen = 0;
+        checksummer->GetBinChecksum(checksumlen);
+        bool cxError = false;
+        std::string computedchecksum = checksummer->GetHexChecksum();
 
-        if (checksummer && verifyfile->computeChecksum) {
-          eos_static_info("rescanned checksum - size=%s time=%.02fms rate=%.02f "
-                          "MB/s limit=%d MB/s", eos::common::StringConversion::GetReadableSizeString(
-                            sizestring, scansize, "B"),
-                          scantime, 1.0 * scansize / 1000 / (scantime ? scantime : 99999999999999LL),
-                          verifyfile->verifyRate);
+        if (fMd->fMd.checksum() != computedchecksum) {
+          cxError = true;
         }
 
-        if (checksummer && verifyfile->computeChecksum) {
-          int checksumlen = 0;
-          checksummer->GetBinChecksum(checksumlen);
-          bool cxError = false;
-          std::string computedchecksum = checksummer->GetHexChecksum();
+        // commit the disk checksum in case of differences between the in-memory value
+        if (fMd->fMd.diskchecksum() != computedchecksum) {
+          cxError = true;
+          localUpdate = true;
+        }
+
+        if (cxError) {
+          eos_static_err("checksum invalid   : path=%s fid=%s checksum=%s stored-checksum=%s",
+                         verifyfile->path.c_str(), hexfid.c_str(), checksummer->GetHexChecksum(),
+                         fMd->fMd.checksum().c_str());
+          fMd->fMd.set_checksum(computedchecksum);
+          fMd->fMd.set_diskchecksum(computedchecksum);
+          fMd->fMd.set_disksize(fMd->fMd.size());
+
+          if (verifyfile->commitSize) {
+            fMd->fMd.set_mgmsize(fMd->fMd.size());
+          }
 
-          if (fMd->fMd.checksum() != computedchecksum) {
-            cxError = true;
+          if (verifyfile->commitChecksum) {
+            fMd->fMd.set_mgmchecksum(computedchecksum);
+            fMd->fMd.set_blockcxerror(0);
+            fMd->fMd.set_filecxerror(0);
           }
 
-          // commit the disk checksum in case of differences between the in-memory value
-          if (fMd->fMd.diskchecksum() != computedchecksum) {
-            cxError = true;
+          localUpdate = true;
+        } else {
+          eos_static_info("checksum OK        : path=%s fid=%s checksum=%s",
+                          verifyfile->path.c_str(), hexfid.c_str(),
+                          checksummer->GetHexChecksum());
+
+          // Reset error flags if needed
+          if (fMd->fMd.blockcxerror() || fMd->fMd.filecxerror()) {
+            fMd->fMd.set_blockcxerror(0);
+            fMd->fMd.set_filecxerror(0);
             localUpdate = true;
           }
+        }
 
-          if (cxError) {
-            eos_static_err("checksum invalid   : path=%s fid=%s checksum=%s stored-checksum=%s",
-                           verifyfile->path.c_str(), hexfid.c_str(), checksummer->GetHexChecksum(),
-                           fMd->fMd.checksum().c_str());
-            fMd->fMd.set_checksum(computedchecksum);
-            fMd->fMd.set_diskchecksum(computedchecksum);
-            fMd->fMd.set_disksize(fMd->fMd.size());
+        // Update the extended attributes
+        if (io) {
+          (void)io->attrSet("user.eos.checksum", checksummer->GetBinChecksum(checksumlen),
+                            checksumlen);
+          (void)io->attrSet("user.eos.checksumtype", checksummer->GetName(),
+                            strlen(checksummer->GetName()));
+          (void)io->attrSet("user.eos.filecxerror", "0", 1);
+          (void)io->attrSet("user.eos.blockcxerror", "0");
+        }
+      }
 
-            if (verifyfile->commitSize) {
-              fMd->fMd.set_mgmsize(fMd->fMd.size());
-            }
+      eos::common::Path cPath(verifyfile->path.c_str());
 
-            if (verifyfile->commitChecksum) {
-              fMd->fMd.set_mgmchecksum(computedchecksum);
-              fMd->fMd.set_blockcxerror(0);
-              fMd->fMd.set_filecxerror(0);
-            }
+      // commit local
+      if (localUpdate && (!gFmdDbMapHandler.Commit(fMd))) {
+        eos_static_err("unable to verify file id=%llu on fs=%u path=%s - commit "
+                       "to local MD storage failed", verifyfile->fId,
+                       verifyfile->fsId, fstPath.c_str());
+      } else {
+        if (localUpdate) {
+          eos_static_info("commited verified meta data locally id=%llu on fs=%u path=%s",
+                          verifyfile->fId, verifyfile->fsId, fstPath.c_str());
+        }
 
-            localUpdate = true;
-          } else {
-            eos_static_info("checksum OK        : path=%s fid=%s checksum=%s",
-                            verifyfile->path.c_str(), hexfid.c_str(),
-                            checksummer->GetHexChecksum());
-
-            // Reset error flags if needed
-            if (fMd->fMd.blockcxerror() || fMd->fMd.filecxerror()) {
-              fMd->fMd.set_blockcxerror(0);
-              fMd->fMd.set_filecxerror(0);
-              localUpdate = true;
-            }
-          }
+        // commit to central mgm cache, only if commitSize or commitChecksum is set
+        XrdOucString capOpaqueFile = "";
+        XrdOucString mTimeString = "";
+        capOpaqueFile += "/?";
+        capOpaqueFile += "&mgm.pcmd=commit";
+        capOpaqueFile += "&mgm.verify.checksum=1";
+        capOpaqueFile += "&mgm.size=";
+        char filesize[1024];
+        sprintf(filesize, "%" PRIu64 "", fMd->fMd.size());
+        capOpaqueFile += filesize;
+        capOpaqueFile += "&mgm.fid=";
+        capOpaqueFile += hexfid;
+        capOpaqueFile += "&mgm.path=";
+        capOpaqueFile += verifyfile->path.c_str();
+
+        if (checksummer && verifyfile->computeChecksum) {
+          capOpaqueFile += "&mgm.checksum=";
+          capOpaqueFile += checksummer->GetHexChecksum();
 
-          // Update the extended attributes
-          if (io) {
-            (void)io->attrSet("user.eos.checksum", checksummer->GetBinChecksum(checksumlen),
-                              checksumlen);
-            (void)io->attrSet("user.eos.checksumtype", checksummer->GetName(),
-                              strlen(checksummer->GetName()));
-            (void)io->attrSet("user.eos.filecxerror", "0", 1);
-            (void)io->attrSet("user.eos.blockcxerror", "0");
+          if (verifyfile->commitChecksum) {
+            capOpaqueFile += "&mgm.commit.checksum=1";
           }
         }
 
-        eos::common::Path cPath(verifyfile->path.c_str());
+        if (verifyfile->commitSize) {
+          capOpaqueFile += "&mgm.commit.size=1";
+        }
 
-        // commit local
-        if (localUpdate && (!gFmdDbMapHandler.Commit(fMd))) {
-          eos_static_err("unable to verify file id=%llu on fs=%u path=%s - commit "
-                         "to local MD storage failed", verifyfile->fId,
-                         verifyfile->fsId, fstPath.c_str());
-        } else {
+        capOpaqueFile += "&mgm.mtime=";
+        capOpaqueFile += eos::common::StringConversion::GetSizeString(mTimeString,
+                         (unsigned long long) fMd->fMd.mtime());
+        capOpaqueFile += "&mgm.mtime_ns=";
+        capOpaqueFile += eos::common::StringConversion::GetSizeString(mTimeString,
+                         (unsigned long long) fMd->fMd.mtime_ns());
+        capOpaqueFile += "&mgm.add.fsid=";
+        capOpaqueFile += (int) fMd->fMd.fsid();
+
+        if (verifyfile->commitSize || verifyfile->commitChecksum) {
           if (localUpdate) {
-            eos_static_info("commited verified meta data locally id=%llu on fs=%u path=%s",
+            eos_static_info("commited verified meta data centrally id=%llu on fs=%u path=%s",
                             verifyfile->fId, verifyfile->fsId, fstPath.c_str());
           }
 
-          // commit to central mgm cache, only if commitSize or commitChecksum is set
-          XrdOucString capOpaqueFile = "";
-          XrdOucString mTimeString = "";
-          capOpaqueFile += "/?";
-          capOpaqueFile += "&mgm.pcmd=commit";
-          capOpaqueFile += "&mgm.verify.checksum=1";
-          capOpaqueFile += "&mgm.size=";
-          char filesize[1024];
-          sprintf(filesize, "%" PRIu64 "", fMd->fMd.size());
-          capOpaqueFile += filesize;
-          capOpaqueFile += "&mgm.fid=";
-          capOpaqueFile += hexfid;
-          capOpaqueFile += "&mgm.path=";
-          capOpaqueFile += verifyfile->path.c_str();
-
-          if (checksummer && verifyfile->computeChecksum) {
-            capOpaqueFile += "&mgm.checksum=";
-            capOpaqueFile += checksummer->GetHexChecksum();
-
-            if (verifyfile->commitChecksum) {
-              capOpaqueFile += "&mgm.commit.checksum=1";
-            }
-          }
+          int rc = gOFS.CallManager(&error, verifyfile->path.c_str(), 0, capOpaqueFile);
 
-          if (verifyfile->commitSize) {
-            capOpaqueFile += "&mgm.commit.size=1";
-          }
-
-          capOpaqueFile += "&mgm.mtime=";
-          capOpaqueFile += eos::common::StringConversion::GetSizeString(mTimeString,
-                           (unsigned long long) fMd->fMd.mtime());
-          capOpaqueFile += "&mgm.mtime_ns=";
-          capOpaqueFile += eos::common::StringConversion::GetSizeString(mTimeString,
-                           (unsigned long long) fMd->fMd.mtime_ns());
-          capOpaqueFile += "&mgm.add.fsid=";
-          capOpaqueFile += (int) fMd->fMd.fsid();
-
-          if (verifyfile->commitSize || verifyfile->commitChecksum) {
-            if (localUpdate) {
-              eos_static_info("commited verified meta data centrally id=%llu on fs=%u path=%s",
-                              verifyfile->fId, verifyfile->fsId, fstPath.c_str());
-            }
-
-            int rc = gOFS.CallManager(&error, verifyfile->path.c_str(), 0, capOpaqueFile);
-
-            if (rc) {
-              eos_static_err("unable to verify file id=%s fs=%u at manager %s",
-                             hexfid.c_str(), verifyfile->fsId, verifyfile->managerId.c_str());
-            }
+          if (rc) {
+            eos_static_err("unable to verify file id=%s fs=%u at manager %s",
+                           hexfid.c_str(), verifyfile->fsId, verifyfile->managerId.c_str());
           }
         }
       }
-
-      if (checksummer) {
-        delete checksummer;
-      }
-
-      if (fMd) {
-        delete fMd;
-      }
     }
 
-    if (!open_rc) {
-      io->fileClose();
+    if (checksummer) {
+      delete checksummer;
     }
 
-    mRunningVerify = 0;
-
-    if (verifyfile) {
-      delete verifyfile;
+    if (fMd) {
+      delete fMd;
     }
   }
-}
 
-EOSFSTNAMESPACE_END
+  if (!open_rc) {
+    io->fileClose();
+  }
 
+  delete io;
+}
 
+EOSFSTNAMESPACE_END
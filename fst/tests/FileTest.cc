@@ -30,6 +30,8 @@
 #include "fst/layout/ReedSLayout.hh"
 #include "fst/io/xrd/XrdIo.hh"
 #include "XrdOuc/XrdOucTokenizer.hh"
+#include <cstring>
+#include <memory>
 /*----------------------------------------------------------------------------*/
 
 CPPUNIT_TEST_SUITE_REGISTRATION(FileTest);
@@ -441,3 +443,36 @@ FileTest::ReadAsyncTest()
   CPPUNIT_ASSERT(file->fileClose());
   delete file;
 }
+
+//------------------------------------------------------------------------------
+// Readahead test with a read split between prefetched and direct reads
+//------------------------------------------------------------------------------
+void
+FileTest::ReadaheadSplitTest()
+{
+  std::string address = "root://root@" + mEnv->GetMapping("server");
+  std::string file_path = mEnv->GetMapping("plain_file");
+  std::string file_url = address + "/" + file_path;
+  const uint64_t blocksize = 64 * 1024;
+  std::unique_ptr<eos::fst::XrdIo> ra_file(new eos::fst::XrdIo(file_url));
+  std::unique_ptr<eos::fst::XrdIo> file(new eos::fst::XrdIo(file_url));
+  CPPUNIT_ASSERT(!ra_file->fileOpen(SFS_O_RDONLY, 0,
+                                    "fst.readahead=true&fst.blocksize=" +
+                                    std::to_string(blocksize)));
+  CPPUNIT_ASSERT(!file->fileOpen(SFS_O_RDONLY));
+  struct stat buff;
+  CPPUNIT_ASSERT(!file->fileStat(&buff));
+  // The second read spans far more blocks than the readahead may allocate
+  uint64_t length = 256 * blocksize;
+  CPPUNIT_ASSERT((uint64_t) buff.st_size >= length + 4096);
+  std::unique_ptr<char[]> ra_buffer(new char[length]);
+  std::unique_ptr<char[]> buffer(new char[length]);
+  CPPUNIT_ASSERT(ra_file->fileReadAsync(0, ra_buffer.get(), 4096, true) == 4096);
+  CPPUNIT_ASSERT(ra_file->fileReadAsync(4096, ra_buffer.get(), length, true) ==
+                 (int64_t) length);
+  CPPUNIT_ASSERT(!ra_file->fileWaitAsyncIO());
+  CPPUNIT_ASSERT(file->fileRead(4096, buffer.get(), length) == (int64_t) length);
+  CPPUNIT_ASSERT(memcmp(ra_buffer.get(), buffer.get(), length) == 0);
+  CPPUNIT_ASSERT(!ra_file->fileClose());
+  CPPUNIT_ASSERT(!file->fileClose());
+}
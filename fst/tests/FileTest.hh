@@ -43,6 +43,7 @@ class FileTest: public CppUnit::TestCase
 {
   CPPUNIT_TEST_SUITE(FileTest);
     CPPUNIT_TEST(ReadAsyncTest);
+    CPPUNIT_TEST(ReadaheadSplitTest);
     CPPUNIT_TEST(WriteTest);
     CPPUNIT_TEST(ReadVTest);
     CPPUNIT_TEST(SplitReadVTest);
@@ -67,6 +68,12 @@ protected:
   //----------------------------------------------------------------------------
   void ReadAsyncTest();
 
+  //----------------------------------------------------------------------------
+  //! Readahead test with a read served partly from the prefetched blocks and
+  //! partly by a direct read once the block limit is reached
+  //----------------------------------------------------------------------------
+  void ReadaheadSplitTest();
+
   //----------------------------------------------------------------------------
   //! ReadV test
   //----------------------------------------------------------------------------
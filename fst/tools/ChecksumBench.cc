@@ -0,0 +1,184 @@
+// ----------------------------------------------------------------------
+// File: ChecksumBench.cc
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <vector>
+#include "fst/checksum/ChecksumPlugins.hh"
+#include "fst/checksum/ChecksumSimd.hh"
+
+using namespace eos::fst;
+
+static double
+Now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void
+Report(const char* name, size_t blocksize, size_t bytes, double seconds,
+       unsigned int value)
+{
+  fprintf(stdout, "%-18s blocksize=%-9lu rate=%8.02f MB/s value=%08x\n", name,
+          (unsigned long) blocksize, bytes / seconds / 1000000.0, value);
+}
+
+//------------------------------------------------------------------------------
+// Checksum throughput of the zlib and vectorized kernels, of the
+// multi-buffer variants and of the checksum plugins used by the FST
+//------------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+  size_t size = 256;
+  int nstreams = 4;
+
+  if ((argc > 3) || ((argc > 1) && !strcmp(argv[1], "-h"))) {
+    fprintf(stderr, "usage: %s [<size-mb>=256] [<streams>=4]\n", argv[0]);
+    exit(-1);
+  }
+
+  if (argc > 1) {
+    size = strtoul(argv[1], 0, 10);
+  }
+
+  if (argc > 2) {
+    nstreams = atoi(argv[2]);
+  }
+
+  if (!size || (nstreams < 1)) {
+    fprintf(stderr, "error: size and streams have to be positive\n");
+    exit(-1);
+  }
+
+  size *= 1024 * 1024;
+  std::vector<char> buffer(size);
+
+  for (size_t i = 0; i < size; i++) {
+    buffer[i] = random();
+  }
+
+  fprintf(stdout, "info: adler32 kernel=%s crc32 kernel=%s size=%lu streams=%d\n",
+          adler32KernelName(), crc32KernelName(), (unsigned long) size, nstreams);
+  size_t blocksizes[] = { 4096, 128 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+
+  for (size_t b = 0; b < sizeof(blocksizes) / sizeof(blocksizes[0]); b++) {
+    size_t bs = blocksizes[b];
+    size_t nblocks = size / bs;
+    const char* names[] = { "adler32-zlib", "adler32", "crc32-zlib", "crc32" };
+
+    for (int k = 0; k < 4; k++) {
+      uint32_t value = (k < 2) ? 1 : 0;
+      double start = Now();
+
+      for (size_t i = 0; i < nblocks; i++) {
+        const char* ptr = &buffer[i * bs];
+
+        switch (k) {
+        case 0:
+          value = adler32UpdateScalar(value, ptr, bs);
+          break;
+
+        case 1:
+          value = adler32Update(value, ptr, bs);
+          break;
+
+        case 2:
+          value = crc32UpdateScalar(value, ptr, bs);
+          break;
+
+        default:
+          value = crc32Update(value, ptr, bs);
+        }
+      }
+
+      Report(names[k], bs, nblocks * bs, Now() - start, value);
+    }
+
+    // the buffer is split into nstreams interleaved streams like RAIN stripes
+    size_t ngroups = nblocks / nstreams;
+    std::vector<const char*> buffers(nstreams);
+    std::vector<size_t> lengths(nstreams, bs);
+    std::vector<uint32_t> adlers(nstreams, 1);
+    std::vector<uint32_t> crcs(nstreams, 0);
+
+    for (int k = 0; (k < 2) && ngroups; k++) {
+      double start = Now();
+
+      for (size_t g = 0; g < ngroups; g++) {
+        for (int s = 0; s < nstreams; s++) {
+          buffers[s] = &buffer[(g * nstreams + s) * bs];
+        }
+
+        if (k) {
+          crc32UpdateMulti(&crcs[0], &buffers[0], &lengths[0], nstreams);
+        } else {
+          adler32UpdateMulti(&adlers[0], &buffers[0], &lengths[0], nstreams);
+        }
+      }
+
+      Report(k ? "crc32-multi" : "adler32-multi", bs, ngroups * nstreams * bs,
+             Now() - start, k ? crcs[0] : adlers[0]);
+    }
+
+    // checksum objects as used on the write path
+    unsigned int xsids[] = { eos::common::LayoutId::kAdler,
+                             eos::common::LayoutId::kCRC32,
+                             eos::common::LayoutId::kCRC32C,
+                             eos::common::LayoutId::kMD5,
+                             eos::common::LayoutId::kSHA1
+                           };
+    const char* xsnames[] = { "plugin-adler", "plugin-crc32", "plugin-crc32c",
+                              "plugin-md5", "plugin-sha1"
+                            };
+
+    for (size_t x = 0; x < sizeof(xsids) / sizeof(xsids[0]); x++) {
+      CheckSum* xs = ChecksumPlugins::GetChecksumObject(xsids[x]);
+
+      if (!xs) {
+        continue;
+      }
+
+      double start = Now();
+
+      for (size_t i = 0; i < nblocks; i++) {
+        xs->Add(&buffer[i * bs], bs, i * bs);
+      }
+
+      xs->Finalize();
+      double seconds = Now() - start;
+      int len = 0;
+      const char* bin = xs->GetBinChecksum(len);
+      unsigned int value = 0;
+      memcpy(&value, bin, (len < (int) sizeof(value)) ? len : sizeof(value));
+      Report(xsnames[x], bs, nblocks * bs, seconds, value);
+      delete xs;
+    }
+  }
+
+  exit(0);
+}
@@ -0,0 +1,224 @@
+// ----------------------------------------------------------------------
+// File: ParityBench.cc
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <vector>
+#include "fst/layout/ParityEngine.hh"
+#include "fst/layout/jerasure/include/jerasure.h"
+
+using namespace eos::fst;
+
+static double
+Now()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void
+Report(const char* layout, const char* name, size_t bytes, double seconds,
+       bool match)
+{
+  fprintf(stdout, "%-8s %-20s rate=%8.02f MB/s %s\n", layout, name,
+          bytes / seconds / 1000000.0, match ? "ok" : "MISMATCH");
+}
+
+//------------------------------------------------------------------------------
+// Pairwise XOR of two blocks, as RAID-DP used to compute its parity
+//------------------------------------------------------------------------------
+static void
+PairwiseXor(const char* block1, const char* block2, char* result, size_t len)
+{
+  typedef long v2do __attribute__((vector_size(16)));
+  size_t i = 0;
+
+  for (; i + sizeof(v2do) <= len; i += sizeof(v2do)) {
+    *(v2do*)(result + i) = *(const v2do*)(block1 + i) ^ *(const v2do*)(block2 + i);
+  }
+
+  for (; i < len; i++) {
+    result[i] = block1[i] ^ block2[i];
+  }
+}
+
+//------------------------------------------------------------------------------
+// RAID-DP: pairwise XOR of whole blocks against the cache-blocked plan
+//------------------------------------------------------------------------------
+static bool
+BenchRaidDp(unsigned int k, size_t width, int loops)
+{
+  const RaidDpParityPlan& plan = RaidDpParityPlan::Get(k);
+  unsigned int nblocks = k * (k + 2);
+  std::vector<char> ref_buf(nblocks * width);
+  std::vector<char> new_buf(nblocks * width);
+  std::vector<char*> ref(nblocks);
+  std::vector<char*> blocks(nblocks);
+
+  for (size_t i = 0; i < ref_buf.size(); i++) {
+    ref_buf[i] = new_buf[i] = random();
+  }
+
+  for (unsigned int i = 0; i < nblocks; i++) {
+    ref[i] = &ref_buf[i * width];
+    blocks[i] = &new_buf[i * width];
+  }
+
+  const std::vector<unsigned int>& targets = plan.GetTargets();
+  const std::vector< std::vector<unsigned int> >& sources = plan.GetSources();
+  double start = Now();
+
+  for (int l = 0; l < loops; l++) {
+    for (size_t t = 0; t < targets.size(); t++) {
+      const std::vector<unsigned int>& ids = sources[t];
+      PairwiseXor(ref[ids[0]], ref[ids[1]], ref[targets[t]], width);
+
+      for (size_t s = 2; s < ids.size(); s++) {
+        PairwiseXor(ref[targets[t]], ref[ids[s]], ref[targets[t]], width);
+      }
+    }
+  }
+
+  double old_time = Now() - start;
+  start = Now();
+
+  for (int l = 0; l < loops; l++) {
+    plan.Compute(&blocks[0], width);
+  }
+
+  double new_time = Now() - start;
+  bool match = (ref_buf == new_buf);
+  size_t bytes = (size_t) loops * k * k * width;
+  Report("raiddp", "pairwise", bytes, old_time, match);
+  Report("raiddp", "engine", bytes, new_time, match);
+  return match;
+}
+
+//------------------------------------------------------------------------------
+// Reed-Solomon: jerasure schedule against the fused schedule, then check the
+// recovery of the first and the last block
+//------------------------------------------------------------------------------
+static bool
+BenchReedS(const char* layout, int k, int m, size_t width, int loops)
+{
+  const int w = 8;
+  int packet = width / (w * sizeof(int));
+  const ReedSCodec* codec = ReedSCodec::Get(k, m, w);
+
+  if (!codec) {
+    fprintf(stderr, "error: cannot build codec k=%d m=%d\n", k, m);
+    return false;
+  }
+
+  std::vector<char> data_buf(k * width);
+  std::vector<char> ref_buf(m * width);
+  std::vector<char> new_buf(m * width);
+  std::vector<char*> data(k);
+  std::vector<char*> ref(m);
+  std::vector<char*> coding(m);
+
+  for (size_t i = 0; i < data_buf.size(); i++) {
+    data_buf[i] = random();
+  }
+
+  for (int i = 0; i < k; i++) {
+    data[i] = &data_buf[i * width];
+  }
+
+  for (int i = 0; i < m; i++) {
+    ref[i] = &ref_buf[i * width];
+    coding[i] = &new_buf[i * width];
+  }
+
+  double start = Now();
+
+  for (int l = 0; l < loops; l++) {
+    jerasure_schedule_encode(k, m, w, codec->GetSchedule(), &data[0], &ref[0],
+                             width, packet);
+  }
+
+  double old_time = Now() - start;
+  start = Now();
+
+  for (int l = 0; l < loops; l++) {
+    codec->Encode(&data[0], &coding[0], width, packet);
+  }
+
+  double new_time = Now() - start;
+  bool match = (ref_buf == new_buf);
+  size_t bytes = (size_t) loops * k * width;
+  Report(layout, "jerasure", bytes, old_time, match);
+  Report(layout, "engine", bytes, new_time, match);
+  // Erase a data and a parity block and decode them back
+  std::vector<char> orig_buf = data_buf;
+  int erasures[] = { 0, k + m - 1, -1 };
+  memset(data[0], 0, width);
+  memset(coding[m - 1], 0, width);
+  start = Now();
+  bool decoded = !codec->Decode(erasures, &data[0], &coding[0], width, packet);
+  double dec_time = Now() - start;
+  decoded = decoded && (orig_buf == data_buf) && (ref_buf == new_buf);
+  Report(layout, "engine-decode", k * width, dec_time, decoded);
+  return match && decoded;
+}
+
+//------------------------------------------------------------------------------
+// Parity computation throughput of the RAIN layouts, before and after the
+// parity engine, checking that both produce the same parity
+//------------------------------------------------------------------------------
+int
+main(int argc, char* argv[])
+{
+  size_t width = 1024;
+  int loops = 10;
+
+  if ((argc > 3) || ((argc > 1) && !strcmp(argv[1], "-h"))) {
+    fprintf(stderr, "usage: %s [<stripe-width-kb>=1024] [<loops>=10]\n",
+            argv[0]);
+    exit(-1);
+  }
+
+  if (argc > 1) {
+    width = strtoul(argv[1], 0, 10);
+  }
+
+  if (argc > 2) {
+    loops = atoi(argv[2]);
+  }
+
+  if (!width || (loops < 1)) {
+    fprintf(stderr, "error: stripe width and loops have to be positive\n");
+    exit(-1);
+  }
+
+  width *= 1024;
+  fprintf(stdout, "info: xor kernel=%s stripe width=%lu loops=%d\n",
+          xorKernelName(), (unsigned long) width, loops);
+  bool ok = BenchRaidDp(4, width, loops);
+  ok = BenchReedS("raid6", 4, 2, width, loops) && ok;
+  ok = BenchReedS("archive", 8, 3, width, loops) && ok;
+  exit(ok ? 0 : 1);
+}
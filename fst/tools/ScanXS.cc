@@ -68,7 +68,8 @@ main(int argc, char* argv[])
   fstLoad.Monitor();
   usleep(100000);
   XrdOucString dirName = argv[1];
-  eos::fst::ScanDir* sd = new eos::fst::ScanDir(dirName.c_str(), 0, &fstLoad,
+  eos::fst::IoScheduler scheduler(&fstLoad);
+  eos::fst::ScanDir* sd = new eos::fst::ScanDir(dirName.c_str(), 0, &scheduler,
       false, 10, 100, setxs);
 
   if (sd) {
@@ -0,0 +1,371 @@
+// ----------------------------------------------------------------------
+// File: TransferCopy.cc
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "fst/txqueue/TransferCopy.hh"
+#include "common/Logging.hh"
+#include "common/LayoutId.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include <algorithm>
+#include <sstream>
+#include <cstdio>
+#include <cerrno>
+#include <sys/time.h>
+#include <sys/stat.h>
+
+EOSFSTNAMESPACE_BEGIN
+
+const uint32_t TransferCopy::sBlockSize;
+const uint32_t TransferCopy::sMaxInFlight;
+
+//------------------------------------------------------------------------------
+// Strip the opaque part of an url, it contains the capabilities
+//------------------------------------------------------------------------------
+static std::string
+StripOpaque(const std::string& url)
+{
+  return url.substr(0, url.find('?'));
+}
+
+//------------------------------------------------------------------------------
+// Get the errno of a failed XrdCl status
+//------------------------------------------------------------------------------
+static int
+StatusErrno(const XrdCl::XRootDStatus& status)
+{
+  return status.errNo ? (int) status.errNo : EIO;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+TransferCopy::TransferCopy(const std::string& source,
+                           const std::string& target,
+                           int bandwidth, int timeout, bool reco):
+  mSourceUrl(source), mTargetUrl(target), mBandWidth(bandwidth),
+  mTimeOut(timeout), mReco(reco), mSource(0), mTarget(0), mCanceled(false),
+  mBytesCopied(0), mSize(0), mInFlight(0), mErrno(0)
+{
+  if (mBandWidth < 0) {
+    mBandWidth = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+TransferCopy::~TransferCopy()
+{
+  delete mSource;
+  delete mTarget;
+
+  for (auto it = mFree.begin(); it != mFree.end(); ++it) {
+    delete *it;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Get the progress of the copy in percent
+//------------------------------------------------------------------------------
+float
+TransferCopy::GetProgress() const
+{
+  if (!mSize) {
+    return 0.0;
+  }
+
+  return 100.0 * mBytesCopied / mSize;
+}
+
+//------------------------------------------------------------------------------
+// Completion of the read or the write of a block
+//------------------------------------------------------------------------------
+void
+TransferCopy::Block::HandleResponse(XrdCl::XRootDStatus* status,
+                                    XrdCl::AnyObject* response)
+{
+  int error = 0;
+  std::string msg;
+
+  if (!status->IsOK()) {
+    error = StatusErrno(*status);
+    msg = status->ToStr();
+  } else if (!mWriting) {
+    XrdCl::ChunkInfo* chunk = 0;
+
+    if (response) {
+      response->Get(chunk);
+    }
+
+    if (!chunk || (chunk->length != mLength)) {
+      error = EIO;
+      msg = "short read from source";
+    }
+  }
+
+  delete status;
+  delete response;
+
+  if (!error && !mWriting && mCopy->mTarget) {
+    // the block was read, now push it to the target
+    mWriting = true;
+    XrdCl::XRootDStatus st = mCopy->mTarget->Write(mOffset, mLength,
+                             &mBuffer[0], this);
+
+    if (st.IsOK()) {
+      return;
+    }
+
+    error = StatusErrno(st);
+    msg = st.ToStr();
+  }
+
+  mCopy->BlockDone(this, error, msg);
+}
+
+//------------------------------------------------------------------------------
+// Called by a block when its read (and write) completed or failed
+//------------------------------------------------------------------------------
+void
+TransferCopy::BlockDone(Block* block, int error, const std::string& msg)
+{
+  XrdSysCondVarHelper lock(mCond);
+
+  if (error) {
+    if (!mErrno) {
+      mErrno = error;
+      mErrMsg = msg;
+    }
+  } else {
+    mBytesCopied += block->mLength;
+  }
+
+  mFree.push_back(block);
+  mInFlight--;
+  mCond.Signal();
+}
+
+//------------------------------------------------------------------------------
+// Open source and target
+//------------------------------------------------------------------------------
+int
+TransferCopy::Open()
+{
+  std::string source = mSourceUrl;
+  XrdCl::OpenFlags::Flags flags = XrdCl::OpenFlags::Read;
+  XrdCl::Access::Mode mode = XrdCl::Access::UR | XrdCl::Access::UW |
+                             XrdCl::Access::GR | XrdCl::Access::OR;
+
+  if (mReco) {
+    // same as 'eoscp -c': the reconstructed stripes are stored
+    flags = XrdCl::OpenFlags::Update;
+    source += ((source.find('?') == std::string::npos) ? "?" : "&");
+    source += "fst.store=1";
+  }
+
+  mSource = new XrdCl::File();
+  XrdCl::XRootDStatus status = mSource->Open(source, flags, mode);
+
+  if (!status.IsOK()) {
+    mErrMsg = "source open failed - " + status.ToStr();
+    return StatusErrno(status);
+  }
+
+  XrdCl::StatInfo* info = 0;
+  status = mSource->Stat(false, info);
+
+  if (!status.IsOK() || !info) {
+    mErrMsg = "source stat failed - " + status.ToStr();
+    delete info;
+    return StatusErrno(status);
+  }
+
+  mSize = info->GetSize();
+  delete info;
+
+  if (mTargetUrl != "/dev/null") {
+    mTarget = new XrdCl::File();
+    status = mTarget->Open(mTargetUrl,
+                           eos::common::LayoutId::MapFlagsSfs2XrdCl(SFS_O_CREAT | SFS_O_RDWR),
+                           eos::common::LayoutId::MapModeSfs2XrdCl(S_IRUSR | S_IWUSR | S_IRGRP));
+
+    if (!status.IsOK()) {
+      mErrMsg = "target open failed - " + status.ToStr();
+      return StatusErrno(status);
+    }
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Push all blocks through the pipeline
+//------------------------------------------------------------------------------
+int
+TransferCopy::Pump()
+{
+  struct timeval start, now;
+  gettimeofday(&start, 0);
+  time_t deadline = (mTimeOut > 0) ? (time(NULL) + mTimeOut) : 0;
+  uint64_t nblocks = (mSize + sBlockSize - 1) / sBlockSize;
+  uint64_t offset = 0;
+
+  for (uint64_t i = 0; i < std::min((uint64_t) sMaxInFlight, nblocks); ++i) {
+    mFree.push_back(new Block(this, sBlockSize));
+  }
+
+  XrdSysCondVarHelper lock(mCond);
+
+  while (true) {
+    int wait = 100;
+
+    while (!mErrno && !mCanceled && (offset < mSize) && !mFree.empty()) {
+      if (mBandWidth) {
+        // same throttling as eoscp: never get ahead of bandwidth * elapsed
+        gettimeofday(&now, 0);
+        long long elapsed = (now.tv_sec - start.tv_sec) * 1000 +
+                            (now.tv_usec - start.tv_usec) / 1000;
+        long long expected = offset / mBandWidth / 1000;
+
+        if (elapsed < expected) {
+          wait = std::max(1ll, std::min((long long) wait, expected - elapsed));
+          break;
+        }
+      }
+
+      Block* block = mFree.back();
+      mFree.pop_back();
+      block->mOffset = offset;
+      block->mLength = (uint32_t) std::min((uint64_t) sBlockSize, mSize - offset);
+      block->mWriting = false;
+      offset += block->mLength;
+      mInFlight++;
+      // the handlers need the lock, don't hold it while submitting
+      mCond.UnLock();
+      XrdCl::XRootDStatus st = mSource->Read(block->mOffset, block->mLength,
+                                             &block->mBuffer[0], block);
+      mCond.Lock();
+
+      if (!st.IsOK()) {
+        mFree.push_back(block);
+        mInFlight--;
+
+        if (!mErrno) {
+          mErrno = StatusErrno(st);
+          mErrMsg = st.ToStr();
+        }
+      }
+    }
+
+    if (!mInFlight && (mErrno || mCanceled || (offset >= mSize))) {
+      break;
+    }
+
+    if (deadline && (time(NULL) > deadline) && !mErrno) {
+      // stop submitting, the requests in flight still have to come back
+      mErrno = ETIMEDOUT;
+      mErrMsg = "transfer timed out";
+    }
+
+    mCond.WaitMS(wait);
+  }
+
+  if (!mErrno && mCanceled) {
+    mErrno = ECANCELED;
+    mErrMsg = "transfer canceled";
+  }
+
+  return mErrno;
+}
+
+//------------------------------------------------------------------------------
+// Run the copy
+//------------------------------------------------------------------------------
+int
+TransferCopy::Run(std::string& log)
+{
+  struct timeval start, stop;
+  gettimeofday(&start, 0);
+  int rc = Open();
+
+  if (!rc) {
+    rc = Pump();
+  }
+
+  // a failed target is removed by the FST on close since its size does not
+  // match the size announced in the capability
+  if (mTarget && mTarget->IsOpen()) {
+    XrdCl::XRootDStatus st = mTarget->Close();
+
+    if (!rc && !st.IsOK()) {
+      rc = StatusErrno(st);
+      mErrMsg = "target close failed - " + st.ToStr();
+    }
+  }
+
+  if (mSource && mSource->IsOpen()) {
+    XrdCl::XRootDStatus st = mSource->Close();
+
+    if (!rc && !st.IsOK()) {
+      rc = StatusErrno(st);
+      mErrMsg = "source close failed - " + st.ToStr();
+    }
+  }
+
+  gettimeofday(&stop, 0);
+  float abs_time = ((stop.tv_sec - start.tv_sec) * 1000.0 +
+                    (stop.tv_usec - start.tv_usec) / 1000.0);
+  time_t rawtime = start.tv_sec;
+  char astime[64];
+  struct tm timeinfo;
+  localtime_r(&rawtime, &timeinfo);
+  strftime(astime, sizeof(astime), "%a %b %e %H:%M:%S %Y", &timeinfo);
+  std::ostringstream oss;
+  oss << "[eoscp] #################################################################\n"
+      << "[eoscp] # Date                     : ( " << (unsigned long) rawtime
+      << " ) " << astime << "\n"
+      << "[eoscp] # Source Name [00]         : " << StripOpaque(mSourceUrl) << "\n"
+      << "[eoscp] # Destination Name [00]    : " << StripOpaque(mTargetUrl) << "\n"
+      << "[eoscp] # Data Copied [bytes]      : " << mBytesCopied << "\n"
+      << "[eoscp] # Realtime [s]             : " << abs_time / 1000.0 << "\n";
+
+  if (abs_time > 0) {
+    oss << "[eoscp] # Eff.Copy. Rate[MB/s]     : "
+        << mBytesCopied / abs_time / 1000.0 << "\n";
+  }
+
+  if (mBandWidth) {
+    oss << "[eoscp] # Bandwidth[MB/s]          : " << mBandWidth << "\n";
+  }
+
+  if (rc) {
+    oss << "error: " << mErrMsg << " errno=" << rc << "\n";
+    eos_static_err("msg=\"in-process transfer failed\" src=\"%s\" dst=\"%s\" "
+                   "errno=%d err=\"%s\"", StripOpaque(mSourceUrl).c_str(),
+                   StripOpaque(mTargetUrl).c_str(), rc, mErrMsg.c_str());
+  }
+
+  log = oss.str();
+  return rc;
+}
+
+EOSFSTNAMESPACE_END
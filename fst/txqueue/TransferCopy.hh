@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------
+// File: TransferCopy.hh
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSFST_TRANSFER_COPY__
+#define __EOSFST_TRANSFER_COPY__
+
+#include "fst/Namespace.hh"
+#include "XrdCl/XrdClFile.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+EOSFSTNAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+//! Class TransferCopy - in-process root:// to root:// copy used by the
+//! transfer jobs instead of forking an eoscp process
+//!
+//! The source is read and the target written with asynchronous XrdCl requests,
+//! keeping up to sMaxInFlight blocks in the pipeline: each block is read and
+//! then written from the completion handler of the read, so reading the next
+//! blocks overlaps with writing the previous ones. All the copies of the FST
+//! share the XrdCl post master, i.e. copies towards the same host are
+//! multiplexed over the same physical connections. A target "/dev/null" only
+//! reads the source (RAIN reconstruction).
+//------------------------------------------------------------------------------
+class TransferCopy
+{
+public:
+  static const uint32_t sBlockSize = 4 * 1024 * 1024; ///< size of a block
+  static const uint32_t sMaxInFlight = 4; ///< max blocks in the pipeline
+
+  //----------------------------------------------------------------------------
+  //! Constructor
+  //!
+  //! @param source source url
+  //! @param target target url or "/dev/null"
+  //! @param bandwidth bandwidth limit in MB/s (0 for no limit)
+  //! @param timeout max duration of the copy in seconds
+  //! @param reco open the source for reconstruction (like eoscp -c)
+  //----------------------------------------------------------------------------
+  TransferCopy(const std::string& source, const std::string& target,
+               int bandwidth, int timeout, bool reco);
+
+  //----------------------------------------------------------------------------
+  //! Destructor
+  //----------------------------------------------------------------------------
+  ~TransferCopy();
+
+  //----------------------------------------------------------------------------
+  //! Run the copy, blocks until it is finished
+  //!
+  //! @param log summary of the copy in the eoscp log format
+  //!
+  //! @return 0 if successful, otherwise an errno
+  //----------------------------------------------------------------------------
+  int Run(std::string& log);
+
+  //----------------------------------------------------------------------------
+  //! Ask a running copy to stop, Run then returns ECANCELED
+  //----------------------------------------------------------------------------
+  void
+  Cancel()
+  {
+    mCanceled = true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the progress of the copy in percent
+  //----------------------------------------------------------------------------
+  float GetProgress() const;
+
+  //----------------------------------------------------------------------------
+  //! Get the number of bytes copied so far
+  //----------------------------------------------------------------------------
+  uint64_t
+  GetBytesCopied() const
+  {
+    return mBytesCopied;
+  }
+
+private:
+  //----------------------------------------------------------------------------
+  //! Pipeline block - handles the read and then the write of one block
+  //----------------------------------------------------------------------------
+  class Block : public XrdCl::ResponseHandler
+  {
+  public:
+    Block(TransferCopy* copy, uint32_t size):
+      mCopy(copy), mBuffer(size), mOffset(0), mLength(0), mWriting(false)
+    {
+    }
+
+    virtual ~Block() {}
+
+    void HandleResponse(XrdCl::XRootDStatus* status,
+                        XrdCl::AnyObject* response);
+
+    TransferCopy* mCopy;
+    std::vector<char> mBuffer;
+    uint64_t mOffset;
+    uint32_t mLength;
+    bool mWriting; ///< the block is being written
+  };
+
+  std::string mSourceUrl;
+  std::string mTargetUrl;
+  int mBandWidth; ///< band width in MB/s
+  int mTimeOut; ///< max duration of the copy in seconds
+  bool mReco; ///< source is opened for reconstruction
+  XrdCl::File* mSource;
+  XrdCl::File* mTarget; ///< 0 for a /dev/null target
+  std::atomic<bool> mCanceled;
+  std::atomic<uint64_t> mBytesCopied;
+  uint64_t mSize; ///< size of the source file
+
+  XrdSysCondVar mCond; ///< protects the members below
+  std::vector<Block*> mFree; ///< blocks not used by a request
+  uint32_t mInFlight; ///< number of blocks in the pipeline
+  int mErrno; ///< first error seen by a block
+  std::string mErrMsg;
+
+  //----------------------------------------------------------------------------
+  //! Called by a block when its read (and write) completed or failed
+  //----------------------------------------------------------------------------
+  void BlockDone(Block* block, int error, const std::string& msg);
+
+  //----------------------------------------------------------------------------
+  //! Open source and target, fills mSize
+  //----------------------------------------------------------------------------
+  int Open();
+
+  //----------------------------------------------------------------------------
+  //! Push all blocks through the pipeline, respecting the band width
+  //----------------------------------------------------------------------------
+  int Pump();
+};
+
+EOSFSTNAMESPACE_END
+
+#endif
@@ -26,6 +26,7 @@
 #include "common/StringConversion.hh"
 #include "common/ShellCmd.hh"
 #include "fst/txqueue/TransferJob.hh"
+#include "fst/txqueue/TransferCopy.hh"
 #include "fst/Config.hh"
 #include "fst/XrdFstOfs.hh"
 #include "mgm/txengine/TransferEngine.hh"
@@ -66,6 +67,7 @@ TransferJob::TransferJob(TransferQueue* queue, eos::common::TransferJob* job,
   mLastProgress = 0.0;
   mDoItThread = 0;
   mCanceled = false;
+  mCopy = 0;
   mLastState = 0;
 }
 
@@ -99,33 +101,51 @@ TransferJob::Progress()
   while (1) {
     eos_static_debug("progress loop");
     float progress = 0;
-    // try to read the progress filename
+    int item = 0;
     XrdSysThread::SetCancelOff();
-    FILE* fd = fopen(mProgressFile.c_str(), "r");
-
-    if (fd) {
-      int item = fscanf(fd, "%f\n", &progress);
-      eos_static_debug("progress=%.02f", progress);
-
-      if (item == 1) {
-        if (fabs(mLastProgress - progress) > 1) {
-          // send only if there is a significant change
-          int rc = SendState(0, 0, progress);
-
-          if (rc == -EIDRM) {
-            eos_static_warning("job %lld has been canceled", mId);
-            // cancel this job !
-            mCancelMutex.Lock();
-            mCanceled = true;
-            mCancelMutex.UnLock();
-            return 0;
+    // an in-process copy reports its progress in memory
+    mCancelMutex.Lock();
+
+    if (mCopy) {
+      progress = mCopy->GetProgress();
+      item = 1;
+    }
+
+    mCancelMutex.UnLock();
+
+    if (!item) {
+      // try to read the progress filename
+      FILE* fd = fopen(mProgressFile.c_str(), "r");
+
+      if (fd) {
+        item = fscanf(fd, "%f\n", &progress);
+        fclose(fd);
+      }
+    }
+
+    eos_static_debug("progress=%.02f", progress);
+
+    if (item == 1) {
+      if (fabs(mLastProgress - progress) > 1) {
+        // send only if there is a significant change
+        int rc = SendState(0, 0, progress);
+
+        if (rc == -EIDRM) {
+          eos_static_warning("job %lld has been canceled", mId);
+          // cancel this job !
+          mCancelMutex.Lock();
+          mCanceled = true;
+
+          if (mCopy) {
+            mCopy->Cancel();
           }
 
-          mLastProgress = progress;
+          mCancelMutex.UnLock();
+          return 0;
         }
-      }
 
-      fclose(fd);
+        mLastProgress = progress;
+      }
     }
 
     XrdSysThread::SetCancelOn();
@@ -285,6 +305,99 @@ TransferJob::SendState(int state, const char* logfile, float progress)
   return rc;
 }
 
+/* ------------------------------------------------------------------------- */
+bool
+TransferJob::UseInProcessCopy(const XrdOucString& source,
+                              const XrdOucString& destination,
+                              const std::string& downloadcmd,
+                              const std::string& stagefile,
+                              bool iskrb5, bool isgsi, bool noauth)
+{
+  // external protocols and user credentials still need the eoscp script
+  if (getenv("EOS_FST_TX_EOSCP") || downloadcmd.length() || stagefile.length() ||
+      iskrb5 || isgsi || noauth) {
+    return false;
+  }
+
+  // the script forces sss, an in-process copy uses the sss of the FST
+  const char* secprotocol = getenv("XrdSecPROTOCOL");
+
+  if (!secprotocol || strcmp(secprotocol, "sss")) {
+    return false;
+  }
+
+  return source.beginswith("root://") &&
+         (destination.beginswith("root://") || (destination == "/dev/null"));
+}
+
+/* ------------------------------------------------------------------------- */
+int
+TransferJob::RunInProcessCopy(const XrdOucString& source,
+                              const XrdOucString& destination,
+                              bool isReco, const std::string& outputfile)
+{
+  TransferCopy* copy = new TransferCopy(source.c_str(), destination.c_str(),
+                                        mBandWidth, mTimeOut, isReco);
+  mCancelMutex.Lock();
+  mCopy = copy;
+
+  if (mCanceled) {
+    copy->Cancel();
+  }
+
+  mCancelMutex.UnLock();
+  std::string log;
+  int rc = copy->Run(log);
+  mCancelMutex.Lock();
+  mCopy = 0;
+  mCancelMutex.UnLock();
+  delete copy;
+  // the output file is used like the one of eoscp for the logs
+  std::ofstream out(outputfile.c_str());
+  out << log;
+  out.close();
+  return rc;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Append the output file of a transfer to the eoscp log file, the caller
+ * holds eoscpLogMutex
+ *
+ * @param output output file of the transfer
+ * @param banner line written before the output or 0
+ * @param skip lines containing this string are left out or 0
+ *
+ * @return true if the log file was written
+ */
+/* ------------------------------------------------------------------------- */
+static bool
+AppendToTransferLog(const std::string& output, const char* banner,
+                    const char* skip)
+{
+  std::ofstream log(gOFS.eoscpTransferLog.c_str(), std::ios::app);
+
+  if (!log) {
+    return false;
+  }
+
+  if (banner) {
+    log << banner << '\n';
+  }
+
+  std::ifstream in(output.c_str());
+  std::string line;
+
+  while (std::getline(in, line)) {
+    if (!skip || (line.find(skip) == std::string::npos)) {
+      log << line << '\n';
+    }
+  }
+
+  log.close();
+  return !log.fail();
+}
+
 /* ------------------------------------------------------------------------- */
 void
 TransferJob::DoIt()
@@ -323,7 +436,6 @@ TransferJob::DoIt()
   bool iskrb5 = false;
   bool isgsi = false;
   bool noauth = false;
-  std::string cattolog;
   std::ofstream file;
   int rc = 0;
 
@@ -596,6 +708,20 @@ TransferJob::DoIt()
     }
   }
 
+  if (UseInProcessCopy(mSource, mDestination, downloadcmd, stagefile,
+                       iskrb5, isgsi, noauth)) {
+    // no fork, the copy shares the XrdCl connections of the FST
+    if (mId) {
+      SendState(eos::mgm::TransferEngine::kRunning);
+      XrdSysThread::Run(&mProgressThread, TransferJob::StaticProgress,
+                        static_cast<void*>(this), XRDSYSTHREAD_HOLD,
+                        "Progress Report Thread");
+    }
+
+    rc = RunInProcessCopy(mSource, mDestination, isReco, fileOutput);
+    goto report;
+  }
+
   // --------------------------------------------------------------------
   // create a transfer/stagein script
   // --------------------------------------------------------------------
@@ -864,6 +990,8 @@ TransferJob::DoIt()
     rc = rcst.exit_code;
   }
 
+report:
+
   // Now set the transfer state and send the log output
   if (rc) {
     eos_static_err("transfer cmd=\"%s\" returned %d", command.str().c_str(), rc);
@@ -963,42 +1091,17 @@ TransferJob::DoIt()
   COMMONTIMING("STOP", &tm);
   eos_static_debug("lock-time=%.02f", tm.RealTime());
   // move the output to the log file
-  cattolog = "touch ";
-  cattolog += gOFS.eoscpTransferLog.c_str();
-  cattolog += "; cat ";
-  cattolog += fileOutput.c_str();
-  cattolog += " >> ";
-  cattolog += gOFS.eoscpTransferLog.c_str();
-  cattolog + " 2>/dev/nulll";
-  {
-    eos::common::ShellCmd scmd(cattolog.c_str());
-    eos::common::cmd_status rcst = scmd.wait(60);
-    rc = rcst.exit_code;
-  }
-
-  if (rc) {
+  if (!AppendToTransferLog(fileOutput, 0, 0)) {
     fprintf(stderr, "error: failed to append to eoscp log file (%s)\n",
-            cattolog.c_str());
+            gOFS.eoscpTransferLog.c_str());
   }
 
   if (stagefile.length()) {
-    // move the output to the log file
-    std::string cattolog = "touch ";
-    cattolog += gOFS.eoscpTransferLog.c_str();
-    cattolog += ";  echo ______________________ STAGEOUT _____________________ >> ";
-    cattolog += gOFS.eoscpTransferLog.c_str();
-    cattolog += " 2>/dev/nulll; cat ";
-    cattolog += fileStageOutput.c_str();
-    cattolog += " | grep -v \"bytes remaining\" >> ";
-    cattolog += gOFS.eoscpTransferLog.c_str();
-    cattolog += " 2>/dev/null;";
-    eos::common::ShellCmd scmd(cattolog.c_str());
-    eos::common::cmd_status rcst = scmd.wait(60);
-    rc = rcst.exit_code;
-
-    if (rc) {
+    if (!AppendToTransferLog(fileStageOutput,
+                             "______________________ STAGEOUT _____________________",
+                             "bytes remaining")) {
       fprintf(stderr, "error: failed to append to eoscp log file (%s)\n",
-              cattolog.c_str());
+              gOFS.eoscpTransferLog.c_str());
     }
   }
 
@@ -38,6 +38,8 @@
 
 EOSFSTNAMESPACE_BEGIN
 
+class TransferCopy;
+
 class TransferJob : public XrdJob
 {
 private:
@@ -57,7 +59,14 @@ private:
   pthread_t mDoItThread; // the id of the thread running the DoIt function
   XrdSysMutex mCancelMutex; // protects the canceled variable
   bool mCanceled; // this indicates that the thread should
-  
+  TransferCopy* mCopy; // in-process copy currently running (protected by mCancelMutex)
+
+  bool UseInProcessCopy (const XrdOucString& source, const XrdOucString& destination,
+                         const std::string& downloadcmd, const std::string& stagefile,
+                         bool iskrb5, bool isgsi, bool noauth);
+  int RunInProcessCopy (const XrdOucString& source, const XrdOucString& destination,
+                        bool isReco, const std::string& outputfile);
+
 public:
 
   TransferJob (TransferQueue* queue, eos::common::TransferJob* cjob, int bw, int timeout = 7200);
@@ -23,6 +23,7 @@
 
 #include "CacheEntry.hh"
 #include "LayoutWrapper.hh"
+#include "common/BufferPool.hh"
 
 size_t CacheEntry::msMaxSize = 256 * 1024; //256 KB
 
@@ -48,7 +49,7 @@ CacheEntry::CacheEntry(FileAbstraction*& fabst,
 
   mOffsetStart = (off / msMaxSize) * msMaxSize;
   off_relative = off % msMaxSize;
-  mBuffer = new char[mCapacity];
+  mBuffer = eos::common::BufferPool::GetInstance().Allocate(mCapacity);
   ptr_buf = mBuffer + off_relative;
   ptr_buf = static_cast<char*>(memcpy(ptr_buf, buf, len));
   mMapPieces.insert(std::make_pair(off, len));
@@ -61,7 +62,7 @@ CacheEntry::CacheEntry(FileAbstraction*& fabst,
 CacheEntry::~CacheEntry()
 {
   mParentFile = NULL;
-  delete[] mBuffer;
+  eos::common::BufferPool::GetInstance().Release(mBuffer, mCapacity);
 }
 
 
@@ -203,18 +203,10 @@ bool GeoTreeEngine::insertFsIntoGroup(FileSystem* fs ,
 #ifdef EOS_GEOTREEENGINE_USE_INSTRUMENTED_MUTEX
 #ifdef EOS_INSTRUMENTED_RWMUTEX
       char buffer[64], buffer2[64];
-      sprintf(buffer, "GTE %s doublebuffer", group->mName.c_str());
-      sprintf(buffer2, "%s doublebuffer", group->mName.c_str());
-      mapEntry->doubleBufferMutex.SetDebugName(buffer2);
-      int retcode = eos::common::RWMutex::AddOrderRule(buffer,
-                    std::vector<eos::common::RWMutex*>(
-      { &pAddRmFsMutex, &pTreeMapMutex, &mapEntry->doubleBufferMutex}));
-      eos_info("creating RWMutex rule order %p, retcode is %d",
-               &mapEntry->doubleBufferMutex, retcode);
       sprintf(buffer, "GTE %s slowtree", group->mName.c_str());
       sprintf(buffer2, "%s slowtree", group->mName.c_str());
       mapEntry->slowTreeMutex.SetDebugName(buffer2);
-      retcode = eos::common::RWMutex::AddOrderRule(buffer,
+      int retcode = eos::common::RWMutex::AddOrderRule(buffer,
                 std::vector<eos::common::RWMutex*>(
       { &pAddRmFsMutex, &pTreeMapMutex, &mapEntry->slowTreeMutex}));
       eos_info("creating RWMutex rule order %p, retcode is %d",
@@ -734,57 +726,54 @@ void GeoTreeEngine::printInfo(std::string& info, bool dispTree, bool dispSnaps,
 
     if (dispSnaps && (schedgroup.empty() || schedgroup == "*" ||
                       (schedgroup == it->second->group->mName))) {
+      FastStructSched* fgStruct = it->second->pinForeground();
+
       if (optype.empty() || (optype == "plct")) {
         ostr << "### scheduling snapshot for scheduling group " <<
              it->second->group->mName << " and operation \'Placement\' :" << std::endl;
-        it->second->foregroundFastStruct->placementTree->recursiveDisplay(ostr,
-            useColors) << endl;
+        fgStruct->placementTree->recursiveDisplay(ostr, useColors) << endl;
       }
 
       if (optype.empty() || (optype == "accsro")) {
         ostr << "### scheduling snapshot for scheduling group " <<
              it->second->group->mName << " and operation \'Access RO\' :" << std::endl;
-        it->second->foregroundFastStruct->rOAccessTree->recursiveDisplay(ostr,
-            useColors) << endl;
+        fgStruct->rOAccessTree->recursiveDisplay(ostr, useColors) << endl;
       }
 
       if (optype.empty() || (optype == "accsrw")) {
         ostr << "### scheduling snapshot for scheduling group " <<
              it->second->group->mName << " and operation \'Access RW\' :" << std::endl;
-        it->second->foregroundFastStruct->rWAccessTree->recursiveDisplay(ostr,
-            useColors) << endl;
+        fgStruct->rWAccessTree->recursiveDisplay(ostr, useColors) << endl;
       }
 
       if (optype.empty() || (optype == "accsdrain")) {
         ostr << "### scheduling snapshot for scheduling group " <<
              it->second->group->mName << " and operation \'Draining Access\' :" << std::endl;
-        it->second->foregroundFastStruct->drnAccessTree->recursiveDisplay(ostr,
-            useColors) << endl;
+        fgStruct->drnAccessTree->recursiveDisplay(ostr, useColors) << endl;
       }
 
       if (optype.empty() || (optype == "plctdrain")) {
         ostr << "### scheduling snapshot for scheduling group " <<
              it->second->group->mName << " and operation \'Draining Placement\' :" <<
              std::endl;
-        it->second->foregroundFastStruct->drnPlacementTree->recursiveDisplay(ostr,
-            useColors) << endl;
+        fgStruct->drnPlacementTree->recursiveDisplay(ostr, useColors) << endl;
       }
 
       if (optype.empty() || (optype == "accsblc")) {
         ostr << "### scheduling snapshot for scheduling group " <<
              it->second->group->mName << " and operation \'Balancing Access\' :" <<
              std::endl;
-        it->second->foregroundFastStruct->blcAccessTree->recursiveDisplay(ostr,
-            useColors) << endl;
+        fgStruct->blcAccessTree->recursiveDisplay(ostr, useColors) << endl;
       }
 
       if (optype.empty() || (optype == "plctblc")) {
         ostr << "### scheduling snapshot for scheduling group " <<
              it->second->group->mName << " and operation \'Draining Placement\' :" <<
              std::endl;
-        it->second->foregroundFastStruct->blcPlacementTree->recursiveDisplay(ostr,
-            useColors) << endl;
+        fgStruct->blcPlacementTree->recursiveDisplay(ostr, useColors) << endl;
       }
+
+      it->second->unpinForeground(fgStruct);
     }
 
     orderByGroupName[it->second->group->mName] = ostr.str();
@@ -804,10 +793,11 @@ void GeoTreeEngine::printInfo(std::string& info, bool dispTree, bool dispSnaps,
 
     if (dispSnaps && (schedgroup.empty() || schedgroup == "*" ||
                       (schedgroup == it->first))) {
+      FastStructProxy* fgStruct = it->second->pinForeground();
       ostr << "### scheduling snapshot for proxy group " << it->first << " :" <<
            std::endl;
-      it->second->foregroundFastStruct->proxyAccessTree->recursiveDisplay(ostr,
-          useColors) << endl;
+      fgStruct->proxyAccessTree->recursiveDisplay(ostr, useColors) << endl;
+      it->second->unpinForeground(fgStruct);
     }
 
     orderByGroupName[it->first] = ostr.str();
@@ -861,7 +851,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
 {
   assert(nNewReplicas);
   assert(newReplicas);
-  std::vector<SchedTME*> entries;
+  std::vector<FastStructSched*> entries;
   // find the entry in the map
   tlCurrentGroup = group;
   SchedTME* entry;
@@ -876,8 +866,8 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
     entry = pGroup2SchedTME[group];
     AtomicInc(entry->fastStructLockWaitersCount);
   }
-  // readlock the original fast structure
-  entry->doubleBufferMutex.LockRead();
+  // pin the current foreground fast structure
+  FastStructSched* fgStruct = entry->pinForeground();
   // locate the existing replicas and the excluded fs in the tree
   vector<SchedTreeBase::tFastTreeIdx> newReplicasIdx(nNewReplicas),
          *existingReplicasIdx = NULL, *excludeFsIdx = NULL, *forceBrIdx = NULL;
@@ -894,7 +884,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
       const SchedTreeBase::tFastTreeIdx* idx =
         static_cast<const SchedTreeBase::tFastTreeIdx*>(0);
 
-      if (!entry->foregroundFastStruct->fs2TreeIdx->get(*it, idx) &&
+      if (!fgStruct->fs2TreeIdx->get(*it, idx) &&
           !(*fsidsgeotags)[count].empty()) {
         // the fs is not in that group.
         // this could happen because the former file scheduler
@@ -902,11 +892,11 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
         // with the new geoscheduler, it should not happen
         // in that case, we try to match a filesystem having the same geotag
         SchedTreeBase::tFastTreeIdx idx =
-          entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode((
+          fgStruct->tag2NodeIdx->getClosestFastTreeNode((
                 *fsidsgeotags)[count].c_str());
 
         if (idx &&
-            (*entry->foregroundFastStruct->treeInfo)[idx].nodeType ==
+            (*fgStruct->treeInfo)[idx].nodeType ==
             SchedTreeBase::TreeNodeInfo::fs) {
           if ((std::find(existingReplicasIdx->begin(), existingReplicasIdx->end(),
                          idx) == existingReplicasIdx->end())) {
@@ -935,7 +925,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
     for (auto it = excludeFs->begin(); it != excludeFs->end(); ++it) {
       const SchedTreeBase::tFastTreeIdx* idx;
 
-      if (!entry->foregroundFastStruct->fs2TreeIdx->get(*it, idx)) {
+      if (!fgStruct->fs2TreeIdx->get(*it, idx)) {
         // the excluded fs might belong to another group
         // so it's not an error condition
         // eos_warning("could not place excluded fs on the fast tree");
@@ -954,7 +944,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
 
     for (auto it = excludeGeoTags->begin(); it != excludeGeoTags->end(); ++it) {
       SchedTreeBase::tFastTreeIdx idx;
-      idx = entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+      idx = fgStruct->tag2NodeIdx->getClosestFastTreeNode(
               it->c_str());
       excludeFsIdx->push_back(idx);
     }
@@ -965,7 +955,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
 
     for (auto it = forceGeoTags->begin(); it != forceGeoTags->end(); ++it) {
       SchedTreeBase::tFastTreeIdx idx;
-      idx = entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+      idx = fgStruct->tag2NodeIdx->getClosestFastTreeNode(
               it->c_str());
       forceBrIdx->push_back(idx);
     }
@@ -975,7 +965,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
 
   if (!startFromGeoTag.empty()) {
     startFromNode =
-      entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+      fgStruct->tag2NodeIdx->getClosestFastTreeNode(
         startFromGeoTag.c_str());
   }
 
@@ -986,7 +976,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
   case regularRO:
   case regularRW:
     success = placeNewReplicas(entry, nNewReplicas, &newReplicasIdx,
-                               entry->foregroundFastStruct->placementTree,
+                               fgStruct->placementTree,
                                existingReplicasIdx, bookingSize, startFromNode,
                                nCollocatedReplicas, excludeFsIdx, forceBrIdx,
                                pSkipSaturatedPlct);
@@ -994,7 +984,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
 
   case draining:
     success = placeNewReplicas(entry, nNewReplicas, &newReplicasIdx,
-                               entry->foregroundFastStruct->drnPlacementTree,
+                               fgStruct->drnPlacementTree,
                                existingReplicasIdx, bookingSize, startFromNode,
                                nCollocatedReplicas, excludeFsIdx, forceBrIdx,
                                pSkipSaturatedDrnPlct);
@@ -1002,7 +992,7 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
 
   case balancing:
     success = placeNewReplicas(entry, nNewReplicas, &newReplicasIdx,
-                               entry->foregroundFastStruct->blcPlacementTree,
+                               fgStruct->blcPlacementTree,
                                existingReplicasIdx, bookingSize, startFromNode,
                                nCollocatedReplicas, excludeFsIdx, forceBrIdx,
                                pSkipSaturatedBlcPlct);
@@ -1022,9 +1012,9 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
 
   for (auto it = newReplicasIdx.begin(); it != newReplicasIdx.end(); ++it) {
     const SchedTreeBase::tFastTreeIdx* idx = NULL;
-    const unsigned int fsid = (*entry->foregroundFastStruct->treeInfo)[*it].fsId;
+    const unsigned int fsid = (*fgStruct->treeInfo)[*it].fsId;
 
-    if (!entry->foregroundFastStruct->fs2TreeIdx->get(fsid, idx)) {
+    if (!fgStruct->fs2TreeIdx->get(fsid, idx)) {
       eos_crit("inconsistency : cannot retrieve index of selected fs though "
                "it should be in the tree");
       success = false;
@@ -1032,25 +1022,25 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
     }
 
     const char netSpeedClass =
-      (*entry->foregroundFastStruct->treeInfo)[*idx].netSpeedClass;
+      (*fgStruct->treeInfo)[*idx].netSpeedClass;
     newReplicas->push_back(fsid);
 
     // Apply the penalties
-    if (entry->foregroundFastStruct->placementTree->pNodes[*idx].fsData.dlScore >
+    if (fgStruct->placementTree->pNodes[*idx].fsData.dlScore >
         0) {
-      applyDlScorePenalty(entry, *idx,
-                          pPenaltySched.pPlctDlScorePenalty[netSpeedClass]);
+      fgStruct->applyDlScorePenalty(*idx,
+                                    pPenaltySched.pPlctDlScorePenalty[netSpeedClass]);
     }
 
-    if (entry->foregroundFastStruct->placementTree->pNodes[*idx].fsData.ulScore >
+    if (fgStruct->placementTree->pNodes[*idx].fsData.ulScore >
         0) {
-      applyUlScorePenalty(entry, *idx,
-                          pPenaltySched.pPlctUlScorePenalty[netSpeedClass]);
+      fgStruct->applyUlScorePenalty(*idx,
+                                    pPenaltySched.pPlctUlScorePenalty[netSpeedClass]);
     }
   }
 
   if (dataProxys || firewallEntryPoint) {
-    entries.assign(newReplicasIdx.size(), entry);
+    entries.assign(newReplicasIdx.size(), fgStruct);
   }
 
   // find proxy for filesticky scheduling
@@ -1071,10 +1061,10 @@ GeoTreeEngine::placeNewReplicasOneGroup(FsGroup* group,
       for (size_t i = 0; i < newReplicasIdx.size(); i++) {
         if (clientGeoTag.empty() ||
             accessReqFwEP((
-                            *entries[i]->foregroundFastStruct->treeInfo)[newReplicasIdx[i]].fullGeotag ,
+                            *entries[i]->treeInfo)[newReplicasIdx[i]].fullGeotag ,
                           clientGeoTag)) {
           firewallProxyGroups[i] = accessGetProxygroup((
-                                     *entries[i]->foregroundFastStruct->treeInfo)[newReplicasIdx[i]].fullGeotag);
+                                     *entries[i]->treeInfo)[newReplicasIdx[i]].fullGeotag);
         }
       }
 
@@ -1113,7 +1103,7 @@ cleanup:
     newReplicas->clear();
   }
 
-  entry->doubleBufferMutex.UnLockRead();
+  entry->unpinForeground(fgStruct);
   AtomicDec(entry->fastStructLockWaitersCount);
 
   if (existingReplicasIdx) {
@@ -1148,7 +1138,7 @@ struct TreeInfoFsIdComparator {
 
 bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
                               fsIdxs,
-                              std::vector<SchedTME*> entries,
+                              const std::vector<FastStructSched*>& entries,
                               ino64_t inode,
                               std::vector<std::string>* dataProxys,
                               std::vector<std::string>* proxyGroups,
@@ -1159,13 +1149,14 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
   dataProxys->resize(fsIdxs.size());
   const std::string* fsproxygroup = 0;
   DataProxyTME* pxyentry = NULL;
+  FastStructProxy* pxyStruct = NULL;
   FastGatewayAccessTree* tree = NULL;
   std::string sgeotag;
 
   for (size_t i = 0; i < fsIdxs.size(); i++) {
     const std::string* geotag = NULL;
     // get the proxygroup
-    // WARNING: entries[i]->doubleBufferMutex should be locked by the caller of findProxy
+    // WARNING: entries[i] should be pinned by the caller of findProxy
 
     if (!(*dataProxys)[i].empty() && (*dataProxys)[i] != "<none>") {
       if (pPxyHost2DpTMEs.count((*dataProxys)[i])) {
@@ -1189,11 +1180,12 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
 
         {
           auto entry = (*TMEs.begin());
+          FastStructProxy* ft = NULL;
 
-          // we don't want to lock the pxyentry which is already locked
+          // we don't want to pin the pxyentry which is already pinned
           if (entry != pxyentry) {
             AtomicInc(entry->fastStructLockWaitersCount);
-            entry->doubleBufferMutex.LockRead();
+            ft = entry->pinForeground();
           }
 
           // if they don't, take their geotag as a staring point
@@ -1202,7 +1194,7 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
           geotag = &sgeotag;
 
           if (entry != pxyentry) {
-            entry->doubleBufferMutex.UnLockRead();
+            entry->unpinForeground(ft);
             AtomicDec(entry->fastStructLockWaitersCount);
           }
         }
@@ -1213,7 +1205,7 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
       fsproxygroup = &((*proxyGroups)[i]);
     } else {
       fsproxygroup = &
-                     (*entries[i]->foregroundFastStruct->treeInfo)[fsIdxs[i]].proxygroup;
+                     (*entries[i]->treeInfo)[fsIdxs[i]].proxygroup;
     }
 
     if (fsproxygroup->empty() ||
@@ -1229,7 +1221,7 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
 
     if (!geotag) {
       geotag = (clientgeotag.empty() ? &
-                ((*(entries[i]->foregroundFastStruct->treeInfo))[fsIdxs[i]].fullGeotag) :
+                ((*(entries[i]->treeInfo))[fsIdxs[i]].fullGeotag) :
                 &clientgeotag);
     }
 
@@ -1247,15 +1239,15 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
 
     pxyentry = pPxyGrp2DpTME[*fsproxygroup];
     AtomicInc(pxyentry->fastStructLockWaitersCount);
-    // readlock the original fast structure
-    pxyentry->doubleBufferMutex.LockRead();
+    // pin the current foreground fast structure
+    pxyStruct = pxyentry->pinForeground();
 
     // copy the fasttree
-    if (pxyentry->foregroundFastStruct->proxyAccessTree->copyToBuffer((
+    if (pxyStruct->proxyAccessTree->copyToBuffer((
           char*)tlGeoBuffer, gGeoBufferSize)) {
       eos_crit("could not make a working copy of the fast tree for proxygroup %s",
                fsproxygroup->c_str());
-      pxyentry->doubleBufferMutex.UnLockRead();
+      pxyentry->unpinForeground(pxyStruct);
       AtomicDec(pxyentry->fastStructLockWaitersCount);
       return false;
     }
@@ -1263,7 +1255,7 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
     tree = (FastGatewayAccessTree*)tlGeoBuffer;
     // get the closest node from the filesystem
     SchedTreeBase::tFastTreeIdx idx;
-    idx = pxyentry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+    idx = pxyStruct->tag2NodeIdx->getClosestFastTreeNode(
             trimlastlevel ? std::string(*geotag, 0,
                                         geotag->rfind("::")).c_str() : geotag->c_str());
     bool schedsuccess = false;
@@ -1273,7 +1265,7 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
       // scheduling should consistently go through the same (firewallentrypoint,proxy)
       // this is to do the caching of the file only on one proxy
       // serving a same file from two proxies is not optimal but it is not mendatory neither
-      if ((*entries[i]->foregroundFastStruct->treeInfo)[fsIdxs[i]].fileStickyProxyDepth
+      if ((*entries[i]->treeInfo)[fsIdxs[i]].fileStickyProxyDepth
           < 0) {
         schedsuccess = true;
       }
@@ -1281,9 +1273,9 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
       else {
         // then consider all the possible proxy in the same proxygroup
         // within the subtree starting at the best proxy and going uproot by
-        // (*pxyentry->foregroundFastStruct->treeInfo)[idx].fileStickyProxyDepth
+        // (*pxyStruct->treeInfo)[idx].fileStickyProxyDepth
         // allocate a vectors to get the proxies
-        auto s = pxyentry->foregroundFastStruct->treeInfo->size();
+        auto s = pxyStruct->treeInfo->size();
         std::vector<SchedTreeBase::tFastTreeIdx> proxiesIdxs(s), upRootLevels(s),
             upRootLevelsIdxs(s);
         SchedTreeBase::tFastTreeIdx upRootLevelsCount = 0;
@@ -1301,8 +1293,8 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
               ss << " all proxys are:";
 
               for (auto it = proxiesIdxs.begin(); it != proxiesIdxs.end(); it++) {
-                ss << (*pxyentry->foregroundFastStruct->treeInfo)[*it].hostport;
-                ss << "(" << (*pxyentry->foregroundFastStruct->treeInfo)[*it].fullGeotag << ")";
+                ss << (*pxyStruct->treeInfo)[*it].hostport;
+                ss << "(" << (*pxyStruct->treeInfo)[*it].fullGeotag << ")";
 
                 if (it != proxiesIdxs.end() - 1) {
                   ss << ",";
@@ -1339,7 +1331,7 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
             while (
               uprlev < upRootLevelsCount &&
               upRootLevels[uprlev] <=
-              (*entries[i]->foregroundFastStruct->treeInfo)[fsIdxs[i]].fileStickyProxyDepth
+              (*entries[i]->treeInfo)[fsIdxs[i]].fileStickyProxyDepth
             ) {
               uprlev++;
             }
@@ -1357,24 +1349,24 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
               }
 
               // sort the proxies by fsid
-              TreeInfoFsIdComparator cmp(pxyentry->foregroundFastStruct->treeInfo);
+              TreeInfoFsIdComparator cmp(pxyStruct->treeInfo);
               std::sort(proxiesIdxs.begin(), proxiesIdxs.end(), cmp);
               // take the proxy
               idx = proxiesIdxs[inode % proxiesIdxs.size()];
               // if it succeeds, feel the corresponding element of the return vector
-              (*dataProxys)[i] = (*pxyentry->foregroundFastStruct->treeInfo)[idx].hostport;
+              (*dataProxys)[i] = (*pxyStruct->treeInfo)[idx].hostport;
 
               if (g_logging.gLogMask & LOG_MASK(LOG_DEBUG)) {
                 stringstream ss;
                 ss << "file sticky proxy scheduling fs:" <<
-                   (*entries[i]->foregroundFastStruct->treeInfo)[fsIdxs[i]].fsId;
+                   (*entries[i]->treeInfo)[fsIdxs[i]].fsId;
                 ss << " | fileStickyProxyDepth:" << (int)(
-                     *entries[i]->foregroundFastStruct->treeInfo)[fsIdxs[i]].fileStickyProxyDepth;
+                     *entries[i]->treeInfo)[fsIdxs[i]].fileStickyProxyDepth;
                 ss << " | possible proxys are:";
 
                 for (auto it = proxiesIdxs.begin(); it != proxiesIdxs.end(); it++) {
-                  ss << (*pxyentry->foregroundFastStruct->treeInfo)[*it].hostport;
-                  ss << "(" << (*pxyentry->foregroundFastStruct->treeInfo)[*it].fullGeotag << ")";
+                  ss << (*pxyStruct->treeInfo)[*it].hostport;
+                  ss << "(" << (*pxyStruct->treeInfo)[*it].fullGeotag << ")";
 
                   if (it != proxiesIdxs.end() - 1) {
                     ss << ",";
@@ -1383,7 +1375,7 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
 
                 ss << " | inode:" << inode;
                 ss << " | selected host is:" <<
-                   (*pxyentry->foregroundFastStruct->treeInfo)[idx].hostport;
+                   (*pxyStruct->treeInfo)[idx].hostport;
                 eos_debug("%s", ss.str().c_str());
               }
             }
@@ -1392,18 +1384,18 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
       }
     } else {
       if (proxyschedtype == any
-          || ((*entries[i]->foregroundFastStruct->treeInfo)[fsIdxs[i]].fileStickyProxyDepth
+          || ((*entries[i]->treeInfo)[fsIdxs[i]].fileStickyProxyDepth
               < 0 && proxyschedtype == regular)) {
         // get the proxy
         if (!(schedsuccess = tree->findFreeSlot(idx, idx,
                                                 true /*allow uproot if necessary*/, false, true /*skipSaturated*/))) {
-          (*dataProxys)[i] = (*pxyentry->foregroundFastStruct->treeInfo)[idx].hostport;
+          (*dataProxys)[i] = (*pxyStruct->treeInfo)[idx].hostport;
         } else {
           if ((schedsuccess = tree->findFreeSlot(idx, idx,
                                                  true /*allow uproot if necessary*/, false, false /*skipSaturated*/)))
             // if it succeeds, feel the corresponding element of the return vector
           {
-            (*dataProxys)[i] = (*pxyentry->foregroundFastStruct->treeInfo)[idx].hostport;
+            (*dataProxys)[i] = (*pxyStruct->treeInfo)[idx].hostport;
           }
         }
       } else {
@@ -1417,13 +1409,13 @@ bool GeoTreeEngine::findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>&
       std::stringstream ss;
       ss << "tree is as follow\n" << (*tree);
       eos_err(ss.str().c_str());
-      pxyentry->doubleBufferMutex.UnLockRead();
+      pxyentry->unpinForeground(pxyStruct);
       AtomicDec(pxyentry->fastStructLockWaitersCount);
       return false;
     }
 
     // unlock it for each new fs
-    pxyentry->doubleBufferMutex.UnLockRead();
+    pxyentry->unpinForeground(pxyStruct);
     AtomicDec(pxyentry->fastStructLockWaitersCount);
   }
 
@@ -1472,8 +1464,8 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
     entry = pGroup2SchedTME[group];
     AtomicInc(entry->fastStructLockWaitersCount);
   }
-  // readlock the original fast structure
-  entry->doubleBufferMutex.LockRead();
+  // pin the current foreground fast structure
+  FastStructSched* fgStruct = entry->pinForeground();
   // locate the existing replicas and the excluded fs in the tree
   vector<SchedTreeBase::tFastTreeIdx> accessedReplicasIdx(nAccessReplicas),
          *existingReplicasIdx = NULL, *excludeFsIdx = NULL, *forceBrIdx = NULL;
@@ -1485,7 +1477,7 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
   for (auto it = existingReplicas->begin(); it != existingReplicas->end(); ++it) {
     const SchedTreeBase::tFastTreeIdx* idx;
 
-    if (!entry->foregroundFastStruct->fs2TreeIdx->get(*it, idx)) {
+    if (!fgStruct->fs2TreeIdx->get(*it, idx)) {
       eos_warning("could not place preexisting replica on the fast tree");
       continue;
     }
@@ -1500,7 +1492,7 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
     for (auto it = excludeFs->begin(); it != excludeFs->end(); ++it) {
       const SchedTreeBase::tFastTreeIdx* idx;
 
-      if (!entry->foregroundFastStruct->fs2TreeIdx->get(*it, idx)) {
+      if (!fgStruct->fs2TreeIdx->get(*it, idx)) {
         eos_warning("could not place excluded fs on the fast tree");
         continue;
       }
@@ -1517,7 +1509,7 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
 
     for (auto it = excludeGeoTags->begin(); it != excludeGeoTags->end(); ++it) {
       SchedTreeBase::tFastTreeIdx idx;
-      idx = entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+      idx = fgStruct->tag2NodeIdx->getClosestFastTreeNode(
               it->c_str());
       excludeFsIdx->push_back(idx);
     }
@@ -1528,7 +1520,7 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
 
     for (auto it = forceGeoTags->begin(); it != forceGeoTags->end(); ++it) {
       SchedTreeBase::tFastTreeIdx idx;
-      idx = entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+      idx = fgStruct->tag2NodeIdx->getClosestFastTreeNode(
               it->c_str());
       forceBrIdx->push_back(idx);
     }
@@ -1536,7 +1528,7 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
 
   // find the closest tree node to the accesser
   SchedTreeBase::tFastTreeIdx accesserNode =
-    entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+    fgStruct->tag2NodeIdx->getClosestFastTreeNode(
       accesserGeotag.c_str());;
   // actually do the job
   unsigned char success = 0;
@@ -1545,28 +1537,28 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
   case regularRO:
     success = accessReplicas(entry, nAccessReplicas, &accessedReplicasIdx,
                              accesserNode, existingReplicasIdx,
-                             entry->foregroundFastStruct->rOAccessTree, excludeFsIdx,
+                             fgStruct->rOAccessTree, excludeFsIdx,
                              forceBrIdx, pSkipSaturatedAccess);
     break;
 
   case regularRW:
     success = accessReplicas(entry, nAccessReplicas, &accessedReplicasIdx,
                              accesserNode, existingReplicasIdx,
-                             entry->foregroundFastStruct->rWAccessTree, excludeFsIdx,
+                             fgStruct->rWAccessTree, excludeFsIdx,
                              forceBrIdx, pSkipSaturatedAccess);
     break;
 
   case draining:
     success = accessReplicas(entry, nAccessReplicas, &accessedReplicasIdx,
                              accesserNode, existingReplicasIdx,
-                             entry->foregroundFastStruct->drnAccessTree, excludeFsIdx,
+                             fgStruct->drnAccessTree, excludeFsIdx,
                              forceBrIdx, pSkipSaturatedDrnAccess);
     break;
 
   case balancing:
     success = accessReplicas(entry, nAccessReplicas, &accessedReplicasIdx,
                              accesserNode, existingReplicasIdx,
-                             entry->foregroundFastStruct->blcAccessTree, excludeFsIdx, forceBrIdx,
+                             fgStruct->blcAccessTree, excludeFsIdx, forceBrIdx,
                              pSkipSaturatedBlcAccess);
     break;
 
@@ -1585,9 +1577,9 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
   for (auto it = accessedReplicasIdx.begin(); it != accessedReplicasIdx.end();
        ++it) {
     const SchedTreeBase::tFastTreeIdx* idx = NULL;
-    const unsigned int fsid = (*entry->foregroundFastStruct->treeInfo)[*it].fsId;
+    const unsigned int fsid = (*fgStruct->treeInfo)[*it].fsId;
 
-    if (!entry->foregroundFastStruct->fs2TreeIdx->get(fsid, idx)) {
+    if (!fgStruct->fs2TreeIdx->get(fsid, idx)) {
       eos_crit("inconsistency : cannot retrieve index of selected fs though it "
                "should be in the tree");
       success = false;
@@ -1595,26 +1587,26 @@ bool GeoTreeEngine::accessReplicasOneGroup(FsGroup* group,
     }
 
     const char netSpeedClass =
-      (*entry->foregroundFastStruct->treeInfo)[*idx].netSpeedClass;
+      (*fgStruct->treeInfo)[*idx].netSpeedClass;
     accessedReplicas->push_back(fsid);
 
     // apply the penalties
-    if (entry->foregroundFastStruct->placementTree->pNodes[*idx].fsData.dlScore >=
+    if (fgStruct->placementTree->pNodes[*idx].fsData.dlScore >=
         pPenaltySched.pAccessDlScorePenalty[netSpeedClass]) {
-      applyDlScorePenalty(entry, *idx,
-                          pPenaltySched.pAccessDlScorePenalty[netSpeedClass]);
+      fgStruct->applyDlScorePenalty(*idx,
+                                    pPenaltySched.pAccessDlScorePenalty[netSpeedClass]);
     }
 
-    if (entry->foregroundFastStruct->placementTree->pNodes[*idx].fsData.ulScore >=
+    if (fgStruct->placementTree->pNodes[*idx].fsData.ulScore >=
         pPenaltySched.pAccessUlScorePenalty[netSpeedClass]) {
-      applyUlScorePenalty(entry, *idx,
-                          pPenaltySched.pAccessUlScorePenalty[netSpeedClass]);
+      fgStruct->applyUlScorePenalty(*idx,
+                                    pPenaltySched.pAccessUlScorePenalty[netSpeedClass]);
     }
   }
 
   // unlock, cleanup
 cleanup:
-  entry->doubleBufferMutex.UnLockRead();
+  entry->unpinForeground(fgStruct);
   AtomicDec(entry->fastStructLockWaitersCount);
   delete existingReplicasIdx;
 
@@ -1670,12 +1662,15 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
   std::vector<eos::common::FileSystem::fsid_t>::iterator it;
   std::vector<SchedTreeBase::tFastTreeIdx> ERIdx;
   ERIdx.reserve(existingReplicas->size());
-  std::vector<SchedTME*> entries;
+  std::vector<FastStructSched*> entries;
   entries.reserve(existingReplicas->size());
   // Maps tree maps entries (i.e. scheduling groups) to fsids containing a
   // replica being available and the corresponding fastTreeIndex
   map<SchedTME*, vector< pair<FileSystem::fsid_t, SchedTreeBase::tFastTreeIdx> > >
   entry2FsId;
+  // Maps tree maps entries to the foreground fast structure pinned for them
+  map<SchedTME*, FastStructSched*> entry2FgStruct;
+  FastStructSched* fgStruct = NULL;
   SchedTME* entry = NULL;
   {
     // Lock the scheduling group -> trees map so that the a map entry cannot
@@ -1694,30 +1689,34 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
 
       entry = mentry->second;
 
-      // lock the double buffering to make sure all the fast trees are not modified
+      // pin the foreground fast structures so that all the fast trees we look
+      // at come from the same snapshot during the whole operation
       if (!entry2FsId.count(entry)) {
-        // if the entry is already there, it was locked already
-        entry->doubleBufferMutex.LockRead();
+        // if the entry is already there, it was pinned already
+        fgStruct = entry->pinForeground();
         // to prevent the destruction of the entry
         AtomicInc(entry->fastStructLockWaitersCount);
+      } else {
+        fgStruct = entry2FgStruct[entry];
       }
 
       const SchedTreeBase::tFastTreeIdx* idx;
 
-      if (!entry->foregroundFastStruct->fs2TreeIdx->get(*exrepIt, idx)) {
+      if (!fgStruct->fs2TreeIdx->get(*exrepIt, idx)) {
         eos_warning("cannot find fs in the scheduling group in the 2nd pass");
 
         if (!entry2FsId.count(entry)) {
-          entry->doubleBufferMutex.UnLockRead();
+          entry->unpinForeground(fgStruct);
           AtomicDec(entry->fastStructLockWaitersCount);
         }
 
         continue;
       }
 
+      entry2FgStruct[entry] = fgStruct;
       // take the fastindex of each existing replica
       ERIdx.push_back(*idx);
-      entries.push_back(entry);
+      entries.push_back(fgStruct);
       // check if the fs is available
       bool isValid = false;
 
@@ -1725,23 +1724,23 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
                     *exrepIt) == unavailableFs->end()) {
         switch (type) {
         case regularRO:
-          isValid = entry->foregroundFastStruct->rOAccessTree->pBranchComp.isValidSlot(
-                      &entry->foregroundFastStruct->rOAccessTree->pNodes[*idx].fsData, &freeSlot);
+          isValid = fgStruct->rOAccessTree->pBranchComp.isValidSlot(
+                      &fgStruct->rOAccessTree->pNodes[*idx].fsData, &freeSlot);
           break;
 
         case regularRW:
-          isValid = entry->foregroundFastStruct->rWAccessTree->pBranchComp.isValidSlot(
-                      &entry->foregroundFastStruct->rWAccessTree->pNodes[*idx].fsData, &freeSlot);
+          isValid = fgStruct->rWAccessTree->pBranchComp.isValidSlot(
+                      &fgStruct->rWAccessTree->pNodes[*idx].fsData, &freeSlot);
           break;
 
         case draining:
-          isValid = entry->foregroundFastStruct->drnAccessTree->pBranchComp.isValidSlot(
-                      &entry->foregroundFastStruct->drnAccessTree->pNodes[*idx].fsData, &freeSlot);
+          isValid = fgStruct->drnAccessTree->pBranchComp.isValidSlot(
+                      &fgStruct->drnAccessTree->pNodes[*idx].fsData, &freeSlot);
           break;
 
         case balancing:
-          isValid = entry->foregroundFastStruct->blcAccessTree->pBranchComp.isValidSlot(
-                      &entry->foregroundFastStruct->blcAccessTree->pNodes[*idx].fsData, &freeSlot);
+          isValid = fgStruct->blcAccessTree->pBranchComp.isValidSlot(
+                      &fgStruct->blcAccessTree->pNodes[*idx].fsData, &freeSlot);
           break;
 
         default:
@@ -1807,7 +1806,7 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
 
           for (auto it = entryIt->second.begin(); it != entryIt->second.end(); ++it) {
             buf += sprintf(buf, "%s  ",
-                           (*entryIt->first->foregroundFastStruct->treeInfo)[it->second].fullGeotag.c_str());
+                           (*entry2FgStruct[entryIt->first]->treeInfo)[it->second].fullGeotag.c_str());
           }
 
           eos_debug("existing replicas geotags in geotree -> %s", buffer);
@@ -1820,8 +1819,9 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
         }
 
         entry = entryIt->first;
+        fgStruct = entry2FgStruct[entry];
         // find the closest tree node to the accesser
-        accesserNode = entry->foregroundFastStruct->tag2NodeIdx->getClosestFastTreeNode(
+        accesserNode = fgStruct->tag2NodeIdx->getClosestFastTreeNode(
                          accesserGeotag.c_str());;
         // fill a vector with the indices of the replicas
         vector<SchedTreeBase::tFastTreeIdx> existingReplicasIdx(entryIt->second.size());
@@ -1838,28 +1838,28 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
         case regularRO:
           retCode = accessReplicas(entryIt->first, 1, &accessedReplicasIdx,
                                    accesserNode, &existingReplicasIdx,
-                                   entry->foregroundFastStruct->rOAccessTree,
+                                   fgStruct->rOAccessTree,
                                    NULL, NULL, pSkipSaturatedAccess);
           break;
 
         case regularRW:
           retCode = accessReplicas(entryIt->first, 1, &accessedReplicasIdx,
                                    accesserNode, &existingReplicasIdx,
-                                   entry->foregroundFastStruct->rWAccessTree,
+                                   fgStruct->rWAccessTree,
                                    NULL, NULL, pSkipSaturatedAccess);
           break;
 
         case draining:
           retCode = accessReplicas(entryIt->first, 1, &accessedReplicasIdx,
                                    accesserNode, &existingReplicasIdx,
-                                   entry->foregroundFastStruct->drnAccessTree,
+                                   fgStruct->drnAccessTree,
                                    NULL, NULL, pSkipSaturatedDrnAccess);
           break;
 
         case balancing:
           retCode = accessReplicas(entryIt->first, 1, &accessedReplicasIdx,
                                    accesserNode, &existingReplicasIdx,
-                                   entry->foregroundFastStruct->blcAccessTree,
+                                   fgStruct->blcAccessTree,
                                    NULL, NULL, pSkipSaturatedBlcAccess);
           break;
 
@@ -1872,7 +1872,7 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
         }
 
         const string& fsGeotag =
-          (*entryIt->first->foregroundFastStruct->treeInfo)[*accessedReplicasIdx.begin()].fullGeotag;
+          (*fgStruct->treeInfo)[*accessedReplicasIdx.begin()].fullGeotag;
         unsigned geoScore = 0;
         size_t kmax = min(accesserGeotag.length(), fsGeotag.length());
 
@@ -1893,7 +1893,7 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
         }
 
         geoScore2Fs[geoScore].push_back(
-          (*entryIt->first->foregroundFastStruct->treeInfo)[*accessedReplicasIdx.begin()].fsId);
+          (*fgStruct->treeInfo)[*accessedReplicasIdx.begin()].fsId);
       }
 
       // randomly choose a fs among the highest scored ones
@@ -1930,7 +1930,7 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
       if (entry) {
         eos_debug("accesser closest node to %s index -> %d / %s",
                   accesserGeotag.c_str(), (int)accesserNode,
-                  (*entry->foregroundFastStruct->treeInfo)[accesserNode].fullGeotag.c_str());
+                  (*entry2FgStruct[entry]->treeInfo)[accesserNode].fullGeotag.c_str());
       }
 
       eos_debug("selected FsId -> %d / idx %d", (int)selectedFsId, (int)fsIndex);
@@ -1960,25 +1960,32 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
       }
 
       entry = pFs2SchedTME[fs];
+
+      // only the snapshots pinned above can be used
+      if (!entry2FgStruct.count(entry)) {
+        continue;
+      }
+
+      fgStruct = entry2FgStruct[entry];
       const SchedTreeBase::tFastTreeIdx* idx;
 
-      if (entry->foregroundFastStruct->fs2TreeIdx->get(fs, idx)) {
+      if (fgStruct->fs2TreeIdx->get(fs, idx)) {
         const char netSpeedClass =
-          (*entry->foregroundFastStruct->treeInfo)[*idx].netSpeedClass;
+          (*fgStruct->treeInfo)[*idx].netSpeedClass;
 
         // every available box will push data
-        if (entry->foregroundFastStruct->placementTree->pNodes[*idx].fsData.ulScore >=
+        if (fgStruct->placementTree->pNodes[*idx].fsData.ulScore >=
             pPenaltySched.pAccessUlScorePenalty[netSpeedClass]) {
-          applyUlScorePenalty(entry, *idx,
-                              pPenaltySched.pAccessUlScorePenalty[netSpeedClass]);
+          fgStruct->applyUlScorePenalty(*idx,
+                                        pPenaltySched.pAccessUlScorePenalty[netSpeedClass]);
         }
 
         // every available box will have to pull data if it's a RW access (or if it's a gateway)
         if ((type == regularRW) || (j == fsIndex && nAccessReplicas > 1)) {
-          if (entry->foregroundFastStruct->placementTree->pNodes[*idx].fsData.dlScore >=
+          if (fgStruct->placementTree->pNodes[*idx].fsData.dlScore >=
               pPenaltySched.pAccessDlScorePenalty[netSpeedClass]) {
-            applyDlScorePenalty(entry, *idx,
-                                pPenaltySched.pAccessDlScorePenalty[netSpeedClass]);
+            fgStruct->applyDlScorePenalty(*idx,
+                                          pPenaltySched.pAccessDlScorePenalty[netSpeedClass]);
           }
         }
       } else {
@@ -2007,10 +2014,10 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
     if (pAccessGeotagMapping.inuse && pAccessProxygroup.inuse)
       for (size_t i = 0; i < ERIdx.size(); i++) {
         if (accesserGeotag.empty() ||
-            accessReqFwEP((*entries[i]->foregroundFastStruct->treeInfo)[ERIdx[i]].fullGeotag
+            accessReqFwEP((*entries[i]->treeInfo)[ERIdx[i]].fullGeotag
                           , accesserGeotag)) {
           firewallProxyGroups[i] = accessGetProxygroup((
-                                     *entries[i]->foregroundFastStruct->treeInfo)[ERIdx[i]].fullGeotag);
+                                     *entries[i]->treeInfo)[ERIdx[i]].fullGeotag);
         }
       }
 
@@ -2042,8 +2049,8 @@ int GeoTreeEngine::accessHeadReplicaMultipleGroup(const size_t& nAccessReplicas,
   // cleanup and exit
 cleanup:
 
-  for (auto cit = entry2FsId.begin(); cit != entry2FsId.end(); cit++) {
-    cit->first->doubleBufferMutex.UnLockRead();
+  for (auto cit = entry2FgStruct.begin(); cit != entry2FgStruct.end(); cit++) {
+    cit->first->unpinForeground(cit->second);
     AtomicDec(cit->first->fastStructLockWaitersCount);
   }
 
@@ -2234,6 +2241,9 @@ bool GeoTreeEngine::updateTreeInfo(SchedTME* entry,
     return true;
   }
 
+  // The background fast structures are about to be modified
+  entry->reclaimBackground();
+
 #define setOneStateVarInAllFastTrees(variable,value)                                      \
   {                                                                                       \
     entry->backgroundFastStruct->rOAccessTree->pNodes[ftIdx].fsData.variable = value;     \
@@ -2710,6 +2720,9 @@ bool GeoTreeEngine::updateTreeInfo(ProxyTMEBase* entry,
     return true;
   }
 
+  // The background fast structures are about to be modified
+  entry->reclaimBackground();
+
 #define setOneStateVarInAllFastTrees(variable,value)                                     \
   {                                                                                      \
     entry->backgroundFastStruct->proxyAccessTree->pNodes[ftIdx].fsData.variable = value; \
@@ -2918,8 +2931,12 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
   for (auto it = pGroup2SchedTME.begin(); it != pGroup2SchedTME.end(); it++) {
     SchedTME* entry = it->second;
     RWMutexReadLock lock(entry->slowTreeMutex);
+    // the updater is the only thread swapping the buffers so the foreground
+    // cannot change under our feet, but the retired buffer has to be reclaimed
+    entry->reclaimBackground();
+    auto fgStruct = entry->foregroundFastStruct.load();
 
-    if (!entry->foregroundFastStruct->DeepCopyTo(entry->backgroundFastStruct)) {
+    if (!fgStruct->DeepCopyTo(entry->backgroundFastStruct)) {
       eos_crit("error deep copying in double buffering");
       pTreeMapMutex.UnLockRead();
       return false;
@@ -2929,14 +2946,14 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
     // penalties counter in the fast trees.
     auto& pVec = pPenaltySched.pCircFrCnt2FsPenalties[pFrameCount % pCircSize];
 
-    for (auto it2 = entry->foregroundFastStruct->fs2TreeIdx->begin();
-         it2 != entry->foregroundFastStruct->fs2TreeIdx->end(); it2++) {
+    for (auto it2 = fgStruct->fs2TreeIdx->begin();
+         it2 != fgStruct->fs2TreeIdx->end(); it2++) {
       auto cur = *it2;
-      pVec[cur.first] = (*entry->foregroundFastStruct->penalties)[cur.second];
-      AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty,
-                (*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty, (char)0);
-      AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].ulScorePenalty,
-                (*entry->foregroundFastStruct->penalties)[cur.second].ulScorePenalty, (char)0);
+      pVec[cur.first] = (*fgStruct->penalties)[cur.second];
+      AtomicCAS((*fgStruct->penalties)[cur.second].dlScorePenalty,
+                (*fgStruct->penalties)[cur.second].dlScorePenalty, (char)0);
+      AtomicCAS((*fgStruct->penalties)[cur.second].ulScorePenalty,
+                (*fgStruct->penalties)[cur.second].ulScorePenalty, (char)0);
     }
   }
 
@@ -2947,8 +2964,12 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
   for (auto it = pPxyGrp2DpTME.begin(); it != pPxyGrp2DpTME.end(); it++) {
     DataProxyTME* entry = it->second;
     RWMutexReadLock lock(entry->slowTreeMutex);
+    // the updater is the only thread swapping the buffers so the foreground
+    // cannot change under our feet, but the retired buffer has to be reclaimed
+    entry->reclaimBackground();
+    auto fgStruct = entry->foregroundFastStruct.load();
 
-    if (!entry->foregroundFastStruct->DeepCopyTo(entry->backgroundFastStruct)) {
+    if (!fgStruct->DeepCopyTo(entry->backgroundFastStruct)) {
       eos_crit("error deep copying in double buffering");
       pPxyTreeMapMutex.UnLockRead();
       return false;
@@ -2958,14 +2979,14 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
     // penalties counter in the fast trees.
     auto& pMap = pPenaltySched.pCircFrCnt2HostPenalties[pFrameCount % pCircSize];
 
-    for (auto it2 = entry->foregroundFastStruct->host2TreeIdx->begin();
-         it2 != entry->foregroundFastStruct->host2TreeIdx->end(); it2++) {
+    for (auto it2 = fgStruct->host2TreeIdx->begin();
+         it2 != fgStruct->host2TreeIdx->end(); it2++) {
       auto cur = *it2;
-      pMap[cur.first] = (*entry->foregroundFastStruct->penalties)[cur.second];
-      AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty,
-                (*entry->foregroundFastStruct->penalties)[cur.second].dlScorePenalty, (char)0);
-      AtomicCAS((*entry->foregroundFastStruct->penalties)[cur.second].ulScorePenalty,
-                (*entry->foregroundFastStruct->penalties)[cur.second].ulScorePenalty, (char)0);
+      pMap[cur.first] = (*fgStruct->penalties)[cur.second];
+      AtomicCAS((*fgStruct->penalties)[cur.second].dlScorePenalty,
+                (*fgStruct->penalties)[cur.second].dlScorePenalty, (char)0);
+      AtomicCAS((*fgStruct->penalties)[cur.second].ulScorePenalty,
+                (*fgStruct->penalties)[cur.second].ulScorePenalty, (char)0);
     }
   }
 
@@ -3028,8 +3049,8 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
     eos_debug("CHANGE BITFIELD %s => %x", it->first.c_str(), it->second);
     // Update only the fast structures because even if a fast structure rebuild
     // is needed from the slow tree. Its information and state is updated from
-    // the fast structures.
-    entry->doubleBufferMutex.LockRead();
+    // the fast structures. Only the background fast structures are accessed
+    // here and every writer is serialized by pAddRmFsMutex.
     const SchedTreeBase::tFastTreeIdx* idx = NULL;
     SlowTreeNode* node = NULL;
 
@@ -3039,7 +3060,6 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
       if (nodeit == entry->fs2SlowTreeNode.end()) {
         eos_crit("Inconsistency : cannot locate an fs %lu supposed to be in "
                  "the fast structures", (unsigned long)fsid);
-        entry->doubleBufferMutex.UnLockRead();
         AtomicDec(entry->fastStructLockWaitersCount);
         return false;
       }
@@ -3062,7 +3082,6 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
     }
 
     // if we update the slowtree, then a fast tree generation is already pending
-    entry->doubleBufferMutex.UnLockRead();
     AtomicDec(entry->fastStructLockWaitersCount);
   }
 
@@ -3108,8 +3127,8 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
       eos_debug("CHANGE BITFIELD %x", it->second);
       // Update only the fast structures because even if a fast structure
       // rebuild is needed from the slow tree. Its information and state is
-      // updated from the fast structures.
-      entry->doubleBufferMutex.LockRead();
+      // updated from the fast structures. Only the background fast structures
+      // are accessed here and every writer is serialized by pAddRmFsMutex.
       const SchedTreeBase::tFastTreeIdx* idx = NULL;
       SlowTreeNode* node = NULL;
 
@@ -3119,7 +3138,6 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
         if (nodeit == entry->host2SlowTreeNode.end()) {
           eos_crit("Inconsistency : cannot locate an host: %s supposed to be "
                    "in the fast structures", host.c_str());
-          entry->doubleBufferMutex.UnLockRead();
           AtomicDec(entry->fastStructLockWaitersCount);
           return false;
         }
@@ -3142,7 +3160,6 @@ bool GeoTreeEngine::updateTreeInfo(const map<string, int>& updatesFs,
       }
 
       // if we update the slowtree, then a fast tree generation is already pending
-      entry->doubleBufferMutex.UnLockRead();
       AtomicDec(entry->fastStructLockWaitersCount);
     }
   }
@@ -3214,14 +3231,16 @@ bool GeoTreeEngine::getInfosFromFsIds(const std::vector<FileSystem::fsid_t>&
 
         if (fsgeotags || hosts) {
           const SchedTreeBase::tFastTreeIdx* idx = NULL;
+          SchedTME* entry = pFs2SchedTME[*it];
+          FastStructSched* fgStruct = entry->pinForeground();
 
-          if (pFs2SchedTME[*it]->foregroundFastStruct->fs2TreeIdx->get(*it, idx)) {
+          if (fgStruct->fs2TreeIdx->get(*it, idx)) {
             if (fsgeotags) fsgeotags->push_back(
-                (*pFs2SchedTME[*it]->foregroundFastStruct->treeInfo)[*idx].fullGeotag
+                (*fgStruct->treeInfo)[*idx].fullGeotag
               );
 
             if (hosts) hosts->push_back(
-                (*pFs2SchedTME[*it]->foregroundFastStruct->treeInfo)[*idx].host
+                (*fgStruct->treeInfo)[*idx].host
               );
           } else {
             if (fsgeotags) {
@@ -3232,6 +3251,8 @@ bool GeoTreeEngine::getInfosFromFsIds(const std::vector<FileSystem::fsid_t>&
               hosts->push_back("");
             }
           }
+
+          entry->unpinForeground(fgStruct);
         }
 
         if (sortedgroups) {
@@ -3795,7 +3816,7 @@ bool GeoTreeEngine::markPendingBranchDisablings(const std::string& group,
     const std::string& optype, const std::string& geotag)
 {
   for (auto git = pGroup2SchedTME.begin(); git != pGroup2SchedTME.end(); git++) {
-    RWMutexReadLock lock(git->second->doubleBufferMutex);
+    RWMutexReadLock lock(git->second->slowTreeMutex);
 
     if (group == "*" || git->first->mName == group) {
       git->second->slowTreeModified = true;
@@ -43,6 +43,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sched.h>
+#include <atomic>
 
 /*----------------------------------------------------------------------------*/
 /**
@@ -116,6 +118,9 @@
  *
  * If any change was made to the SlowTree (add/remove fs/proxy, geotag change), GeoTreeEngine::FastStructSched/GeotreeEngine::FastStructProxy are then regenerated fom the SlowTree.
  * Once the whole refresh is done pointers to foreground and background structures are swapped.
+ * The swap is an atomic pointer exchange (GeoTreeEngine::TreeMapEntry::swapFastStructBuffers) so the scheduling operations never block on the updater.
+ * Scheduling operations pin the foreground structure they use (reference count per buffer) and the buffer retired by a swap is reclaimed as the next
+ * background only once all the readers of its epoch have unpinned it (GeoTreeEngine::TreeMapEntry::reclaimBackground). The waiting, if any, is done by the updater.
  *
  *
  * ### Penalty subsystem
@@ -452,7 +457,7 @@ class GeoTreeEngine : public eos::common::LogId
     }
 
     inline void applyDlScorePenalty(SchedTreeBase::tFastTreeIdx idx,
-                                    const char& penalty, bool background)
+                                    const char& penalty, bool background = false)
     /**< Apply download score penalty */
     {
       AtomicSub(placementTree->pNodes[idx].fsData.dlScore, penalty);
@@ -469,7 +474,7 @@ class GeoTreeEngine : public eos::common::LogId
     }
 
     inline void applyUlScorePenalty(SchedTreeBase::tFastTreeIdx idx,
-                                    const char& penalty, bool background)
+                                    const char& penalty, bool background = false)
     /**< Apply upload score penalty */
     {
       AtomicSub(placementTree->pNodes[idx].fsData.ulScore, penalty);
@@ -636,7 +641,7 @@ class GeoTreeEngine : public eos::common::LogId
     }
 
     inline void applyDlScorePenalty(SchedTreeBase::tFastTreeIdx idx,
-                                    const char& penalty, bool background)
+                                    const char& penalty, bool background = false)
     {
       AtomicSub(proxyAccessTree->pNodes[idx].fsData.dlScore, penalty);
 
@@ -646,7 +651,7 @@ class GeoTreeEngine : public eos::common::LogId
     }
 
     inline void applyUlScorePenalty(SchedTreeBase::tFastTreeIdx idx,
-                                    const char& penalty, bool background)
+                                    const char& penalty, bool background = false)
     {
       AtomicSub(proxyAccessTree->pNodes[idx].fsData.ulScore, penalty);
 
@@ -712,13 +717,18 @@ class GeoTreeEngine : public eos::common::LogId
     // ===== Fast Structures Management and Double Buffering ====== //
     FastStruct fastStructures[2];
     // the pointed object is read only accessed by several thread
-    FastStruct* foregroundFastStruct;
+    // it is published through an atomic pointer swap and every reader has to
+    // pin it with pinForeground() and release it with unpinForeground()
+    std::atomic<FastStruct*> foregroundFastStruct;
     // the pointed object is accessed in read /write only by the thread update
+    // every writer is serialized by GeoTreeEngine::pAddRmFsMutex
     FastStruct* backgroundFastStruct;
-    // the two previous pointers are swapped once an update is done. To do so, we need a mutex and a counter (for deletion)
-    // every access to *mForegroundFastStruct for reading should be protected by a LockRead to mDoubleBufferMutex
-    // when swapping mForegroundFastStruct and mBackgroundFastStruct is needed a LockWrite is taken to mDoubleBufferMutex
-    eos::common::RWMutex doubleBufferMutex;
+    // number of readers currently holding a reference on each buffer
+    // a retired foreground buffer is reclaimed as a background buffer only
+    // once all the readers of its epoch have released it
+    std::atomic<size_t> fastStructRefCount[2];
+    // incremented every time a new foreground buffer is published
+    std::atomic<unsigned long long> fastStructEpoch;
     size_t fastStructLockWaitersCount;
     bool fastStructModified;
 
@@ -726,12 +736,14 @@ class GeoTreeEngine : public eos::common::LogId
       slowTreeModified(false),
       foregroundFastStruct(fastStructures),
       backgroundFastStruct(fastStructures + 1),
+      fastStructEpoch(0),
       fastStructLockWaitersCount(0),
       fastStructModified(false)
     {
       slowTree = new SlowTree(groupName);
       slowTreeMutex.SetBlocking(true);
-      doubleBufferMutex.SetBlocking(true);
+      fastStructRefCount[0] = 0;
+      fastStructRefCount[1] = 0;
     }
 
     ~TreeMapEntry()
@@ -741,10 +753,55 @@ class GeoTreeEngine : public eos::common::LogId
       }
     }
 
+    /// take a reference on the current foreground buffer, never blocks
+    FastStruct* pinForeground()
+    {
+      while (true) {
+        FastStruct* ft = foregroundFastStruct.load();
+        fastStructRefCount[ft - fastStructures]++;
+
+        // the buffer might have been retired between the load and the
+        // increment, in which case it could be under modification already
+        if (ft == foregroundFastStruct.load()) {
+          return ft;
+        }
+
+        fastStructRefCount[ft - fastStructures]--;
+      }
+    }
+
+    /// release a reference taken with pinForeground
+    void unpinForeground(FastStruct* ft)
+    {
+      fastStructRefCount[ft - fastStructures]--;
+    }
+
+    /// wait until no reader holds a reference on the background buffer anymore
+    /// this has to be called by the updater before modifying it
+    void reclaimBackground()
+    {
+      size_t spins = 0;
+
+      while (fastStructRefCount[backgroundFastStruct - fastStructures].load()) {
+        if (++spins < 64) {
+          sched_yield();
+        } else {
+          usleep(100);
+        }
+      }
+
+      if (spins >= 64) {
+        eos_static_debug("waited for the readers of epoch %llu to reclaim the "
+                         "fast structures", fastStructEpoch.load() - 1);
+      }
+    }
+
     void swapFastStructBuffers()
     {
-      eos::common::RWMutexWriteLock lock(doubleBufferMutex);
-      std::swap(foregroundFastStruct, backgroundFastStruct);
+      // publish the background buffer, the previous foreground is retired and
+      // gets reclaimed lazily at the next background update
+      backgroundFastStruct = foregroundFastStruct.exchange(backgroundFastStruct);
+      fastStructEpoch++;
     }
 
     void updateBGFastStructuresConfigParam(
@@ -886,6 +943,9 @@ class GeoTreeEngine : public eos::common::LogId
       return true;
     }
 
+    // make sure no reader still holds the buffer retired at the previous swap
+    entry->reclaimBackground();
+
     if (entry->slowTreeModified) {
       entry->updateSlowTreeInfoFromBgFastStruct();
 
@@ -927,7 +987,7 @@ class GeoTreeEngine : public eos::common::LogId
     // clear the penalties
     std::fill(entry->backgroundFastStruct->penalties->begin(),
               entry->backgroundFastStruct->penalties->end(), Penalties());
-    // swap the buffers (this is the only bit where the fast structures is not accessible for a placement/access operation)
+    // swap the buffers (readers holding the previous foreground keep using it until they unpin it)
     entry->swapFastStructBuffers();
     return true;
   }
@@ -941,6 +1001,9 @@ class GeoTreeEngine : public eos::common::LogId
       return true;
     }
 
+    // make sure no reader still holds the buffer retired at the previous swap
+    entry->reclaimBackground();
+
     if (entry->slowTreeModified) {
       entry->updateSlowTreeInfoFromBgFastStruct();
 
@@ -982,7 +1045,7 @@ class GeoTreeEngine : public eos::common::LogId
     // clear the penalties
     std::fill(entry->backgroundFastStruct->penalties->begin(),
               entry->backgroundFastStruct->penalties->end(), Penalties());
-    // swap the buffers (this is the only bit where the fast structures is not accessible for a placement/access operation)
+    // swap the buffers (readers holding the previous foreground keep using it until they unpin it)
     entry->swapFastStructBuffers();
     return true;
   }
@@ -1315,7 +1378,7 @@ protected:
                                   bool background = false)
   {
     FastStructSched* ft = background ? entry->backgroundFastStruct :
-                          entry->foregroundFastStruct;
+                          entry->foregroundFastStruct.load();
     ft->applyDlScorePenalty(idx, penalty, background);
   }
 
@@ -1324,7 +1387,7 @@ protected:
                                   bool background = false)
   {
     FastStructProxy* ft = background ? entry->backgroundFastStruct :
-                          entry->foregroundFastStruct;
+                          entry->foregroundFastStruct.load();
     ft->applyDlScorePenalty(idx, penalty, background);
   }
 
@@ -1333,7 +1396,7 @@ protected:
                                   bool background = false)
   {
     FastStructSched* ft = background ? entry->backgroundFastStruct :
-                          entry->foregroundFastStruct;
+                          entry->foregroundFastStruct.load();
     ft->applyUlScorePenalty(idx, penalty, background);
   }
 
@@ -1342,7 +1405,7 @@ protected:
                                   bool background = false)
   {
     FastStructProxy* ft = background ? entry->backgroundFastStruct :
-                          entry->foregroundFastStruct;
+                          entry->foregroundFastStruct.load();
     ft->applyUlScorePenalty(idx, penalty, background);
   }
 
@@ -1359,13 +1422,13 @@ protected:
          (pLatencySched.pCircFrCnt2Timestamp[circIdx] > lstat.lastupdate -
           pPublishToPenaltyDelayMs);
          circIdx = ((pCircSize + circIdx - 1) % pCircSize)) {
-      if (entry->foregroundFastStruct->placementTree->pNodes[idx].fsData.dlScore > 0)
+      if (entry->foregroundFastStruct.load()->placementTree->pNodes[idx].fsData.dlScore > 0)
         applyDlScorePenalty(entry, idx,
                             pPenaltySched.pCircFrCnt2FsPenalties[circIdx][fsid].dlScorePenalty,
                             true
                            );
 
-      if (entry->foregroundFastStruct->placementTree->pNodes[idx].fsData.ulScore > 0)
+      if (entry->foregroundFastStruct.load()->placementTree->pNodes[idx].fsData.ulScore > 0)
         applyUlScorePenalty(entry, idx,
                             pPenaltySched.pCircFrCnt2FsPenalties[circIdx][fsid].ulScorePenalty,
                             true
@@ -1402,14 +1465,14 @@ protected:
          (pLatencySched.pCircFrCnt2Timestamp[circIdx] > lstat.lastupdate -
           pPublishToPenaltyDelayMs);
          circIdx = ((pCircSize + circIdx - 1) % pCircSize)) {
-      if (entry->foregroundFastStruct->proxyAccessTree->pNodes[idx].fsData.dlScore >
+      if (entry->foregroundFastStruct.load()->proxyAccessTree->pNodes[idx].fsData.dlScore >
           0)
         applyDlScorePenalty(entry, idx,
                             pPenaltySched.pCircFrCnt2HostPenalties[circIdx][host].dlScorePenalty,
                             true
                            );
 
-      if (entry->foregroundFastStruct->proxyAccessTree->pNodes[idx].fsData.ulScore >
+      if (entry->foregroundFastStruct.load()->proxyAccessTree->pNodes[idx].fsData.ulScore >
           0)
         applyUlScorePenalty(entry, idx,
                             pPenaltySched.pCircFrCnt2HostPenalties[circIdx][host].ulScorePenalty,
@@ -1810,7 +1873,7 @@ protected:
     any         // do the regular scheduling for all the filesystems
   } tProxySchedType;
   bool findProxy(const std::vector<SchedTreeBase::tFastTreeIdx>& fsidxs,
-                 std::vector<SchedTME*> entries,
+                 const std::vector<FastStructSched*>& entries,
                  ino64_t inode,
                  std::vector<std::string>* proxies,
                  std::vector<std::string>* proxyGroups = NULL,
@@ -43,6 +43,12 @@ const char* Iostat::gIostatReport = "iostat::report";
 const char* Iostat::gIostatReportNamespace = "iostat::reportnamespace";
 const char* Iostat::gIostatPopularity = "iostat::popularity";
 const char* Iostat::gIostatUdpTargetList = "iostat::udptargets";
+const char* Iostat::gReportTagNames[Iostat::kNumReportTags] = {
+  "bytes_read", "bytes_written", "read_calls", "readv_calls", "write_calls",
+  "fwd_seeks", "bwd_seeks", "xl_fwd_seeks", "xl_bwd_seeks", "bytes_fwd_seek",
+  "bytes_bwd_wseek", "bytes_xl_fwd_seek", "bytes_xl_bwd_wseek",
+  "disk_time_read", "disk_time_write"
+};
 
 /* ------------------------------------------------------------------------- */
 Iostat::Iostat()
@@ -83,6 +89,11 @@ Iostat::Iostat()
   }
 
   IostatLastPopularityBin = 0;
+
+  for (int i = 0; i < kNumReportTags; i++) {
+    GetTagId(gReportTagNames[i]);
+  }
+
   mReportPopularity = true;
   mReportNamespace = false;
   mReport = true;
@@ -263,35 +274,35 @@ Iostat::Receive(void)
 
       XrdOucEnv ioreport(body.c_str());
       eos::common::Report* report = new eos::common::Report(ioreport);
-      Add("bytes_read", report->uid, report->gid, report->rb, report->ots,
+      Add(kBytesRead, report->uid, report->gid, report->rb, report->ots,
           report->cts);
-      Add("bytes_written", report->uid, report->gid, report->wb, report->ots,
+      Add(kBytesWritten, report->uid, report->gid, report->wb, report->ots,
           report->cts);
-      Add("read_calls", report->uid, report->gid, report->nrc, report->ots,
+      Add(kReadCalls, report->uid, report->gid, report->nrc, report->ots,
           report->cts);
-      Add("readv_calls", report->uid, report->gid, report->rv_op, report->ots,
+      Add(kReadvCalls, report->uid, report->gid, report->rv_op, report->ots,
           report->cts);
-      Add("write_calls", report->uid, report->gid, report->nwc, report->ots,
+      Add(kWriteCalls, report->uid, report->gid, report->nwc, report->ots,
           report->cts);
-      Add("fwd_seeks", report->uid, report->gid, report->nfwds, report->ots,
+      Add(kFwdSeeks, report->uid, report->gid, report->nfwds, report->ots,
           report->cts);
-      Add("bwd_seeks", report->uid, report->gid, report->nbwds, report->ots,
+      Add(kBwdSeeks, report->uid, report->gid, report->nbwds, report->ots,
           report->cts);
-      Add("xl_fwd_seeks", report->uid, report->gid, report->nxlfwds, report->ots,
+      Add(kXlFwdSeeks, report->uid, report->gid, report->nxlfwds, report->ots,
           report->cts);
-      Add("xl_bwd_seeks", report->uid, report->gid, report->nxlbwds, report->ots,
+      Add(kXlBwdSeeks, report->uid, report->gid, report->nxlbwds, report->ots,
           report->cts);
-      Add("bytes_fwd_seek", report->uid, report->gid, report->sfwdb, report->ots,
+      Add(kBytesFwdSeek, report->uid, report->gid, report->sfwdb, report->ots,
           report->cts);
-      Add("bytes_bwd_wseek", report->uid, report->gid, report->sbwdb, report->ots,
+      Add(kBytesBwdSeek, report->uid, report->gid, report->sbwdb, report->ots,
           report->cts);
-      Add("bytes_xl_fwd_seek", report->uid, report->gid, report->sxlfwdb, report->ots,
+      Add(kBytesXlFwdSeek, report->uid, report->gid, report->sxlfwdb, report->ots,
           report->cts);
-      Add("bytes_xl_bwd_wseek", report->uid, report->gid, report->sxlbwdb,
+      Add(kBytesXlBwdSeek, report->uid, report->gid, report->sxlbwdb,
           report->ots, report->cts);
-      Add("disk_time_read", report->uid, report->gid, (unsigned long long) report->rt,
+      Add(kDiskTimeRead, report->uid, report->gid, (unsigned long long) report->rt,
           report->ots, report->cts);
-      Add("disk_time_write", report->uid, report->gid,
+      Add(kDiskTimeWrite, report->uid, report->gid,
           (unsigned long long) report->wt, report->ots, report->cts);
       // do the UDP broadcasting here
       {
@@ -306,17 +317,7 @@ Iostat::Receive(void)
       if (report->path.substr(0, 11) == "/replicate:") {
         // check if this is a replication path
         // push into the 'eos' domain
-        Mutex.Lock();
-
-        if (report->rb) {
-          IostatAvgDomainIOrb["eos"].Add(report->rb, report->ots, report->cts);
-        }
-
-        if (report->wb) {
-          IostatAvgDomainIOwb["eos"].Add(report->wb, report->ots, report->cts);
-        }
-
-        Mutex.UnLock();
+        AddDomain("eos", report->rb, report->wb, report->ots, report->cts);
       } else {
         bool dfound = false;
 
@@ -332,17 +333,7 @@ Iostat::Receive(void)
           std::string sdomain = report->sec_domain.substr(pos);
 
           if (IoDomains.find(sdomain) != IoDomains.end()) {
-            Mutex.Lock();
-
-            if (report->rb) {
-              IostatAvgDomainIOrb[sdomain].Add(report->rb, report->ots, report->cts);
-            }
-
-            if (report->wb) {
-              IostatAvgDomainIOwb[sdomain].Add(report->wb, report->ots, report->cts);
-            }
-
-            Mutex.UnLock();
+            AddDomain(sdomain, report->rb, report->wb, report->ots, report->cts);
             dfound = true;
           }
         }
@@ -352,34 +343,14 @@ Iostat::Receive(void)
 
         for (nit = IoNodes.begin(); nit != IoNodes.end(); nit++) {
           if (*nit == report->sec_host.substr(0, nit->length())) {
-            Mutex.Lock();
-
-            if (report->rb) {
-              IostatAvgDomainIOrb[*nit].Add(report->rb, report->ots, report->cts);
-            }
-
-            if (report->wb) {
-              IostatAvgDomainIOwb[*nit].Add(report->wb, report->ots, report->cts);
-            }
-
-            Mutex.UnLock();
+            AddDomain(*nit, report->rb, report->wb, report->ots, report->cts);
             dfound = true;
           }
         }
 
         if (!dfound) {
           // push into the 'other' domain
-          Mutex.Lock();
-
-          if (report->rb) {
-            IostatAvgDomainIOrb["other"].Add(report->rb, report->ots, report->cts);
-          }
-
-          if (report->wb) {
-            IostatAvgDomainIOwb["other"].Add(report->wb, report->ots, report->cts);
-          }
-
-          Mutex.UnLock();
+          AddDomain("other", report->rb, report->wb, report->ots, report->cts);
         }
       }
 
@@ -391,17 +362,7 @@ Iostat::Receive(void)
       }
 
       // Push into app accounting
-      Mutex.Lock();
-
-      if (report->rb) {
-        IostatAvgAppIOrb[apptag].Add(report->rb, report->ots, report->cts);
-      }
-
-      if (report->wb) {
-        IostatAvgAppIOwb[apptag].Add(report->wb, report->ots, report->cts);
-      }
-
-      Mutex.UnLock();
+      AddApp(apptag, report->rb, report->wb, report->ots, report->cts);
 
       if (mReport) {
         // add the record to a daily report log file
@@ -480,20 +441,193 @@ Iostat::Receive(void)
   return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+int
+Iostat::GetTagId(const std::string& tag)
+{
+  XrdSysMutexHelper tLock(TagMutex);
+  std::map<std::string, int>::const_iterator it = IostatTagIds.find(tag);
+
+  if (it != IostatTagIds.end()) {
+    return it->second;
+  }
+
+  int id = (int) IostatTagNames.size();
+  IostatTagNames.push_back(tag);
+  IostatTagIds[tag] = id;
+  return id;
+}
+
+/* ------------------------------------------------------------------------- */
+void
+Iostat::AddDomain(const std::string& domain, unsigned long long rb,
+                  unsigned long long wb, time_t starttime, time_t stoptime)
+{
+  IostatSample sample;
+  sample.tag = 0;
+  sample.uid = 0;
+  sample.gid = 0;
+  sample.starttime = starttime;
+  sample.stoptime = stoptime;
+  sample.name = domain;
+
+  if (rb) {
+    sample.kind = IostatSample::kDomainRead;
+    sample.val = rb;
+    Queue(sample);
+  }
+
+  if (wb) {
+    sample.kind = IostatSample::kDomainWrite;
+    sample.val = wb;
+    Queue(sample);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+void
+Iostat::AddApp(const std::string& app, unsigned long long rb,
+               unsigned long long wb, time_t starttime, time_t stoptime)
+{
+  IostatSample sample;
+  sample.tag = 0;
+  sample.uid = 0;
+  sample.gid = 0;
+  sample.starttime = starttime;
+  sample.stoptime = stoptime;
+  sample.name = app;
+
+  if (rb) {
+    sample.kind = IostatSample::kAppRead;
+    sample.val = rb;
+    Queue(sample);
+  }
+
+  if (wb) {
+    sample.kind = IostatSample::kAppWrite;
+    sample.val = wb;
+    Queue(sample);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+void
+Iostat::Queue(const IostatSample& sample)
+{
+  // ---------------------------------------------------------------------------
+  // ! append a sample to the pending ones, merge if too many samples are
+  // ! pending
+  // ---------------------------------------------------------------------------
+  bool full = false;
+  {
+    XrdSysMutexHelper pLock(PendingMutex);
+    mPending.push_back(sample);
+    full = (mPending.size() > sMaxPendingSamples);
+  }
+
+  if (full) {
+    Merge();
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+void
+Iostat::Merge()
+{
+  // ---------------------------------------------------------------------------
+  // ! move the pending samples into the uid/gid/domain/app tables
+  // ---------------------------------------------------------------------------
+  XrdSysMutexHelper mergeLock(MergeMutex);
+  {
+    XrdSysMutexHelper pLock(PendingMutex);
+    mMergeBuffer.swap(mPending);
+  }
+
+  if (mMergeBuffer.empty()) {
+    return;
+  }
+
+  Mutex.Lock();
+
+  for (size_t i = 0; i < mMergeBuffer.size(); i++) {
+    ApplySample(mMergeBuffer[i]);
+  }
+
+  Mutex.UnLock();
+  // keep the capacity for the next round
+  mMergeBuffer.clear();
+}
+
+/* ------------------------------------------------------------------------- */
+void
+Iostat::ResizeTags(int tag)
+{
+  if (tag >= (int) IostatUid.size()) {
+    IostatUid.resize(tag + 1);
+    IostatGid.resize(tag + 1);
+    IostatAvgUid.resize(tag + 1);
+    IostatAvgGid.resize(tag + 1);
+  }
+}
+
+/* ------------------------------------------------------------------------- */
+void
+Iostat::ApplySample(const IostatSample& sample)
+{
+  switch (sample.kind) {
+  case IostatSample::kUidGid:
+    ResizeTags(sample.tag);
+    IostatUid[sample.tag][sample.uid] += sample.val;
+    IostatGid[sample.tag][sample.gid] += sample.val;
+    IostatAvgUid[sample.tag][sample.uid].Add(sample.val, sample.starttime,
+        sample.stoptime);
+    IostatAvgGid[sample.tag][sample.gid].Add(sample.val, sample.starttime,
+        sample.stoptime);
+    break;
+
+  case IostatSample::kDomainRead:
+    IostatAvgDomainIOrb[sample.name].Add(sample.val, sample.starttime,
+                                         sample.stoptime);
+    break;
+
+  case IostatSample::kDomainWrite:
+    IostatAvgDomainIOwb[sample.name].Add(sample.val, sample.starttime,
+                                         sample.stoptime);
+    break;
+
+  case IostatSample::kAppRead:
+    IostatAvgAppIOrb[sample.name].Add(sample.val, sample.starttime,
+                                      sample.stoptime);
+    break;
+
+  case IostatSample::kAppWrite:
+    IostatAvgAppIOwb[sample.name].Add(sample.val, sample.starttime,
+                                      sample.stoptime);
+    break;
+  }
+}
+
 /* ------------------------------------------------------------------------- */
 void
 Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
                  bool monitoring, bool numerical, bool top,
                  bool domain, bool apps, XrdOucString option)
 {
+  Merge();
+  std::vector<std::string> tagnames;
+  {
+    XrdSysMutexHelper tLock(TagMutex);
+    tagnames = IostatTagNames;
+  }
   Mutex.Lock();
-  std::vector<std::string> tags;
-  std::vector<std::string>::iterator it;
-  google::sparse_hash_map<std::string, google::sparse_hash_map<uid_t, unsigned long long> >::iterator
-  tit;
+  // tags sorted by name
+  std::vector<std::pair<std::string, int> > tags;
+  std::vector<std::pair<std::string, int> >::iterator it;
 
-  for (tit = IostatUid.begin(); tit != IostatUid.end(); tit++) {
-    tags.push_back(tit->first);
+  for (size_t i = 0; i < IostatUid.size() && i < tagnames.size(); i++) {
+    if (!IostatUid[i].empty()) {
+      tags.push_back(std::make_pair(tagnames[i], (int) i));
+    }
   }
 
   std::sort(tags.begin(), tags.end());
@@ -510,7 +644,8 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
     }
 
     for (it = tags.begin(); it != tags.end(); ++it) {
-      const char* tag = it->c_str();
+      const char* tagname = it->first.c_str();
+      int tag = it->second;
       char a60[1024];
       char a300[1024];
       char a3600[1024];
@@ -526,7 +661,7 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
         XrdOucString sa2;
         XrdOucString sa3;
         XrdOucString sa4;
-        sprintf(outline, "ALL        %-32s %10s %8s %8s %8s %8s\n", tag,
+        sprintf(outline, "ALL        %-32s %10s %8s %8s %8s %8s\n", tagname,
                 eos::common::StringConversion::GetReadableSizeString(sizestring, GetTotal(tag),
                     ""), eos::common::StringConversion::GetReadableSizeString(sa1,
                         GetTotalAvg60(tag), ""),
@@ -538,7 +673,7 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
       } else {
         sprintf(outline,
                 "uid=all gid=all measurement=%s total=%llu 60s=%s 300s=%s 3600s=%s 86400s=%s\n",
-                tag, GetTotal(tag), a60, a300, a3600, a86400);
+                tagname, GetTotal(tag), a60, a300, a3600, a86400);
       }
 
       out += outline;
@@ -574,17 +709,14 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
       out += "# -----------------------------------------------------------------------------------------------------------\n";
     }
 
-    google::sparse_hash_map<std::string, google::sparse_hash_map<uid_t, IostatAvg > >::iterator
-    tuit;
-    google::sparse_hash_map<std::string, google::sparse_hash_map<gid_t, IostatAvg > >::iterator
-    tgit;
     std::vector <std::string> uidout;
     std::vector <std::string> gidout;
 
-    for (tuit = IostatAvgUid.begin(); tuit != IostatAvgUid.end(); tuit++) {
+    for (size_t tag = 0; tag < IostatAvgUid.size() && tag < tagnames.size();
+         tag++) {
       google::sparse_hash_map<uid_t, IostatAvg>::iterator it;
 
-      for (it = tuit->second.begin(); it != tuit->second.end(); ++it) {
+      for (it = IostatAvgUid[tag].begin(); it != IostatAvgUid[tag].end(); ++it) {
         char a60[1024];
         char a300[1024];
         char a3600[1024];
@@ -615,8 +747,8 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
           XrdOucString sa3;
           XrdOucString sa4;
           sprintf(outline, "%-10s  %-32s %8s %8s %8s %8s %8s\n", identifier,
-                  tuit->first.c_str(), eos::common::StringConversion::GetReadableSizeString(
-                    sizestring, IostatUid[tuit->first.c_str()][it->first], ""),
+                  tagnames[tag].c_str(), eos::common::StringConversion::GetReadableSizeString(
+                    sizestring, IostatUid[tag][it->first], ""),
                   eos::common::StringConversion::GetReadableSizeString(sa1, it->second.GetAvg60(),
                       ""), eos::common::StringConversion::GetReadableSizeString(sa2,
                           it->second.GetAvg300(), ""),
@@ -627,7 +759,7 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
         } else {
           sprintf(outline,
                   "%s gid=all measurement=%s total=%llu 60s=%s 300s=%s 3600s=%s 86400s=%s\n",
-                  identifier, tuit->first.c_str(), IostatUid[tuit->first.c_str()][it->first], a60,
+                  identifier, tagnames[tag].c_str(), IostatUid[tag][it->first], a60,
                   a300, a3600, a86400);
         }
 
@@ -650,10 +782,11 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
       out += "# --------------------------------------------------------------------------------------\n";
     }
 
-    for (tgit = IostatAvgGid.begin(); tgit != IostatAvgGid.end(); tgit++) {
+    for (size_t tag = 0; tag < IostatAvgGid.size() && tag < tagnames.size();
+         tag++) {
       google::sparse_hash_map<gid_t, IostatAvg>::iterator it;
 
-      for (it = tgit->second.begin(); it != tgit->second.end(); ++it) {
+      for (it = IostatAvgGid[tag].begin(); it != IostatAvgGid[tag].end(); ++it) {
         char a60[1024];
         char a300[1024];
         char a3600[1024];
@@ -684,8 +817,8 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
           XrdOucString sa3;
           XrdOucString sa4;
           sprintf(outline, "%-10s  %-32s %8s %8s %8s %8s %8s\n", identifier,
-                  tgit->first.c_str(), eos::common::StringConversion::GetReadableSizeString(
-                    sizestring, IostatGid[tgit->first.c_str()][it->first], ""),
+                  tagnames[tag].c_str(), eos::common::StringConversion::GetReadableSizeString(
+                    sizestring, IostatGid[tag][it->first], ""),
                   eos::common::StringConversion::GetReadableSizeString(sa1, it->second.GetAvg60(),
                       ""), eos::common::StringConversion::GetReadableSizeString(sa2,
                           it->second.GetAvg300(), ""),
@@ -696,7 +829,7 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
         } else {
           sprintf(outline,
                   "%s gid=all measurement=%s total=%llu 60s=%s 300s=%s 3600s=%s 86400s=%s\n",
-                  identifier, tgit->first.c_str(), IostatGid[tgit->first.c_str()][it->first], a60,
+                  identifier, tagnames[tag].c_str(), IostatGid[tag][it->first], a60,
                   a300, a3600, a86400);
         }
 
@@ -720,7 +853,7 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
       if (!monitoring) {
         out += "# --------------------------------------------------------------------------------------\n";
         out += "# top IO list by user name: ";
-        out += it->c_str();
+        out += it->first.c_str();
         out += "\n";
         out += "# --------------------------------------------------------------------------------------\n";
       }
@@ -730,7 +863,7 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
       std::vector<std::string>::reverse_iterator sit;
       google::sparse_hash_map<uid_t, unsigned long long>::iterator tuit;
 
-      for (tuit = IostatUid[*it].begin(); tuit != IostatUid[*it].end(); tuit++) {
+      for (tuit = IostatUid[it->second].begin(); tuit != IostatUid[it->second].end(); tuit++) {
         sprintf(outline, "%020llu|%u\n", tuit->second, tuit->first);
         uidout.push_back(outline);
       }
@@ -763,11 +896,11 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
         }
 
         if (!monitoring) {
-          sprintf(outline, "[ %-16s ] %4s. %-10s %s\n", it->c_str(), stopplace.c_str(),
+          sprintf(outline, "[ %-16s ] %4s. %-10s %s\n", it->first.c_str(), stopplace.c_str(),
                   identifier, eos::common::StringConversion::GetReadableSizeString(sizestring,
                       strtoull(counter.c_str(), 0, 10), ""));
         } else {
-          sprintf(outline, "measurement=%s rank=%d uid=%s counter=%s\n", it->c_str(),
+          sprintf(outline, "measurement=%s rank=%d uid=%s counter=%s\n", it->first.c_str(),
                   topplace, identifier, counter.c_str());
         }
 
@@ -779,14 +912,14 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
       if (!monitoring) {
         out += "# --------------------------------------------------------------------------------------\n";
         out += "# top IO list by group name: ";
-        out += it->c_str();
+        out += it->first.c_str();
         out += "\n";
         out += "# --------------------------------------------------------------------------------------\n";
       }
 
       google::sparse_hash_map<gid_t, unsigned long long>::iterator tgit;
 
-      for (tgit = IostatGid[*it].begin(); tgit != IostatGid[*it].end(); tgit++) {
+      for (tgit = IostatGid[it->second].begin(); tgit != IostatGid[it->second].end(); tgit++) {
         sprintf(outline, "%020llu|%u\n", tgit->second, tgit->first);
         gidout.push_back(outline);
       }
@@ -819,11 +952,11 @@ Iostat::PrintOut(XrdOucString& out, bool summary, bool details,
         }
 
         if (!monitoring) {
-          sprintf(outline, "[ %-16s ] %4s. %-10s %s\n", it->c_str(), stopplace.c_str(),
+          sprintf(outline, "[ %-16s ] %4s. %-10s %s\n", it->first.c_str(), stopplace.c_str(),
                   identifier, eos::common::StringConversion::GetReadableSizeString(sizestring,
                       strtoull(counter.c_str(), 0, 10), ""));
         } else {
-          sprintf(outline, "measurement=%s rank=%d gid=%s counter=%s\n", it->c_str(),
+          sprintf(outline, "measurement=%s rank=%d gid=%s counter=%s\n", it->first.c_str(),
                   topplace, identifier, counter.c_str());
         }
 
@@ -1342,28 +1475,30 @@ Iostat::Store()
     return false;
   }
 
-  google::sparse_hash_map<std::string, google::sparse_hash_map<uid_t, unsigned long long> >::iterator
-  tuit;
-  google::sparse_hash_map<std::string, google::sparse_hash_map<uid_t, unsigned long long> >::iterator
-  tgit;
+  Merge();
+  std::vector<std::string> tagnames;
+  {
+    XrdSysMutexHelper tLock(TagMutex);
+    tagnames = IostatTagNames;
+  }
   Mutex.Lock();
 
   // store user counters
-  for (tuit = IostatUid.begin(); tuit != IostatUid.end(); tuit++) {
+  for (size_t tag = 0; tag < IostatUid.size() && tag < tagnames.size(); tag++) {
     google::sparse_hash_map<uid_t, unsigned long long>::iterator it;
 
-    for (it = tuit->second.begin(); it != tuit->second.end(); ++it) {
-      fprintf(fout, "tag=%s&uid=%u&val=%llu\n", tuit->first.c_str(), it->first,
+    for (it = IostatUid[tag].begin(); it != IostatUid[tag].end(); ++it) {
+      fprintf(fout, "tag=%s&uid=%u&val=%llu\n", tagnames[tag].c_str(), it->first,
               it->second);
     }
   }
 
   // store group counter
-  for (tgit = IostatGid.begin(); tgit != IostatGid.end(); tgit++) {
-    google::sparse_hash_map<uid_t, unsigned long long>::iterator it;
+  for (size_t tag = 0; tag < IostatGid.size() && tag < tagnames.size(); tag++) {
+    google::sparse_hash_map<gid_t, unsigned long long>::iterator it;
 
-    for (it = tgit->second.begin(); it != tgit->second.end(); ++it) {
-      fprintf(fout, "tag=%s&gid=%u&val=%llu\n", tgit->first.c_str(), it->first,
+    for (it = IostatGid[tag].begin(); it != IostatGid[tag].end(); ++it) {
+      fprintf(fout, "tag=%s&gid=%u&val=%llu\n", tagnames[tag].c_str(), it->first,
               it->second);
     }
   }
@@ -1399,16 +1534,18 @@ Iostat::Restore()
     XrdOucEnv env(line);
 
     if (env.Get("tag") && env.Get("uid") && env.Get("val")) {
-      std::string tag = env.Get("tag");
+      int tag = GetTagId(env.Get("tag"));
       uid_t uid = atoi(env.Get("uid"));
       unsigned long long val = strtoull(env.Get("val"), 0, 10);
+      ResizeTags(tag);
       IostatUid[tag][uid] = val;
     }
 
     if (env.Get("tag") && env.Get("gid") && env.Get("val")) {
-      std::string tag = env.Get("tag");
+      int tag = GetTagId(env.Get("tag"));
       gid_t gid = atoi(env.Get("gid"));
       unsigned long long val = strtoull(env.Get("val"), 0, 10);
+      ResizeTags(tag);
       IostatGid[tag][gid] = val;
     }
   }
@@ -1496,26 +1633,26 @@ Iostat::Circulate()
     sc++;
     XrdSysTimer sleeper;
     sleeper.Wait(512);
+    // fold the samples collected since the last round into the tables
+    Merge();
     Mutex.Lock();
-    google::sparse_hash_map<std::string, google::sparse_hash_map<uid_t, IostatAvg> >::iterator
-    tit;
     google::sparse_hash_map<std::string, IostatAvg >::iterator dit;
 
     // loop over tags
-    for (tit = IostatAvgUid.begin(); tit != IostatAvgUid.end(); ++tit) {
+    for (size_t tag = 0; tag < IostatAvgUid.size(); ++tag) {
       // loop over vids
       google::sparse_hash_map<uid_t, IostatAvg>::iterator it;
 
-      for (it = tit->second.begin(); it != tit->second.end(); ++it) {
+      for (it = IostatAvgUid[tag].begin(); it != IostatAvgUid[tag].end(); ++it) {
         it->second.StampZero();
       }
     }
 
-    for (tit = IostatAvgGid.begin(); tit != IostatAvgGid.end(); ++tit) {
+    for (size_t tag = 0; tag < IostatAvgGid.size(); ++tag) {
       // loop over vids
-      google::sparse_hash_map<uid_t, IostatAvg>::iterator it;
+      google::sparse_hash_map<gid_t, IostatAvg>::iterator it;
 
-      for (it = tit->second.begin(); it != tit->second.end(); ++it) {
+      for (it = IostatAvgGid[tag].begin(); it != IostatAvgGid[tag].end(); ++it) {
         it->second.StampZero();
       }
     }
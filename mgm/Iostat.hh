@@ -35,6 +35,8 @@
 #include <sys/types.h>
 #include <string>
 #include <set>
+#include <map>
+#include <vector>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -205,14 +207,11 @@ class Iostat
 private:
 
   XrdSysMutex Mutex;
-  google::sparse_hash_map<std::string, google::sparse_hash_map<uid_t, unsigned long long> >
-  IostatUid;
-  google::sparse_hash_map<std::string, google::sparse_hash_map<gid_t, unsigned long long> >
-  IostatGid;
-  google::sparse_hash_map<std::string, google::sparse_hash_map<uid_t, IostatAvg> >
-  IostatAvgUid;
-  google::sparse_hash_map<std::string, google::sparse_hash_map<gid_t, IostatAvg> >
-  IostatAvgGid;
+  // counters and averages by interned tag id, updated only by Merge
+  std::vector<google::sparse_hash_map<uid_t, unsigned long long> > IostatUid;
+  std::vector<google::sparse_hash_map<gid_t, unsigned long long> > IostatGid;
+  std::vector<google::sparse_hash_map<uid_t, IostatAvg> > IostatAvgUid;
+  std::vector<google::sparse_hash_map<gid_t, IostatAvg> > IostatAvgGid;
 
   google::sparse_hash_map<std::string, IostatAvg> IostatAvgDomainIOrb;
   google::sparse_hash_map<std::string, IostatAvg> IostatAvgDomainIOwb;
@@ -223,6 +222,44 @@ private:
   std::set<std::string> IoDomains;
   std::set<std::string> IoNodes;
 
+  // -----------------------------------------------------------
+  // tag strings are interned into integer ids (protected by TagMutex)
+  // -----------------------------------------------------------
+
+  XrdSysMutex TagMutex;
+  std::vector<std::string> IostatTagNames;
+  std::map<std::string, int> IostatTagIds;
+
+  // -----------------------------------------------------------
+  // reports are accumulated into a buffer of samples which is merged
+  // into the tables above by the circulation thread or before they are
+  // printed/stored, the collector only takes this::Mutex to merge when
+  // too many samples are pending
+  // -----------------------------------------------------------
+
+  struct IostatSample {
+    enum { kUidGid, kDomainRead, kDomainWrite, kAppRead, kAppWrite };
+    int kind;
+    int tag;
+    uid_t uid;
+    gid_t gid;
+    unsigned long val;
+    time_t starttime;
+    time_t stoptime;
+    std::string name; // domain or application name
+  };
+
+  static const size_t sMaxPendingSamples = 65536;
+
+  XrdSysMutex PendingMutex; // protects mPending
+  std::vector<IostatSample> mPending;
+  XrdSysMutex MergeMutex; // serializes Merge calls
+  std::vector<IostatSample> mMergeBuffer; // protected by MergeMutex
+
+  void Queue(const IostatSample& sample);
+  void ApplySample(const IostatSample& sample); // needs this::Mutex
+  void ResizeTags(int tag); // needs this::Mutex
+
   // -----------------------------------------------------------
   // here we handle the popularity history for the last 7+1 days
   // -----------------------------------------------------------
@@ -294,6 +331,15 @@ public:
   static const char* gIostatPopularity;
   static const char* gIostatUdpTargetList;
 
+  // counters of the FST reports, interned first so that their id is the value
+  enum ReportTag {
+    kBytesRead = 0, kBytesWritten, kReadCalls, kReadvCalls, kWriteCalls,
+    kFwdSeeks, kBwdSeeks, kXlFwdSeeks, kXlBwdSeeks, kBytesFwdSeek,
+    kBytesBwdSeek, kBytesXlFwdSeek, kBytesXlBwdSeek, kDiskTimeRead,
+    kDiskTimeWrite, kNumReportTags
+  };
+  static const char* gReportTagNames[kNumReportTags];
+
   pthread_t thread;
   pthread_t cthread;
   bool mRunning;
@@ -367,25 +413,47 @@ public:
 
   // stats collection
 
+  int GetTagId(const std::string& tag);
+
+  void
+  Add(int tag, uid_t uid, gid_t gid, unsigned long val, time_t starttime,
+      time_t stoptime)
+  {
+    IostatSample sample;
+    sample.kind = IostatSample::kUidGid;
+    sample.tag = tag;
+    sample.uid = uid;
+    sample.gid = gid;
+    sample.val = val;
+    sample.starttime = starttime;
+    sample.stoptime = stoptime;
+    Queue(sample);
+  }
+
   void
   Add(const char* tag, uid_t uid, gid_t gid, unsigned long val, time_t starttime,
       time_t stoptime)
   {
-    Mutex.Lock();
-    IostatUid[tag][uid] += val;
-    IostatGid[tag][gid] += val;
-    IostatAvgUid[tag][uid].Add(val, starttime, stoptime);
-    IostatAvgGid[tag][gid].Add(val, starttime, stoptime);
-    Mutex.UnLock();
+    Add(GetTagId(tag), uid, gid, val, starttime, stoptime);
   }
 
+  void AddDomain(const std::string& domain, unsigned long long rb,
+                 unsigned long long wb, time_t starttime, time_t stoptime);
+  void AddApp(const std::string& app, unsigned long long rb,
+              unsigned long long wb, time_t starttime, time_t stoptime);
+
+  // move all accumulated samples into the tables
+  void Merge();
+
+  // warning: you have to lock the mutex if directly used
+
   unsigned long long
-  GetTotal(const char* tag)
+  GetTotal(int tag)
   {
     google::sparse_hash_map<uid_t, unsigned long long>::const_iterator it;
     unsigned long long val = 0;
 
-    if (!IostatUid.count(tag)) {
+    if (tag >= (int) IostatUid.size()) {
       return 0;
     }
 
@@ -399,12 +467,12 @@ public:
   // warning: you have to lock the mutex if directly used
 
   double
-  GetTotalAvg86400(const char* tag)
+  GetTotalAvg86400(int tag)
   {
     google::sparse_hash_map<uid_t, IostatAvg>::iterator it;
     double val = 0;
 
-    if (!IostatAvgUid.count(tag)) {
+    if (tag >= (int) IostatAvgUid.size()) {
       return 0;
     }
 
@@ -418,12 +486,12 @@ public:
   // warning: you have to lock the mutex if directly used
 
   double
-  GetTotalAvg3600(const char* tag)
+  GetTotalAvg3600(int tag)
   {
     google::sparse_hash_map<uid_t, IostatAvg>::iterator it;
     double val = 0;
 
-    if (!IostatAvgUid.count(tag)) {
+    if (tag >= (int) IostatAvgUid.size()) {
       return 0;
     }
 
@@ -437,12 +505,12 @@ public:
   // warning: you have to lock the mutex if directly used
 
   double
-  GetTotalAvg300(const char* tag)
+  GetTotalAvg300(int tag)
   {
     google::sparse_hash_map<uid_t, IostatAvg>::iterator it;
     double val = 0;
 
-    if (!IostatAvgUid.count(tag)) {
+    if (tag >= (int) IostatAvgUid.size()) {
       return 0;
     }
 
@@ -456,12 +524,12 @@ public:
   // warning: you have to lock the mutex if directly used
 
   double
-  GetTotalAvg60(const char* tag)
+  GetTotalAvg60(int tag)
   {
     google::sparse_hash_map<uid_t, IostatAvg>::iterator it;
     double val = 0;
 
-    if (!IostatAvgUid.count(tag)) {
+    if (tag >= (int) IostatAvgUid.size()) {
       return 0;
     }
 
@@ -23,6 +23,7 @@
 
 #ifndef __EOSMGM_FASTTREE__H__
 #include "mgm/geotree/SchedulingTreeCommon.hh"
+#include "mgm/geotree/SchedulingSimd.hh"
 #include <cstddef>
 #include <ostream>
 #include <string>
@@ -35,6 +36,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <limits>
+#include <memory>
 #define __EOSMGM_FASTTREE__H__
 
 #define DEFINE_TREECOMMON_MACRO
@@ -687,6 +689,13 @@ public:
   {
     return s->dlScore < saturationThresh;
   }
+
+  inline void getSlotFilter(SlotFilter& f) const
+  {
+    f.disabledMask = SchedTreeBase::Disabled;
+    f.requiredMask = SchedTreeBase::Available | SchedTreeBase::Writable;
+    f.dlSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+  }
 };
 
 /*----------------------------------------------------------------------------*/
@@ -752,6 +761,14 @@ public:
   {
     return s->dlScore < saturationThresh;
   }
+
+  inline void getSlotFilter(SlotFilter& f) const
+  {
+    f.disabledMask = SchedTreeBase::Disabled;
+    f.requiredMask = SchedTreeBase::Available | SchedTreeBase::Writable |
+                     SchedTreeBase::Drainer;
+    f.dlSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+  }
 };
 
 /*----------------------------------------------------------------------------*/
@@ -806,6 +823,14 @@ public:
   {
     return s->dlScore < saturationThresh;
   }
+
+  inline void getSlotFilter(SlotFilter& f) const
+  {
+    f.disabledMask = SchedTreeBase::Disabled;
+    f.requiredMask = SchedTreeBase::Available | SchedTreeBase::Writable |
+                     SchedTreeBase::Balancer;
+    f.dlSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+  }
 };
 
 /*----------------------------------------------------------------------------*/
@@ -856,6 +881,13 @@ public:
   {
     return s->ulScore < saturationThresh;
   }
+
+  inline void getSlotFilter(SlotFilter& f) const
+  {
+    f.disabledMask = SchedTreeBase::Disabled;
+    f.requiredMask = SchedTreeBase::Available | SchedTreeBase::Readable;
+    f.ulSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+  }
 };
 
 /*----------------------------------------------------------------------------*/
@@ -896,6 +928,14 @@ public:
   {
     return s->ulScore < saturationThresh;
   }
+
+  inline void getSlotFilter(SlotFilter& f) const
+  {
+    f.disabledMask = SchedTreeBase::Disabled;
+    f.requiredMask = SchedTreeBase::Available | SchedTreeBase::Readable;
+    f.altRequiredMask = SchedTreeBase::Available | SchedTreeBase::Draining;
+    f.ulSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+  }
 };
 
 /*----------------------------------------------------------------------------*/
@@ -933,6 +973,14 @@ public:
   {
     return s->ulScore < saturationThresh || s->dlScore < saturationThresh;
   }
+
+  inline void getSlotFilter(SlotFilter& f) const
+  {
+    f.disabledMask = SchedTreeBase::Disabled;
+    f.requiredMask = SchedTreeBase::Available;
+    f.ulSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+    f.dlSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+  }
 };
 
 /*----------------------------------------------------------------------------*/
@@ -972,6 +1020,15 @@ public:
   {
     return s->ulScore < saturationThresh || s->dlScore < saturationThresh;
   }
+
+  inline void getSlotFilter(SlotFilter& f) const
+  {
+    f.disabledMask = SchedTreeBase::Disabled;
+    f.requiredMask = SchedTreeBase::Available | SchedTreeBase::Readable |
+                     SchedTreeBase::Writable;
+    f.ulSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+    f.dlSaturationThresh = SlotFilter::clampThresh(saturationThresh);
+  }
 };
 
 
@@ -2358,6 +2415,90 @@ public:
     }
   }
 
+  /**
+   * Pick a valid and unsaturated leaf among the branches [brchBegIdx,brchEndIdx[
+   * with the same distribution as the repeated calls to getRandomBranchGeneric
+   * in findFreeSlotSkipSaturated, but evaluating the slot predicates of all the
+   * candidates at once instead of retrying one random branch at a time.
+   * The non eligible leaves are marked as visited.
+   * @return -1 if the level is not suited (too narrow, too wide or not only
+   *         made of leaves), 0 if no leaf is eligible, 1 if newReplica is set
+   */
+  int
+  findFreeSlotInLeafLevel(tFastTreeIdx& newReplica,
+                          const tFastTreeIdx& brchBegIdx, const tFastTreeIdx& brchEndIdx,
+                          bool decrFreeSlot, bool* visited)
+  {
+    const size_t count = brchEndIdx - brchBegIdx;
+
+    if (!gSettings.vectorizedScoring || count < SlotCandidates::sMinCount ||
+        count > SlotCandidates::sMaxCount) {
+      return -1;
+    }
+
+    // the scratch space is too big for the stack of the scheduling threads
+    static thread_local SlotCandidates candidates;
+    SlotCandidates& c = candidates;
+
+    for (size_t k = 0; k < count; k++) {
+      const tFastTreeIdx nodeIdx = pBranches[brchBegIdx + k].sonIdx;
+      const FastTreeNode& node = pNodes[nodeIdx];
+
+      if (node.treeData.childrenCount) {
+        return -1;
+      }
+
+      c.nodeIdx[k] = nodeIdx;
+      c.status[k] = node.fsData.mStatus;
+      c.freeSlots[k] = node.fileData.freeSlotsCount;
+      c.ulScore[k] = node.fsData.ulScore;
+      c.dlScore[k] = node.fsData.dlScore;
+      c.visited[k] = visited[nodeIdx];
+      c.weight[k] = pRandVar(node.fsData, node.fileData);
+    }
+
+    c.count = count;
+    c.pad();
+    SlotFilter filter;
+    pBranchComp.getSlotFilter(filter);
+    int weightSum = scoreSlotCandidates(filter, c);
+    size_t picked = count;
+
+    if (weightSum) {
+      const int r = rand() % weightSum;
+
+      for (size_t k = 0, w = 0; k < count; k++) {
+        w += c.eligibleWeight[k];
+
+        if ((int) w > r) {
+          picked = k;
+          break;
+        }
+      }
+    }
+
+    // what is not picked now would be visited and rejected by the scalar walk
+    for (size_t k = 0; k < count; k++) {
+      if (!c.eligible[k]) {
+        visited[c.nodeIdx[k]] = true;
+      }
+    }
+
+    if (picked == count) {
+      return 0;
+    }
+
+    newReplica = c.nodeIdx[picked];
+    eos_static_debug("node %d is valid and unsaturated (vectorized)",
+                     (int)newReplica);
+
+    if (decrFreeSlot) {
+      decrementFreeSlot(newReplica, true);
+    }
+
+    return 1;
+  }
+
   bool
   findFreeSlotSkipSaturated(tFastTreeIdx& newReplica, tFastTreeIdx startFrom,
                             bool allowUpRoot, bool decrFreeSlot, bool* visited = NULL)
@@ -2365,10 +2506,18 @@ public:
     // initial call to allocate the visited array in the stack
     if (!visited) {
       // initialize children as non visited
-      // visited children (over allocated but it allows a static allocation)
-      bool localvisited[(256)^sizeof(tFastTreeIdx)];
+      // one flag per node of the tree, kept per thread to stay off the stack
+      static thread_local std::unique_ptr<bool[]> tlVisited;
+      static thread_local size_t tlVisitedSize = 0;
+
+      if (tlVisitedSize < pNodeCount) {
+        tlVisited.reset(new bool[pNodeCount]);
+        tlVisitedSize = pNodeCount;
+      }
+
+      bool* localvisited = tlVisited.get();
 
-      for (size_t t = 0; t < (256 ^ sizeof(tFastTreeIdx)); t++) {
+      for (size_t t = 0; t < pNodeCount; t++) {
         localvisited[t] = false;
       }
 
@@ -2450,9 +2599,17 @@ public:
             }
           } else {
             tFastTreeIdx nodeIdxToVisit = 0;
+            // wide levels of leaves are filtered in one pass
+            const int vecRet = findFreeSlotInLeafLevel(newReplica, begBrIdx, endBrIdx,
+                               decrFreeSlot, visited);
+
+            if (vecRet > 0) {
+              return true;
+            }
 
             // try until no branch is selectable
-            while (getRandomBranchGeneric(begBrIdx, endBrIdx, &nodeIdxToVisit, visited)) {
+            while (vecRet < 0 &&
+                   getRandomBranchGeneric(begBrIdx, endBrIdx, &nodeIdxToVisit, visited)) {
               // if only one branch, no need to call getRandomBranch
               if (findFreeSlotSkipSaturated(newReplica, nodeIdxToVisit, false, decrFreeSlot,
                                             visited)) {
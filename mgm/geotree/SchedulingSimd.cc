@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+// @file SchedulingSimd.cc
+// @author agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include "mgm/geotree/SchedulingSimd.hh"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define EOS_SCHEDSIMD_X86 1
+#include <immintrin.h>
+#endif
+
+EOSMGMNAMESPACE_BEGIN
+
+const size_t SlotCandidates::sMaxCount;
+const size_t SlotCandidates::sMinCount;
+
+int
+scoreSlotCandidatesScalar(const SlotFilter& f, SlotCandidates& c)
+{
+  int weightSum = 0;
+
+  for (size_t i = 0; i < c.count; i++) {
+    const int16_t st = c.status[i];
+    const bool statusOk = !(st & f.disabledMask) &&
+                          (((st & f.requiredMask) == f.requiredMask) ||
+                           (f.altRequiredMask &&
+                            ((st & f.altRequiredMask) == f.altRequiredMask)));
+    const bool ok = statusOk && (c.freeSlots[i] > 0) && !c.visited[i] &&
+                    !(c.ulScore[i] < f.ulSaturationThresh) &&
+                    !(c.dlScore[i] < f.dlSaturationThresh);
+    c.eligible[i] = ok ? -1 : 0;
+    c.eligibleWeight[i] = ok ? c.weight[i] : 0;
+    weightSum += c.eligibleWeight[i];
+  }
+
+  return weightSum;
+}
+
+#ifdef EOS_SCHEDSIMD_X86
+__attribute__((target("avx2"))) static int
+scoreSlotCandidatesAvx2(const SlotFilter& f, SlotCandidates& c)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi16(1);
+  const __m256i disabledMask = _mm256_set1_epi16(f.disabledMask);
+  const __m256i requiredMask = _mm256_set1_epi16(f.requiredMask);
+  const __m256i altRequiredMask = _mm256_set1_epi16(f.altRequiredMask);
+  const __m256i altEnabled = _mm256_set1_epi16(f.altRequiredMask ? -1 : 0);
+  const __m256i ulThresh = _mm256_set1_epi16(f.ulSaturationThresh);
+  const __m256i dlThresh = _mm256_set1_epi16(f.dlSaturationThresh);
+  __m256i acc = zero;
+  // the arrays are padded up to a multiple of 16 entries by the caller
+  const size_t n = (c.count + 15) & ~((size_t)15);
+
+  for (size_t i = 0; i < n; i += 16) {
+    const __m256i st = _mm256_load_si256((const __m256i*)(c.status + i));
+    const __m256i fs = _mm256_load_si256((const __m256i*)(c.freeSlots + i));
+    const __m256i ul = _mm256_load_si256((const __m256i*)(c.ulScore + i));
+    const __m256i dl = _mm256_load_si256((const __m256i*)(c.dlScore + i));
+    const __m256i vis = _mm256_load_si256((const __m256i*)(c.visited + i));
+    const __m256i w = _mm256_load_si256((const __m256i*)(c.weight + i));
+    __m256i ok = _mm256_cmpeq_epi16(_mm256_and_si256(st, disabledMask), zero);
+    const __m256i req = _mm256_cmpeq_epi16(_mm256_and_si256(st, requiredMask),
+                                           requiredMask);
+    const __m256i alt = _mm256_and_si256(altEnabled,
+                                         _mm256_cmpeq_epi16(_mm256_and_si256(st, altRequiredMask),
+                                             altRequiredMask));
+    ok = _mm256_and_si256(ok, _mm256_or_si256(req, alt));
+    ok = _mm256_and_si256(ok, _mm256_cmpgt_epi16(fs, zero));
+    ok = _mm256_and_si256(ok, _mm256_cmpeq_epi16(vis, zero));
+    // saturated when thresh > score
+    ok = _mm256_andnot_si256(_mm256_cmpgt_epi16(ulThresh, ul), ok);
+    ok = _mm256_andnot_si256(_mm256_cmpgt_epi16(dlThresh, dl), ok);
+    const __m256i ew = _mm256_and_si256(w, ok);
+    _mm256_store_si256((__m256i*)(c.eligible + i), ok);
+    _mm256_store_si256((__m256i*)(c.eligibleWeight + i), ew);
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(ew, ones));
+  }
+
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                            _mm256_extracti128_si256(acc, 1));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(s);
+}
+#endif
+
+typedef int (*tScoreKernel)(const SlotFilter&, SlotCandidates&);
+
+static tScoreKernel
+selectScoreKernel()
+{
+#ifdef EOS_SCHEDSIMD_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) {
+    return &scoreSlotCandidatesAvx2;
+  }
+
+#endif
+  return &scoreSlotCandidatesScalar;
+}
+
+static tScoreKernel
+scoreKernel()
+{
+  // resolved once, safe even if used during static initialization
+  static const tScoreKernel kernel = selectScoreKernel();
+  return kernel;
+}
+
+int
+scoreSlotCandidates(const SlotFilter& filter, SlotCandidates& candidates)
+{
+  return scoreKernel()(filter, candidates);
+}
+
+bool
+slotScoringHasAvx2()
+{
+  return scoreKernel() != &scoreSlotCandidatesScalar;
+}
+
+EOSMGMNAMESPACE_END
@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+// @file SchedulingSimd.hh
+// @author agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __EOSMGM_SCHEDULINGSIMD__H__
+#define __EOSMGM_SCHEDULINGSIMD__H__
+
+#include "mgm/Namespace.hh"
+#include <cstddef>
+#include <stdint.h>
+#include <limits>
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @file SchedulingSimd.hh
+ *
+ * @brief Vectorized evaluation of the slot predicates of a FastTree
+ *
+ * When a priority level of a FastTree is made of many leaves (typically a
+ * flat scheduling group with hundreds of file systems), the per-branch
+ * evaluation of isValidSlot / isSaturatedSlot dominates the placement time.
+ * The scheduling state of such a level is gathered into the structure of
+ * arrays defined here and all the candidates are filtered and weighted at
+ * once. An AVX2 kernel is used when the CPU supports it, a scalar kernel
+ * giving identical results is used otherwise.
+ *
+ */
+
+EOSMGMNAMESPACE_BEGIN
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @brief Description of the slot predicates of a priority comparator
+ *        A slot is eligible if it is not disabled, if its status contains
+ *        all the bits of requiredMask (or all the bits of altRequiredMask
+ *        when it is not zero), if it has a free slot, if it is not visited
+ *        yet and if none of its scores is below the matching threshold.
+ *
+ */
+/*----------------------------------------------------------------------------*/
+struct SlotFilter {
+  int16_t disabledMask;
+  int16_t requiredMask;
+  int16_t altRequiredMask;
+  int16_t ulSaturationThresh;
+  int16_t dlSaturationThresh;
+
+  SlotFilter() : disabledMask(0), requiredMask(0), altRequiredMask(0),
+    ulSaturationThresh(std::numeric_limits<int16_t>::min()),
+    dlSaturationThresh(std::numeric_limits<int16_t>::min())
+  {
+  }
+
+  // comparators use thresholds of various integer types, scores are chars
+  template<typename T>
+  static inline int16_t
+  clampThresh(const T& thresh)
+  {
+    const long t = (long) thresh;
+
+    if (t > std::numeric_limits<int16_t>::max()) {
+      return std::numeric_limits<int16_t>::max();
+    }
+
+    if (t < std::numeric_limits<int16_t>::min()) {
+      return std::numeric_limits<int16_t>::min();
+    }
+
+    return (int16_t) t;
+  }
+};
+
+/*----------------------------------------------------------------------------*/
+/**
+ * @brief Structure of arrays holding the scheduling state of the leaves of
+ *        one priority level. The arrays are over-allocated to a multiple of
+ *        the widest vector so the kernels never need a special tail.
+ *
+ */
+/*----------------------------------------------------------------------------*/
+struct SlotCandidates {
+  // above this width a level is handled by the regular scalar walk
+  static const size_t sMaxCount = 1024;
+  // below this width the gather costs more than it saves
+  static const size_t sMinCount = 16;
+
+  size_t count;
+  alignas(32) int16_t status[sMaxCount];
+  alignas(32) int16_t freeSlots[sMaxCount];
+  alignas(32) int16_t ulScore[sMaxCount];
+  alignas(32) int16_t dlScore[sMaxCount];
+  alignas(32) int16_t visited[sMaxCount];
+  alignas(32) int16_t weight[sMaxCount];
+  // outputs of the kernel
+  alignas(32) int16_t eligible[sMaxCount];
+  alignas(32) int16_t eligibleWeight[sMaxCount];
+  uint16_t nodeIdx[sMaxCount];
+
+  SlotCandidates() : count(0)
+  {
+  }
+
+  //! pad the arrays with non eligible entries up to the next vector width
+  inline void
+  pad()
+  {
+    for (size_t i = count; i < ((count + 15) & ~((size_t)15)); i++) {
+      status[i] = 0;
+      freeSlots[i] = 0;
+      ulScore[i] = dlScore[i] = 0;
+      visited[i] = 1;
+      weight[i] = 0;
+    }
+  }
+};
+
+//------------------------------------------------------------------------------
+//! Fill candidates.eligible (0 or -1) and candidates.eligibleWeight
+//! (weight masked by eligibility) and return the sum of the eligible weights.
+//! Dispatches to the AVX2 kernel when available.
+//------------------------------------------------------------------------------
+int scoreSlotCandidates(const SlotFilter& filter, SlotCandidates& candidates);
+
+//------------------------------------------------------------------------------
+//! Portable implementation of scoreSlotCandidates
+//------------------------------------------------------------------------------
+int scoreSlotCandidatesScalar(const SlotFilter& filter,
+                              SlotCandidates& candidates);
+
+//------------------------------------------------------------------------------
+//! Tell if the AVX2 kernel is used by scoreSlotCandidates
+//------------------------------------------------------------------------------
+bool slotScoringHasAvx2();
+
+EOSMGMNAMESPACE_END
+
+#endif /* __EOSMGM_SCHEDULINGSIMD__H__ */
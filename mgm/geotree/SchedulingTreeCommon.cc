@@ -31,7 +31,7 @@ EOSMGMNAMESPACE_BEGIN
 
 // static variables implementation
 SchedTreeBase::Settings SchedTreeBase::gSettings =
-{ 0 , 0};
+{ 0 , 0 , true};
 
 ostream& SchedTreeBase::TreeNodeInfo::display(ostream &os) const
 {
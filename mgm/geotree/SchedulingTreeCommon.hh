@@ -71,6 +71,7 @@ struct SchedTreeBase {
     //char fillRatioCompTol;
     size_t debugLevel;// 0(off)->3(full)
     size_t checkLevel;// 0(off)->3(full)
+    bool vectorizedScoring;// filter wide levels of leaves at once (SchedulingSimd.hh)
   };
 
   static Settings gSettings;
@@ -728,6 +728,37 @@ int mainFull()
          elapsed) / CLOCKS_PER_SEC)
        << " placements/sec " << endl;
   cout << "----------------------------" << endl << endl;
+
+  // same placement skipping the saturated slots, with and without the
+  // vectorized filtering of the wide levels of leaves
+  for (int vectorized = 0; vectorized < 2; vectorized++) {
+    SchedTreeBase::gSettings.vectorizedScoring = vectorized;
+    begin = clock();
+
+    for (size_t i = 0; i < schedGroups.size() * nbIter; i++) {
+      char buffer[bufferSize];
+      assert(fptrees[i % schedGroups.size()].copyToBuffer(buffer, bufferSize) == 0);
+      FastPlacementTree* ftree = (FastPlacementTree*) buffer;
+      SchedTreeBase::tFastTreeIdx repId;
+
+      for (int k = 0; k < 3; k++) {
+        ftree->findFreeSlot(repId, 0, false, true, true);
+      }
+    }
+
+    elapsed = clock() - begin;
+    cout << "REPLICA PLACEMENT SKIP SATURATED SPEED TEST ("
+         << (vectorized ? (slotScoringHasAvx2() ? "AVX2" : "VECTORIZED SCALAR") :
+             "SCALAR") << ")" << endl;
+    cout << "elapsed time : " << float (elapsed) / CLOCKS_PER_SEC << " sec." <<
+         endl;
+    cout << "speed        : " << 3 * schedGroups.size() * nbIter / (float (
+           elapsed) / CLOCKS_PER_SEC)
+         << " placements/sec " << endl;
+    cout << "----------------------------" << endl << endl;
+  }
+
+  SchedTreeBase::gSettings.vectorizedScoring = true;
   begin = clock();
 
   for (size_t i = 0; i < schedGroups.size() * nbIter; i++) {
@@ -112,8 +112,16 @@ ProcCommand::Fs()
         XrdOucString ds = pOpaque->Get("mgm.dumpmd.size");
         XrdOucString dt = pOpaque->Get("mgm.dumpmd.storetime");
         size_t entries = 0;
-        retc = proc_fs_dumpmd(fsidst, option, dp, df, ds, stdOut, stdErr, tident, *pVid,
-                              entries);
+
+        if (option == "b") {
+          // binary records used by the FSTs to resync their local database
+          const char* startfid = pOpaque->Get("mgm.dumpmd.startfid");
+          retc = proc_fs_dumpmd_binary(fsidst, startfid ? strtoull(startfid, 0, 10) : 0,
+                                       stdOut, stdErr, entries);
+        } else {
+          retc = proc_fs_dumpmd(fsidst, option, dp, df, ds, stdOut, stdErr, tident,
+                                *pVid, entries);
+        }
 
         if (!retc) {
           gOFS->MgmStats.Add("DumpMd", pVid->uid, pVid->gid, entries);
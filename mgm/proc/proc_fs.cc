@@ -26,8 +26,11 @@
 #include "common/LayoutId.hh"
 #include "common/StringConversion.hh"
 #include "common/Path.hh"
+#include "common/SymKeys.hh"
+#include "fst/FmdBase.pb.h"
 #include "mgm/ProcInterface.hh"
 #include "mgm/XrdMgmOfs.hh"
+#include <algorithm>
 
 EOSMGMNAMESPACE_BEGIN
 
@@ -277,6 +280,136 @@ proc_fs_dumpmd(std::string& fsidst, XrdOucString& option, XrdOucString& dp,
   return retc;
 }
 
+//------------------------------------------------------------------------------
+// Encode the metadata of a file as a record of the binary dump
+//------------------------------------------------------------------------------
+bool
+proc_fs_dumpmd_record(const eos::IFileMD& fmd, unsigned int fsid,
+                      XrdOucString& line)
+{
+  eos::IFileMD::ctime_t ctime;
+  eos::IFileMD::ctime_t mtime;
+  fmd.getCTime(ctime);
+  fmd.getMTime(mtime);
+  eos::fst::FmdBase record;
+  record.set_fid(fmd.getId());
+  record.set_cid(fmd.getContainerId());
+  record.set_fsid(fsid);
+  record.set_ctime(ctime.tv_sec);
+  record.set_ctime_ns(ctime.tv_nsec);
+  record.set_mtime(mtime.tv_sec);
+  record.set_mtime_ns(mtime.tv_nsec);
+  record.set_mgmsize(fmd.getSize());
+  record.set_lid(fmd.getLayoutId());
+  record.set_uid(fmd.getCUid());
+  record.set_gid(fmd.getCGid());
+  // Same location list as the env of the "m" dump
+  std::string locations;
+  char loc[16];
+
+  for (auto lit : fmd.getLocations()) {
+    snprintf(loc, sizeof(loc), "%u,", lit);
+    locations += loc;
+  }
+
+  for (auto lit : fmd.getUnlinkedLocations()) {
+    snprintf(loc, sizeof(loc), "!%u,", lit);
+    locations += loc;
+  }
+
+  record.set_locations(locations);
+  const eos::Buffer xs = fmd.getChecksum();
+  std::string checksum;
+  char hx[3];
+
+  for (size_t i = 0; i < xs.getSize(); i++) {
+    snprintf(hx, sizeof(hx), "%02x", *((unsigned char*)(xs.getDataPtr() + i)));
+    checksum += hx;
+  }
+
+  record.set_mgmchecksum(checksum.length() ? checksum : "none");
+  std::string buffer;
+  record.SerializeToString(&buffer);
+  return eos::common::SymKey::Base64Encode((char*) buffer.data(), buffer.size(),
+         line);
+}
+
+//------------------------------------------------------------------------------
+// Dump metadata information as binary records
+//------------------------------------------------------------------------------
+int
+proc_fs_dumpmd_binary(std::string& fsidst, unsigned long long startfid,
+                      XrdOucString& stdOut, XrdOucString& stdErr,
+                      size_t& entries)
+{
+  entries = 0;
+
+  if (!fsidst.length()) {
+    stdErr = "error: illegal parameters";
+    return EINVAL;
+  }
+
+  int fsid = atoi(fsidst.c_str());
+  eos::common::RWMutexReadLock nslock(gOFS->eosViewRWMutex);
+  // The files which have yet to be unlinked are dumped as well, like the "m"
+  // dump does, the FST keeps their records until the deletion arrives
+  std::vector<eos::IFileMD::id_t> fids;
+
+  try {
+    eos::IFsView::FileList filelist = gOFS->eosFsView->getFileList(fsid);
+    eos::IFsView::FileList unlinked = gOFS->eosFsView->getUnlinkedFileList(fsid);
+    fids.reserve(filelist.size() + unlinked.size());
+
+    for (auto it : filelist) {
+      if (it > startfid) {
+        fids.push_back(it);
+      }
+    }
+
+    for (auto it : unlinked) {
+      if (it > startfid) {
+        fids.push_back(it);
+      }
+    }
+  } catch (eos::MDException& e) {
+    errno = e.getErrno();
+    eos_static_err("Couldn't retrieve file list. Error code: %d, message: %s",
+                   e.getErrno(), e.getMessage().str().c_str());
+    return e.getErrno();
+  }
+
+  // Sorted so that a client can resume after the last file id it received
+  std::sort(fids.begin(), fids.end());
+  std::shared_ptr<eos::IFileMD> fmd;
+  XrdOucString line;
+
+  for (auto it : fids) {
+    try {
+      fmd = gOFS->eosFileService->getFileMD(it);
+    } catch (eos::MDException& e) {
+      eos_static_err("Couldn't retrieve meta data for file id: %llu. Error code: "
+                     "%d, message: %s", (unsigned long long) it, e.getErrno(),
+                     e.getMessage().str().c_str());
+      continue;
+    }
+
+    if (!proc_fs_dumpmd_record(*fmd, fsid, line)) {
+      stdErr = "error: failed to encode the meta data records";
+      return EIO;
+    }
+
+    stdOut += line;
+    stdOut += "\n";
+    entries++;
+  }
+
+  // Lets the client tell a complete dump from an interrupted one
+  stdOut += "#eof entries=";
+  stdOut += (int) entries;
+  stdOut += "\n";
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 // Configure filesystem
 //------------------------------------------------------------------------------
@@ -345,7 +478,9 @@ proc_fs_config(std::string& identifier, std::string& key, std::string& value,
            (eos::common::FileSystem::GetConfigStatusFromString(value.c_str()) !=
             eos::common::FileSystem::kUnknown)) ||
           (((key == "headroom") || (key == "scaninterval") || (key == "graceperiod") ||
-            (key == "drainperiod") || (key == "proxygroup") ||
+            (key == "drainperiod") || (key == "dbcachemb") ||
+            (key == "dbbloombits") || (key == "dbwritebuffermb") ||
+            (key == "proxygroup") ||
             (key == "filestickyproxydepth") || (key == "forcegeotag")))) {
         std::string nodename = fs->GetString("host");
         size_t dpos = 0;
@@ -362,7 +497,9 @@ proc_fs_config(std::string& identifier, std::string& key, std::string& value,
           retc = EPERM;
         } else {
           if ((key == "headroom") || (key == "scaninterval") ||
-              (key == "graceperiod") || (key == "drainperiod")) {
+              (key == "graceperiod") || (key == "drainperiod") ||
+              (key == "dbcachemb") || (key == "dbbloombits") ||
+              (key == "dbwritebuffermb")) {
             fs->SetLongLong(key.c_str(),
                             eos::common::StringConversion::GetSizeFromString(value.c_str()));
             FsView::gFsView.StoreFsConfig(fs);
@@ -29,6 +29,7 @@
 #include "common/Mapping.hh"
 #include "mgm/FileSystem.hh"
 #include "mgm/FsView.hh"
+#include "namespace/interface/IFileMD.hh"
 #include "XrdSec/XrdSecEntity.hh"
 
 EOSMGMNAMESPACE_BEGIN
@@ -59,6 +60,37 @@ int proc_fs_dumpmd(std::string& fsidst, XrdOucString& option, XrdOucString& dp,
                    eos::common::Mapping::VirtualIdentity& vid_in,
                    size_t& entries);
 
+//------------------------------------------------------------------------------
+//! Encode the metadata of a file as a record of the binary dump
+//!
+//! @param fmd file metadata
+//! @param fsid filesystem id of the dump
+//! @param line base64 encoded FmdBase record
+//!
+//! @return true if successful, otherwise false
+//------------------------------------------------------------------------------
+bool proc_fs_dumpmd_record(const eos::IFileMD& fmd, unsigned int fsid,
+                           XrdOucString& line);
+
+//------------------------------------------------------------------------------
+//! Dump metadata held on filesystem as base64 encoded FmdBase records, one per
+//! line in increasing order of file id and followed by an end of dump line.
+//! Like the "m" dump it includes the files which have yet to be unlinked from
+//! the filesystem, their locations list it as "!<fsid>".
+//!
+//! @param fsidst filesystem id
+//! @param startfid only files with an id greater than this one are dumped,
+//!        which allows a client to resume an interrupted dump
+//! @param stdOut output records
+//! @param stdErr error message
+//! @param entries number of records dumped
+//!
+//! @return 0 if successful, otherwise errno
+//------------------------------------------------------------------------------
+int proc_fs_dumpmd_binary(std::string& fsidst, unsigned long long startfid,
+                          XrdOucString& stdOut, XrdOucString& stdErr,
+                          size_t& entries);
+
 //------------------------------------------------------------------------------
 //! Dump metada held on filesystem
 //------------------------------------------------------------------------------
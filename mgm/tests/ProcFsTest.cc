@@ -24,6 +24,9 @@
 #include <gtest/gtest.h>
 #include "Namespace.hh"
 #include "mgm/proc/proc_fs.hh"
+#include "common/SymKeys.hh"
+#include "fst/FmdBase.pb.h"
+#include "namespace/ns_in_memory/FileMD.hh"
 
 EOSMGMTESTING_BEGIN
 
@@ -67,4 +70,101 @@ TEST(ProcFs, MvOpClassification)
               err));
 }
 
+//------------------------------------------------------------------------------
+// File metadata service which ignores the changes of the files
+//------------------------------------------------------------------------------
+class FileMDSvcStub: public eos::IFileMDSvc
+{
+public:
+  void initialize() {}
+  void configure(const std::map<std::string, std::string>& config) {}
+  void finalize() {}
+  std::shared_ptr<eos::IFileMD> getFileMD(eos::IFileMD::id_t id)
+  {
+    return nullptr;
+  }
+  std::shared_ptr<eos::IFileMD> createFile()
+  {
+    return nullptr;
+  }
+  void updateStore(eos::IFileMD* obj) {}
+  void removeFile(eos::IFileMD* obj) {}
+  uint64_t getNumFiles()
+  {
+    return 0;
+  }
+  void addChangeListener(eos::IFileMDChangeListener* listener) {}
+  void notifyListeners(eos::IFileMDChangeListener::Event* event) {}
+  void setQuotaStats(eos::IQuotaStats* quota_stats) {}
+  void setContMDService(eos::IContainerMDSvc* cont_svc) {}
+  void visit(eos::IFileVisitor* visitor) {}
+  eos::IFileMD::id_t getFirstFreeId()
+  {
+    return 1;
+  }
+};
+
+//------------------------------------------------------------------------------
+// Decode a record of the binary dump
+//------------------------------------------------------------------------------
+static eos::fst::FmdBase
+DecodeDumpRecord(XrdOucString& line)
+{
+  eos::fst::FmdBase record;
+  char* data = 0;
+  unsigned int len = 0;
+  EXPECT_TRUE(eos::common::SymKey::Base64Decode(line, data, len));
+  EXPECT_TRUE(record.ParseFromArray(data, len));
+  free(data);
+  return record;
+}
+
+//------------------------------------------------------------------------------
+// Test the records of the binary metadata dump
+//------------------------------------------------------------------------------
+TEST(ProcFs, DumpmdRecord)
+{
+  using namespace eos::mgm;
+  FileMDSvcStub svc;
+  eos::FileMD fmd(0x1234, &svc);
+  eos::IFileMD::ctime_t ctime = {1500000000, 11};
+  eos::IFileMD::ctime_t mtime = {1500000100, 22};
+  fmd.setCTime(ctime);
+  fmd.setMTime(mtime);
+  fmd.setContainerId(17);
+  fmd.setSize(4096);
+  fmd.setLayoutId(0x100002);
+  fmd.setCUid(1001);
+  fmd.setCGid(1002);
+  fmd.addLocation(3);
+  fmd.addLocation(5);
+  unsigned char xs[4] = {0xde, 0xad, 0xbe, 0xef};
+  fmd.setChecksum(xs, sizeof(xs));
+  XrdOucString line;
+  ASSERT_TRUE(proc_fs_dumpmd_record(fmd, 3, line));
+  eos::fst::FmdBase record = DecodeDumpRecord(line);
+  ASSERT_EQ(0x1234u, record.fid());
+  ASSERT_EQ(17u, record.cid());
+  ASSERT_EQ(3u, record.fsid());
+  ASSERT_EQ(1500000000u, record.ctime());
+  ASSERT_EQ(11u, record.ctime_ns());
+  ASSERT_EQ(1500000100u, record.mtime());
+  ASSERT_EQ(22u, record.mtime_ns());
+  ASSERT_EQ(4096u, record.mgmsize());
+  ASSERT_EQ(0x100002u, record.lid());
+  ASSERT_EQ(1001u, record.uid());
+  ASSERT_EQ(1002u, record.gid());
+  ASSERT_EQ("3,5,", record.locations());
+  ASSERT_EQ("deadbeef", record.mgmchecksum());
+  // Unlinked locations are listed like in the "m" dump, a file without
+  // checksum gets "none"
+  fmd.unlinkLocation(5);
+  fmd.setChecksum(xs, 0);
+  ASSERT_TRUE(proc_fs_dumpmd_record(fmd, 5, line));
+  record = DecodeDumpRecord(line);
+  ASSERT_EQ(5u, record.fsid());
+  ASSERT_EQ("3,!5,", record.locations());
+  ASSERT_EQ("none", record.mgmchecksum());
+}
+
 EOSMGMTESTING_END
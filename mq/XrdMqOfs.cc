@@ -92,9 +92,13 @@ STRINGSTORE(const char* __charptr__)
   }
 }
 
-XrdMqOfsOutMutex::XrdMqOfsOutMutex()
+XrdMqOfsOutMutex::XrdMqOfsOutMutex(bool exclusive)
 {
-  gMqFS->QueueOutMutex.Lock();
+  if (exclusive) {
+    gMqFS->QueueOutMutex.WriteLock();
+  } else {
+    gMqFS->QueueOutMutex.ReadLock();
+  }
 }
 
 XrdMqOfsOutMutex::~XrdMqOfsOutMutex()
@@ -118,7 +122,11 @@ XrdMqOfs::XrdMqOfs(XrdSysError* ep):
   AdvisoryMessages = 0;
   UndeliverableMessages = 0;
   DiscardedMonitoringMessages = 0;
-  BacklogDeferred = NoMessages = QueueBacklogHits = 0;
+  BacklogDeferred = 0;
+  NoMessages = 0;
+  QueueBacklogHits = 0;
+  QueuedDeliveries = 0;
+  QueueBacklog = 0;
   MaxMessageBacklog  = MQOFSMAXMESSAGEBACKLOG;
   MaxQueueBacklog    = MQOFSMAXQUEUEBACKLOG;
   RejectQueueBacklog = MQOFSREJECTQUEUEBACKLOG;
@@ -277,7 +285,7 @@ XrdMqOfs::stat(const char*                queuename,
   {
     XrdMqOfsOutMutex qm;
 
-    if ((!gMqFS->QueueOut.count(squeue)) || (!(Out = gMqFS->QueueOut[squeue]))) {
+    if (!(Out = gMqFS->QueueOut.Find(squeue))) {
       return gMqFS->Emsg(epname, error, EINVAL, "check queue - no such queue");
     }
 
@@ -361,7 +369,7 @@ XrdMqOfsFile::open(const char*                queuename,
   tident = error.getErrUser();
   MAYREDIRECT;
   ZTRACE(open, "Connecting Queue: " << queuename);
-  XrdMqOfsOutMutex qm;
+  XrdMqOfsOutMutex qm(true);
   QueueName = queuename;
   std::string squeue = queuename;
 
@@ -373,7 +381,7 @@ XrdMqOfsFile::open(const char*                queuename,
                        "connect queue - the broker does not serve the requested queue");
   }
 
-  if (gMqFS->QueueOut.count(squeue)) {
+  if (gMqFS->QueueOut.Find(squeue)) {
     fprintf(stderr, "EBUSY: Queue %s is busy\n", QueueName.c_str());
     // this is already open by 'someone'
     return gMqFS->Emsg(epname, error, EBUSY, "connect queue - already connected",
@@ -404,7 +412,9 @@ XrdMqOfsFile::open(const char*                queuename,
   Out->AdvisoryQuery  = advisoryquery;
   Out->AdvisoryFlushBackLog = advisoryflushbacklog;
   Out->BrokenByFlush = false;
-  gMqFS->QueueOut.insert(std::pair<std::string, XrdMqMessageOut*>(squeue, Out));
+  gMqFS->QueueOut.Insert(squeue, Out,
+                         (advisorystatus ? XrdMqOfs::kSubscribeAdvisoryStatus : 0) |
+                         (advisoryquery ? XrdMqOfs::kSubscribeAdvisoryQuery : 0));
   ZTRACE(open, "Connected Queue: " << queuename);
   IsOpen = true;
   return SFS_OK;
@@ -422,15 +432,15 @@ XrdMqOfsFile::close()
   ZTRACE(close, "Disconnecting Queue: " << QueueName.c_str());
   std::string squeue = QueueName.c_str();
   {
-    XrdMqOfsOutMutex qm;
+    XrdMqOfsOutMutex qm(true);
 
-    if ((gMqFS->QueueOut.count(squeue)) && (Out = gMqFS->QueueOut[squeue])) {
+    if ((Out = gMqFS->QueueOut.Find(squeue))) {
       // hmm this could create a dead lock
       //      Out->DeletionSem.Wait();
       Out->Lock();
       // we have to take away all pending messages
       Out->RetrieveMessages();
-      gMqFS->QueueOut.erase(squeue);
+      gMqFS->QueueOut.Remove(squeue);
       delete Out;
     }
 
@@ -723,14 +733,14 @@ XrdMqOfs::Statistics()
   static struct timezone tz;
   static long long LastReceivedMessages, LastDeliveredMessages,
          LastFanOutMessages, LastAdvisoryMessages, LastUndeliverableMessages,
-         LastNoMessages, LastDiscardedMonitoringMessages;
+         LastNoMessages, LastDiscardedMonitoringMessages, LastQueuedDeliveries;
 
   if (startup) {
     tstart.tv_sec = 0;
     tstart.tv_usec = 0;
     LastReceivedMessages = LastDeliveredMessages = LastFanOutMessages =
                              LastAdvisoryMessages = LastUndeliverableMessages = LastNoMessages =
-                                   LastDiscardedMonitoringMessages = 0;
+                                   LastDiscardedMonitoringMessages = LastQueuedDeliveries = 0;
     startup = false;
   }
 
@@ -749,6 +759,17 @@ XrdMqOfs::Statistics()
 
   if (tdiff > (10 * 1000)) {
     // every minute
+    int maxQueueBacklog = 0;
+    {
+      XrdMqOfsOutMutex qm;
+
+      for (XrdMqSubscriptionIndex<XrdMqMessageOut>::const_iterator it =
+             QueueOut.begin(); it != QueueOut.end(); ++it) {
+        if (it->second->nQueued > maxQueueBacklog) {
+          maxQueueBacklog = it->second->nQueued;
+        }
+      }
+    }
     XrdOucString tmpfile = StatisticsFile;
     tmpfile += ".tmp";
     int fd = open(tmpfile.c_str(), O_CREAT | O_RDWR | O_TRUNC,
@@ -757,25 +778,31 @@ XrdMqOfs::Statistics()
     if (fd >= 0) {
       char line[4096];
       int rc;
-      sprintf(line, "mq.received               %lld\n", ReceivedMessages);
+      sprintf(line, "mq.received               %lld\n", ReceivedMessages.load());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.delivered              %lld\n", DeliveredMessages);
+      sprintf(line, "mq.delivered              %lld\n", DeliveredMessages.load());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.fanout                 %lld\n", FanOutMessages);
+      sprintf(line, "mq.fanout                 %lld\n", FanOutMessages.load());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.advisory               %lld\n", AdvisoryMessages);
+      sprintf(line, "mq.advisory               %lld\n", AdvisoryMessages.load());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.undeliverable          %lld\n", UndeliverableMessages);
+      sprintf(line, "mq.undeliverable          %lld\n", UndeliverableMessages.load());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.droppedmonitoring      %lld\n", DiscardedMonitoringMessages);
+      sprintf(line, "mq.droppedmonitoring      %lld\n", DiscardedMonitoringMessages.load());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.total                  %lld\n", NoMessages);
+      sprintf(line, "mq.total                  %lld\n", NoMessages.load());
       rc = write(fd, line, strlen(line));
       sprintf(line, "mq.queued                 %d\n", (int)Messages.size());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.nqueues                %d\n", (int)QueueOut.size());
+      sprintf(line, "mq.nqueues                %d\n", (int)QueueOut.Size());
+      rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.backloghits            %lld\n", QueueBacklogHits.load());
       rc = write(fd, line, strlen(line));
-      sprintf(line, "mq.backloghits            %lld\n", QueueBacklogHits);
+      sprintf(line, "mq.deliveries             %lld\n", QueuedDeliveries.load());
+      rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.backlog                %lld\n", QueueBacklog.load());
+      rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.maxqueuebacklog        %d\n", maxQueueBacklog);
       rc = write(fd, line, strlen(line));
       sprintf(line, "mq.in_rate                %f\n",
               (1000.0 * (ReceivedMessages - LastReceivedMessages) / (tdiff)));
@@ -799,6 +826,9 @@ XrdMqOfs::Statistics()
       sprintf(line, "mq.total_rate             %f\n",
               (1000.0 * (NoMessages - LastNoMessages) / (tdiff)));
       rc = write(fd, line, strlen(line));
+      sprintf(line, "mq.delivery_rate          %f\n",
+              (1000.0 * (QueuedDeliveries - LastQueuedDeliveries) / (tdiff)));
+      rc = write(fd, line, strlen(line));
       close(fd);
       rc = ::rename(tmpfile.c_str(), StatisticsFile.c_str());
 
@@ -819,12 +849,15 @@ XrdMqOfs::Statistics()
            DiscardedMonitoringMessages);
     ZTRACE(getstats, "No        Messages            : " << NoMessages);
     ZTRACE(getstats, "Queue     Messages            : " << Messages.size());
-    ZTRACE(getstats, "#Queues                       : " << QueueOut.size());
+    ZTRACE(getstats, "#Queues                       : " << QueueOut.Size());
     ZTRACE(getstats, "Deferred  Messages (backlog)  : " << BacklogDeferred);
     ZTRACE(getstats, "Backlog   Messages Hits       : " << QueueBacklogHits);
+    ZTRACE(getstats, "Queued    Deliveries          : " << QueuedDeliveries);
+    ZTRACE(getstats, "Queue     Backlog (max)       : " << QueueBacklog << " ("
+           << maxQueueBacklog << ")");
     char rates[4096];
     sprintf(rates,
-            "Rates: IN: %.02f OUT: %.02f FAN: %.02f ADV: %.02f: UNDEV: %.02f DISCMON: %.02f NOMSG: %.02f"
+            "Rates: IN: %.02f OUT: %.02f FAN: %.02f ADV: %.02f: UNDEV: %.02f DISCMON: %.02f NOMSG: %.02f DLV: %.02f"
             , (1000.0 * (ReceivedMessages - LastReceivedMessages) / (tdiff))
             , (1000.0 * (DeliveredMessages - LastDeliveredMessages) / (tdiff))
             , (1000.0 * (FanOutMessages - LastFanOutMessages) / (tdiff))
@@ -832,7 +865,8 @@ XrdMqOfs::Statistics()
             , (1000.0 * (UndeliverableMessages - LastUndeliverableMessages) / (tdiff))
             , (1000.0 * (DiscardedMonitoringMessages - LastDiscardedMonitoringMessages) /
                (tdiff))
-            , (1000.0 * (NoMessages - LastNoMessages) / (tdiff)));
+            , (1000.0 * (NoMessages - LastNoMessages) / (tdiff))
+            , (1000.0 * (QueuedDeliveries - LastQueuedDeliveries) / (tdiff)));
     ZTRACE(getstats, rates);
     ZTRACE(getstats, "*****************************************************");
     LastOutputTime = now;
@@ -843,6 +877,7 @@ XrdMqOfs::Statistics()
     LastUndeliverableMessages = UndeliverableMessages;
     LastNoMessages = NoMessages;
     LastDiscardedMonitoringMessages = DiscardedMonitoringMessages;
+    LastQueuedDeliveries = QueuedDeliveries;
   }
 
   StatLock.UnLock();
@@ -40,6 +40,7 @@
 #include <string>
 #include <vector>
 #include <deque>
+#include <atomic>
 
 #include <utime.h>
 #include <pwd.h>
@@ -58,6 +59,7 @@
 #include "XrdAcc/XrdAccAuthorize.hh"
 #include "XrdOfs/XrdOfs.hh"
 #include "Xrd/XrdScheduler.hh"
+#include "mq/XrdMqSubscriptionIndex.hh"
 
 
 // if we have too many messages pending we don't take new ones for the moment
@@ -76,30 +78,31 @@
 class XrdSysError;
 class XrdSysLogger;
 
+//------------------------------------------------------------------------------
+//! Message shared by all the output queues it is delivered to. The content is
+//! immutable once created, the last queue releasing it deletes it.
+//------------------------------------------------------------------------------
 class XrdSmartOucEnv : public XrdOucEnv
 {
 private:
-  int nref;
+  std::atomic<int> nref;
 public:
-  XrdSysMutex procmutex;
-
   int  Refs()
   {
-    return nref;
+    return nref.load();
   }
-  void DecRefs()
+  //! @return number of references left
+  int DecRefs()
   {
-    nref--;
+    return --nref;
   }
   void AddRefs(int nrefs)
   {
-    ;
     nref += nrefs;
   }
   XrdSmartOucEnv(const char* vardata = 0, int vardlen = 0) : XrdOucEnv(vardata,
-        vardlen)
+        vardlen), nref(0)
   {
-    nref = 0;
   }
 
   virtual ~XrdSmartOucEnv() {}
@@ -142,7 +145,7 @@ public:
   bool AdvisoryQuery;
   bool AdvisoryFlushBackLog;
   bool BrokenByFlush;
-  int  nQueued;
+  std::atomic<int> nQueued;
   XrdOucString QueueName;
   XrdSysSemWait DeletionSem;
   XrdSysSemWait MessageSem;
@@ -265,10 +268,15 @@ private:
 };
 
 
+//------------------------------------------------------------------------------
+//! Scoped lock of the output queue table: deliveries and lookups share it,
+//! only connecting/disconnecting a queue takes it exclusively. The queues
+//! themselves are protected by their own mutex.
+//------------------------------------------------------------------------------
 class XrdMqOfsOutMutex
 {
 public:
-  XrdMqOfsOutMutex();
+  XrdMqOfsOutMutex(bool exclusive = false);
   ~XrdMqOfsOutMutex();
 };
 
@@ -326,13 +334,21 @@ public:
   QueueAdvisory;      // -> "<queueprefix>/*" for advisory message matches
   XrdOucString     BrokerId;           // -> manger id + queue name as path
 
-  std::map<std::string, XrdMqMessageOut*>
-  QueueOut;  // -> hash of all output's connected
-  XrdSysMutex
-  QueueOutMutex;  // -> mutex protecting the output hash
+  // subscription flags of the output queues in the QueueOut index
+  enum {
+    kSubscribeAdvisoryStatus = 1 << 0,
+    kSubscribeAdvisoryQuery = 1 << 1
+  };
+
+  XrdMqSubscriptionIndex<XrdMqMessageOut>
+  QueueOut;  // -> index of all output's connected
+  XrdSysRWLock
+  QueueOutMutex;  // -> lock protecting the output index
 
   bool             Deliver(XrdMqOfsMatches&
                            Match); // -> delivers a message into matching output queues
+  void             ReleaseMessage(XrdSmartOucEnv*
+                                  message); // -> drops one reference of a delivered message
 
   std::map<std::string, XrdSmartOucEnv*> Messages;  // -> hash with all messages
 
@@ -401,15 +417,17 @@ public:
   XrdSysMutex  StatLock;
   time_t       StartupTime;
   time_t       LastOutputTime;
-  long long    ReceivedMessages;
-  long long    DeliveredMessages;
-  long long    FanOutMessages;
-  long long    AdvisoryMessages;
-  long long    UndeliverableMessages;
-  long long    DiscardedMonitoringMessages;
-  long long    NoMessages;
-  long long    BacklogDeferred;
-  long long    QueueBacklogHits;
+  std::atomic<long long> ReceivedMessages;
+  std::atomic<long long> DeliveredMessages;
+  std::atomic<long long> FanOutMessages;
+  std::atomic<long long> AdvisoryMessages;
+  std::atomic<long long> UndeliverableMessages;
+  std::atomic<long long> DiscardedMonitoringMessages;
+  std::atomic<long long> NoMessages;
+  std::atomic<long long> BacklogDeferred;
+  std::atomic<long long> QueueBacklogHits;
+  std::atomic<long long> QueuedDeliveries; // -> messages appended to an output queue
+  std::atomic<long long> QueueBacklog;     // -> messages waiting in all output queues
   long long    MaxMessageBacklog;
   long long    MaxQueueBacklog;
   long long    RejectQueueBacklog;
@@ -44,97 +44,33 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
   std::string sendername = Matches.sendername.c_str();
   // here we store all the queues where we need to deliver this message
   std::vector<XrdMqMessageOut*> MatchedOutputQueues;
-  Matches.message->procmutex.Lock();
 
-  // If we have a status message we have to do a complete loop
-  if (((Matches.messagetype) == XrdMqMessageHeader::kStatusMessage) ||
-      ((Matches.messagetype) == XrdMqMessageHeader::kQueryMessage)) {
-    std::map<std::string, XrdMqMessageOut*>::const_iterator QueueOutIt;
-
-    for (QueueOutIt = QueueOut.begin(); QueueOutIt != QueueOut.end();
-         QueueOutIt++) {
-      XrdMqMessageOut* Out = QueueOutIt->second;
-
-      // if this would be a loop back message we continue
-      if (sendername == QueueOutIt->first) {
-        // avoid feedback to the same queue
-        continue;
-      }
-
-      // if this queue does not take advisory status messages we continue
-      if ((Matches.messagetype == XrdMqMessageHeader::kStatusMessage) &&
-          (!Out->AdvisoryStatus)) {
-        continue;
-      }
-
-      // if this queue does not take advisory query messages we continue
-      if ((Matches.messagetype == XrdMqMessageHeader::kQueryMessage)  &&
-          (!Out->AdvisoryQuery)) {
-        continue;
-      } else {
-        ZTRACE(fsctl, "Adding Advisory Message to Queuename: " <<
-               Out->QueueName.c_str());
-        MatchedOutputQueues.push_back(Out);
-      }
-    }
+  // Status and query messages go to the queues subscribed to these advisories,
+  // anything else is matched by name or wildcard through the queue index
+  if ((Matches.messagetype) == XrdMqMessageHeader::kStatusMessage) {
+    QueueOut.MatchFlag(kSubscribeAdvisoryStatus, sendername, MatchedOutputQueues);
+  } else if ((Matches.messagetype) == XrdMqMessageHeader::kQueryMessage) {
+    QueueOut.MatchFlag(kSubscribeAdvisoryQuery, sendername, MatchedOutputQueues);
   } else {
-    // If we have a wildcard match we have to do a complete loop
-    if ((Matches.queuename.find("*") != STR_NPOS)) {
-      std::map<std::string, XrdMqMessageOut*>::const_iterator QueueOutIt;
-
-      for (QueueOutIt = QueueOut.begin(); QueueOutIt != QueueOut.end();
-           QueueOutIt++) {
-        XrdMqMessageOut* Out = QueueOutIt->second;
-
-        // fprintf(stderr,"%s <=> %s\n", sendername.c_str(), QueueOutIt->first.c_str());
-        // If this would be a loop back message we continue
-        if (sendername == QueueOutIt->first) {
-          // avoid feedback to the same queue
-          continue;
-        }
-
-        XrdOucString Key = QueueOutIt->first.c_str();
-        XrdOucString nowildcard = Matches.queuename;
-        nowildcard.replace("*", "");
-        int nmatch = Key.matches(Matches.queuename.c_str(), '*');
-
-        if (nmatch == nowildcard.length()) {
-          // this is a match
-          ZTRACE(fsctl, "Adding Wildcard matched Message to Queuename: "
-                 << Out->QueueName.c_str());
-          MatchedOutputQueues.push_back(Out);
-        }
-      }
-    } else {
-      // We have just to find one named queue
-      std::string queuename = Matches.queuename.c_str();
-      XrdMqMessageOut* Out = 0;
-
-      if (QueueOut.count(queuename)) {
-        Out = QueueOut[queuename];
-      }
-
-      if (Out) {
-        ZTRACE(fsctl, "Adding full matched Message to Queuename: " <<
-               Out->QueueName.c_str());
-        MatchedOutputQueues.push_back(Out);
-      }
-    }
+    QueueOut.Match(Matches.queuename.c_str(), sendername, MatchedOutputQueues);
   }
 
+  ZTRACE(fsctl, "Matched " << (int) MatchedOutputQueues.size() <<
+         " queues for " << Matches.queuename.c_str());
+
   // This is a match
   if (MatchedOutputQueues.size()) {
     Matches.backlog = false;
     Matches.backlogrejected = false;
+    // Hold a reference while fanning out: a consumer may already release the
+    // message from a queue before we append it to the next one
+    Matches.message->AddRefs(1);
 
-    // Lock all matched queues at once
-    for (unsigned int i = 0; i < MatchedOutputQueues.size(); ++i) {
-      XrdMqMessageOut* Out = MatchedOutputQueues[i];
-      Out->Lock();
-    }
-
+    // Queues are locked one at a time, the shared lock on the queue index
+    // keeps them alive and deliveries to other queues run concurrently
     for (unsigned int i = 0; i < MatchedOutputQueues.size(); ++i) {
       XrdMqMessageOut* Out = MatchedOutputQueues[i];
+      XrdSysMutexHelper outLock(*Out);
 
       // check for backlog on this queue and set a warning flag
       if (Out->nQueued > MaxQueueBacklog) {
@@ -197,24 +133,25 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
           }
 
           ZTRACE(fsctl, "Adding Message to Queuename: " << Out->QueueName.c_str());
-          // fprintf(stderr, "%s adding message %llu\n",
-          // Out->QueueName.c_str(), (unsigned long long)Matches.message);
-          Out->MessageQueue.push_back((Matches.message));
+          // the same message object is shared by all the queues
           Matches.message->AddRefs(1);
+          Out->MessageQueue.push_back((Matches.message));
           Out->nQueued++;
+          gMqFS->QueuedDeliveries++;
+          gMqFS->QueueBacklog++;
         }
       }
     }
 
-    // Unlock all matched queues at once
-    for (unsigned int i = 0; i < MatchedOutputQueues.size(); ++i) {
-      XrdMqMessageOut* Out = MatchedOutputQueues[i];
-      Out->UnLock();
+    if (Matches.matches) {
+      // drop the fan-out reference, the queues own the message now
+      ReleaseMessage(Matches.message);
+    } else {
+      // nobody took it, the caller keeps the ownership
+      Matches.message->DecRefs();
     }
   }
 
-  Matches.message->procmutex.UnLock();
-
   if (Matches.matches > 0) {
     return true;
   } else {
@@ -222,6 +159,20 @@ XrdMqOfs::Deliver(XrdMqOfsMatches& Matches)
   }
 }
 
+void
+XrdMqOfs::ReleaseMessage(XrdSmartOucEnv* message)
+{
+  if (message->DecRefs() <= 0) {
+    // we can delete this message from the queue!
+    XrdOucString msg = message->Get(XMQHEADER);
+    MessagesMutex.Lock();
+    Messages.erase(msg.c_str());
+    MessagesMutex.UnLock();
+    delete message;
+    FanOutMessages++;
+  }
+}
+
 size_t
 XrdMqMessageOut::RetrieveMessages()
 {
@@ -230,28 +181,12 @@ XrdMqMessageOut::RetrieveMessages()
   while (MessageQueue.size()) {
     message = MessageQueue.front();
     MessageQueue.pop_front();
-    message->procmutex.Lock();
-    //    fprintf(stderr,"%llu %s Message %llu nref: %d\n", (unsigned long long) &MessageQueue, QueueName.c_str(), (unsigned long long) message, message->Refs());
     int len;
     MessageBuffer += message->Env(len);
-    gMqFS->MessagesMutex.Lock();
     gMqFS->DeliveredMessages++;
-    message->DecRefs();
-
-    if (message->Refs() <= 0) {
-      // we can delete this message from the queue!
-      XrdOucString msg = message->Get(XMQHEADER);
-      gMqFS->Messages.erase(msg.c_str());
-      message->procmutex.UnLock();
-      //      fprintf(stderr,"%s delete %llu \n", QueueName.c_str(), (unsigned long long) message);
-      delete message;
-      gMqFS->FanOutMessages++;
-    } else {
-      message->procmutex.UnLock();
-    }
-
     nQueued--;
-    gMqFS->MessagesMutex.UnLock();
+    gMqFS->QueueBacklog--;
+    gMqFS->ReleaseMessage(message);
   }
 
   return MessageBuffer.length();
@@ -363,7 +298,7 @@ XrdMqOfs::FSctl(const int               cmd,
 
     TRACES(backlogmessage.c_str());
 
-    if (!matches.message->Refs()) {
+    if (!matches.matches) {
       delete env;
     }
 
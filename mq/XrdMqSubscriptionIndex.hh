@@ -0,0 +1,278 @@
+// ----------------------------------------------------------------------
+// File: XrdMqSubscriptionIndex.hh
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#ifndef __XRDMQ_SUBSCRIPTIONINDEX_HH__
+#define __XRDMQ_SUBSCRIPTIONINDEX_HH__
+
+#include <map>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//! Class XrdMqSubscriptionIndex - indexed table of the connected queues
+//!
+//! Receiver queue names used by the broker are either plain names or '*'
+//! wildcard patterns like "/eos/*/fst" or "/xmessage/*". Instead of testing
+//! every connected queue against the pattern, the candidates are restricted
+//! to the queues sharing the literal prefix of the pattern (ordered index on
+//! the names) or its literal suffix (ordered index on the reversed names),
+//! whichever range is smaller, and only those are matched against the full
+//! pattern. Each queue can also carry subscription flags (e.g. advisory
+//! status/query) with one index per flag, so flag based broadcasts only visit
+//! the subscribers.
+//!
+//! The class is not thread-safe, the caller serializes modifications against
+//! lookups.
+//------------------------------------------------------------------------------
+template<typename T>
+class XrdMqSubscriptionIndex
+{
+public:
+  static const int sMaxFlags = 8;
+  typedef typename std::map<std::string, T*>::const_iterator const_iterator;
+
+  //----------------------------------------------------------------------------
+  //! Add a queue, returns false if a queue with this name already exists
+  //!
+  //! @param name queue name
+  //! @param value queue object
+  //! @param flags bit mask of subscription flags (bits < sMaxFlags)
+  //----------------------------------------------------------------------------
+  bool Insert(const std::string& name, T* value, int flags = 0)
+  {
+    std::pair<typename std::map<std::string, T*>::iterator, bool> res =
+      mByName.insert(std::make_pair(name, value));
+
+    if (!res.second) {
+      return false;
+    }
+
+    mByReversedName[Reverse(name)] = res.first;
+    mFlags[name] = flags;
+
+    for (int i = 0; i < sMaxFlags; ++i) {
+      if (flags & (1 << i)) {
+        mByFlag[i][name] = value;
+      }
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Remove a queue, returns false if it does not exist
+  //----------------------------------------------------------------------------
+  bool Remove(const std::string& name)
+  {
+    typename std::map<std::string, int>::iterator it = mFlags.find(name);
+
+    if (it == mFlags.end()) {
+      return false;
+    }
+
+    for (int i = 0; i < sMaxFlags; ++i) {
+      if (it->second & (1 << i)) {
+        mByFlag[i].erase(name);
+      }
+    }
+
+    mFlags.erase(it);
+    mByReversedName.erase(Reverse(name));
+    mByName.erase(name);
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  //! Get the queue with exactly this name or 0
+  //----------------------------------------------------------------------------
+  T* Find(const std::string& name) const
+  {
+    const_iterator it = mByName.find(name);
+    return (it == mByName.end()) ? 0 : it->second;
+  }
+
+  size_t Size() const
+  {
+    return mByName.size();
+  }
+
+  const_iterator begin() const
+  {
+    return mByName.begin();
+  }
+
+  const_iterator end() const
+  {
+    return mByName.end();
+  }
+
+  //----------------------------------------------------------------------------
+  //! Collect the queues matching a name or a '*' wildcard pattern. The
+  //! candidates are matched in place, without copying their names.
+  //!
+  //! @param pattern queue name or pattern
+  //! @param exclude name of a queue to skip for wildcard patterns (the sender)
+  //! @param out matching queues are appended here
+  //----------------------------------------------------------------------------
+  void Match(const std::string& pattern, const std::string& exclude,
+             std::vector<T*>& out) const
+  {
+    size_t first = pattern.find('*');
+
+    // a fully named queue is addressed explicitly, even by itself
+    if (first == std::string::npos) {
+      T* value = Find(pattern);
+
+      if (value) {
+        out.push_back(value);
+      }
+
+      return;
+    }
+
+    size_t last = pattern.rfind('*');
+    const std::string prefix = pattern.substr(0, first);
+    const std::string rsuffix = Reverse(pattern.substr(last + 1));
+    const_iterator pbeg = mByName.lower_bound(prefix);
+    reversed_iterator sbeg = mByReversedName.lower_bound(rsuffix);
+    const_iterator pit = pbeg;
+    reversed_iterator sit = sbeg;
+
+    // advance both ranges in lockstep, the first one to end is the smaller
+    while (true) {
+      if ((pit == mByName.end()) || !StartsWith(pit->first, prefix)) {
+        Collect(pbeg, mByName.end(), prefix, pattern, exclude, out);
+        return;
+      }
+
+      if ((sit == mByReversedName.end()) || !StartsWith(sit->first, rsuffix)) {
+        Collect(sbeg, mByReversedName.end(), rsuffix, pattern, exclude, out);
+        return;
+      }
+
+      ++pit;
+      ++sit;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Collect the queues subscribed with a given flag
+  //!
+  //! @param flag subscription flag (single bit)
+  //! @param exclude name of a queue to skip (the sender)
+  //! @param out matching queues are appended here
+  //----------------------------------------------------------------------------
+  void MatchFlag(int flag, const std::string& exclude,
+                 std::vector<T*>& out) const
+  {
+    for (int i = 0; i < sMaxFlags; ++i) {
+      if (flag == (1 << i)) {
+        for (const_iterator it = mByFlag[i].begin(); it != mByFlag[i].end(); ++it) {
+          if (it->first != exclude) {
+            out.push_back(it->second);
+          }
+        }
+
+        return;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //! Full match of a name against a pattern where '*' matches any sequence
+  //! of characters (same semantic as XrdOucString::matches with '*')
+  //----------------------------------------------------------------------------
+  static bool GlobMatch(const char* pattern, const char* name)
+  {
+    const char* star = 0;
+    const char* resume = 0;
+
+    while (*name) {
+      if (*pattern == '*') {
+        star = pattern++;
+        resume = name;
+      } else if (*pattern == *name) {
+        ++pattern;
+        ++name;
+      } else if (star) {
+        pattern = star + 1;
+        name = ++resume;
+      } else {
+        return false;
+      }
+    }
+
+    while (*pattern == '*') {
+      ++pattern;
+    }
+
+    return !*pattern;
+  }
+
+private:
+  typedef typename std::map<std::string, const_iterator>::const_iterator
+  reversed_iterator;
+
+  std::map<std::string, T*> mByName;
+  //! Reversed names pointing to the entries of mByName
+  std::map<std::string, const_iterator> mByReversedName;
+  std::map<std::string, int> mFlags;
+  std::map<std::string, T*> mByFlag[sMaxFlags];
+
+  static std::string Reverse(const std::string& s)
+  {
+    return std::string(s.rbegin(), s.rend());
+  }
+
+  static bool StartsWith(const std::string& s, const std::string& prefix)
+  {
+    return !s.compare(0, prefix.length(), prefix);
+  }
+
+  static const_iterator Entry(const_iterator it)
+  {
+    return it;
+  }
+
+  static const_iterator Entry(reversed_iterator it)
+  {
+    return it->second;
+  }
+
+  template<typename Iterator>
+  static void Collect(Iterator it, Iterator end, const std::string& key,
+                      const std::string& pattern, const std::string& exclude,
+                      std::vector<T*>& out)
+  {
+    for (; (it != end) && StartsWith(it->first, key); ++it) {
+      const_iterator entry = Entry(it);
+      const std::string& name = entry->first;
+
+      if ((name != exclude) && GlobMatch(pattern.c_str(), name.c_str())) {
+        out.push_back(entry->second);
+      }
+    }
+  }
+};
+
+#endif
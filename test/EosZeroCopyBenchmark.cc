@@ -0,0 +1,220 @@
+// ----------------------------------------------------------------------
+// File: EosZeroCopyBenchmark.cc
+// Author: agent
+// ----------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+//------------------------------------------------------------------------------
+// Compare the CPU spent by the FST to serve a file over a socket when the
+// data is copied through a user buffer (pread + send) and when it is sent
+// with sendfile, as done for the zero copy reads of plain files. The file is
+// read from the page cache, so only the cost of the copies is measured.
+//
+// usage: eoszerocopybench [file-size-MB] [rounds]
+//------------------------------------------------------------------------------
+
+/*-----------------------------------------------------------------------------*/
+#include <sys/types.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+/*-----------------------------------------------------------------------------*/
+#include <thread>
+#include <vector>
+/*-----------------------------------------------------------------------------*/
+
+// Size of the reads of the xrootd and http servers
+#define READSIZE 4ll*1024ll*1024ll
+
+//------------------------------------------------------------------------------
+// CPU time of the calling thread in seconds
+//------------------------------------------------------------------------------
+static double
+ThreadCpu()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//------------------------------------------------------------------------------
+// Wall clock time in seconds
+//------------------------------------------------------------------------------
+static double
+WallClock()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//------------------------------------------------------------------------------
+// Drain a socket until the peer closes it
+//------------------------------------------------------------------------------
+static void
+Drain(int sock)
+{
+  std::vector<char> buffer(READSIZE);
+
+  while (read(sock, buffer.data(), buffer.size()) > 0) {
+  }
+}
+
+//------------------------------------------------------------------------------
+// Send a file through a user buffer
+//------------------------------------------------------------------------------
+static bool
+SendCopy(int fd, int sock, off_t size, char* buffer)
+{
+  for (off_t offset = 0; offset < size;) {
+    ssize_t nread = pread(fd, buffer, READSIZE, offset);
+
+    if (nread <= 0) {
+      return false;
+    }
+
+    for (ssize_t sent = 0; sent < nread;) {
+      ssize_t n = write(sock, buffer + sent, nread - sent);
+
+      if (n <= 0) {
+        return false;
+      }
+
+      sent += n;
+    }
+
+    offset += nread;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Send a file with sendfile
+//------------------------------------------------------------------------------
+static bool
+SendZeroCopy(int fd, int sock, off_t size)
+{
+  for (off_t offset = 0; offset < size;) {
+    size_t length = ((size - offset) > READSIZE ? READSIZE : size - offset);
+    // sendfile moves the offset forward
+    ssize_t n = sendfile(sock, fd, &offset, length);
+
+    if (n <= 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  long long size_mb = 1024;
+  int rounds = 5;
+
+  if (argc > 1) {
+    size_mb = atoll(argv[1]);
+  }
+
+  if (argc > 2) {
+    rounds = atoi(argv[2]);
+  }
+
+  if ((size_mb <= 0) || (rounds <= 0)) {
+    fprintf(stderr, "usage: eoszerocopybench [file-size-MB] [rounds]\n");
+    exit(-1);
+  }
+
+  off_t size = size_mb * 1024ll * 1024ll;
+  char path[] = "/tmp/eoszerocopybench.XXXXXX";
+  int fd = mkstemp(path);
+
+  if (fd < 0) {
+    fprintf(stderr, "error: failed to create the test file\n");
+    exit(-1);
+  }
+
+  unlink(path);
+  char* buffer = (char*) malloc(READSIZE);
+
+  if (!buffer) {
+    fprintf(stderr, "error: failed to allocate the read buffer\n");
+    exit(-1);
+  }
+
+  for (off_t i = 0; i < READSIZE; i++) {
+    buffer[i] = (rand()) % 256;
+  }
+
+  for (off_t offset = 0; offset < size; offset += READSIZE) {
+    if (pwrite(fd, buffer, READSIZE, offset) != READSIZE) {
+      fprintf(stderr, "error: failed to write the test file\n");
+      exit(-1);
+    }
+  }
+
+  fprintf(stdout, "file-size=%lld MB rounds=%d read-size=%lld\n", size_mb, rounds,
+          READSIZE);
+  const char* names[2] = {"copy", "sendfile"};
+
+  for (int mode = 0; mode < 2; mode++) {
+    double cpu = 0;
+    double wall = 0;
+
+    for (int round = 0; round < rounds; round++) {
+      int socks[2];
+
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, socks)) {
+        fprintf(stderr, "error: failed to create the socket pair\n");
+        exit(-1);
+      }
+
+      std::thread reader(Drain, socks[1]);
+      double cpu_start = ThreadCpu();
+      double wall_start = WallClock();
+      bool ok = (mode ? SendZeroCopy(fd, socks[0], size) :
+                 SendCopy(fd, socks[0], size, buffer));
+      cpu += ThreadCpu() - cpu_start;
+      wall += WallClock() - wall_start;
+      close(socks[0]);
+      reader.join();
+      close(socks[1]);
+
+      if (!ok) {
+        fprintf(stderr, "error: sending the file with %s failed\n", names[mode]);
+        exit(-1);
+      }
+    }
+
+    double gb = (double) size * rounds / (1024.0 * 1024.0 * 1024.0);
+    fprintf(stdout, "mode=%-8s cpu-per-GB=%.03f [s] rate=%.02f [MB/s]\n",
+            names[mode], cpu / gb, gb * 1024.0 / wall);
+  }
+
+  free(buffer);
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,53 @@
+//------------------------------------------------------------------------------
+// File: EnvTunableTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include "Namespace.hh"
+#include "common/EnvTunable.hh"
+
+EOSCOMMONTESTING_BEGIN
+
+using eos::common::EnvTunable;
+
+TEST(EnvTunable, Get)
+{
+  const char* name = "EOS_TEST_ENV_TUNABLE";
+  unsetenv(name);
+  ASSERT_EQ(8, EnvTunable::Get(name, 8, 1, 64));
+  setenv(name, "32", 1);
+  ASSERT_EQ(32, EnvTunable::Get(name, 8, 1, 64));
+  // Values out of range are clamped
+  setenv(name, "0", 1);
+  ASSERT_EQ(1, EnvTunable::Get(name, 8, 1, 64));
+  setenv(name, "1000", 1);
+  ASSERT_EQ(64, EnvTunable::Get(name, 8, 1, 64));
+  // Values which are not a number give the default
+  setenv(name, "many", 1);
+  ASSERT_EQ(8, EnvTunable::Get(name, 8, 1, 64));
+  setenv(name, "", 1);
+  ASSERT_EQ(8, EnvTunable::Get(name, 8, 1, 64));
+  unsetenv(name);
+}
+
+EOSCOMMONTESTING_END
@@ -0,0 +1,152 @@
+//------------------------------------------------------------------------------
+// File: AdlerTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/checksum/Adler.hh"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace eos::fst;
+
+namespace
+{
+std::atomic<unsigned long long> sBytesRead(0);
+
+//------------------------------------------------------------------------------
+// Read callback serving the data from a vector
+//------------------------------------------------------------------------------
+int
+ReadVector(CheckSum::ReadCallBack::callback_data_t* cbd)
+{
+  std::vector<char>* data = (std::vector<char>*) cbd->caller;
+
+  if (cbd->offset >= (off_t) data->size()) {
+    return 0;
+  }
+
+  size_t length = std::min(cbd->size, data->size() - cbd->offset);
+  memcpy(cbd->buffer, data->data() + cbd->offset, length);
+  sBytesRead += length;
+  return length;
+}
+
+std::vector<char>
+RandomData(size_t length)
+{
+  std::vector<char> data(length);
+  srandom(42);
+
+  for (size_t i = 0; i < length; i++) {
+    data[i] = random();
+  }
+
+  return data;
+}
+
+std::string
+ZlibHex(const std::vector<char>& data)
+{
+  char hex[16];
+  snprintf(hex, sizeof(hex), "%08lx", adler32(adler32(0L, Z_NULL, 0),
+           (const Bytef*) data.data(), data.size()));
+  return hex;
+}
+}
+
+TEST(AdlerTest, OutOfOrderChunks)
+{
+  std::vector<char> data = RandomData(100 * 4096 + 17);
+  std::vector<off_t> offsets;
+
+  for (off_t offset = 0; offset < (off_t) data.size(); offset += 4096) {
+    offsets.push_back(offset);
+  }
+
+  std::shuffle(offsets.begin(), offsets.end(), std::mt19937(42));
+  Adler xs;
+
+  for (size_t i = 0; i < offsets.size(); i++) {
+    size_t length = std::min((size_t) 4096, data.size() - offsets[i]);
+    xs.Add(data.data() + offsets[i], length, offsets[i]);
+  }
+
+  xs.Finalize();
+  ASSERT_FALSE(xs.NeedsRecalculation());
+  ASSERT_EQ(ZlibHex(data), xs.GetHexChecksum());
+}
+
+TEST(AdlerTest, ScanMissingRanges)
+{
+  std::vector<char> data = RandomData(50 * 1024 * 1024 + 3);
+  Adler xs;
+  // The overwrite of [10MB, 30MB) drops the chunk [2MB, 40MB) it overlaps,
+  // leaving the holes [1MB, 10MB), [30MB, 45MB) and from 48MB to the end
+  off_t MB = 1024 * 1024;
+  xs.Add(data.data(), MB, 0);
+  xs.Add(data.data() + 2 * MB, 38 * MB, 2 * MB);
+  xs.Add(data.data() + 45 * MB, 3 * MB, 45 * MB);
+  xs.Add(data.data() + 10 * MB, 20 * MB, 10 * MB);
+  xs.Finalize();
+  ASSERT_TRUE(xs.NeedsRecalculation());
+  ASSERT_EQ(3u, xs.GetMissingRanges(data.size()).size());
+  sBytesRead = 0;
+  CheckSum::ReadCallBack::callback_data_t cbd;
+  cbd.caller = (void*) &data;
+  CheckSum::ReadCallBack cb(ReadVector, cbd);
+  unsigned long long scansize = 0;
+  float scantime = 0;
+  ASSERT_TRUE(xs.ScanMissing(cb, data.size(), scansize, scantime, 4));
+  ASSERT_EQ(data.size() - 24 * MB, scansize);
+  ASSERT_EQ(scansize, sBytesRead);
+  ASSERT_FALSE(xs.NeedsRecalculation());
+  ASSERT_EQ(ZlibHex(data), xs.GetHexChecksum());
+}
+
+TEST(AdlerTest, PresetChecksum)
+{
+  std::vector<char> data = RandomData(3 * 1024 * 1024);
+  Adler xs;
+  xs.ResetInit(0, data.size(), ZlibHex(data).c_str());
+  // Overwrite the middle with new content, only the rest is read again
+  std::vector<char> update(4096, 'x');
+  std::copy(update.begin(), update.end(), data.begin() + 1024 * 1024);
+  xs.Add(update.data(), update.size(), 1024 * 1024);
+  xs.Finalize();
+  ASSERT_TRUE(xs.NeedsRecalculation());
+  sBytesRead = 0;
+  CheckSum::ReadCallBack::callback_data_t cbd;
+  cbd.caller = (void*) &data;
+  CheckSum::ReadCallBack cb(ReadVector, cbd);
+  unsigned long long scansize = 0;
+  float scantime = 0;
+  ASSERT_TRUE(xs.ScanMissing(cb, data.size(), scansize, scantime, 2));
+  ASSERT_EQ(data.size() - update.size(), scansize);
+  ASSERT_EQ(ZlibHex(data), xs.GetHexChecksum());
+  // A file shorter than expected fails the scan
+  Adler partial;
+  partial.Add(data.data(), 4096, 0);
+  ASSERT_FALSE(partial.ScanMissing(cb, data.size() + 1, scansize, scantime, 2));
+}
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+// File: AsyncMetaHandlerTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+#include "fst/io/AsyncMetaHandler.hh"
+#include "fst/io/ChunkHandler.hh"
+
+using namespace eos::fst;
+
+TEST(AsyncMetaHandlerTest, WriteWindow)
+{
+  AsyncMetaHandler handler;
+  handler.SetWriteWindow(2);
+  char buf[16] = {0};
+  ChunkHandler* chunk1 = handler.Register(0, sizeof(buf), buf, true);
+  ChunkHandler* chunk2 = handler.Register(16, sizeof(buf), buf, true);
+  ASSERT_TRUE((chunk1 != 0) && (chunk2 != 0));
+  std::atomic<bool> registered(false);
+  // The third write has to wait for a response
+  std::thread writer([&]() {
+    ChunkHandler* chunk3 = handler.Register(32, sizeof(buf), buf, true);
+    registered = true;
+    chunk3->HandleResponse(new XrdCl::XRootDStatus(), 0);
+  });
+  usleep(100000);
+  ASSERT_FALSE(registered);
+  chunk1->HandleResponse(new XrdCl::XRootDStatus(), 0);
+  writer.join();
+  ASSERT_TRUE(registered);
+  // Failures are visible before waiting for all the responses
+  ASSERT_EQ(XrdCl::errNone, handler.GetErrorType());
+  chunk2->HandleResponse(new XrdCl::XRootDStatus(XrdCl::stError,
+                         XrdCl::errSocketError), 0);
+  ASSERT_EQ(XrdCl::errSocketError, handler.GetErrorType());
+  ASSERT_EQ(XrdCl::errSocketError, handler.WaitOK());
+}
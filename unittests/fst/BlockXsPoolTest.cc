@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+// File: BlockXsPoolTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/checksum/BlockXsPool.hh"
+#include "fst/checksum/Adler.hh"
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+using namespace eos::fst;
+
+namespace
+{
+const size_t sBlockSize = eos::common::LayoutId::OssXsBlockSize;
+
+std::vector<char>
+RandomData(size_t length)
+{
+  std::vector<char> data(length);
+  srandom(42);
+
+  for (size_t i = 0; i < length; i++) {
+    data[i] = random();
+  }
+
+  return data;
+}
+
+unsigned long
+AdlerBlockLid()
+{
+  return eos::common::LayoutId::GetId(eos::common::LayoutId::kPlain,
+                                      eos::common::LayoutId::kNone, 1, 0,
+                                      eos::common::LayoutId::kAdler);
+}
+}
+
+TEST(BlockXsPoolTest, ParallelChecksums)
+{
+  std::vector<char> data = RandomData(3000 * sBlockSize);
+  BlockXsPool pool(4);
+  ASSERT_FALSE(pool.IsParallel(1));
+  ASSERT_TRUE(pool.IsParallel(3000));
+  ASSERT_FALSE(BlockXsPool(0).IsParallel(3000));
+  // Two ranges of different size are split into tasks of the pool
+  Adler xs;
+  size_t len = xs.GetCheckSumLen();
+  std::vector<char> sums(3000 * len);
+  std::vector<BlockXsPool::Blocks> work;
+  work.push_back({data.data(), 1000, sums.data()});
+  work.push_back({data.data() + 1000 * sBlockSize, 2000,
+                  sums.data() + 1000 * len});
+  ASSERT_TRUE(pool.Compute(AdlerBlockLid(), sBlockSize, work));
+
+  for (size_t i = 0; i < 3000; i++) {
+    int bin_len = 0;
+    xs.Reset();
+    xs.Add(data.data() + i * sBlockSize, sBlockSize, 0);
+    xs.Finalize();
+    ASSERT_EQ(0, memcmp(xs.GetBinChecksum(bin_len), sums.data() + i * len, len));
+  }
+
+  // Without a block checksum type there is nothing to compute
+  ASSERT_FALSE(pool.Compute(0, sBlockSize, work));
+}
+
+TEST(BlockXsPoolTest, SharedMap)
+{
+  std::vector<char> data = RandomData(1024 * sBlockSize);
+  char path[] = "/tmp/eos.blockxspool.XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  Adler map;
+  ASSERT_TRUE(map.OpenMap(path, data.size(), sBlockSize, true));
+  size_t len = map.GetCheckSumLen();
+  std::vector<char> sums(1024 * len);
+  std::vector<BlockXsPool::Blocks> work;
+  work.push_back({data.data(), 1024, sums.data()});
+  BlockXsPool pool(2);
+  ASSERT_TRUE(pool.Compute(AdlerBlockLid(), sBlockSize, work));
+  ASSERT_TRUE(map.AddBlockSums(0, sums.data(), 1024));
+  // The stored checksums match the ones computed inline
+  ASSERT_TRUE(map.CheckBlockSum(0, data.data(), data.size()));
+  ASSERT_TRUE(map.CheckBlockSums(0, sums.data(), 1024));
+  // A corrupted block is found
+  data[700 * sBlockSize + 3] ^= 0x1;
+  ASSERT_TRUE(pool.Compute(AdlerBlockLid(), sBlockSize, work));
+  ASSERT_FALSE(map.CheckBlockSums(0, sums.data(), 1024));
+  ASSERT_TRUE(map.CloseMap());
+  unlink(path);
+}
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+// File: BufferPoolTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "common/BufferPool.hh"
+#include <cstring>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+using eos::common::BufferPool;
+
+TEST(BufferPool, Reuse)
+{
+  BufferPool pool(64 * 1024 * 1024, false);
+  std::vector<BufferPool::Stats> stats;
+  char* buf1 = pool.Allocate(1024 * 1024);
+  ASSERT_TRUE(buf1 != 0);
+  ASSERT_EQ(0u, ((uintptr_t) buf1) % 4096);
+  memset(buf1, 0xff, 1024 * 1024);
+  pool.Release(buf1, 1024 * 1024);
+  // A smaller size of the same class gets the idle buffer back
+  char* buf2 = pool.Allocate(1024 * 1024 - 100);
+  ASSERT_EQ(buf1, buf2);
+  char* buf3 = pool.Allocate(1024 * 1024);
+  ASSERT_TRUE(buf3 != buf2);
+  pool.GetStats(stats);
+  ASSERT_EQ(1u, stats.size());
+  ASSERT_EQ(1024u * 1024, stats[0].size);
+  ASSERT_EQ(2u, stats[0].inUse);
+  ASSERT_EQ(0u, stats[0].idle);
+  ASSERT_EQ(1u, stats[0].hits);
+  ASSERT_EQ(2u, stats[0].misses);
+  pool.Release(buf2, 1024 * 1024 - 100);
+  pool.Release(buf3, 1024 * 1024);
+  pool.GetStats(stats);
+  ASSERT_EQ(0u, stats[0].inUse);
+  ASSERT_EQ(2u, stats[0].idle);
+  pool.Trim();
+  pool.GetStats(stats);
+  ASSERT_EQ(0u, stats[0].idle);
+  std::string out;
+  pool.Print(out);
+  ASSERT_TRUE(out.find("bufferpool.size=1048576 inuse=0 idle=0 hits=1 "
+                       "misses=2") != std::string::npos);
+}
+
+TEST(BufferPool, Limits)
+{
+  // Only one 64 KB buffer fits in the idle memory
+  BufferPool pool(100 * 1024, false);
+  std::vector<BufferPool::Stats> stats;
+  char* buf1 = pool.Allocate(64 * 1024);
+  char* buf2 = pool.Allocate(64 * 1024);
+  pool.Release(buf1, 64 * 1024);
+  pool.Release(buf2, 64 * 1024);
+  pool.GetStats(stats);
+  ASSERT_EQ(1u, stats.size());
+  ASSERT_EQ(1u, stats[0].idle);
+  // Larger than the largest class, served directly
+  size_t oversize = 65 * 1024 * 1024;
+  char* big = pool.Allocate(oversize);
+  ASSERT_TRUE(big != 0);
+  ASSERT_EQ(0u, ((uintptr_t) big) % 4096);
+  pool.Release(big, oversize);
+  pool.Release(0, 4096);
+  std::string out;
+  pool.Print(out);
+  ASSERT_TRUE(out.find("oversize=1") != std::string::npos);
+}
+
+TEST(BufferPool, HugePages)
+{
+  // Falls back to regular pages if the system has no huge pages
+  BufferPool pool(16 * 1024 * 1024, true);
+  char* buf = pool.Allocate(4 * 1024 * 1024);
+  ASSERT_TRUE(buf != 0);
+  ASSERT_EQ(0u, ((uintptr_t) buf) % 4096);
+  memset(buf, 0, 4 * 1024 * 1024);
+  pool.Release(buf, 4 * 1024 * 1024);
+  ASSERT_EQ(buf, pool.Allocate(4 * 1024 * 1024));
+  pool.Release(buf, 4 * 1024 * 1024);
+}
+
+TEST(BufferPool, ConcurrentLimit)
+{
+  // Releases of different classes racing for the idle memory
+  size_t limit = 1024 * 1024;
+  BufferPool pool(limit, false);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&pool, t]() {
+      size_t size = 64 * 1024 << (t % 4);
+
+      for (int i = 0; i < 1000; i++) {
+        char* bufs[4];
+
+        for (int j = 0; j < 4; j++) {
+          bufs[j] = pool.Allocate(size);
+        }
+
+        for (int j = 0; j < 4; j++) {
+          pool.Release(bufs[j], size);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<BufferPool::Stats> stats;
+  pool.GetStats(stats);
+  size_t idle = 0;
+
+  for (auto& st : stats) {
+    ASSERT_EQ(0u, st.inUse);
+    idle += st.idle * st.size;
+  }
+
+  ASSERT_TRUE(idle <= limit);
+}
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// File: ChecksumSimdTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/checksum/ChecksumSimd.hh"
+#include <cstdlib>
+#include <vector>
+
+using namespace eos::fst;
+
+TEST(ChecksumSimdTest, MatchesZlib)
+{
+  std::vector<char> buffer(1024 * 1024 + 77);
+  srandom(42);
+
+  for (size_t i = 0; i < buffer.size(); i++) {
+    buffer[i] = random();
+  }
+
+  size_t lengths[] = { 0, 1, 15, 16, 31, 32, 63, 64, 65, 200, 5552, 5553,
+                       100000, 1024 * 1024
+                     };
+
+  for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+    for (size_t offset = 0; offset < 4; offset++) {
+      const char* ptr = &buffer[offset];
+      ASSERT_EQ(adler32UpdateScalar(1, ptr, lengths[l]),
+                adler32Update(1, ptr, lengths[l]));
+      ASSERT_EQ(adler32UpdateScalar(0x1234abcd, ptr, lengths[l]),
+                adler32Update(0x1234abcd, ptr, lengths[l]));
+      ASSERT_EQ(crc32UpdateScalar(0, ptr, lengths[l]),
+                crc32Update(0, ptr, lengths[l]));
+      ASSERT_EQ(crc32UpdateScalar(0xdeadbeef, ptr, lengths[l]),
+                crc32Update(0xdeadbeef, ptr, lengths[l]));
+    }
+  }
+
+  // saturated bytes stress the overflow bounds of the accumulators
+  std::vector<char> ones(256 * 1024, (char) 0xff);
+  ASSERT_EQ(adler32UpdateScalar(0xfff0fff0, &ones[0], ones.size()),
+            adler32Update(0xfff0fff0, &ones[0], ones.size()));
+  ASSERT_EQ(crc32UpdateScalar(0, &ones[0], ones.size()),
+            crc32Update(0, &ones[0], ones.size()));
+  // well known values
+  ASSERT_EQ(0x11e60398u, adler32Update(1, "Wikipedia", 9));
+  ASSERT_EQ(0xcbf43926u, crc32Update(0, "123456789", 9));
+}
+
+TEST(ChecksumSimdTest, MultiBuffer)
+{
+  std::vector<char> buffer(4 * 1024 * 1024);
+
+  for (size_t i = 0; i < buffer.size(); i++) {
+    buffer[i] = random();
+  }
+
+  const char* buffers[] = { &buffer[0], &buffer[3], &buffer[1024 * 1024],
+                            &buffer[1024]
+                          };
+  size_t lengths[] = { 1024 * 1024, 0, 3 * 1024 * 1024 - 5, 70001 };
+  uint32_t adlers[] = { 1, 1, 1, 1 };
+  uint32_t crcs[] = { 0, 0, 0, 0 };
+  adler32UpdateMulti(adlers, buffers, lengths, 4);
+  crc32UpdateMulti(crcs, buffers, lengths, 4);
+
+  for (size_t i = 0; i < 4; i++) {
+    ASSERT_EQ(adler32UpdateScalar(1, buffers[i], lengths[i]), adlers[i]);
+    ASSERT_EQ(crc32UpdateScalar(0, buffers[i], lengths[i]), crcs[i]);
+  }
+}
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+// File: FmdRecordTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/FmdRecord.hh"
+#include "common/LayoutId.hh"
+
+using namespace eos::fst;
+
+namespace
+{
+FmdBase
+SampleFmd()
+{
+  FmdBase fmd;
+  fmd.set_fid(0x123456789ULL);
+  fmd.set_cid(77);
+  fmd.set_fsid(12);
+  fmd.set_ctime(1500000000);
+  fmd.set_ctime_ns(1);
+  fmd.set_mtime(1500000100);
+  fmd.set_mtime_ns(2);
+  fmd.set_atime(1500000200);
+  fmd.set_atime_ns(3);
+  fmd.set_checktime(1500000300);
+  fmd.set_size(4096);
+  fmd.set_disksize(4096);
+  fmd.set_mgmsize(4096);
+  fmd.set_checksum("0a0b0c0d");
+  fmd.set_diskchecksum("0a0b0c0d");
+  fmd.set_mgmchecksum("0a0b0c0d");
+  fmd.set_lid(0x00100002);
+  fmd.set_uid(1000);
+  fmd.set_gid(100);
+  fmd.set_filecxerror(0);
+  fmd.set_blockcxerror(-1);
+  fmd.set_layouterror(0);
+  fmd.set_locations("12,13");
+  return fmd;
+}
+
+unsigned int
+Classes(const FmdBase& fmd)
+{
+  std::string data;
+  FmdRecord::Encode(fmd, data);
+  return FmdRecord(data.data(), data.size()).GetClasses();
+}
+}
+
+TEST(FmdRecordTest, EncodeDecode)
+{
+  FmdBase fmd = SampleFmd();
+  std::string data;
+  FmdRecord::Encode(fmd, data);
+  ASSERT_EQ(FmdRecord::sMagic, (unsigned char) data[0]);
+  ASSERT_EQ(FmdRecord::sVersion, (unsigned char) data[1]);
+  // The header fields are read in place
+  FmdRecord rec(data.data(), data.size());
+  ASSERT_TRUE(rec.IsValid());
+  ASSERT_EQ(fmd.fid(), rec.GetFid());
+  ASSERT_EQ(4096u, rec.GetDiskSize());
+  ASSERT_EQ(1500000100u, rec.GetMtime());
+  ASSERT_EQ(1500000300u, rec.GetCheckTime());
+  FmdBase decoded;
+  ASSERT_TRUE(FmdRecord::Decode(data, decoded));
+  ASSERT_EQ(fmd.SerializeAsString(), decoded.SerializeAsString());
+  // A truncated record is rejected
+  ASSERT_FALSE(FmdRecord(data.data(), data.size() - 1).IsValid());
+  ASSERT_FALSE(FmdRecord::Decode(data.data(), data.size() - 1, decoded));
+  ASSERT_FALSE(FmdRecord::Decode(data.data(), 100, decoded));
+  // A missing record has an invalid view
+  ASSERT_FALSE(FmdRecord().IsValid());
+}
+
+TEST(FmdRecordTest, ProtobufRecords)
+{
+  FmdBase fmd = SampleFmd();
+  std::string proto;
+  fmd.SerializePartialToString(&proto);
+  ASSERT_NE(FmdRecord::sMagic, (unsigned char) proto[0]);
+  FmdBase decoded;
+  ASSERT_TRUE(FmdRecord::Decode(proto, decoded));
+  ASSERT_EQ(proto, decoded.SerializeAsString());
+  // A view of a protobuf record holds the converted record
+  std::string buffer;
+  FmdRecord rec = FmdRecord::Open(proto.data(), proto.size(), buffer);
+  ASSERT_TRUE(rec.IsValid());
+  ASSERT_EQ(fmd.fid(), rec.GetFid());
+  ASSERT_FALSE(buffer.empty());
+  // A missing record decodes to an empty one
+  ASSERT_TRUE(FmdRecord::Decode("", decoded));
+  ASSERT_EQ(0u, decoded.fid());
+}
+
+TEST(FmdRecordTest, Classes)
+{
+  FmdBase fmd = SampleFmd();
+  unsigned int synced = (1u << FmdRecord::kMem) | (1u << FmdRecord::kDiskSync) |
+                        (1u << FmdRecord::kMgmSync);
+  ASSERT_EQ(synced, Classes(fmd));
+  fmd.set_disksize(100);
+  fmd.set_diskchecksum("ffffffff");
+  ASSERT_EQ(synced | (1u << FmdRecord::kDiskSizeDiff) |
+            (1u << FmdRecord::kDiskCxDiff), Classes(fmd));
+  // Checksums are only compared without layout error
+  fmd = SampleFmd();
+  fmd.set_mgmchecksum("ffffffff");
+  fmd.set_layouterror(eos::common::LayoutId::kOrphan |
+                      eos::common::LayoutId::kMissing);
+  ASSERT_EQ(synced | (1u << FmdRecord::kOrphan) | (1u << FmdRecord::kMissing),
+            Classes(fmd));
+  fmd.set_layouterror(0);
+  ASSERT_EQ(synced | (1u << FmdRecord::kMgmCxDiff), Classes(fmd));
+  // Not synced files have no size mismatch
+  fmd = SampleFmd();
+  fmd.set_disksize(FmdRecord::sUndefSize);
+  fmd.set_mgmsize(FmdRecord::sUndefSize);
+  fmd.set_size(1);
+  ASSERT_EQ(1u << FmdRecord::kMem, Classes(fmd));
+  ASSERT_STREQ("d_mem_sz_diff", FmdRecord::ClassName(FmdRecord::kDiskSizeDiff));
+  ASSERT_STREQ("rep_missing_n", FmdRecord::ClassName(FmdRecord::kMissing));
+}
+
+TEST(FmdRecordTest, ScanTime)
+{
+  FmdBase fmd = SampleFmd();
+  std::string data;
+  FmdRecord::Encode(fmd, data);
+  ASSERT_EQ(1500000300u, FmdRecord(data.data(), data.size()).GetScanTime());
+  // Files modified after their check or never checked are due at once
+  fmd.set_mtime(1500000400);
+  FmdRecord::Encode(fmd, data);
+  ASSERT_EQ(0u, FmdRecord(data.data(), data.size()).GetScanTime());
+  fmd = SampleFmd();
+  fmd.set_checktime(0);
+  FmdRecord::Encode(fmd, data);
+  ASSERT_EQ(0u, FmdRecord(data.data(), data.size()).GetScanTime());
+  // Files which are not on disk are never scanned
+  fmd.set_disksize(FmdRecord::sUndefSize);
+  FmdRecord::Encode(fmd, data);
+  ASSERT_EQ(FmdRecord::sNoScan,
+            FmdRecord(data.data(), data.size()).GetScanTime());
+}
@@ -0,0 +1,89 @@
+//------------------------------------------------------------------------------
+// File: IoSchedulerTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/IoScheduler.hh"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace eos::fst;
+
+namespace
+{
+//------------------------------------------------------------------------------
+// Seconds taken by a number of threads acquiring IO on the given devices
+//------------------------------------------------------------------------------
+double
+AcquireTime(IoScheduler& scheduler, const std::vector<std::string>& devices,
+            size_t bytes)
+{
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < devices.size(); i++) {
+    threads.push_back(std::thread([&scheduler, &devices, bytes, i]() {
+      // The first slot is granted right away, the second one waits for it
+      scheduler.Acquire(devices[i], bytes);
+      scheduler.Acquire(devices[i], bytes);
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start).count();
+}
+}
+
+TEST(IoSchedulerTest, DeviceBudgets)
+{
+  // Without load monitor all the devices keep the maximum budget
+  IoScheduler scheduler(0);
+  double budget = scheduler.GetBudget("sdx");
+  ASSERT_GT(budget, 0);
+  size_t bytes = (size_t)(budget * 1024 * 1024 / 5);
+  // Two callers on the same device share its budget
+  double elapsed = AcquireTime(scheduler, {"sdx", "sdx"}, bytes);
+  ASSERT_GE(elapsed, 0.55);
+  // Callers on different devices don't wait for each other
+  elapsed = AcquireTime(scheduler, {"sdy", "sdz"}, bytes);
+  ASSERT_GE(elapsed, 0.15);
+  ASSERT_LT(elapsed, 0.35);
+}
+
+TEST(IoSchedulerTest, DeviceNames)
+{
+  IoScheduler scheduler(0);
+  // Device names are used as they are
+  ASSERT_EQ("sdx", scheduler.GetDevice("sdx"));
+  ASSERT_EQ("sdx", Load::DevMap("sdx"));
+  // A path is always mapped to the same device
+  ASSERT_EQ(Load::DevMap("/tmp"), Load::DevMap("/tmp"));
+  ASSERT_TRUE(Load::IsDevice("sdx"));
+  // A path which is not on a block device is not taken for a device
+  ASSERT_FALSE(Load::IsDevice(Load::DevMap("/proc/self")));
+  ASSERT_FALSE(Load::IsDevice(""));
+}
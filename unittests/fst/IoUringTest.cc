@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------------
+// File: IoUringTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/io/local/IoUring.hh"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace eos::fst;
+
+TEST(IoUringTest, WriteReadSync)
+{
+  IoUring ring(4);
+
+  if (!ring.IsOk()) {
+    // Kernel without io_uring, the IO objects fall back to the system calls
+    return;
+  }
+
+  char path[] = "/tmp/eos.iouring.XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_TRUE(fd >= 0);
+  unlink(path);
+  // Larger than the staging buffers of all the slots together
+  size_t length = 6 * IoUring::sSlotSize + 123;
+  std::vector<char> data(length);
+
+  for (size_t i = 0; i < length; i++) {
+    data[i] = (char)(i * 7);
+  }
+
+  IoUring::Tracker writes;
+  ASSERT_EQ(0, ring.Write(fd, data.data(), length, 4096, writes));
+  ASSERT_EQ(0, writes.Wait());
+  ASSERT_EQ(length, writes.GetBytes());
+  IoUring::Tracker sync;
+  ASSERT_EQ(0, ring.Fsync(fd, sync));
+  ASSERT_EQ(0, sync.Wait());
+  // Reads past the end of the file are short without failing
+  std::vector<char> out(length + 4096);
+  IoUring::Tracker reads;
+  ASSERT_EQ(0, ring.Read(fd, out.data(), 4096, 4096, reads));
+  ASSERT_EQ(0, ring.Read(fd, out.data() + 4096, length + 100, 8192, reads));
+  ASSERT_EQ(0, reads.Wait());
+  ASSERT_EQ(4096 + length - 4096, reads.GetBytes());
+  ASSERT_TRUE(std::equal(data.begin(), data.end(), out.begin()));
+  close(fd);
+}
+
+TEST(IoUringTest, Errors)
+{
+  IoUring ring(2);
+
+  if (!ring.IsOk()) {
+    return;
+  }
+
+  char path[] = "/tmp/eos.iouring.XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_TRUE(fd >= 0);
+  unlink(path);
+  int rdonly = open("/proc/self/exe", O_RDONLY);
+  ASSERT_TRUE(rdonly >= 0);
+  char buffer[4096] = {0};
+  IoUring::Tracker writes;
+  ASSERT_EQ(0, ring.Write(fd, buffer, sizeof(buffer), 0, writes));
+  ASSERT_EQ(0, ring.Write(rdonly, buffer, sizeof(buffer), 0, writes));
+  ASSERT_EQ(0, ring.Write(fd, buffer, sizeof(buffer), 4096, writes));
+  // The first failure is kept
+  ASSERT_EQ(EBADF, writes.Wait());
+  ASSERT_EQ(EBADF, writes.GetError());
+  ASSERT_EQ(2 * sizeof(buffer), writes.GetBytes());
+  close(rdonly);
+  close(fd);
+}
+
+TEST(IoUringTest, OverlappingWrites)
+{
+  IoUring ring(8);
+
+  if (!ring.IsOk()) {
+    return;
+  }
+
+  char path[] = "/tmp/eos.iouring.XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_TRUE(fd >= 0);
+  unlink(path);
+  std::vector<char> buffer(64 * 1024);
+  std::vector<char> expected(buffer.size() + 3 * 4096);
+  IoUring::Tracker writes;
+
+  // Overlapping writes land in submission order
+  for (int i = 1; i <= 64; i++) {
+    off_t offset = (i % 4) * 4096;
+    std::fill(buffer.begin(), buffer.end(), (char) i);
+    std::copy(buffer.begin(), buffer.end(), expected.begin() + offset);
+    ASSERT_EQ(0, ring.Write(fd, buffer.data(), buffer.size(), offset, writes));
+  }
+
+  ASSERT_EQ(0, writes.Wait());
+  std::vector<char> out(expected.size());
+  ASSERT_EQ((ssize_t) out.size(), pread(fd, out.data(), out.size(), 0));
+  ASSERT_TRUE(expected == out);
+  close(fd);
+}
+
+//! Result of an async read, set by its completion callback
+struct AsyncRead {
+  int result;
+  std::thread::id thread;
+};
+
+static void
+AsyncReadDone(void* arg, int result)
+{
+  AsyncRead* read = static_cast<AsyncRead*>(arg);
+  read->result = result;
+  read->thread = std::this_thread::get_id();
+}
+
+TEST(IoUringTest, AsyncReadCallback)
+{
+  IoUring ring(2);
+
+  if (!ring.IsOk()) {
+    return;
+  }
+
+  char path[] = "/tmp/eos.iouring.XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_TRUE(fd >= 0);
+  unlink(path);
+  std::vector<char> data(3 * 4096);
+
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = (char)(i * 13);
+  }
+
+  ASSERT_EQ((ssize_t) data.size(), pwrite(fd, data.data(), data.size(), 0));
+  // The callback runs on the reaper thread before the tracker is done
+  std::vector<char> out(2 * 4096);
+  AsyncRead first = { -1, std::this_thread::get_id() };
+  AsyncRead last = { -1, std::this_thread::get_id() };
+  IoUring::Tracker reads;
+  ASSERT_EQ(0, ring.Read(fd, out.data(), 4096, 4096, reads, &AsyncReadDone,
+                         &first));
+  ASSERT_EQ(0, ring.Read(fd, out.data() + 4096, 8192, 8192, reads,
+                         &AsyncReadDone, &last));
+  ASSERT_EQ(0, reads.Wait());
+  ASSERT_EQ(4096, first.result);
+  ASSERT_EQ(4096, last.result);
+  ASSERT_NE(std::this_thread::get_id(), first.thread);
+  ASSERT_NE(std::this_thread::get_id(), last.thread);
+  ASSERT_TRUE(std::equal(out.begin(), out.end(), data.begin() + 4096));
+  close(fd);
+}
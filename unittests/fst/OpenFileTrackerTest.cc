@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+// File: OpenFileTrackerTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/OpenFileTracker.hh"
+#include <thread>
+#include <vector>
+
+using namespace eos::fst;
+
+TEST(OpenFileTrackerTest, Counters)
+{
+  OpenFileTracker tracker;
+  ASSERT_FALSE(tracker.IsOpen(1, 100, false));
+  ASSERT_EQ(0, tracker.GetNumOpenFiles(1, false));
+  ASSERT_EQ(0u, tracker.Down(1, 100, false));
+  tracker.Up(1, 100, false);
+  tracker.Up(1, 100, false);
+  tracker.Up(1, 101, true);
+  // Reads and writes are counted apart, per filesystem
+  ASSERT_EQ(2u, tracker.GetUseCount(1, 100, false));
+  ASSERT_FALSE(tracker.IsOpen(1, 100, true));
+  ASSERT_FALSE(tracker.IsOpen(2, 100, false));
+  ASSERT_EQ(1, tracker.GetNumOpenFiles(1, false));
+  ASSERT_EQ(1, tracker.GetNumOpenFiles(1, true));
+  ASSERT_TRUE(tracker.IsAnyOpen(true));
+  ASSERT_EQ(1u, tracker.Down(1, 100, false));
+  ASSERT_EQ(0u, tracker.Down(1, 100, false));
+  ASSERT_EQ(0u, tracker.Down(1, 101, true));
+  ASSERT_EQ(0, tracker.GetNumOpenFiles(1, false));
+  ASSERT_FALSE(tracker.IsAnyOpen(true));
+  ASSERT_FALSE(tracker.IsAnyOpen(false));
+}
+
+TEST(OpenFileTrackerTest, HotFiles)
+{
+  OpenFileTracker tracker;
+
+  // File i is opened i times
+  for (unsigned long long fid = 1; fid <= 20; fid++) {
+    for (unsigned long long i = 0; i < fid; i++) {
+      tracker.Up(1, fid, false);
+    }
+  }
+
+  std::vector<OpenFileTracker::HotFile> hot = tracker.GetHotFiles(1, false, 3);
+  ASSERT_EQ(3u, hot.size());
+  ASSERT_EQ(OpenFileTracker::HotFile(20, 20), hot[0]);
+  ASSERT_EQ(OpenFileTracker::HotFile(19, 19), hot[1]);
+  ASSERT_EQ(OpenFileTracker::HotFile(18, 18), hot[2]);
+
+  // Closes move a file down, the same counts are ordered by file id
+  for (int i = 0; i < 2; i++) {
+    tracker.Down(1, 20, false);
+  }
+
+  hot = tracker.GetHotFiles(1, false, 3);
+  ASSERT_EQ(OpenFileTracker::HotFile(19, 19), hot[0]);
+  ASSERT_EQ(OpenFileTracker::HotFile(18, 18), hot[1]);
+  ASSERT_EQ(OpenFileTracker::HotFile(18, 20), hot[2]);
+  ASSERT_TRUE(tracker.GetHotFiles(1, true, 3).empty());
+  ASSERT_EQ(20u, tracker.GetHotFiles(1, false, 100).size());
+}
+
+TEST(OpenFileTrackerTest, Concurrent)
+{
+  OpenFileTracker tracker;
+  std::vector<std::thread> threads;
+
+  for (unsigned long fsid = 1; fsid <= 8; fsid++) {
+    threads.push_back(std::thread([&tracker, fsid]() {
+      for (int round = 0; round < 1000; round++) {
+        for (unsigned long long fid = 0; fid < 10; fid++) {
+          tracker.Up(fsid % 4, fid, (round % 2));
+        }
+
+        for (unsigned long long fid = 0; fid < 10; fid++) {
+          tracker.Down(fsid % 4, fid, (round % 2));
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (unsigned long fsid = 0; fsid < 4; fsid++) {
+    ASSERT_EQ(0, tracker.GetNumOpenFiles(fsid, false));
+    ASSERT_EQ(0, tracker.GetNumOpenFiles(fsid, true));
+    ASSERT_TRUE(tracker.GetHotFiles(fsid, false, 10).empty());
+  }
+}
@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------------
+// File: ParityEngineTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "fst/layout/ParityEngine.hh"
+#include "fst/layout/jerasure/include/jerasure.h"
+
+using namespace eos::fst;
+
+TEST(ParityEngineTest, XorRegions)
+{
+  const size_t len = 4096 + 77;
+  std::vector< std::vector<char> > bufs(5, std::vector<char>(len + 3));
+
+  for (size_t b = 0; b < bufs.size(); b++) {
+    for (size_t i = 0; i < bufs[b].size(); i++) {
+      bufs[b][i] = random();
+    }
+  }
+
+  // unaligned sources, any count, destination aliasing the first source
+  for (unsigned int n = 0; n <= 4; n++) {
+    const char* srcs[4];
+
+    for (unsigned int s = 0; s < n; s++) {
+      srcs[s] = &bufs[s][s % 3];
+    }
+
+    std::vector<char> expected(len, 0);
+
+    for (unsigned int s = 0; s < n; s++) {
+      for (size_t i = 0; i < len; i++) {
+        expected[i] ^= srcs[s][i];
+      }
+    }
+
+    std::vector<char> scalar(len);
+    xorRegionsScalar(&scalar[0], srcs, n, len);
+    ASSERT_TRUE(scalar == expected);
+    std::vector<char> out(len, 1);
+    xorRegions(&out[0], srcs, n, len);
+    ASSERT_TRUE(out == expected);
+  }
+
+  std::vector<char> first(bufs[0].begin(), bufs[0].begin() + len);
+  const char* srcs[] = { &first[0], &bufs[1][0] };
+  xorRegions(&first[0], srcs, 2, len);
+
+  for (size_t i = 0; i < len; i++) {
+    ASSERT_EQ((char)(bufs[0][i] ^ bufs[1][i]), first[i]);
+  }
+}
+
+TEST(ParityEngineTest, RaidDpPlan)
+{
+  // reference: the original block selection of RaidDpLayout::ComputeParity
+  for (unsigned int k = 2; k <= 8; k++) {
+    const RaidDpParityPlan& plan = RaidDpParityPlan::Get(k);
+    ASSERT_EQ(&plan, &RaidDpParityPlan::Get(k));
+    ASSERT_EQ(2 * k, plan.GetTargets().size());
+    unsigned int nb_total_blocks = k * k + 2 * k;
+
+    for (unsigned int i = 0; i < k; i++) {
+      ASSERT_EQ((i + 1) * k + 2 * i, plan.GetTargets()[i]);
+      std::vector<unsigned int> srcs;
+
+      for (unsigned int b = i * (k + 2); b < (i + 1) * k + 2 * i; b++) {
+        srcs.push_back(b);
+      }
+
+      ASSERT_TRUE(srcs == plan.GetSources()[i]);
+    }
+
+    std::vector<unsigned int> used;
+
+    for (unsigned int i = 0; i < k; i++) {
+      used.push_back((i + 1) * (k + 1) + i);
+    }
+
+    for (unsigned int i = 0; i < k; i++) {
+      unsigned int next = i + k + 3;
+      std::vector<unsigned int> srcs;
+      srcs.push_back(i);
+      srcs.push_back(next);
+      used.push_back(i);
+      used.push_back(next);
+
+      for (unsigned int j = 0; j < k - 2; j++) {
+        unsigned int aux = next + k + 3;
+
+        if ((aux < nb_total_blocks) &&
+            (std::find(used.begin(), used.end(), aux) == used.end())) {
+          next = aux;
+        } else {
+          next++;
+
+          while (std::find(used.begin(), used.end(), next) != used.end()) {
+            next++;
+          }
+        }
+
+        srcs.push_back(next);
+        used.push_back(next);
+      }
+
+      ASSERT_EQ((i + 1) * (k + 1) + i, plan.GetTargets()[k + i]);
+      ASSERT_TRUE(srcs == plan.GetSources()[k + i]);
+    }
+  }
+}
+
+TEST(ParityEngineTest, ReedSolomon)
+{
+  const int w = 8;
+  const size_t width = 64 * 1024;
+  const int packet = width / (w * sizeof(int));
+  int configs[][2] = { {4, 2}, {8, 3}, {10, 4} };
+
+  for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+    int k = configs[c][0];
+    int m = configs[c][1];
+    const ReedSCodec* codec = ReedSCodec::Get(k, m, w);
+    ASSERT_TRUE(codec != 0);
+    ASSERT_EQ(codec, ReedSCodec::Get(k, m, w));
+    std::vector<char> data_buf(k * width);
+    std::vector<char> ref_buf(m * width);
+    std::vector<char> coding_buf(m * width);
+    std::vector<char*> data(k), ref(m), coding(m);
+
+    for (size_t i = 0; i < data_buf.size(); i++) {
+      data_buf[i] = random();
+    }
+
+    for (int i = 0; i < k; i++) {
+      data[i] = &data_buf[i * width];
+    }
+
+    for (int i = 0; i < m; i++) {
+      ref[i] = &ref_buf[i * width];
+      coding[i] = &coding_buf[i * width];
+    }
+
+    jerasure_schedule_encode(k, m, w, codec->GetSchedule(), &data[0], &ref[0],
+                             width, packet);
+    codec->Encode(&data[0], &coding[0], width, packet);
+    ASSERT_TRUE(ref_buf == coding_buf);
+    // lose one data block and one parity block, then a single data block
+    std::vector<char> orig = data_buf;
+    int erasures[] = { 1, k + m - 1, -1 };
+    memset(data[1], 0, width);
+    memset(coding[m - 1], 0, width);
+    ASSERT_EQ(0, codec->Decode(erasures, &data[0], &coding[0], width, packet));
+    ASSERT_TRUE(orig == data_buf);
+    ASSERT_TRUE(ref_buf == coding_buf);
+    int single[] = { k - 1, -1 };
+    memset(data[k - 1], 0, width);
+    ASSERT_EQ(0, codec->Decode(single, &data[0], &coding[0], width, packet));
+    ASSERT_TRUE(orig == data_buf);
+  }
+}
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+// File: PublishFilterTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/storage/PublishFilter.hh"
+
+using namespace eos::fst;
+
+TEST(PublishFilterTest, ApproximateValues)
+{
+  PublishFilter filter(0.05, 0.01);
+  filter.SetFullPublish(false);
+  // never published
+  ASSERT_TRUE(filter.Changed("", 0.0));
+  // small relative/absolute moves are suppressed
+  ASSERT_FALSE(filter.Changed("100.000000", 104.0));
+  ASSERT_FALSE(filter.Changed("0.001", 0.005));
+  ASSERT_TRUE(filter.Changed("100.000000", 106.0));
+  ASSERT_TRUE(filter.Changed("100", 90.0));
+  // going idle is always published
+  ASSERT_TRUE(filter.Changed("0.005", 0.0));
+  ASSERT_FALSE(filter.Changed("0", 0.0));
+  ASSERT_TRUE(filter.Changed("0", 1.0));
+  ASSERT_EQ(5u, filter.GetPublished());
+  ASSERT_EQ(3u, filter.GetSuppressed());
+}
+
+TEST(PublishFilterTest, ExactValues)
+{
+  PublishFilter filter;
+  filter.SetFullPublish(false);
+  ASSERT_FALSE(filter.Changed("1099511627776", 1099511627776ll));
+  ASSERT_TRUE(filter.Changed("1099511627776", 1099511627777ll));
+  ASSERT_TRUE(filter.Changed("", 0ll));
+  ASSERT_FALSE(filter.Changed(std::string("booted"), std::string("booted")));
+  ASSERT_TRUE(filter.Changed(std::string("booted"), std::string("booting")));
+  filter.ResetCounters();
+  ASSERT_EQ(0u, filter.GetPublished());
+  ASSERT_EQ(0u, filter.GetSuppressed());
+}
+
+TEST(PublishFilterTest, FullPublish)
+{
+  PublishFilter filter;
+  ASSERT_TRUE(filter.FullPublish());
+  ASSERT_TRUE(filter.Changed("100", 100.0));
+  ASSERT_TRUE(filter.Changed("7", 7ll));
+  ASSERT_TRUE(filter.Changed(std::string("x"), std::string("x")));
+  filter.SetFullPublish(false);
+  ASSERT_FALSE(filter.Changed("7", 7ll));
+}
@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+// File: ReadaheadStreamsTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "fst/io/xrd/ReadaheadStreams.hh"
+
+using namespace eos::fst;
+
+TEST(ReadaheadStreamsTest, InterleavedStreams)
+{
+  const uint64_t bs = 1024 * 1024;
+  ReadaheadStreams ra(bs, 1, 8);
+  bool is_new = false;
+  // Two readers interleaved in the same file keep their own stream
+  unsigned int s1 = ra.Access(0, 4096, is_new);
+  ASSERT_TRUE(is_new);
+  unsigned int s2 = ra.Access(100 * bs, 4096, is_new);
+  ASSERT_TRUE(is_new);
+  ASSERT_NE(s1, s2);
+
+  for (uint64_t i = 1; i < 10; i++) {
+    ASSERT_EQ(s1, ra.Access(i * 4096, 4096, is_new));
+    ASSERT_FALSE(is_new);
+    ASSERT_EQ(s2, ra.Access(100 * bs + i * 4096, 4096, is_new));
+    ASSERT_FALSE(is_new);
+  }
+
+  // A small gap still continues the stream
+  ASSERT_EQ(s1, ra.Access(bs / 2, 4096, is_new));
+  ASSERT_FALSE(is_new);
+  // Further streams replace the least recently used one
+  unsigned int s3 = ra.Access(200 * bs, 4096, is_new);
+  unsigned int s4 = ra.Access(300 * bs, 4096, is_new);
+  ASSERT_EQ(s2, ra.Access(100 * bs + 10 * 4096, 4096, is_new));
+  unsigned int s5 = ra.Access(400 * bs, 4096, is_new);
+  ASSERT_TRUE(is_new);
+  ASSERT_EQ(s1, s5);
+  ASSERT_NE(s3, s4);
+  ASSERT_EQ(400 * bs, ra.GetPrefetch(s5));
+}
+
+TEST(ReadaheadStreamsTest, Window)
+{
+  const uint64_t bs = 1024 * 1024;
+  ReadaheadStreams ra(bs, 1, 8);
+  bool is_new = false;
+  unsigned int s = ra.Access(0, bs, is_new);
+  ASSERT_EQ(1u, ra.GetWindow(s));
+  ASSERT_EQ(0u, ra.GetPrefetch(s));
+  // Block 0 read on demand, the prefetching continues after it
+  ra.Restart(s, 0);
+  ASSERT_EQ(bs, ra.GetPrefetch(s));
+  ASSERT_EQ(1u, ra.GetWindow(s));
+  ra.Prefetched(s);
+  // The reader waits for its blocks, the window grows up to the maximum
+  ra.Access(bs, bs, is_new);
+  ra.Hit(s, true);
+  ASSERT_EQ(2u, ra.GetWindow(s));
+  ra.Hit(s, false);
+  ASSERT_EQ(2u, ra.GetWindow(s));
+
+  for (int i = 0; i < 5; i++) {
+    ra.Hit(s, true);
+  }
+
+  ASSERT_EQ(8u, ra.GetWindow(s));
+  // Unread blocks shrink the window, catching up with the prefetching counts
+  // as waiting
+  ra.Wasted(s);
+  ra.Wasted(s);
+  ASSERT_EQ(2u, ra.GetWindow(s));
+  ra.Restart(s, ra.GetPrefetch(s));
+  ASSERT_EQ(4u, ra.GetWindow(s));
+  ra.Wasted(s);
+  ra.Wasted(s);
+  ra.Wasted(s);
+  ASSERT_EQ(1u, ra.GetWindow(s));
+  std::string summary = ra.Summary();
+  ASSERT_TRUE(summary.find("prefetched=1 hits=7 wasted=5") !=
+              std::string::npos) << summary;
+}
+
+TEST(ReadaheadStreamsTest, RandomReads)
+{
+  const uint64_t bs = 1024 * 1024;
+  ReadaheadStreams ra(bs, 1, 8);
+  bool is_new = false;
+  ASSERT_FALSE(ra.Used());
+
+  // Random reads waste everything prefetched for them
+  for (uint64_t i = 0; i < 8; i++) {
+    unsigned int s = ra.Access(i * 10 * bs, 4096, is_new);
+    ASSERT_TRUE(is_new);
+    ASSERT_TRUE(ra.Wanted(s));
+    ra.Prefetched(s);
+    ra.Wasted(s);
+  }
+
+  ASSERT_TRUE(ra.Used());
+  // From now on a stream needs to be confirmed before prefetching
+  unsigned int s = ra.Access(500 * bs, 4096, is_new);
+  ASSERT_TRUE(is_new);
+  ASSERT_FALSE(ra.Wanted(s));
+  ra.Access(500 * bs + 4096, 4096, is_new);
+  ASSERT_FALSE(ra.Wanted(s));
+  ra.Access(500 * bs + 8192, 4096, is_new);
+  ASSERT_TRUE(ra.Wanted(s));
+  ra.Reset(bs, 1, 8);
+  ASSERT_FALSE(ra.Used());
+}
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+// File: XrdMqSubscriptionIndexTest.cc
+// Author: agent
+//------------------------------------------------------------------------------
+
+/************************************************************************
+ * EOS - the CERN Disk Storage System                                   *
+ * Copyright (C) 2026 CERN/Switzerland                                  *
+ *                                                                      *
+ * This program is free software: you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful,      *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.*
+ ************************************************************************/
+
+#include <gtest/gtest.h>
+#include "mq/XrdMqSubscriptionIndex.hh"
+#include <sstream>
+
+class XrdMqSubscriptionIndexTest : public ::testing::Test
+{
+public:
+  XrdMqSubscriptionIndex<int> index;
+  std::vector<std::string> names;
+  int values[512];
+
+  virtual void SetUp() override
+  {
+    for (int i = 0; i < 500; ++i) {
+      std::ostringstream oss;
+      oss << "/eos/fst" << i << ".cern.ch:1095/fst";
+      names.push_back(oss.str());
+    }
+
+    names.push_back("/eos/mgm.cern.ch:1094/mgm");
+    names.push_back("/eos/fst1.cern.ch:1095/fstx");
+    names.push_back("/xmessage/client");
+
+    for (size_t i = 0; i < names.size(); ++i) {
+      ASSERT_TRUE(index.Insert(names[i], &values[i], (i % 2) ? 1 : 2));
+    }
+  }
+
+  size_t BruteForce(const std::string& pattern, const std::string& exclude)
+  {
+    size_t n = 0;
+
+    for (auto& name : names) {
+      if ((name != exclude) &&
+          XrdMqSubscriptionIndex<int>::GlobMatch(pattern.c_str(), name.c_str())) {
+        n++;
+      }
+    }
+
+    return n;
+  }
+};
+
+TEST_F(XrdMqSubscriptionIndexTest, GlobMatch)
+{
+  ASSERT_TRUE(XrdMqSubscriptionIndex<int>::GlobMatch("/eos/*/fst",
+              "/eos/a:1095/fst"));
+  ASSERT_TRUE(XrdMqSubscriptionIndex<int>::GlobMatch("/xmessage/*",
+              "/xmessage/a/b"));
+  ASSERT_TRUE(XrdMqSubscriptionIndex<int>::GlobMatch("*", ""));
+  ASSERT_TRUE(XrdMqSubscriptionIndex<int>::GlobMatch("a*b*c", "aXbYbZc"));
+  ASSERT_FALSE(XrdMqSubscriptionIndex<int>::GlobMatch("/eos/*/fst",
+               "/eos/a:1095/fstx"));
+  ASSERT_FALSE(XrdMqSubscriptionIndex<int>::GlobMatch("/eos/*/fst", "/eos/fst"));
+}
+
+TEST_F(XrdMqSubscriptionIndexTest, WildcardMatch)
+{
+  const char* patterns[] = {"/eos/*/fst", "/eos/*", "*", "/xmessage/*",
+                            "/eos/fst1*/fst", "*mgm", "nothing*", "*fst*x"
+                           };
+  const std::string exclude = "/eos/fst7.cern.ch:1095/fst";
+
+  for (auto pattern : patterns) {
+    std::vector<int*> out;
+    index.Match(pattern, exclude, out);
+    ASSERT_EQ(BruteForce(pattern, exclude), out.size()) << pattern;
+  }
+}
+
+TEST_F(XrdMqSubscriptionIndexTest, NamedMatchAndRemove)
+{
+  std::vector<int*> out;
+  index.Match(names[3], names[3], out);
+  ASSERT_EQ(1u, out.size());
+  ASSERT_EQ(&values[3], out[0]);
+  ASSERT_FALSE(index.Insert(names[3], &values[3]));
+  ASSERT_TRUE(index.Remove(names[3]));
+  ASSERT_FALSE(index.Remove(names[3]));
+  ASSERT_EQ(nullptr, index.Find(names[3]));
+  out.clear();
+  index.Match("/eos/*/fst", "", out);
+  ASSERT_EQ(499u, out.size());
+}
+
+TEST_F(XrdMqSubscriptionIndexTest, FlagMatch)
+{
+  std::vector<int*> out;
+  index.MatchFlag(1, names[1], out);
+  ASSERT_EQ(names.size() / 2 - 1, out.size());
+  out.clear();
+  index.MatchFlag(2, "", out);
+  ASSERT_EQ(names.size() - names.size() / 2, out.size());
+}